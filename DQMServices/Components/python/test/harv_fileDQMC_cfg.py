@@ -0,0 +1,28 @@
+import FWCore.ParameterSet.Config as cms
+import sys
+
+# Loads a DQM file written by create_filePB_cfg.py or create_fileDQMC_cfg.py
+# through DQMStore::load and saves its content as a ROOT file, so that the
+# PB and DQMC formats can be compared bin by bin.
+#   cmsRun harv_fileDQMC_cfg.py <input file> <workflow>
+
+process = cms.Process("TESTHARV")
+
+process.load("DQMServices.Components.DQMFileSaver_cfi")
+process.load("DQMServices.Components.DQMFileReader_cfi")
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(1))
+process.source = cms.Source("EmptySource")
+
+process.dqmFileReader.FileNames = cms.untracked.vstring(sys.argv[2])
+
+process.dqmSaver.workflow = cms.untracked.string(sys.argv[3])
+process.dqmSaver.convention = 'Offline'
+process.dqmSaver.saveByRun = cms.untracked.int32(-1)
+process.dqmSaver.saveAtJobEnd = cms.untracked.bool(True)
+process.dqmSaver.forceRunNumber = cms.untracked.int32(1)
+
+process.p = cms.Path(process.dqmFileReader)
+process.o = cms.EndPath(process.dqmSaver)
+
+process.add_(cms.Service("DQMStore"))
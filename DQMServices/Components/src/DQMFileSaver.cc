@@ -52,6 +52,8 @@ dataFileExtension(DQMFileSaver::FileFormat fileFormat)
     extension = ".root";
   else if (fileFormat ==  DQMFileSaver::PB)
     extension = ".pb";
+  else if (fileFormat ==  DQMFileSaver::DQMC)
+    extension = ".dqmc";
   return extension;
 }
 
@@ -78,8 +80,11 @@ DQMFileSaver::saveForOfflinePB(const std::string &workflow, int run) const
 {
   char suffix[64];
   sprintf(suffix, "R%09d", run);
-  std::string filename = onlineOfflineFileName(fileBaseName_, std::string(suffix), workflow, child_, PB);
-  dbe_->savePB(filename, filterName_);
+  std::string filename = onlineOfflineFileName(fileBaseName_, std::string(suffix), workflow, child_, fileFormat_);
+  if (fileFormat_ == DQMC)
+    dbe_->saveColumnar(filename, filterName_);
+  else
+    dbe_->savePB(filename, filterName_);
 }
 
 void
@@ -188,6 +193,10 @@ doSaveForOnline(DQMStore *store,
     store->savePB(filename,
 		  filterName,
 		  enableMultiThread ? run : 0);
+  else if (fileFormat == DQMFileSaver::DQMC)
+    store->saveColumnar(filename,
+                        filterName,
+                        enableMultiThread ? run : 0);
 }
 
 void
@@ -197,14 +206,14 @@ DQMFileSaver::saveForOnlinePB(int run, const std::string &suffix) const
   // as we do not want to look inside the DQMStore,
   // and the @a suffix, defined in the run/lumi transitions.
   // TODO(diguida): add the possibility to change the dir structure with rewrite.
-  std::string filename = onlineOfflineFileName(fileBaseName_, suffix, workflow_, child_, PB);
+  std::string filename = onlineOfflineFileName(fileBaseName_, suffix, workflow_, child_, fileFormat_);
   doSaveForOnline(dbe_, run, enableMultiThread_,
 		  filename,
 		  "", "^(Reference/)?([^/]+)", "\\1\\2",
 		  (DQMStore::SaveReferenceTag) saveReference_,
 		  saveReferenceQMin_,
 		  filterName_,
-		  PB);
+		  fileFormat_);
 }
 
 void
@@ -373,7 +382,10 @@ DQMFileSaver::saveForFilterUnit(const std::string& rewrite, int run, int lumi,
     } else if (fileFormat == PB) {
       openHistoFilePathName = edm::Service<evf::EvFDaqDirector>()->getOpenProtocolBufferHistogramFilePath(lumi, stream_label_);
       histoFilePathName = edm::Service<evf::EvFDaqDirector>()->getProtocolBufferHistogramFilePath(lumi, stream_label_);
-    }
+    } else
+      throw cms::Exception("DQMFileSaver")
+        << "Columnar files can be saved in the FilterUnit convention"
+        << " only in fakeFilterUnitMode.";
   }
 
   if (fms_ ? fms_->getEventsProcessedForLumi(lumi) : true) {
@@ -401,10 +413,17 @@ DQMFileSaver::saveForFilterUnit(const std::string& rewrite, int run, int lumi,
         enableMultiThread_ ? run : 0,
         lumi);
     }
+    else if (fileFormat == DQMC)
+    {
+      dbe_->saveColumnar(openHistoFilePathName,
+        filterName_,
+        enableMultiThread_ ? run : 0,
+        lumi);
+    }
     else
       throw cms::Exception("DQMFileSaver")
         << "Internal error, can save files"
-        << " only in ROOT or ProtocolBuffer format.";
+        << " only in ROOT, ProtocolBuffer or columnar format.";
 
     // Now move the the data and json files into the output directory.
     rename(openHistoFilePathName.c_str(), histoFilePathName.c_str());
@@ -505,10 +524,12 @@ DQMFileSaver::DQMFileSaver(const edm::ParameterSet &ps)
     fileFormat_ = ROOT;
   else if (fileFormat == "PB")
     fileFormat_ = PB;
+  else if (fileFormat == "DQMC")
+    fileFormat_ = DQMC;
   else
     throw cms::Exception("DQMFileSaver")
       << "Invalid 'fileFormat' parameter '" << fileFormat << "'."
-      << "  Expected one of 'ROOT' or 'PB'.";
+      << "  Expected one of 'ROOT', 'PB' or 'DQMC'.";
 
   // Allow file producer to be set to specific values in certain conditions.
   producer_ = ps.getUntrackedParameter<std::string>("producer", producer_);
@@ -707,12 +728,12 @@ DQMFileSaver::globalEndLuminosityBlock(const edm::LuminosityBlock & iLS, const e
       sprintf(rewrite, "\\1Run %d/\\2/By Lumi Section %d-%d", irun, ilumi-nlumi_, ilumi);
       if (fileFormat_ == ROOT)
         saveForOnline(irun, suffix, rewrite);
-      else if (fileFormat_ == PB)
+      else if (fileFormat_ == PB || fileFormat_ == DQMC)
         saveForOnlinePB(irun, suffix);
       else
         throw cms::Exception("DQMFileSaver")
           << "Internal error, can save files"
-          << " only in ROOT or ProtocolBuffer format.";
+          << " only in ROOT, ProtocolBuffer or columnar format.";
     }
 
     // Store at every lumi section end only if some events have been processed.
@@ -761,16 +782,16 @@ DQMFileSaver::globalEndRun(const edm::Run & iRun, const edm::EventSetup &) const
 	  sprintf(rewrite, "\\1Run %d/\\2/Run summary", irun);
 	  if (fileFormat_ == ROOT)
 	    saveForOnline(irun, suffix, rewrite);
-	  else if (fileFormat_ == PB)
+	  else if (fileFormat_ == PB || fileFormat_ == DQMC)
 	    saveForOnlinePB(irun, suffix);
 	  else
 	    throw cms::Exception("DQMFileSaver")
 	      << "Internal error, can save files"
-	      << " only in ROOT or ProtocolBuffer format.";
+	      << " only in ROOT, ProtocolBuffer or columnar format.";
 	}
       else if (convention_ == Offline && fileFormat_ == ROOT)
 	saveForOffline(workflow_, irun, 0);
-      else if (convention_ == Offline && fileFormat_ == PB)
+      else if (convention_ == Offline && (fileFormat_ == PB || fileFormat_ == DQMC))
 	saveForOfflinePB(workflow_, irun);
       else
 	throw cms::Exception("DQMFileSaver")
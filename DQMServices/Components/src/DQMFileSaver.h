@@ -45,7 +45,8 @@ public:
   enum FileFormat
   {
     ROOT,
-    PB
+    PB,
+    DQMC
   };
 
 private:
@@ -0,0 +1,39 @@
+#!/bin/bash
+
+# Round trip of the columnar DQM file format: the same monitor elements are
+# saved per lumisection as PB and as DQMC files, each file is loaded back
+# through DQMStore::load and saved as ROOT, and the two are compared bin by bin.
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+export LOCAL_TEST_DIR=$CMSSW_BASE/src/DQMServices/Components/python/test/
+lumis="0001 0005 0010"
+
+rm -fr dqmcTests
+mkdir dqmcTests
+cd dqmcTests
+
+for testConfig in create_filePB_cfg.py create_fileDQMC_cfg.py
+do
+  echo "${testConfig}"
+  cmsRun ${LOCAL_TEST_DIR}/${testConfig} BR &> ${testConfig}.log || die "cmsRun ${testConfig}" $?
+done
+
+for lumi in $lumis
+do
+  base=run000001/run000001_ls${lumi}_streamDQMHistograms
+  for format in pb dqmc
+  do
+    [ -f ${base}.${format} ] || die "missing ${base}.${format}" 1
+    echo "harv_fileDQMC_cfg.py ${base}.${format}"
+    cmsRun ${LOCAL_TEST_DIR}/harv_fileDQMC_cfg.py ${base}.${format} /Test/LS${lumi}/${format} &> harv_${lumi}_${format}.log \
+      || die "cmsRun harv_fileDQMC_cfg.py ${base}.${format}" $?
+  done
+
+  echo "comparing the PB and DQMC files of lumisection ${lumi}"
+  compare_using_files.py DQM_V0001_R000000001__Test__LS${lumi}__pb.root DQM_V0001_R000000001__Test__LS${lumi}__dqmc.root \
+    -C -s b2b -t 0.999999 2> /dev/null | grep -q 'Successes: 100.00%' \
+    || die "comparing the PB and DQMC files of lumisection ${lumi}" 1
+done
+
+exit 0
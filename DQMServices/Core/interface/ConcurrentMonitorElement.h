@@ -6,15 +6,111 @@
  * ...
  */
 
+#include <memory>
 #include <mutex>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/spin_mutex.h>
 
 #include "DQMServices/Core/interface/MonitorElement.h"
 
+#include "TList.h"
+
+/* Per-thread copies of a histogram MonitorElement.
+ *
+ * Each thread fills its own copy; the copies are added to the booked
+ * MonitorElement by merge(), e.g. at the end of each lumisection. Each copy
+ * has its own lock, which is only ever contended by merge(), so that merging
+ * is safe while other threads keep filling (e.g. with concurrent lumisections).
+ */
+class ConcurrentMonitorElementReplicas
+{
+private:
+  struct Replica {
+    tbb::spin_mutex lock;
+    std::unique_ptr<MonitorElement> me;
+  };
+
+  MonitorElement* me_;
+  mutable tbb::enumerable_thread_specific<Replica> replicas_;
+  // protects the booked MonitorElement and the creation of new copies
+  mutable tbb::spin_mutex lock_;
+
+  // must be called while holding lock_
+  void mergeReplicas()
+  {
+    for (auto& replica : replicas_) {
+      std::lock_guard<tbb::spin_mutex> guard(replica.lock);
+      if (replica.me and replica.me->getTH1()->GetEntries()) {
+        // same as DQMStore::mergeAndResetMEsRunSummaryCache
+        if (me_->getTH1()->CanExtendAllAxes() and replica.me->getTH1()->CanExtendAllAxes()) {
+          TList list;
+          list.Add(replica.me->getTH1());
+          me_->getTH1()->Merge(&list);
+        } else {
+          me_->getTH1()->Add(replica.me->getTH1());
+        }
+        me_->update();
+        replica.me->Reset();
+      }
+    }
+  }
+
+public:
+  explicit ConcurrentMonitorElementReplicas(MonitorElement* me) :
+    me_(me)
+  { }
+
+  // fill the copy used by the calling thread, created on its first fill
+  template <typename... Args>
+  void fill(Args && ... args) const
+  {
+    auto& replica = replicas_.local();
+    if (not replica.me) {
+      // cloning the booked histogram is not concurrent-safe
+      std::lock_guard<tbb::spin_mutex> guard(lock_);
+      replica.me = std::make_unique<MonitorElement>(*me_);
+      replica.me->Reset();
+    }
+    std::lock_guard<tbb::spin_mutex> guard(replica.lock);
+    replica.me->Fill(std::forward<Args>(args)...);
+  }
+
+  void merge()
+  {
+    std::lock_guard<tbb::spin_mutex> guard(lock_);
+    mergeReplicas();
+  }
+
+  // ShiftFillLast moves the content of the histogram, so the copies are
+  // merged first and the shift is applied to the booked histogram
+  void shiftFillLast(double y, double ye, int32_t xscale)
+  {
+    std::lock_guard<tbb::spin_mutex> guard(lock_);
+    mergeReplicas();
+    me_->ShiftFillLast(y, ye, xscale);
+  }
+
+  // apply a change of titles, labels or axes to the booked histogram and
+  // to all its copies, so that they can still be merged
+  template <typename F>
+  void apply(F && f)
+  {
+    std::lock_guard<tbb::spin_mutex> guard(lock_);
+    f(*me_);
+    for (auto& replica : replicas_) {
+      std::lock_guard<tbb::spin_mutex> guard(replica.lock);
+      if (replica.me)
+        f(*replica.me);
+    }
+  }
+};
+
 class ConcurrentMonitorElement
 {
 private:
   mutable MonitorElement* me_;
+  // only set for histograms booked with per-thread replicas
+  std::shared_ptr<ConcurrentMonitorElementReplicas> replicas_;
   mutable tbb::spin_mutex lock_;
 
 public:
@@ -26,6 +122,11 @@ public:
     me_(me)
   { }
 
+  ConcurrentMonitorElement(MonitorElement* me, std::shared_ptr<ConcurrentMonitorElementReplicas> replicas) :
+    me_(me),
+    replicas_(std::move(replicas))
+  { }
+
   // non-copiable
   ConcurrentMonitorElement(ConcurrentMonitorElement const&) = delete;
 
@@ -34,6 +135,7 @@ public:
   {
     std::lock_guard<tbb::spin_mutex> guard(other.lock_);
     me_ = other.me_;
+    replicas_ = std::move(other.replicas_);
     other.me_ = nullptr;
   }
 
@@ -48,6 +150,7 @@ public:
     std::lock_guard<tbb::spin_mutex> ours(lock_, std::adopt_lock);
     std::lock_guard<tbb::spin_mutex> others(other.lock_, std::adopt_lock);
     me_ = other.me_;
+    replicas_ = std::move(other.replicas_);
     other.me_ = nullptr;
     return *this;
   }
@@ -59,6 +162,10 @@ public:
   template <typename... Args>
   void fill(Args && ... args) const
   {
+    if (replicas_) {
+      replicas_->fill(std::forward<Args>(args)...);
+      return;
+    }
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_->Fill(std::forward<Args>(args)...);
   }
@@ -67,6 +174,10 @@ public:
   void shiftFillLast(double y, double ye = 0., int32_t xscale = 1) const
   {
     std::lock_guard<tbb::spin_mutex> guard(lock_);
+    if (replicas_) {
+      replicas_->shiftFillLast(y, ye, xscale);
+      return;
+    }
     me_->ShiftFillLast(y, ye, xscale);
   }
 
@@ -75,6 +186,7 @@ public:
   {
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_ = nullptr;
+    replicas_.reset();
   }
 
   operator bool() const
@@ -86,59 +198,71 @@ public:
   // non-const methods to manipulate axes and titles.
   // these are not concurrent-safe, and should be used only when the underlying
   // MonitorElement is being booked.
+  // for histograms booked with per-thread replicas they are also applied to
+  // the replicas that already exist.
   void setTitle(std::string const& title)
   {
-    me_->setTitle(title);
+    apply([&](MonitorElement& me) { me.setTitle(title); });
   }
 
   void setXTitle(std::string const& title)
   {
-    me_->getTH1()->SetXTitle(title.c_str());
+    apply([&](MonitorElement& me) { me.getTH1()->SetXTitle(title.c_str()); });
   }
 
   void setXTitle(const char* title)
   {
-    me_->getTH1()->SetXTitle(title);
+    apply([&](MonitorElement& me) { me.getTH1()->SetXTitle(title); });
   }
 
   void setYTitle(std::string const& title)
   {
-    me_->getTH1()->SetYTitle(title.c_str());
+    apply([&](MonitorElement& me) { me.getTH1()->SetYTitle(title.c_str()); });
   }
 
   void setYTitle(const char* title)
   {
-    me_->getTH1()->SetYTitle(title);
+    apply([&](MonitorElement& me) { me.getTH1()->SetYTitle(title); });
   }
 
   void setAxisRange(double xmin, double xmax, int axis = 1)
   {
-    me_->setAxisRange(xmin, xmax, axis);
+    apply([&](MonitorElement& me) { me.setAxisRange(xmin, xmax, axis); });
   }
 
   void setAxisTitle(std::string const& title, int axis = 1)
   {
-    me_->setAxisTitle(title, axis);
+    apply([&](MonitorElement& me) { me.setAxisTitle(title, axis); });
   }
 
   void setAxisTimeDisplay(int value, int axis = 1)
   {
-    me_->setAxisTimeDisplay(value, axis);
+    apply([&](MonitorElement& me) { me.setAxisTimeDisplay(value, axis); });
   }
 
   void setAxisTimeFormat(const char* format = "", int axis = 1)
   {
-    me_->setAxisTimeFormat(format, axis);
+    apply([&](MonitorElement& me) { me.setAxisTimeFormat(format, axis); });
   }
 
   void setBinLabel(int bin, std::string const& label, int axis = 1)
   {
-    me_->setBinLabel(bin, label, axis);
+    apply([&](MonitorElement& me) { me.setBinLabel(bin, label, axis); });
   }
 
   void enableSumw2()
   {
-    me_->getTH1()->Sumw2();
+    apply([&](MonitorElement& me) { me.getTH1()->Sumw2(); });
+  }
+
+private:
+  template <typename F>
+  void apply(F && f)
+  {
+    if (replicas_)
+      replicas_->apply(std::forward<F>(f));
+    else
+      f(*me_);
   }
 
 };
@@ -3,13 +3,22 @@
 
 #include "DQMServices/Core/interface/DQMStore.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/Run.h"
 #include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 
 template <typename H>
-class DQMGlobalEDAnalyzer : public edm::global::EDAnalyzer<edm::RunCache<H>>
+class DQMGlobalEDAnalyzer : public edm::global::EDAnalyzer<edm::RunCache<H>, edm::LuminosityBlockCache<void>>
 {
+protected:
+  // fill the histograms through per-thread replicas, merged at the end of
+  // each lumisection, instead of taking a lock on every fill; this trades
+  // memory (one copy of each histogram per thread) for fill throughput.
+  // must be called in the constructor of the module.
+  void
+  useHistogramReplicas(bool value = true) { histogramReplicas_ = value; }
+
 private:
   std::shared_ptr<H>
   globalBeginRun(edm::Run const&, edm::EventSetup const&) const final;
@@ -17,6 +26,12 @@ private:
   void
   globalEndRun(edm::Run const&, edm::EventSetup const&) const final;
 
+  std::shared_ptr<void>
+  globalBeginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) const final;
+
+  void
+  globalEndLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) const final;
+
   virtual void
   dqmBeginRun(edm::Run const&, edm::EventSetup const&, H &) const { }
 
@@ -29,6 +44,8 @@ private:
 
   virtual void
   dqmAnalyze(edm::Event const&, edm::EventSetup const&, H const&) const = 0;
+
+  bool histogramReplicas_ = false;
 };
 
 template <typename H>
@@ -37,19 +54,44 @@ DQMGlobalEDAnalyzer<H>::globalBeginRun(edm::Run const& run, edm::EventSetup cons
 {
   auto h = std::make_shared<H>();
   dqmBeginRun(run, setup, *h);
-  edm::Service<DQMStore>()->bookConcurrentTransaction([&, this](DQMStore::ConcurrentBooker &b) {
-      // this runs while holding the DQMStore lock
-      b.cd();
-      bookHistograms(b, run, setup, *h);
-    },
-    run.run() );
+  auto book = [&, this](DQMStore::ConcurrentBooker &b) {
+    // this runs while holding the DQMStore lock
+    b.cd();
+    bookHistograms(b, run, setup, *h);
+  };
+  if (histogramReplicas_) {
+    // the replicas are merged in globalEndLuminosityBlock and globalEndRun
+    edm::Service<DQMStore>()->bookReplicatedConcurrentTransaction(book, run.run(), this->moduleDescription().id());
+  } else {
+    edm::Service<DQMStore>()->bookConcurrentTransaction(book, run.run());
+  }
   return h;
 }
 
 template <typename H>
 void
-DQMGlobalEDAnalyzer<H>::globalEndRun(edm::Run const&, edm::EventSetup const&) const
+DQMGlobalEDAnalyzer<H>::globalEndRun(edm::Run const& run, edm::EventSetup const&) const
+{
+  // all the events of the run have been analysed
+  if (histogramReplicas_)
+    edm::Service<DQMStore>()->releaseConcurrentReplicas(run.run(), this->moduleDescription().id());
+}
+
+template <typename H>
+std::shared_ptr<void>
+DQMGlobalEDAnalyzer<H>::globalBeginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) const
+{
+  return std::shared_ptr<void>();
+}
+
+template <typename H>
+void
+DQMGlobalEDAnalyzer<H>::globalEndLuminosityBlock(edm::LuminosityBlock const& lumi, edm::EventSetup const&) const
 {
+  // make the content filled so far visible to the per-lumisection saving;
+  // with concurrent lumisections, fills from the following ones may be included
+  if (histogramReplicas_)
+    edm::Service<DQMStore>()->mergeConcurrentReplicas(lumi.run(), this->moduleDescription().id());
 }
 
 template <typename H>
@@ -27,6 +27,7 @@
 namespace edm { class DQMHttpSource; class ParameterSet; class ActivityRegistry; class GlobalContext; }
 namespace lat { class Regexp; }
 namespace dqmstorepb {class ROOTFilePB; class ROOTFilePB_Histo;}
+namespace dqm { namespace columnar { class FileWriter; } }
 
 class MonitorElement;
 class QCriterion;
@@ -222,70 +223,84 @@ class DQMStore
     template <typename... Args>
     ConcurrentMonitorElement book1D(Args && ... args) {
       MonitorElement* me = IBooker::book1D(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
     // for the supported syntaxes, see the declarations of DQMStore::book1S
     template <typename... Args>
     ConcurrentMonitorElement book1S(Args && ... args) {
       MonitorElement* me = IBooker::book1S(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
     // for the supported syntaxes, see the declarations of DQMStore::book1DD
     template <typename... Args>
     ConcurrentMonitorElement book1DD(Args && ... args) {
       MonitorElement* me = IBooker::book1DD(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
     // for the supported syntaxes, see the declarations of DQMStore::book2D
     template <typename... Args>
     ConcurrentMonitorElement book2D(Args && ... args) {
       MonitorElement* me = IBooker::book2D(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
     // for the supported syntaxes, see the declarations of DQMStore::book2S
     template <typename... Args>
     ConcurrentMonitorElement book2S(Args && ... args) {
       MonitorElement* me = IBooker::book2S(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
     // for the supported syntaxes, see the declarations of DQMStore::book2DD
     template <typename... Args>
     ConcurrentMonitorElement book2DD(Args && ... args) {
       MonitorElement* me = IBooker::book2DD(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
     // for the supported syntaxes, see the declarations of DQMStore::book3D
     template <typename... Args>
     ConcurrentMonitorElement book3D(Args && ... args) {
       MonitorElement* me = IBooker::book3D(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
     // for the supported syntaxes, see the declarations of DQMStore::bookProfile
     template <typename... Args>
     ConcurrentMonitorElement bookProfile(Args && ... args) {
       MonitorElement* me = IBooker::bookProfile(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
     // for the supported syntaxes, see the declarations of DQMStore::bookProfile2D
     template <typename... Args>
     ConcurrentMonitorElement bookProfile2D(Args && ... args) {
       MonitorElement* me = IBooker::bookProfile2D(std::forward<Args>(args)...);
-      return ConcurrentMonitorElement(me);
+      return concurrentHistogram(me);
     }
 
   private:
-    explicit ConcurrentBooker(DQMStore * store) :
-      IBooker(store)
+    explicit ConcurrentBooker(DQMStore * store,
+                              std::vector<std::shared_ptr<ConcurrentMonitorElementReplicas>> * replicas = nullptr) :
+      IBooker(store),
+      replicas_(replicas)
     { }
 
+    // histograms are filled through per-thread replicas if the booking
+    // transaction collects them
+    ConcurrentMonitorElement concurrentHistogram(MonitorElement* me) {
+      if (replicas_ == nullptr) {
+        return ConcurrentMonitorElement(me);
+      }
+      replicas_->push_back(std::make_shared<ConcurrentMonitorElementReplicas>(me));
+      return ConcurrentMonitorElement(me, replicas_->back());
+    }
+
+    std::vector<std::shared_ptr<ConcurrentMonitorElementReplicas>> * replicas_;
+
     ConcurrentBooker() = delete;
     ConcurrentBooker(ConcurrentBooker const&) = delete;
     ConcurrentBooker(ConcurrentBooker &&) = delete;
@@ -397,6 +412,29 @@ class DQMStore
     }
   }
 
+  // Same as bookConcurrentTransaction, but the histograms are filled
+  // without contention through per-thread replicas. The owner of the
+  // histograms must call mergeConcurrentReplicas with the same run
+  // and module ID, e.g. in its globalEndLuminosityBlock, for their
+  // content to show up in the DQMStore, and releaseConcurrentReplicas
+  // once all their fills are done, e.g. in its globalEndRun.
+  template <typename iFunc>
+  void bookReplicatedConcurrentTransaction(iFunc f, uint32_t run, uint32_t moduleId) {
+    std::lock_guard<std::mutex> guard(book_mutex_);
+    if (enableMultiThread_) {
+      run_ = run;
+    }
+    ConcurrentBooker booker(this, &concurrentReplicas_[std::make_pair(run, moduleId)]);
+    f(booker);
+
+    if (enableMultiThread_) {
+      run_ = 0;
+    }
+  }
+
+  void mergeConcurrentReplicas(uint32_t run, uint32_t moduleId);
+  void releaseConcurrentReplicas(uint32_t run, uint32_t moduleId);
+
   // Signature needed in the harvesting where the booking is done
   // in the endJob. No handles to the run there. Two arguments ensure
   // the capability of booking and getting. The method relies on the
@@ -679,6 +717,10 @@ class DQMStore
                                        const std::string &path = "",
                                        const uint32_t run = 0,
                                        const uint32_t lumi = 0);
+  void                          saveColumnar(const std::string &filename,
+                                             const std::string &path = "",
+                                             const uint32_t run = 0,
+                                             const uint32_t lumi = 0);
   bool                          open(const std::string &filename,
                                      bool overwrite = false,
                                      const std::string &path ="",
@@ -723,6 +765,12 @@ class DQMStore
                                            const std::string &prepend = "",
                                            OpenRunDirs stripdirs = StripRunDirs,
                                            bool fileMustExist = true);
+  bool                          readFileColumnar(const std::string &filename,
+                                                 bool overwrite = false,
+                                                 const std::string &path ="",
+                                                 const std::string &prepend = "",
+                                                 OpenRunDirs stripdirs = StripRunDirs,
+                                                 bool fileMustExist = true);
   bool                          readFile(const std::string &filename,
                                          bool overwrite = false,
                                          const std::string &path ="",
@@ -855,6 +903,16 @@ class DQMStore
                                     MEMap::const_iterator end,
                                     TFile & file,
                                     unsigned int & counter);
+  void                          saveMonitorElementToColumnar(
+                                    MonitorElement const& me,
+                                    dqm::columnar::FileWriter & file);
+  void                          saveMonitorElementRangeToColumnar(
+                                    std::string const& dir,
+                                    unsigned int run,
+                                    MEMap::const_iterator begin,
+                                    MEMap::const_iterator end,
+                                    dqm::columnar::FileWriter & file,
+                                    unsigned int & counter);
 
   unsigned                      verbose_;
   unsigned                      verboseQT_;
@@ -879,6 +937,11 @@ class DQMStore
   QTestSpecs                    qtestspecs_;
 
   std::mutex book_mutex_;
+
+  // replicated histograms booked by bookReplicatedConcurrentTransaction
+  // and not merged yet, indexed by run and module ID
+  std::map<std::pair<uint32_t, uint32_t>,
+           std::vector<std::shared_ptr<ConcurrentMonitorElementReplicas>>> concurrentReplicas_;
   IBooker * ibooker_;
   IGetter * igetter_;
 
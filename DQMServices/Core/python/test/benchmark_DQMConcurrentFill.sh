@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# Measures the DQM event throughput of modules filling
+# ConcurrentMonitorElements from 1 to 64 threads.
+# Additional arguments are passed to the configuration, e.g. fills=100, or
+# replicas=False to measure the locked fill path.
+
+EVENTS=20000
+
+printf "%8s %12s %12s\n" threads "time [s]" "events/s"
+for THREADS in 1 2 4 8 16 32 64; do
+  START=$(date +%s.%N)
+  cmsRun dqm_benchmarkConcurrentFill_cfg.py threads=${THREADS} maxEvents=${EVENTS} "$@" &> benchmark_${THREADS}.log
+  ret=$?
+  STOP=$(date +%s.%N)
+  if [ ${ret} -ne 0 ]; then
+    echo "cmsRun failed with ${THREADS} threads, see benchmark_${THREADS}.log"
+    exit ${ret}
+  fi
+  echo ${THREADS} ${START} ${STOP} ${EVENTS} | awk '{ printf "%8d %12.2f %12.1f\n", $1, $3-$2, $4/($3-$2) }'
+done
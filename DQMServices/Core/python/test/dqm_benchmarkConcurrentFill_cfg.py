@@ -0,0 +1,57 @@
+import FWCore.ParameterSet.Config as cms
+import FWCore.ParameterSet.VarParsing as VarParsing
+
+options = VarParsing.VarParsing('analysis')
+options.register('threads',
+                 1,
+                 VarParsing.VarParsing.multiplicity.singleton,
+                 VarParsing.VarParsing.varType.int,
+                 "Number of threads and streams")
+options.register('histograms',
+                 10,
+                 VarParsing.VarParsing.multiplicity.singleton,
+                 VarParsing.VarParsing.varType.int,
+                 "Number of histograms filled by each module")
+options.register('fills',
+                 1000,
+                 VarParsing.VarParsing.multiplicity.singleton,
+                 VarParsing.VarParsing.varType.int,
+                 "Number of fills of each histogram per event")
+options.register('replicas',
+                 True,
+                 VarParsing.VarParsing.multiplicity.singleton,
+                 VarParsing.VarParsing.varType.bool,
+                 "Fill per-thread replicas of the histograms instead of locking them")
+options.maxEvents = 10000
+options.parseArguments()
+
+process = cms.Process("DQMBENCHMARK")
+process.load("DQMServices.Core.DQM_cfg")
+process.DQMStore.enableMultiThread = cms.untracked.bool(True)
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = 1000
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.source = cms.Source("EmptySource",
+                            numberEventsInRun = cms.untracked.uint32(options.maxEvents),
+                            numberEventsInLuminosityBlock = cms.untracked.uint32(100))
+
+process.dqm_concurrent_fill_a = cms.EDAnalyzer("DQMTestConcurrentFill",
+                                               folder = cms.untracked.string("A_Folder/Module"),
+                                               numberOfHistograms = cms.untracked.uint32(options.histograms),
+                                               fillsPerEvent = cms.untracked.uint32(options.fills),
+                                               useReplicas = cms.untracked.bool(options.replicas))
+process.dqm_concurrent_fill_b = process.dqm_concurrent_fill_a.clone(
+                                               folder = cms.untracked.string("B_Folder/Module"))
+
+process.p = cms.Path(process.dqm_concurrent_fill_a
+                     + process.dqm_concurrent_fill_b)
+
+process.options = cms.untracked.PSet(
+    numberOfStreams = cms.untracked.uint32(options.threads),
+    numberOfThreads = cms.untracked.uint32(options.threads),
+)
@@ -0,0 +1,424 @@
+#include "DQMServices/Core/src/DQMColumnarFormat.h"
+#include "DQMServices/Core/src/DQMError.h"
+#include "DQMServices/Core/interface/MonitorElement.h"
+#include "TBufferFile.h"
+#include "TH1.h"
+#include "TObjString.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace dqm::columnar;
+
+namespace {
+
+  // The loops below are written so that they are vectorised by the compiler.
+  template <typename T>
+  void addColumn(T * __restrict__ to, T const* __restrict__ from, size_t size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      to[i] += from[i];
+  }
+
+  // TH1S saturates instead of wrapping around.
+  void addColumn(short * __restrict__ to, short const* __restrict__ from, size_t size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      to[i] = std::min(std::max(int(to[i]) + int(from[i]), -32768), 32767);
+  }
+
+  template <typename T>
+  void addColumnAsDouble(double * __restrict__ to, T const* __restrict__ from, size_t size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      to[i] += from[i];
+  }
+
+  template <typename T>
+  void mergeColumn(T * to, T const* from, size_t size, bool overwrite)
+  {
+    if (overwrite)
+      std::copy(from, from + size, to);
+    else
+      addColumn(to, from, size);
+  }
+
+  bool isProfile(uint32_t kind)
+  {
+    return kind == MonitorElement::DQM_KIND_TPROFILE
+      || kind == MonitorElement::DQM_KIND_TPROFILE2D;
+  }
+
+  TAxis const* axis(TH1 const* h, unsigned i)
+  {
+    return i == 0 ? h->GetXaxis() : (i == 1 ? h->GetYaxis() : h->GetZaxis());
+  }
+
+  // TProfile and TProfile2D have no common base class for the bin entries.
+  TArrayD * binSumw2(TH1 * h)
+  {
+    if (auto *p = dynamic_cast<TProfile *>(h))
+      return p->GetBinSumw2();
+    if (auto *p = dynamic_cast<TProfile2D *>(h))
+      return p->GetBinSumw2();
+    return nullptr;
+  }
+
+  TArrayD const* binSumw2(TH1 const* h)
+  {
+    return binSumw2(const_cast<TH1 *>(h));
+  }
+
+  double binEntries(TH1 const* h, int bin)
+  {
+    if (auto const* p = dynamic_cast<TProfile const*>(h))
+      return p->GetBinEntries(bin);
+    return static_cast<TProfile2D const*>(h)->GetBinEntries(bin);
+  }
+
+  void setBinEntries(TH1 * h, int bin, double w)
+  {
+    if (auto *p = dynamic_cast<TProfile *>(h))
+      p->SetBinEntries(bin, w);
+    else
+      static_cast<TProfile2D *>(h)->SetBinEntries(bin, w);
+  }
+
+  void writeAll(int fd, void const* data, size_t size, std::string const& filename)
+  {
+    auto const* p = static_cast<char const*>(data);
+    while (size > 0)
+    {
+      ssize_t n = ::write(fd, p, size);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+      {
+        ::close(fd);
+        raiseDQMError("DQMStore", "Failed to write file '%s': %s",
+                      filename.c_str(), strerror(errno));
+      }
+      p += n;
+      size -= n;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+uint64_t
+FileWriter::append(void const* data, size_t size)
+{
+  uint64_t offset = data_.size();
+  auto const* p = static_cast<char const*>(data);
+  data_.insert(data_.end(), p, p + size);
+  // keep every array 8 byte aligned
+  data_.resize((data_.size() + 7) & ~size_t(7), 0);
+  return offset;
+}
+
+Element &
+FileWriter::newElement(std::string const& name, uint32_t flags, uint32_t kind)
+{
+  elements_.emplace_back();
+  Element & e = elements_.back();
+  std::memset(&e, 0, sizeof(Element));
+  e.name = append(name.data(), name.size());
+  e.nameLength = name.size();
+  e.flags = flags;
+  e.kind = kind;
+  return e;
+}
+
+void
+FileWriter::addScalar(std::string const& name, uint32_t flags, uint32_t kind, std::string const& tag)
+{
+  TObjString object(tag.c_str());
+  TBufferFile buffer(TBufferFile::kWrite);
+  buffer.WriteObject(&object);
+
+  Element & e = newElement(name, flags, kind);
+  e.object = append(buffer.Buffer(), buffer.Length());
+  e.objectLength = buffer.Length();
+}
+
+void
+FileWriter::addHistogram(std::string const& name, uint32_t flags, uint32_t kind, TH1 const* h)
+{
+  Element & e = newElement(name, flags, kind);
+  for (unsigned i = 0; i < 3; ++i)
+  {
+    TAxis const* a = axis(h, i);
+    e.bins[i] = a->GetNbins();
+    e.min[i] = a->GetXmin();
+    e.max[i] = a->GetXmax();
+    if (a->GetLabels())
+      e.labelledAxes |= 1u << i;
+  }
+  e.entries = h->GetEntries();
+  h->GetStats(e.stats);
+  e.cells = h->GetNcells();
+
+  if (auto const* a = dynamic_cast<TArrayF const*>(h))
+    e.contents = append(a->GetArray(), e.cells * sizeof(float));
+  else if (auto const* a = dynamic_cast<TArrayS const*>(h))
+    e.contents = append(a->GetArray(), e.cells * sizeof(short));
+  else if (auto const* a = dynamic_cast<TArrayD const*>(h))
+    e.contents = append(a->GetArray(), e.cells * sizeof(double));
+  else
+    raiseDQMError("DQMStore", "Cannot save histogram '%s' of type '%s' in columnar format",
+                  name.c_str(), h->IsA()->GetName());
+
+  if (h->GetSumw2N() > 0)
+    e.sumw2 = append(h->GetSumw2()->GetArray(), e.cells * sizeof(double));
+
+  if (isProfile(kind))
+  {
+    std::vector<double> entries(e.cells);
+    for (uint64_t bin = 0; bin < e.cells; ++bin)
+      entries[bin] = binEntries(h, bin);
+    e.binEntries = append(entries.data(), e.cells * sizeof(double));
+    TArrayD const* w2 = binSumw2(h);
+    if (w2 && w2->GetSize() > 0)
+      e.binSumw2 = append(w2->GetArray(), e.cells * sizeof(double));
+  }
+
+  // Stream the histogram without its bins, which are stored above.
+  std::unique_ptr<TH1> header(static_cast<TH1 *>(h->Clone()));
+  header->SetBinsLength(0);
+  TBufferFile buffer(TBufferFile::kWrite);
+  buffer.WriteObject(header.get());
+  e.object = append(buffer.Buffer(), buffer.Length());
+  e.objectLength = buffer.Length();
+}
+
+void
+FileWriter::write(std::string const& filename) const
+{
+  FileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.elements = elements_.size();
+  header.elementsOffset = sizeof(FileHeader);
+  uint64_t dataOffset = header.elementsOffset + elements_.size() * sizeof(Element);
+  header.fileSize = dataOffset + data_.size();
+
+  // The offsets were recorded relative to the data section.  The optional
+  // arrays always follow the name of their element, so for them a zero
+  // offset can only mean that they are absent.
+  std::vector<Element> elements(elements_);
+  for (auto & e : elements)
+  {
+    e.name += dataOffset;
+    e.object += dataOffset;
+    for (uint64_t *offset : { &e.contents, &e.sumw2, &e.binEntries, &e.binSumw2 })
+      if (*offset)
+        *offset += dataOffset;
+  }
+
+  int fd = ::open(filename.c_str(),
+                  O_WRONLY | O_CREAT | O_TRUNC,
+                  S_IRUSR | S_IWUSR |
+                  S_IRGRP | S_IWGRP |
+                  S_IROTH);
+  if (fd == -1)
+    raiseDQMError("DQMStore", "Failed to create file '%s': %s",
+                  filename.c_str(), strerror(errno));
+  writeAll(fd, &header, sizeof(header), filename);
+  writeAll(fd, elements.data(), elements.size() * sizeof(Element), filename);
+  writeAll(fd, data_.data(), data_.size(), filename);
+  ::close(fd);
+}
+
+//////////////////////////////////////////////////////////////////////
+FileReader::FileReader(std::string const& filename)
+  : filename_(filename),
+    data_(nullptr),
+    size_(0)
+{
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    raiseDQMError("DQMStore", "Failed to open file '%s'", filename.c_str());
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(FileHeader))
+  {
+    ::close(fd);
+    raiseDQMError("DQMStore", "File '%s' is too short to be a columnar DQM file", filename.c_str());
+  }
+  size_ = st.st_size;
+
+  // Mapped privately: TBufferFile may write to the buffer it reads from,
+  // which must never reach the file.
+  void *data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+    raiseDQMError("DQMStore", "Failed to map file '%s': %s", filename.c_str(), strerror(errno));
+  ::madvise(data, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<char const*>(data);
+
+  FileHeader const& h = header();
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0
+      || h.version != kVersion
+      || h.fileSize != size_
+      || h.elementsOffset + uint64_t(h.elements) * sizeof(Element) > size_)
+  {
+    ::munmap(const_cast<char *>(data_), size_);
+    raiseDQMError("DQMStore", "File '%s' is not a valid columnar DQM file", filename.c_str());
+  }
+}
+
+FileReader::~FileReader()
+{
+  ::munmap(const_cast<char *>(data_), size_);
+}
+
+Element const&
+FileReader::element(uint32_t i) const
+{
+  Element const& e = column<Element>(header().elementsOffset)[i];
+
+  size_t valueSize = sizeof(double);
+  if (e.kind == MonitorElement::DQM_KIND_TH1F
+      || e.kind == MonitorElement::DQM_KIND_TH2F
+      || e.kind == MonitorElement::DQM_KIND_TH3F)
+    valueSize = sizeof(float);
+  else if (e.kind == MonitorElement::DQM_KIND_TH1S
+           || e.kind == MonitorElement::DQM_KIND_TH2S)
+    valueSize = sizeof(short);
+
+  auto inside = [this] (uint64_t offset, uint64_t length)
+    { return offset <= size_ && length <= size_ - offset; };
+  if (! inside(e.name, e.nameLength)
+      || ! inside(e.object, e.objectLength)
+      || (e.contents && ! inside(e.contents, e.cells * valueSize))
+      || (e.sumw2 && ! inside(e.sumw2, e.cells * sizeof(double)))
+      || (e.binEntries && ! inside(e.binEntries, e.cells * sizeof(double)))
+      || (e.binSumw2 && ! inside(e.binSumw2, e.cells * sizeof(double))))
+    raiseDQMError("DQMStore", "Corrupted element %u in file '%s'", i, filename_.c_str());
+  return e;
+}
+
+std::string
+FileReader::name(Element const& e) const
+{
+  return std::string(data_ + e.name, e.nameLength);
+}
+
+bool
+FileReader::compatible(Element const& e, uint32_t kind, TH1 const* h) const
+{
+  if (e.kind != kind || ! e.contents || e.labelledAxes
+      || e.cells != uint64_t(h->GetNcells()))
+    return false;
+  for (unsigned i = 0; i < 3; ++i)
+  {
+    TAxis const* a = axis(h, i);
+    if (a->GetNbins() != e.bins[i]
+        || a->GetXmin() != e.min[i]
+        || a->GetXmax() != e.max[i]
+        || a->GetLabels())
+      return false;
+  }
+  return true;
+}
+
+void
+FileReader::merge(Element const& e, TH1 *h, bool overwrite) const
+{
+  size_t const cells = e.cells;
+
+  // Read the statistics before touching the bins: TH1::GetStats computes
+  // them from the bin contents when they have never been filled.
+  double stats[kMaxStats] = {};
+  if (overwrite)
+    std::copy(e.stats, e.stats + kMaxStats, stats);
+  else
+  {
+    h->GetStats(stats);
+    for (unsigned i = 0; i < kMaxStats; ++i)
+      stats[i] += e.stats[i];
+  }
+  double entries = overwrite ? e.entries : h->GetEntries() + e.entries;
+
+  // Same treatment of the missing sums of squares as TH1::Add; this must
+  // happen before the contents are added, since TH1::Sumw2 starts from them.
+  TArrayD *sumw2 = h->GetSumw2();
+  if (overwrite)
+  {
+    sumw2->Set(e.sumw2 ? cells : 0);
+    if (e.sumw2)
+      std::copy(column<double>(e.sumw2), column<double>(e.sumw2) + cells, sumw2->GetArray());
+  }
+  else if (e.sumw2)
+  {
+    if (sumw2->GetSize() == 0)
+      h->Sumw2();
+    addColumn(sumw2->GetArray(), column<double>(e.sumw2), cells);
+  }
+  else if (sumw2->GetSize() > 0)
+  {
+    if (e.kind == MonitorElement::DQM_KIND_TH1S || e.kind == MonitorElement::DQM_KIND_TH2S)
+      addColumnAsDouble(sumw2->GetArray(), column<short>(e.contents), cells);
+    else if (e.kind == MonitorElement::DQM_KIND_TH1F || e.kind == MonitorElement::DQM_KIND_TH2F
+             || e.kind == MonitorElement::DQM_KIND_TH3F)
+      addColumnAsDouble(sumw2->GetArray(), column<float>(e.contents), cells);
+    else
+      addColumn(sumw2->GetArray(), column<double>(e.contents), cells);
+  }
+
+  if (auto *a = dynamic_cast<TArrayF *>(h))
+    mergeColumn(a->GetArray(), column<float>(e.contents), cells, overwrite);
+  else if (auto *a = dynamic_cast<TArrayS *>(h))
+    mergeColumn(a->GetArray(), column<short>(e.contents), cells, overwrite);
+  else
+    mergeColumn(dynamic_cast<TArrayD *>(h)->GetArray(), column<double>(e.contents), cells, overwrite);
+
+  if (e.binEntries)
+  {
+    double const* from = column<double>(e.binEntries);
+    for (size_t bin = 0; bin < cells; ++bin)
+      setBinEntries(h, bin, overwrite ? from[bin] : binEntries(h, bin) + from[bin]);
+
+    TArrayD *w2 = binSumw2(h);
+    if (overwrite)
+    {
+      w2->Set(e.binSumw2 ? cells : 0);
+      if (e.binSumw2)
+        std::copy(column<double>(e.binSumw2), column<double>(e.binSumw2) + cells, w2->GetArray());
+    }
+    else if (w2->GetSize() > 0)
+      // unweighted entries contribute their number to the sum of the squares
+      addColumn(w2->GetArray(), column<double>(e.binSumw2 ? e.binSumw2 : e.binEntries), cells);
+  }
+
+  h->PutStats(stats);
+  h->SetEntries(entries);
+}
+
+TObject *
+FileReader::object(Element const& e) const
+{
+  TBufferFile buf(TBufferFile::kRead, e.objectLength,
+                  const_cast<char *>(data_ + e.object), kFALSE);
+  buf.Reset();
+  buf.InitMap();
+  auto *obj = reinterpret_cast<TObject *>(buf.ReadObjectAny(nullptr));
+  if (! obj)
+    raiseDQMError("DQMStore", "Error reading element '%s' from file '%s'",
+                  name(e).c_str(), filename_.c_str());
+
+  if (e.contents)
+  {
+    auto *h = static_cast<TH1 *>(obj);
+    h->SetBinsLength(e.cells);
+    merge(e, h, true);
+  }
+  return obj;
+}
@@ -0,0 +1,133 @@
+#ifndef DQMSERVICES_CORE_DQMCOLUMNARFORMAT_H
+# define DQMSERVICES_CORE_DQMCOLUMNARFORMAT_H
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <vector>
+
+class TH1;
+class TObject;
+
+/** Columnar DQM file format, used for the ".dqmc" files.
+
+    The file starts with a fixed size header, followed by one fixed size
+    record per monitor element, followed by the data section.  Every
+    record points into the data section to
+
+    - the full path name of the monitor element;
+    - the bin contents, stored with the element type of the histogram
+      (float, short or double) so that they can be added to the booked
+      histogram without conversions;
+    - the sum of the squares of the weights, the bin entries and the sum
+      of the squares of the bin weights, when they are present;
+    - the streamed ROOT object with all the bin arrays emptied, which
+      carries the title, axes, labels and options of the histogram, or
+      the tag string for scalar monitor elements.
+
+    All the offsets are counted from the beginning of the file, and all
+    the arrays are 8 byte aligned, so that the file can be memory mapped
+    and the bin arrays merged in place.  The ROOT object is only read
+    back when the monitor element is not booked yet, when it must be
+    overwritten rather than summed, or when its axes have alphanumeric
+    labels that must be compared; in all the other cases the bins are
+    added directly from the mapped file.  */
+namespace dqm {
+  namespace columnar {
+
+    constexpr char     kMagic[8] = { 'D', 'Q', 'M', 'C', 'O', 'L', 'U', 'M' };
+    constexpr uint32_t kVersion  = 1;
+    constexpr unsigned kMaxStats = 13;   // same as TH1::kNstat
+
+    struct FileHeader
+    {
+      char     magic[8];
+      uint32_t version;
+      uint32_t elements;
+      uint64_t elementsOffset;
+      uint64_t fileSize;
+    };
+
+    struct Element
+    {
+      uint64_t name;            // offset of the full path name
+      uint32_t nameLength;
+      uint32_t flags;           // DQMNet flags of the monitor element
+      uint32_t kind;            // MonitorElement::Kind
+      uint32_t labelledAxes;    // bit i set if axis i has bin labels
+      int32_t  bins[3];         // number of bins along x, y and z
+      uint32_t padding;
+      double   min[3];
+      double   max[3];
+      double   entries;
+      double   stats[kMaxStats];
+      uint64_t cells;           // number of bins, including under- and overflows
+      uint64_t contents;        // offset of the bin contents, 0 for scalars
+      uint64_t sumw2;           // offsets of the optional double arrays, 0 if absent
+      uint64_t binEntries;
+      uint64_t binSumw2;
+      uint64_t object;          // offset of the streamed object
+      uint64_t objectLength;
+    };
+
+    static_assert(sizeof(FileHeader) % 8 == 0, "FileHeader must be 8 byte aligned");
+    static_assert(sizeof(Element) % 8 == 0, "Element must be 8 byte aligned");
+
+    /// Accumulates the monitor elements in memory and writes them to disk.
+    class FileWriter
+    {
+    public:
+      /// add a histogram of the given MonitorElement::Kind
+      void addHistogram(std::string const& name, uint32_t flags, uint32_t kind, TH1 const* h);
+      /// add a scalar monitor element, stored through its tag string
+      void addScalar(std::string const& name, uint32_t flags, uint32_t kind, std::string const& tag);
+      /// write the file; raises a DQMError on failure
+      void write(std::string const& filename) const;
+
+    private:
+      uint64_t append(void const* data, size_t size);
+      Element & newElement(std::string const& name, uint32_t flags, uint32_t kind);
+
+      std::vector<Element> elements_;
+      std::vector<char> data_;
+    };
+
+    /// Memory maps a file written by FileWriter, read only.
+    class FileReader
+    {
+    public:
+      /// raises a DQMError if the file cannot be opened or is not valid
+      explicit FileReader(std::string const& filename);
+      ~FileReader();
+      FileReader(FileReader const&) = delete;
+      FileReader & operator=(FileReader const&) = delete;
+
+      uint32_t size() const { return header().elements; }
+      Element const& element(uint32_t i) const;
+      std::string name(Element const& e) const;
+
+      /// true if the bins of @a e can be added to @a h, a histogram of the
+      /// given MonitorElement::Kind, without reading back the ROOT object
+      bool compatible(Element const& e, uint32_t kind, TH1 const* h) const;
+
+      /// add (or copy, if @a overwrite) the bins and statistics of @a e into @a h;
+      /// the caller must have checked compatible(e, kind, h)
+      void merge(Element const& e, TH1* h, bool overwrite) const;
+
+      /// read back the object of @a e, with its bins restored; owned by the caller
+      TObject * object(Element const& e) const;
+
+    private:
+      FileHeader const& header() const { return *reinterpret_cast<FileHeader const*>(data_); }
+      template <typename T> T const* column(uint64_t offset) const
+      { return reinterpret_cast<T const*>(data_ + offset); }
+
+      std::string filename_;
+      char const* data_;
+      size_t size_;
+    };
+
+  }
+}
+
+#endif // DQMSERVICES_CORE_DQMCOLUMNARFORMAT_H
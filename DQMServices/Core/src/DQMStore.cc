@@ -4,6 +4,7 @@
 #include "DQMServices/Core/interface/QTest.h"
 #include "DQMServices/Core/src/ROOTFilePB.pb.h"
 #include "DQMServices/Core/src/DQMError.h"
+#include "DQMServices/Core/src/DQMColumnarFormat.h"
 #include "classlib/utils/RegexpMatch.h"
 #include "classlib/utils/Regexp.h"
 #include "classlib/utils/StringOps.h"
@@ -24,7 +25,9 @@
 #include <fstream>
 #include <sstream>
 #include <exception>
+#include <memory>
 #include <utility>
+#include <unistd.h>
 
 /** @var DQMStore::verbose_
     Universal verbose flag for DQM. */
@@ -65,6 +68,7 @@ static const lat::Regexp s_rxmeqr2 ("^st\\.(\\d+)\\.(.*)$");
 static const lat::Regexp s_rxtrace ("(.*)\\((.*)\\+0x.*\\).*");
 static const lat::Regexp s_rxself  ("^[^()]*DQMStore::.*");
 static const lat::Regexp s_rxpbfile (".*\\.pb$");
+static const lat::Regexp s_rxcolfile (".*\\.dqmc$");
 
 //////////////////////////////////////////////////////////////////////
 /// Check whether the @a path is a subdirectory of @a ofdir.  Returns
@@ -359,6 +363,41 @@ void DQMStore::IGetter::setCurrentFolder(const std::string &fullpath) {
     needed since the ROOT histograms is cloned starting from the local
     one. */
 
+/** Adds the per-thread replicas of the histograms booked through
+    bookReplicatedConcurrentTransaction by the given module for the given
+    run to the booked histograms, which are global. The replicas can keep
+    being filled while they are merged. */
+void DQMStore::mergeConcurrentReplicas(uint32_t run, uint32_t moduleId) {
+  if (verbose_ > 1)
+    std::cout << "DQMStore::mergeConcurrentReplicas - Merging objects from run: "
+              << run
+              << " module: " << moduleId << std::endl;
+
+  std::vector<std::shared_ptr<ConcurrentMonitorElementReplicas>> replicas;
+  {
+    std::lock_guard<std::mutex> guard(book_mutex_);
+    auto found = concurrentReplicas_.find(std::make_pair(run, moduleId));
+    if (found == concurrentReplicas_.end()) {
+      return;
+    }
+    replicas = found->second;
+  }
+  // do not hold the book mutex while merging, other modules may be
+  // booking or merging their own histograms
+  for (auto& replica : replicas) {
+    replica->merge();
+  }
+}
+
+/** Merges the per-thread replicas of the histograms booked by the given
+    module for the given run for the last time, and forgets about them. */
+void DQMStore::releaseConcurrentReplicas(uint32_t run, uint32_t moduleId) {
+  mergeConcurrentReplicas(run, moduleId);
+
+  std::lock_guard<std::mutex> guard(book_mutex_);
+  concurrentReplicas_.erase(std::make_pair(run, moduleId));
+}
+
 void DQMStore::mergeAndResetMEsRunSummaryCache(uint32_t run,
                                                uint32_t streamId,
                                                uint32_t moduleId) {
@@ -2984,6 +3023,111 @@ DQMStore::savePB(const std::string &filename,
   }
 }
 
+void
+DQMStore::saveMonitorElementToColumnar(
+    MonitorElement const& me,
+    dqm::columnar::FileWriter & file)
+{
+  std::string fullname = *me.data_.dirname + '/' + me.data_.objname;
+  if (me.kind() < MonitorElement::DQM_KIND_TH1F)
+    file.addScalar(fullname, me.data_.flags, me.kind(), me.tagString());
+  else
+    file.addHistogram(fullname, me.data_.flags, me.kind(), static_cast<TH1 const*>(me.object_));
+
+  // Quality reports, efficiency tags and tags are not supported, as for
+  // protobuf files.
+}
+
+void
+DQMStore::saveMonitorElementRangeToColumnar(
+    std::string const& dir,
+    unsigned int run,
+    MEMap::const_iterator begin,
+    MEMap::const_iterator end,
+    dqm::columnar::FileWriter & file,
+    unsigned int & counter)
+{
+  for (auto const& me: boost::make_iterator_range(begin, end))
+  {
+    if (not isSubdirectory(dir, *me.data_.dirname))
+      break;
+
+    // Skip MonitorElements in a subdirectory of the current one.
+    if (dir != *me.data_.dirname)
+      continue;
+
+    // For MonitorElements booked with the thread-safe approach, identified
+    // by having run != 0, ignore the per-stream ones.
+    if (run != 0 and (me.data_.streamId != 0 or me.data_.moduleId != 0))
+      continue;
+
+    if (verbose_ > 1)
+      std::cout << "DQMStore::saveColumnar: saving monitor element "
+                << me.getFullname() << std::endl;
+
+    saveMonitorElementToColumnar(me, file);
+
+    // Count saved histograms
+    ++counter;
+  }
+}
+
+/// save directory with monitoring objects into columnar file <filename>;
+/// if directory="", save full monitoring structure.
+/// Selects the same monitor elements as savePB.
+void
+DQMStore::saveColumnar(const std::string &filename,
+                       const std::string &path /* = "" */,
+                       const uint32_t run /* = 0 */,
+                       const uint32_t lumi /* = 0 */)
+{
+  std::lock_guard<std::mutex> guard(book_mutex_);
+
+  unsigned int nme = 0;
+
+  if (verbose_) {
+    std::cout << "DQMStore::saveColumnar: Opening file '" << filename << "'"
+              << std::endl;
+  }
+  dqm::columnar::FileWriter file;
+
+  for (auto const& dir: dirs_)
+  {
+    if (not path.empty()
+        and not isSubdirectory(path, dir))
+      continue;
+
+    MonitorElement proto(&dir, std::string(), run, 0, 0);
+    if (not enableMultiThread_) {
+      auto begin = data_.lower_bound(proto);
+      auto end   = data_.end();
+      saveMonitorElementRangeToColumnar(dir, run, begin, end, file, nme);
+    } else {
+      // Restrict the loop to the monitor elements for the current lumisection
+      proto.setLumi(lumi);
+      auto begin = data_.lower_bound(proto);
+      proto.setLumi(lumi+1);
+      auto end   = data_.lower_bound(proto);
+      saveMonitorElementRangeToColumnar(dir, run, begin, end, file, nme);
+    }
+
+    // In LSbasedMode, loop also over the (run, 0, 0, 0) global histograms.
+    if (enableMultiThread_ and LSbasedMode_ and lumi != 0) {
+      auto begin = data_.lower_bound(MonitorElement(&dir, std::string(), run, 0, 0));
+      auto end   = data_.lower_bound(MonitorElement(&dir, std::string(), run, 0, 1));
+      saveMonitorElementRangeToColumnar(dir, run, begin, end, file, nme);
+    }
+  }
+
+  file.write(filename);
+
+  if (verbose_) {
+    std::cout << "DQMStore::saveColumnar: successfully wrote " << nme
+              << " objects from path '" << path << "/"
+              << "' into DQM file '" << filename << "'\n";
+  }
+}
+
 
 /// read ROOT objects from file <file> in directory <onlypath>;
 /// return total # of ROOT objects read
@@ -3173,10 +3317,12 @@ DQMStore::load(const std::string &filename,
       std::cout << "DQMStore::load: in overwrite mode   " << "\n";
   }
 
-  if (!s_rxpbfile.match(filename, 0, 0))
-    return readFile(filename, overwrite, "", "", stripdirs, fileMustExist);
-  else
+  if (s_rxpbfile.match(filename, 0, 0))
     return readFilePB(filename, overwrite, "", "", stripdirs, fileMustExist);
+  else if (s_rxcolfile.match(filename, 0, 0))
+    return readFileColumnar(filename, overwrite, "", "", stripdirs, fileMustExist);
+  else
+    return readFile(filename, overwrite, "", "", stripdirs, fileMustExist);
 }
 
 /// private readFile <filename>, and copy MonitorElements;
@@ -3344,6 +3490,75 @@ DQMStore::readFilePB(const std::string &filename,
   return true;
 }
 
+/// read a columnar file written by saveColumnar.  Histograms which are
+/// already booked with the same binning are summed directly from the
+/// mapped file, without deserialising a ROOT object.
+bool
+DQMStore::readFileColumnar(const std::string &filename,
+                           bool overwrite /* = false */,
+                           const std::string &onlypath /* ="" */,
+                           const std::string &prepend /* ="" */,
+                           OpenRunDirs stripdirs /* =StripRunDirs */,
+                           bool fileMustExist /* =true */)
+{
+  if (verbose_)
+    std::cout << "DQMStore::readFileColumnar: reading from file '" << filename << "'\n";
+
+  if (::access(filename.c_str(), R_OK) != 0) {
+    if (fileMustExist)
+      raiseDQMError("DQMStore", "Failed to open file '%s'", filename.c_str());
+    else
+      if (verbose_)
+        std::cout << "DQMStore::readFileColumnar: file '" << filename << "' does not exist, continuing\n";
+    return false;
+  }
+
+  dqm::columnar::FileReader file(filename);
+  unsigned int nfast = 0;
+  for (uint32_t i = 0; i < file.size(); ++i) {
+    dqm::columnar::Element const& e = file.element(i);
+
+    std::string fullname = file.name(e);
+    size_t slash = fullname.rfind('/');
+    std::string path(fullname, 0, slash == std::string::npos ? 0 : slash);
+    std::string objname(fullname, slash == std::string::npos ? 0 : slash+1);
+
+    setCurrentFolder(path);
+    MonitorElement *me = findObject(path, objname);
+
+    /* Run histograms should be collated and not overwritten,
+     * Lumi histograms should be overwritten (and collate flag is not checked)
+     */
+    bool overwrite = e.flags & DQMNet::DQM_PROP_LUMI;
+    bool collate = !(e.flags & DQMNet::DQM_PROP_LUMI);
+
+    // Summing into an existing histogram: equivalent to collate*().
+    if (me and collate
+        and me->kind() >= MonitorElement::DQM_KIND_TH1F
+        and file.compatible(e, me->kind(), me->getTH1())) {
+      file.merge(e, me->getTH1(), false);
+      ++nfast;
+      continue;
+    }
+
+    std::unique_ptr<TObject> obj(file.object(e));
+    extract(obj.get(), path, overwrite, collate);
+
+    if (me == nullptr) {
+      me = findObject(path, objname);
+      if (me)
+        me->data_.flags = e.flags;
+    }
+  }
+
+  if (verbose_)
+    std::cout << "DQMStore::readFileColumnar: read " << file.size()
+              << " objects, " << nfast << " of them summed in place\n";
+
+  cd();
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
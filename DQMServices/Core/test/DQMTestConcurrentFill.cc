@@ -0,0 +1,70 @@
+#include "DQMServices/Core/interface/DQMGlobalEDAnalyzer.h"
+#include "DQMServices/Core/interface/ConcurrentMonitorElement.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <string>
+#include <vector>
+
+// Fills a configurable number of histograms many times per event, used to
+// measure how the DQM fill path scales with the number of threads.
+struct DQMTestConcurrentFillHistograms {
+  std::vector<ConcurrentMonitorElement> histograms;
+};
+
+class DQMTestConcurrentFill
+    : public DQMGlobalEDAnalyzer<DQMTestConcurrentFillHistograms>
+{
+ public:
+  explicit DQMTestConcurrentFill(const edm::ParameterSet&);
+
+ private:
+  void bookHistograms(DQMStore::ConcurrentBooker&,
+                      edm::Run const&,
+                      edm::EventSetup const&,
+                      DQMTestConcurrentFillHistograms&) const override;
+
+  void dqmAnalyze(edm::Event const&,
+                  edm::EventSetup const&,
+                  DQMTestConcurrentFillHistograms const&) const override;
+
+  std::string folder_;
+  unsigned int numberOfHistograms_;
+  unsigned int fillsPerEvent_;
+};
+
+DQMTestConcurrentFill::DQMTestConcurrentFill(const edm::ParameterSet &pset)
+    : folder_(pset.getUntrackedParameter<std::string>("folder")),
+      numberOfHistograms_(pset.getUntrackedParameter<unsigned int>("numberOfHistograms", 10)),
+      fillsPerEvent_(pset.getUntrackedParameter<unsigned int>("fillsPerEvent", 1000))
+{
+  useHistogramReplicas(pset.getUntrackedParameter<bool>("useReplicas", true));
+}
+
+void DQMTestConcurrentFill::bookHistograms(DQMStore::ConcurrentBooker &b,
+                                           edm::Run const & /* iRun*/,
+                                           edm::EventSetup const & /* iSetup*/,
+                                           DQMTestConcurrentFillHistograms &h) const {
+  b.setCurrentFolder(folder_);
+  h.histograms.reserve(numberOfHistograms_);
+  for (unsigned int i = 0; i < numberOfHistograms_; ++i) {
+    std::string name = "MyHisto" + std::to_string(i);
+    h.histograms.push_back(b.book1D(name, name, 100, -0.5, 99.5));
+  }
+}
+
+void DQMTestConcurrentFill::dqmAnalyze(edm::Event const& iEvent,
+                                       edm::EventSetup const&,
+                                       DQMTestConcurrentFillHistograms const& h) const
+{
+  double const offset = iEvent.id().event() % 100;
+  for (unsigned int i = 0; i < fillsPerEvent_; ++i) {
+    for (auto const& histogram : h.histograms) {
+      histogram.fill(offset + (i % 7));
+    }
+  }
+}
+
+// define this as a plug-in
+DEFINE_FWK_MODULE(DQMTestConcurrentFill);
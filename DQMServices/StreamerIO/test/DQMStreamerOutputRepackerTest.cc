@@ -46,8 +46,6 @@ class DQMStreamerOutputRepackerTest : public edm::StreamerOutputModuleBase {
 
   virtual void beginLuminosityBlock(
       edm::LuminosityBlockForOutput const&) override{};
-  virtual void endLuminosityBlock(
-      edm::LuminosityBlockForOutput const&) override{};
 
  private:
   void openFile(uint32_t run, uint32_t lumi);
@@ -39,6 +39,10 @@
 #include "TH1D.h"
 #include "TFile.h"
 
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+
 using namespace std;
 
 // -----------------------------------------------------------------------------
@@ -101,6 +105,9 @@ SiPixelRawToDigi::SiPixelRawToDigi( const edm::ParameterSet& conf )
     usePhase1 = config_.getParameter<bool> ("UsePhase1");
     if(usePhase1) edm::LogInfo("SiPixelRawToDigi")  << " Using phase1";
   }
+  // Unpack the FEDs in parallel
+  parallelFEDs = config_.getUntrackedParameter<bool>("ParallelFEDs",false);
+
   //CablingMap could have a label //Tav
   cablingMapLabel = config_.getParameter<std::string> ("CablingMapLabel");
 
@@ -148,6 +155,7 @@ SiPixelRawToDigi::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
     desc.add<edm::ParameterSetDescription>("Regions",psd0)->setComment("## Empty Regions PSet means complete unpacking");
   }
   desc.addUntracked<bool>("Timing",false);
+  desc.addUntracked<bool>("ParallelFEDs",false)->setComment("## Unpack the FEDs in parallel TBB tasks");
   desc.add<bool>("UsePilotBlade",false)->setComment("##  Use pilot blades");
   desc.add<bool>("UsePhase1",false)->setComment("##  Use phase1");
   desc.add<std::string>("CablingMapLabel","")->setComment("CablingMap label"); //Tav
@@ -214,6 +222,7 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
     LogDebug("SiPixelRawToDigi") << "region2unpack #modules (BPIX,EPIX,total): "<<regions_->nBarrelModules()<<" "<<regions_->nForwardModules()<<" "<<regions_->nModules();
   }
 
+  std::vector<int> fedsToUnpack;
   for (auto aFed = fedIds.begin(); aFed != fedIds.end(); ++aFed) {
     int fedId = *aFed;
 
@@ -221,15 +230,45 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
 
     if (regions_ && !regions_->mayUnpackFED(fedId)) continue;
 
+    fedsToUnpack.push_back(fedId);
+  }
+
+  // In parallel mode each FED is unpacked by its own copy of the formatter into its own
+  // digis and errors; the digis are merged in the order of the FEDs at the end, and the
+  // errors are processed in the serial loop below as if they had just been unpacked.
+  struct FedOutput {
+    PixelDataFormatter formatter;
+    edm::DetSetVector<PixelDigi> digis;
+    PixelDataFormatter::Errors errors;
+    bool errorsInEvent;
+  };
+  std::vector<FedOutput> fedOutputs;
+  if (parallelFEDs) {
+    fedOutputs.reserve(fedsToUnpack.size());
+    for (unsigned int i = 0; i < fedsToUnpack.size(); ++i) fedOutputs.push_back(FedOutput{formatter, {}, {}, false});
+    tbb::parallel_for(0UL, fedsToUnpack.size(), 1UL, [&](unsigned long i) {
+	auto & out = fedOutputs[i];
+	out.formatter.interpretRawData( out.errorsInEvent, fedsToUnpack[i], buffers->FEDData( fedsToUnpack[i] ), out.digis, out.errors);
+      });
+  }
+
+  for (unsigned int iFed = 0; iFed < fedsToUnpack.size(); ++iFed) {
+    int fedId = fedsToUnpack[iFed];
+
     if(debug) LogDebug("SiPixelRawToDigi")<< " PRODUCE DIGI FOR FED: " <<  fedId << endl;
 
     PixelDataFormatter::Errors errors;
 
-    //get event data for this fed
-    const FEDRawData& fedRawData = buffers->FEDData( fedId );
+    if (parallelFEDs) {
+      errors.swap(fedOutputs[iFed].errors);
+      errorsInEvent |= fedOutputs[iFed].errorsInEvent;
+    } else {
+      //get event data for this fed
+      const FEDRawData& fedRawData = buffers->FEDData( fedId );
 
-    //convert data to digi and strip off errors
-    formatter.interpretRawData( errorsInEvent, fedId, fedRawData, *collection, errors);
+      //convert data to digi and strip off errors
+      formatter.interpretRawData( errorsInEvent, fedId, fedRawData, *collection, errors);
+    }
 
     //pack errors into collection
     if(includeErrors) {
@@ -298,6 +337,27 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
     } // if errors to be included in the event
   } // loop on FED data to be unpacked
 
+  int nDigisInEvent = formatter.nDigis();
+  int nWordsInEvent = formatter.nWords();
+  if (parallelFEDs) {
+    // merge the digis of the FEDs: a module read out by several FEDs gets the digis in the order of the FEDs
+    std::vector<edm::DetSet<PixelDigi> > detSets;
+    for (auto & out : fedOutputs) {
+      for (auto & detSet : out.digis) detSets.emplace_back(std::move(detSet));
+      nDigisInEvent += out.formatter.nDigis();
+      nWordsInEvent += out.formatter.nWords();
+    }
+    std::stable_sort(detSets.begin(), detSets.end());
+    auto last = detSets.begin();
+    for (auto it = detSets.begin(); it != detSets.end(); ++it) {
+      if (it == last) continue;
+      if (it->detId() == last->detId()) last->data.insert(last->data.end(), it->data.begin(), it->data.end());
+      else if (++last != it) *last = std::move(*it);
+    }
+    if (!detSets.empty()) detSets.erase(last+1, detSets.end());
+    collection = std::make_unique<edm::DetSetVector<PixelDigi>>(detSets, true);
+  }
+
   if(includeErrors) {
     edm::DetSet<SiPixelRawDataError>& errorDetSet = errorcollection->find_or_insert(dummydetid);
     errorDetSet.data = nodeterrors;
@@ -307,12 +367,12 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
   if (theTimer) {
     theTimer->stop();
     LogDebug("SiPixelRawToDigi") << "TIMING IS: (real)" << theTimer->realTime() ;
-    ndigis += formatter.nDigis();
-    nwords += formatter.nWords();
+    ndigis += nDigisInEvent;
+    nwords += nWordsInEvent;
     LogDebug("SiPixelRawToDigi") << " (Words/Digis) this ev: "
-         <<formatter.nWords()<<"/"<<formatter.nDigis() << "--- all :"<<nwords<<"/"<<ndigis;
+         <<nWordsInEvent<<"/"<<nDigisInEvent << "--- all :"<<nwords<<"/"<<ndigis;
     hCPU->Fill( theTimer->realTime() ); 
-    hDigi->Fill(formatter.nDigis());
+    hDigi->Fill(nDigisInEvent);
   }
 
   //send digis and errors back to framework 
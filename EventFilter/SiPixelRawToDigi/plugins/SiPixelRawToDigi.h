@@ -60,6 +60,7 @@ private:
   int nwords;
   bool usePilotBlade;
   bool usePhase1;
+  bool parallelFEDs;
   std::string cablingMapLabel;
 };
 #endif
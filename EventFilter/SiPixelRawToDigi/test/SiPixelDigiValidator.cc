@@ -0,0 +1,115 @@
+/** \class SiPixelDigiValidator
+ *  Compares two collections of pixel digis, and their FED errors, module
+ *  by module and digi by digi, and throws at the end of the job if they
+ *  differ in any event.
+ */
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+#include "DataFormats/SiPixelRawData/interface/SiPixelRawDataError.h"
+
+#include <algorithm>
+#include <sstream>
+
+class SiPixelDigiValidator : public edm::one::EDAnalyzer<> {
+public:
+  explicit SiPixelDigiValidator(const edm::ParameterSet&);
+
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob() override;
+
+private:
+  template<class T, class Equal>
+  bool compare(const edm::DetSetVector<T>&, const edm::DetSetVector<T>&, Equal, std::ostream&) const;
+
+  edm::EDGetTokenT< edm::DetSetVector<PixelDigi> > digis1_, digis2_;
+  edm::EDGetTokenT< edm::DetSetVector<SiPixelRawDataError> > errors1_, errors2_;
+  const bool checkErrors_;
+  unsigned int events_;
+  unsigned int differences_;
+};
+
+SiPixelDigiValidator::SiPixelDigiValidator(const edm::ParameterSet& pset) :
+  checkErrors_(pset.getUntrackedParameter<bool>("CheckErrors", true)),
+  events_(0),
+  differences_(0)
+{
+  auto tag1 = pset.getUntrackedParameter<edm::InputTag>("TagCollection1");
+  auto tag2 = pset.getUntrackedParameter<edm::InputTag>("TagCollection2");
+  digis1_ = consumes< edm::DetSetVector<PixelDigi> >(tag1);
+  digis2_ = consumes< edm::DetSetVector<PixelDigi> >(tag2);
+  if (checkErrors_) {
+    errors1_ = consumes< edm::DetSetVector<SiPixelRawDataError> >(tag1);
+    errors2_ = consumes< edm::DetSetVector<SiPixelRawDataError> >(tag2);
+  }
+}
+
+template<class T, class Equal>
+bool SiPixelDigiValidator::compare(const edm::DetSetVector<T>& c1, const edm::DetSetVector<T>& c2,
+                                   Equal equal, std::ostream& ss) const
+{
+  if (c1.size() != c2.size()) {
+    ss << c1.size() << " modules in collection 1, " << c2.size() << " in collection 2. ";
+    return false;
+  }
+  for (auto d1 = c1.begin(), d2 = c2.begin(); d1 != c1.end(); ++d1, ++d2) {
+    if (d1->detId() != d2->detId() || d1->size() != d2->size()) {
+      ss << "Module " << d1->detId() << " (" << d1->size() << " entries) differs from module "
+         << d2->detId() << " (" << d2->size() << " entries). ";
+      return false;
+    }
+    if (!std::equal(d1->begin(), d1->end(), d2->begin(), equal)) {
+      ss << "Different entries in module " << d1->detId() << ". ";
+      return false;
+    }
+  }
+  return true;
+}
+
+void SiPixelDigiValidator::analyze(const edm::Event& ev, const edm::EventSetup&)
+{
+  ++events_;
+  std::stringstream ss;
+  ss << "Event " << ev.id().event() << ": ";
+
+  edm::Handle< edm::DetSetVector<PixelDigi> > digis1, digis2;
+  ev.getByToken(digis1_, digis1);
+  ev.getByToken(digis2_, digis2);
+  bool same = compare(*digis1, *digis2,
+                      [](const PixelDigi& a, const PixelDigi& b) { return a.packedData() == b.packedData(); }, ss);
+
+  if (checkErrors_) {
+    edm::Handle< edm::DetSetVector<SiPixelRawDataError> > errors1, errors2;
+    ev.getByToken(errors1_, errors1);
+    ev.getByToken(errors2_, errors2);
+    same = compare(*errors1, *errors2,
+                   [](const SiPixelRawDataError& a, const SiPixelRawDataError& b) {
+                     return a.getWord64() == b.getWord64() && a.getWord32() == b.getWord32() &&
+                            a.getType() == b.getType() && a.getFedId() == b.getFedId(); }, ss) && same;
+  }
+
+  if (!same) {
+    ++differences_;
+    edm::LogError("SiPixelDigiValidator") << ss.str();
+  }
+}
+
+void SiPixelDigiValidator::endJob()
+{
+  if (differences_) {
+    throw cms::Exception("SiPixelDigiValidator")
+      << "Collections differ in " << differences_ << " out of " << events_ << " events";
+  }
+  edm::LogInfo("SiPixelDigiValidator") << "Collections are identical in all " << events_ << " events";
+}
+
+DEFINE_FWK_MODULE(SiPixelDigiValidator);
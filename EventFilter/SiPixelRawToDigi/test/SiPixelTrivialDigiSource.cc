@@ -0,0 +1,68 @@
+/** \class SiPixelTrivialDigiSource
+ *  Produces random pixel digis on every module of the cabling map, to
+ *  feed SiPixelDigiToRaw in unpacking tests. The digis are kept in the
+ *  first two ROCs of each module, so that they are valid for both full
+ *  and half modules, and the random sequence is seeded with the event
+ *  number, so the output is reproducible.
+ */
+
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "CondFormats/DataRecord/interface/SiPixelFedCablingMapRcd.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingMap.h"
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+
+class SiPixelTrivialDigiSource : public edm::stream::EDProducer<> {
+public:
+  explicit SiPixelTrivialDigiSource(const edm::ParameterSet&);
+
+  void produce(edm::Event&, const edm::EventSetup&) override;
+
+private:
+  const double meanDigis_;
+};
+
+SiPixelTrivialDigiSource::SiPixelTrivialDigiSource(const edm::ParameterSet& pset) :
+  meanDigis_(pset.getUntrackedParameter<double>("MeanDigisPerModule", 20.))
+{
+  produces< edm::DetSetVector<PixelDigi> >();
+}
+
+void SiPixelTrivialDigiSource::produce(edm::Event& ev, const edm::EventSetup& es)
+{
+  edm::ESHandle<SiPixelFedCablingMap> cablingMap;
+  es.get<SiPixelFedCablingMapRcd>().get(cablingMap);
+
+  // std::unordered_map iteration order is unspecified, sort the modules
+  std::vector<uint32_t> detIds;
+  for (auto const& det2fed : cablingMap->det2fedMap()) detIds.push_back(det2fed.first);
+  std::sort(detIds.begin(), detIds.end());
+
+  std::mt19937 rng(ev.id().event());
+  std::poisson_distribution<int> ndigis(meanDigis_);
+  std::uniform_int_distribution<int> row(0, 79), col(0, 103), adc(1, 255);
+
+  auto collection = std::make_unique< edm::DetSetVector<PixelDigi> >();
+  for (auto detId : detIds) {
+    std::set<std::pair<int,int> > pixels;
+    int n = ndigis(rng);
+    for (int i = 0; i < n; ++i) pixels.emplace(row(rng), col(rng));
+    if (pixels.empty()) continue;
+    edm::DetSet<PixelDigi>& detSet = collection->find_or_insert(detId);
+    for (auto const& pixel : pixels) detSet.data.emplace_back(pixel.first, pixel.second, adc(rng));
+  }
+  ev.put(std::move(collection));
+}
+
+DEFINE_FWK_MODULE(SiPixelTrivialDigiSource);
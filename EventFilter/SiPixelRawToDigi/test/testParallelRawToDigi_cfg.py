@@ -0,0 +1,43 @@
+import FWCore.ParameterSet.Config as cms
+
+# Packs random digis with SiPixelDigiToRaw, unpacks them with the serial FED
+# loop of SiPixelRawToDigi and with ParallelFEDs = True, and fails if the
+# digis or the FED errors are not identical.
+
+process = cms.Process("ParallelRawToDigi")
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(10) )
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc', '')
+
+process.digiSource = cms.EDProducer("SiPixelTrivialDigiSource",
+    MeanDigisPerModule = cms.untracked.double(20.)
+)
+
+process.load("EventFilter.SiPixelRawToDigi.SiPixelDigiToRaw_cfi")
+process.siPixelRawData.InputLabel = 'digiSource'
+
+process.load("EventFilter.SiPixelRawToDigi.SiPixelRawToDigi_cfi")
+process.parallelSiPixelDigis = process.siPixelDigis.clone(
+    ParallelFEDs = cms.untracked.bool(True)
+)
+
+process.validator = cms.EDAnalyzer("SiPixelDigiValidator",
+    TagCollection1 = cms.untracked.InputTag("siPixelDigis"),
+    TagCollection2 = cms.untracked.InputTag("parallelSiPixelDigis"),
+    CheckErrors = cms.untracked.bool(True)
+)
+
+process.p = cms.Path(process.digiSource * process.siPixelRawData *
+                     process.siPixelDigis * process.parallelSiPixelDigis *
+                     process.validator)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(1)
+)
@@ -43,6 +43,7 @@ namespace sistrip {
     int16_t fed_buffer_dump_freq = pset.getUntrackedParameter<int>("FedBufferDumpFreq",0);
     int16_t fed_event_dump_freq = pset.getUntrackedParameter<int>("FedEventDumpFreq",0);
     bool quiet = pset.getUntrackedParameter<bool>("Quiet",true);
+    bool parallel_feds = pset.getUntrackedParameter<bool>("ParallelFEDs",false);
     extractCm_ = pset.getParameter<bool>("UnpackCommonModeValues");
     doFullCorruptBufferChecks_ = pset.getParameter<bool>("DoAllCorruptBufferChecks");
     doAPVEmulatorCheck_ = pset.getParameter<bool>("DoAPVEmulatorCheck");
@@ -56,6 +57,7 @@ namespace sistrip {
     rawToDigi_->extractCm(extractCm_);
     rawToDigi_->doFullCorruptBufferChecks(doFullCorruptBufferChecks_);
     rawToDigi_->doAPVEmulatorCheck(doAPVEmulatorCheck_);
+    rawToDigi_->parallelFeds(parallel_feds);
 
     produces< SiStripEventSummary >();
     produces< edm::DetSetVector<SiStripRawDigi> >("ScopeMode");
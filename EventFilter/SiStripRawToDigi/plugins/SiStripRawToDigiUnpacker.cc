@@ -15,7 +15,9 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <numeric>
 #include <ext/algorithm>
+#include "tbb/parallel_for.h"
 #include "FWCore/Utilities/interface/RunningAverage.h"
 
 
@@ -38,7 +40,8 @@ namespace sistrip {
     extractCm_(false),
     doFullCorruptBufferChecks_(false),
     doAPVEmulatorCheck_(true),
-    errorThreshold_(errorThreshold)
+    errorThreshold_(errorThreshold),
+    parallelFeds_(false)
   {
     if ( edm::isDebugEnabled() ) {
       LogTrace("SiStripRawToDigi")
@@ -68,8 +71,8 @@ namespace sistrip {
   void RawToDigiUnpacker::createDigis( const SiStripFedCabling& cabling, const FEDRawDataCollection& buffers, SiStripEventSummary& summary, RawDigis& scope_mode, RawDigis& virgin_raw, RawDigis& proc_raw, Digis& zero_suppr, DetIdCollection& detids, RawDigis& cm_values ) {
 
     // Clear done at the end
-    assert(zs_work_digis_.empty()); 
-    zs_work_digis_.reserve(localRA.upper());
+    assert(work_.zs_digis.empty()); 
+    work_.zs_digis.reserve(localRA.upper());
     // Reserve space in bad module list
     detids.reserve(100);
   
@@ -99,499 +102,546 @@ namespace sistrip {
     bool first_fed = true;
   
     // Retrieve FED ids from cabling map and iterate through 
-    std::vector<uint16_t>::const_iterator ifed = cabling.fedIds().begin();
-    for ( ; ifed != cabling.fedIds().end(); ifed++ ) {
-
-      // ignore trigger FED
-      if ( *ifed == triggerFedId_ ) { continue;  }
-    
-      // Retrieve FED raw data for given FED 
-      const FEDRawData& input = buffers.FEDData( static_cast<int>(*ifed) );
-    
-      // Some debug on FED buffer size
-      if ( edm::isDebugEnabled() ) {
-	if ( first_ && input.data() ) {
-	  std::stringstream ss;
-	  ss << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-	     << " Found FED id " 
-	     << std::setw(4) << std::setfill(' ') << *ifed 
-	     << " in FEDRawDataCollection"
-	     << " with non-zero pointer 0x" 
-	     << std::hex
-	     << std::setw(8) << std::setfill('0') 
-	     << reinterpret_cast<uint32_t*>( const_cast<uint8_t*>(input.data()))
-	     << std::dec
-	     << " and size " 
-	     << std::setw(5) << std::setfill(' ') << input.size()
-	     << " chars";
-	  LogTrace("SiStripRawToDigi") << ss.str();
-	}	
+    auto fedIds = cabling.fedIds();
+    if ( !parallelFeds_ || useDaqRegister_ ) {
+      for ( auto ifed = fedIds.begin(); ifed != fedIds.end(); ifed++ ) {
+	// ignore trigger FED
+	if ( *ifed == triggerFedId_ ) { continue;  }
+	unpackFed( *ifed, buffers.FEDData( static_cast<int>(*ifed) ), cabling, summary, first_fed, work_, detids );
       }
-    
-      // Dump of FEDRawData to stdout
-      if ( edm::isDebugEnabled() ) {
-	if ( fedBufferDumpFreq_ && !(event_%fedBufferDumpFreq_) ) {
-	  std::stringstream ss;
-	  dumpRawData( *ifed, input, ss );
-	  edm::LogVerbatim(sistrip::mlRawToDigi_) << ss.str();
-	}
+    } else {
+      // The EventSummary is not updated from the DAQ registers, so the FEDs are independent:
+      // each one is unpacked in its own work vectors, which are then appended in the order of
+      // the FEDs to give exactly the work vectors of the serial loop.
+      // The FED key flag only depends on the run type and is set once before the tasks start.
+      if ( summary.valid() && ( summary.runType() == sistrip::APV_LATENCY || summary.runType() == sistrip::FINE_DELAY ) ) { useFedKey_ = false; }
+      const size_t nfeds = fedIds.size();
+      if ( fedWork_.size() < nfeds ) { fedWork_.resize( nfeds ); fedDetIds_.resize( nfeds ); }
+      tbb::parallel_for( size_t(0), nfeds, [&]( size_t i ) {
+	  uint16_t fed_id = fedIds[i];
+	  if ( fed_id == triggerFedId_ ) { return; }
+	  bool first = false;
+	  unpackFed( fed_id, buffers.FEDData( static_cast<int>(fed_id) ), cabling, summary, first, fedWork_[i], fedDetIds_[i] );
+	} );
+      detids.reserve( detids.size()+std::accumulate( fedDetIds_.begin(), fedDetIds_.begin()+nfeds, size_t(0), []( size_t n, DetIdCollection const & ids ) { return n+ids.size(); } ) );
+      for ( size_t i = 0; i < nfeds; ++i ) {
+	work_.append( fedWork_[i] );
+	for ( auto const & id : fedDetIds_[i] ) { detids.push_back( id ); }
+	fedWork_[i].clear();
+	DetIdCollection().swap( fedDetIds_[i] );
       }
-      
-      // get the cabling connections for this FED
-      auto conns = cabling.fedConnections(*ifed);
-    
-      // Check on FEDRawData pointer
-      if ( !input.data() ) {
-	if ( edm::isDebugEnabled() ) {
-	  edm::LogWarning(sistrip::mlRawToDigi_)
-	    << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-	    << " NULL pointer to FEDRawData for FED id " 
-	    << *ifed;
-	}
-        // Mark FED modules as bad
-        detids.reserve(detids.size()+conns.size());
-        std::vector<FedChannelConnection>::const_iterator iconn = conns.begin();
-        for ( ; iconn != conns.end(); iconn++ ) {
-          if ( !iconn->detId() || iconn->detId() == sistrip::invalid32_ ) continue;
-          detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
-        }
-	continue;
+    }
+
+    // bad channels warning
+    unsigned int detIdsSize = detids.size();
+    if ( edm::isDebugEnabled() && detIdsSize ) {
+      std::ostringstream ss;
+      ss << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+         << " Problems were found in data and " << detIdsSize << " channels could not be unpacked. "
+         << "See output of FED Hardware monitoring for more information. ";
+      edm::LogWarning(sistrip::mlRawToDigi_) << ss.str();
+    }
+    if( (errorThreshold_ != 0) && (detIdsSize > errorThreshold_) ) {
+      edm::LogError("TooManyErrors") << "Total number of errors = " << detIdsSize;
+    }
+
+    // update DetSetVectors
+    update(scope_mode, virgin_raw, proc_raw, zero_suppr, cm_values);
+
+    // increment event counter
+    event_++;
+  
+    // no longer first event!
+    if ( first_ ) { first_ = false; }
+  
+    // final cleanup, just in case
+    cleanupWorkVectors();
+  }
+
+  void RawToDigiUnpacker::unpackFed( uint16_t fed_id, const FEDRawData& input, const SiStripFedCabling& cabling, SiStripEventSummary& summary, bool& first_fed, WorkVectors& work, DetIdCollection& detids ) {
+
+    // Some debug on FED buffer size
+    if ( edm::isDebugEnabled() ) {
+      if ( first_ && input.data() ) {
+	std::stringstream ss;
+	ss << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+	   << " Found FED id " 
+	   << std::setw(4) << std::setfill(' ') << fed_id 
+	   << " in FEDRawDataCollection"
+	   << " with non-zero pointer 0x" 
+	   << std::hex
+	   << std::setw(8) << std::setfill('0') 
+	   << reinterpret_cast<uint32_t*>( const_cast<uint8_t*>(input.data()))
+	   << std::dec
+	   << " and size " 
+	   << std::setw(5) << std::setfill(' ') << input.size()
+	   << " chars";
+	LogTrace("SiStripRawToDigi") << ss.str();
       }	
-    
-      // Check on FEDRawData size
-      if ( !input.size() ) {
-	if ( edm::isDebugEnabled() ) {
-	  edm::LogWarning(sistrip::mlRawToDigi_)
-	    << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-	    << " FEDRawData has zero size for FED id " 
-	    << *ifed;
-	}
-        // Mark FED modules as bad
-        detids.reserve(detids.size()+conns.size());
-        std::vector<FedChannelConnection>::const_iterator iconn = conns.begin();
-        for ( ; iconn != conns.end(); iconn++ ) {
-          if ( !iconn->detId() || iconn->detId() == sistrip::invalid32_ ) continue;
-          detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
-        }
-        continue;
+    }
+
+    // Dump of FEDRawData to stdout
+    if ( edm::isDebugEnabled() ) {
+      if ( fedBufferDumpFreq_ && !(event_%fedBufferDumpFreq_) ) {
+	std::stringstream ss;
+	dumpRawData( fed_id, input, ss );
+	edm::LogVerbatim(sistrip::mlRawToDigi_) << ss.str();
       }
-      
-      // construct FEDBuffer
-      std::auto_ptr<sistrip::FEDBuffer> buffer;
-      try {
-        buffer.reset(new sistrip::FEDBuffer(input.data(),input.size()));
-        buffer->setLegacyMode(legacy_);
-        if (!buffer->doChecks()) {
-          if (!unpackBadChannels_ || !buffer->checkNoFEOverflows() )
-            throw cms::Exception("FEDBuffer") << "FED Buffer check fails for FED ID " << *ifed << ".";
-        }
-        if (doFullCorruptBufferChecks_ && !buffer->doCorruptBufferChecks()) {
-          throw cms::Exception("FEDBuffer") << "FED corrupt buffer check fails for FED ID " << *ifed << ".";
-        }
+    }
+
+    // get the cabling connections for this FED
+    auto conns = cabling.fedConnections(fed_id);
+
+    // Check on FEDRawData pointer
+    if ( !input.data() ) {
+      if ( edm::isDebugEnabled() ) {
+	edm::LogWarning(sistrip::mlRawToDigi_)
+	  << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+	  << " NULL pointer to FEDRawData for FED id " 
+	  << fed_id;
       }
-      catch (const cms::Exception& e) { 
-	if ( edm::isDebugEnabled() ) {
-	  edm::LogWarning("sistrip::RawToDigiUnpacker") << "Exception caught when creating FEDBuffer object for FED " << *ifed << ": " << e.what();
-	}
-        // FED buffer is bad and should not be unpacked. Skip this FED and mark all modules as bad. 
-        std::vector<FedChannelConnection>::const_iterator iconn = conns.begin();
-        for ( ; iconn != conns.end(); iconn++ ) {
-          if ( !iconn->detId() || iconn->detId() == sistrip::invalid32_ ) continue;
-          detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
-        }
-        continue;
+      // Mark FED modules as bad
+      detids.reserve(detids.size()+conns.size());
+      std::vector<FedChannelConnection>::const_iterator iconn = conns.begin();
+      for ( ; iconn != conns.end(); iconn++ ) {
+        if ( !iconn->detId() || iconn->detId() == sistrip::invalid32_ ) continue;
+        detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
       }
+      return;
+    }	
 
-      // Check if EventSummary ("trigger FED info") needs updating
-      if ( first_fed && useDaqRegister_ ) { updateEventSummary( *buffer, summary ); first_fed = false; }
-    
-      // Check to see if EventSummary info is set
+    // Check on FEDRawData size
+    if ( !input.size() ) {
       if ( edm::isDebugEnabled() ) {
-	if ( !quiet_ && !summary.isSet() ) {
-	  std::stringstream ss;
-	  ss << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-	     << " EventSummary is not set correctly!"
-	     << " Missing information from both \"trigger FED\" and \"DAQ registers\"!";
-	  edm::LogWarning(sistrip::mlRawToDigi_) << ss.str();
-	}
+	edm::LogWarning(sistrip::mlRawToDigi_)
+	  << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+	  << " FEDRawData has zero size for FED id " 
+	  << fed_id;
       }
-    
-      // Check to see if event is to be analyzed according to EventSummary
-      if ( !summary.valid() ) { 
-	if ( edm::isDebugEnabled() ) {
-	  LogTrace("SiStripRawToDigi")
-	    << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-	    << " EventSummary is not valid: skipping...";
-	}
-	continue; 
+      // Mark FED modules as bad
+      detids.reserve(detids.size()+conns.size());
+      std::vector<FedChannelConnection>::const_iterator iconn = conns.begin();
+      for ( ; iconn != conns.end(); iconn++ ) {
+        if ( !iconn->detId() || iconn->detId() == sistrip::invalid32_ ) continue;
+        detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
       }
-    
-      /// extract readout mode
-      sistrip::FEDReadoutMode mode = buffer->readoutMode();
-      sistrip::FEDLegacyReadoutMode lmode = (legacy_) ? buffer->legacyReadoutMode() : sistrip::READOUT_MODE_LEGACY_INVALID;
-
-      // Retrive run type
-      sistrip::RunType runType_ = summary.runType();
-      if( runType_ == sistrip::APV_LATENCY || runType_ == sistrip::FINE_DELAY ) { useFedKey_ = false; } 
-     
-      // Dump of FED buffer
+      return;
+    }
+
+    // construct FEDBuffer
+    std::auto_ptr<sistrip::FEDBuffer> buffer;
+    try {
+      buffer.reset(new sistrip::FEDBuffer(input.data(),input.size()));
+      buffer->setLegacyMode(legacy_);
+      if (!buffer->doChecks()) {
+        if (!unpackBadChannels_ || !buffer->checkNoFEOverflows() )
+          throw cms::Exception("FEDBuffer") << "FED Buffer check fails for FED ID " << fed_id << ".";
+      }
+      if (doFullCorruptBufferChecks_ && !buffer->doCorruptBufferChecks()) {
+        throw cms::Exception("FEDBuffer") << "FED corrupt buffer check fails for FED ID " << fed_id << ".";
+      }
+    }
+    catch (const cms::Exception& e) { 
       if ( edm::isDebugEnabled() ) {
-	if ( fedEventDumpFreq_ && !(event_%fedEventDumpFreq_) ) {
-	  std::stringstream ss;
-	  buffer->dump( ss );
-	  edm::LogVerbatim(sistrip::mlRawToDigi_) << ss.str();
-	}
+	edm::LogWarning("sistrip::RawToDigiUnpacker") << "Exception caught when creating FEDBuffer object for FED " << fed_id << ": " << e.what();
       }
-    
-      // Iterate through FED channels, extract payload and create Digis
+      // FED buffer is bad and should not be unpacked. Skip this FED and mark all modules as bad. 
       std::vector<FedChannelConnection>::const_iterator iconn = conns.begin();
       for ( ; iconn != conns.end(); iconn++ ) {
+        if ( !iconn->detId() || iconn->detId() == sistrip::invalid32_ ) continue;
+        detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
+      }
+      return;
+    }
 
-	/// FED channel
-	uint16_t chan = iconn->fedCh();
+    // Check if EventSummary ("trigger FED info") needs updating
+    if ( first_fed && useDaqRegister_ ) { updateEventSummary( *buffer, summary ); first_fed = false; }
 
-	// Check if fed connection is valid
-	if ( !iconn->isConnected() ) { continue; }
-        
-        // Check DetId is valid (if to be used as key)
-	if ( !useFedKey_ && ( !iconn->detId() || iconn->detId() == sistrip::invalid32_ ) ) { continue; }
-      
-	// Check FED channel
-	if (!buffer->channelGood(iconn->fedCh(),doAPVEmulatorCheck_)) {
-          if (!unpackBadChannels_ || !(buffer->fePresent(iconn->fedCh()/FEDCH_PER_FEUNIT) && buffer->feEnabled(iconn->fedCh()/FEDCH_PER_FEUNIT)) ) {
-            detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
-            continue;
-          }
-	}
+    // Check to see if EventSummary info is set
+    if ( edm::isDebugEnabled() ) {
+      if ( !quiet_ && !summary.isSet() ) {
+	std::stringstream ss;
+	ss << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+	   << " EventSummary is not set correctly!"
+	   << " Missing information from both \"trigger FED\" and \"DAQ registers\"!";
+	edm::LogWarning(sistrip::mlRawToDigi_) << ss.str();
+      }
+    }
+
+    // Check to see if event is to be analyzed according to EventSummary
+    if ( !summary.valid() ) { 
+      if ( edm::isDebugEnabled() ) {
+	LogTrace("SiStripRawToDigi")
+	  << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+	  << " EventSummary is not valid: skipping...";
+      }
+      return; 
+    }
 
-	// Determine whether FED key is inferred from cabling or channel loop
-	uint32_t fed_key = ( summary.runType() == sistrip::FED_CABLING ) ? ( ( *ifed & sistrip::invalid_ ) << 16 ) | ( chan & sistrip::invalid_ ) : ( ( iconn->fedId() & sistrip::invalid_ ) << 16 ) | ( iconn->fedCh() & sistrip::invalid_ );
+    /// extract readout mode
+    sistrip::FEDReadoutMode mode = buffer->readoutMode();
+    sistrip::FEDLegacyReadoutMode lmode = (legacy_) ? buffer->legacyReadoutMode() : sistrip::READOUT_MODE_LEGACY_INVALID;
 
-	// Determine whether DetId or FED key should be used to index digi containers
-	uint32_t key = ( useFedKey_ || (!legacy_ && mode == sistrip::READOUT_MODE_SCOPE) || (legacy_ && lmode == sistrip::READOUT_MODE_LEGACY_SCOPE) ) ? fed_key : iconn->detId();
-      
-	// Determine APV std::pair number (needed only when using DetId)
-	uint16_t ipair = ( useFedKey_ || (!legacy_ && mode == sistrip::READOUT_MODE_SCOPE) || (legacy_ && lmode == sistrip::READOUT_MODE_LEGACY_SCOPE) ) ? 0 : iconn->apvPairNumber();
+    // Retrive run type
+    sistrip::RunType runType_ = summary.runType();
+    if( useFedKey_ && ( runType_ == sistrip::APV_LATENCY || runType_ == sistrip::FINE_DELAY ) ) { useFedKey_ = false; } 
 
-	if ((!legacy_ && (mode == sistrip::READOUT_MODE_ZERO_SUPPRESSED || mode == sistrip::READOUT_MODE_ZERO_SUPPRESSED_FAKE))
-         || (legacy_ && (lmode == sistrip::READOUT_MODE_LEGACY_ZERO_SUPPRESSED_REAL || lmode == sistrip::READOUT_MODE_LEGACY_ZERO_SUPPRESSED_FAKE)) ) {
-	
-	  Registry regItem(key, 0, zs_work_digis_.size(), 0);
-	
-          try {
-	    /// create unpacker
-	    sistrip::FEDZSChannelUnpacker unpacker = sistrip::FEDZSChannelUnpacker::zeroSuppressedModeUnpacker(buffer->channel(iconn->fedCh()));
-	    
-	    /// unpack -> add check to make sure strip < nstrips && strip > last strip......
-            
-	    while (unpacker.hasData()) {zs_work_digis_.push_back(SiStripDigi(unpacker.sampleNumber()+ipair*256,unpacker.adc())); unpacker++;}
-          } catch (const cms::Exception& e) {
-            if ( edm::isDebugEnabled() ) {
-              edm::LogWarning(sistrip::mlRawToDigi_)
-                << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-                << " Clusters are not ordered for FED "
-                << *ifed << " channel " << iconn->fedCh()
-                << ": " << e.what();
-            }
-            detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
-            continue;
+    // Dump of FED buffer
+    if ( edm::isDebugEnabled() ) {
+      if ( fedEventDumpFreq_ && !(event_%fedEventDumpFreq_) ) {
+	std::stringstream ss;
+	buffer->dump( ss );
+	edm::LogVerbatim(sistrip::mlRawToDigi_) << ss.str();
+      }
+    }
+
+    // Iterate through FED channels, extract payload and create Digis
+    std::vector<FedChannelConnection>::const_iterator iconn = conns.begin();
+    for ( ; iconn != conns.end(); iconn++ ) {
+
+      /// FED channel
+      uint16_t chan = iconn->fedCh();
+
+      // Check if fed connection is valid
+      if ( !iconn->isConnected() ) { continue; }
+
+      // Check DetId is valid (if to be used as key)
+      if ( !useFedKey_ && ( !iconn->detId() || iconn->detId() == sistrip::invalid32_ ) ) { continue; }
+
+      // Check FED channel
+      if (!buffer->channelGood(iconn->fedCh(),doAPVEmulatorCheck_)) {
+        if (!unpackBadChannels_ || !(buffer->fePresent(iconn->fedCh()/FEDCH_PER_FEUNIT) && buffer->feEnabled(iconn->fedCh()/FEDCH_PER_FEUNIT)) ) {
+          detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
+          continue;
+        }
+      }
+
+      // Determine whether FED key is inferred from cabling or channel loop
+      uint32_t fed_key = ( summary.runType() == sistrip::FED_CABLING ) ? ( ( fed_id & sistrip::invalid_ ) << 16 ) | ( chan & sistrip::invalid_ ) : ( ( iconn->fedId() & sistrip::invalid_ ) << 16 ) | ( iconn->fedCh() & sistrip::invalid_ );
+
+      // Determine whether DetId or FED key should be used to index digi containers
+      uint32_t key = ( useFedKey_ || (!legacy_ && mode == sistrip::READOUT_MODE_SCOPE) || (legacy_ && lmode == sistrip::READOUT_MODE_LEGACY_SCOPE) ) ? fed_key : iconn->detId();
+
+      // Determine APV std::pair number (needed only when using DetId)
+      uint16_t ipair = ( useFedKey_ || (!legacy_ && mode == sistrip::READOUT_MODE_SCOPE) || (legacy_ && lmode == sistrip::READOUT_MODE_LEGACY_SCOPE) ) ? 0 : iconn->apvPairNumber();
+
+      if ((!legacy_ && (mode == sistrip::READOUT_MODE_ZERO_SUPPRESSED || mode == sistrip::READOUT_MODE_ZERO_SUPPRESSED_FAKE))
+       || (legacy_ && (lmode == sistrip::READOUT_MODE_LEGACY_ZERO_SUPPRESSED_REAL || lmode == sistrip::READOUT_MODE_LEGACY_ZERO_SUPPRESSED_FAKE)) ) {
+
+	Registry regItem(key, 0, work.zs_digis.size(), 0);
+
+        try {
+	  /// create unpacker
+	  sistrip::FEDZSChannelUnpacker unpacker = sistrip::FEDZSChannelUnpacker::zeroSuppressedModeUnpacker(buffer->channel(iconn->fedCh()));
+
+	  /// unpack -> add check to make sure strip < nstrips && strip > last strip......
+
+	  while (unpacker.hasData()) {work.zs_digis.push_back(SiStripDigi(unpacker.sampleNumber()+ipair*256,unpacker.adc())); unpacker++;}
+        } catch (const cms::Exception& e) {
+          if ( edm::isDebugEnabled() ) {
+            edm::LogWarning(sistrip::mlRawToDigi_)
+              << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+              << " Clusters are not ordered for FED "
+              << fed_id << " channel " << iconn->fedCh()
+              << ": " << e.what();
           }
-          
-	  regItem.length = zs_work_digis_.size() - regItem.index;
-	  if (regItem.length > 0) {
-	    regItem.first = zs_work_digis_[regItem.index].strip();
-	    zs_work_registry_.push_back(regItem);
-	  }
+          detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
+          continue;
+        }
 
-	    
-	  // Common mode values
- 	  if ( extractCm_ ) {
- 	    try {
-	      Registry regItem2( key, 2*ipair, cm_work_digis_.size(), 2 );
-	      cm_work_digis_.push_back( SiStripRawDigi( buffer->channel(iconn->fedCh()).cmMedian(0) ) );
-	      cm_work_digis_.push_back( SiStripRawDigi( buffer->channel(iconn->fedCh()).cmMedian(1) ) );
-	      cm_work_registry_.push_back( regItem2 );
- 	    } catch (const cms::Exception& e) {
- 	      if ( edm::isDebugEnabled() ) {
- 		edm::LogWarning(sistrip::mlRawToDigi_)
- 		  << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
- 		  << " Problem extracting common modes for FED id "
- 		  << *ifed << " and channel " << iconn->fedCh()
- 		  << ": " << std::endl << e.what();
- 	      }
- 	    }
- 	  }
-	  
+	regItem.length = work.zs_digis.size() - regItem.index;
+	if (regItem.length > 0) {
+	  regItem.first = work.zs_digis[regItem.index].strip();
+	  work.zs_registry.push_back(regItem);
 	}
 
-	else if (!legacy_ && (mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE10 || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE10_CMOVERRIDE)) { 
-
-	  Registry regItem(key, 0, zs_work_digis_.size(), 0);
 
+	// Common mode values
+	if ( extractCm_ ) {
 	  try {
-            /// create unpacker
-	    sistrip::FEDBSChannelUnpacker unpacker = sistrip::FEDBSChannelUnpacker::zeroSuppressedLiteModeUnpacker(buffer->channel(iconn->fedCh()), 10);
-	    
-	    /// unpack -> add check to make sure strip < nstrips && strip > last strip......
-	    while (unpacker.hasData()) {zs_work_digis_.push_back(SiStripDigi(unpacker.sampleNumber()+ipair*256,unpacker.adc()));unpacker++;}
+	    Registry regItem2( key, 2*ipair, work.cm_digis.size(), 2 );
+	    work.cm_digis.push_back( SiStripRawDigi( buffer->channel(iconn->fedCh()).cmMedian(0) ) );
+	    work.cm_digis.push_back( SiStripRawDigi( buffer->channel(iconn->fedCh()).cmMedian(1) ) );
+	    work.cm_registry.push_back( regItem2 );
 	  } catch (const cms::Exception& e) {
-            if ( edm::isDebugEnabled() ) {
-              edm::LogWarning(sistrip::mlRawToDigi_)
-                << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-                << " Clusters are not ordered for FED "
-                << *ifed << " channel " << iconn->fedCh()
-                << ": " << e.what();
-            }
-            detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
-            continue;
-          }  
-
-	  regItem.length = zs_work_digis_.size() - regItem.index;
-	  if (regItem.length > 0) {
-	    regItem.first = zs_work_digis_[regItem.index].strip();
-	    zs_work_registry_.push_back(regItem);
+	    if ( edm::isDebugEnabled() ) {
+	      edm::LogWarning(sistrip::mlRawToDigi_)
+		<< "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+		<< " Problem extracting common modes for FED id "
+		<< fed_id << " and channel " << iconn->fedCh()
+		<< ": " << std::endl << e.what();
+	    }
 	  }
-          
+	}
 
-	} 
+      }
 
-        else if ((!legacy_ &&
-                 (mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8  || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_CMOVERRIDE ||
-                  mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_TOPBOT || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_TOPBOT_CMOVERRIDE ||
-                  mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_BOTBOT || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_BOTBOT_CMOVERRIDE))
-             || (legacy_ && (lmode == sistrip::READOUT_MODE_LEGACY_ZERO_SUPPRESSED_LITE_REAL || lmode == sistrip::READOUT_MODE_LEGACY_ZERO_SUPPRESSED_LITE_FAKE))) {
+      else if (!legacy_ && (mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE10 || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE10_CMOVERRIDE)) { 
 
-      	  Registry regItem(key, 0, zs_work_digis_.size(), 0);
-	
-	  size_t bits_shift = 0;
-	  if (mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_TOPBOT || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_TOPBOT_CMOVERRIDE) bits_shift = 1;
-	  if (mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_BOTBOT || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_BOTBOT_CMOVERRIDE) bits_shift = 2;
-	  
-	  try {
-            /// create unpacker
-            sistrip::FEDZSChannelUnpacker unpacker = sistrip::FEDZSChannelUnpacker::zeroSuppressedLiteModeUnpacker(buffer->channel(iconn->fedCh()));
-	    	    
-    	    /// unpack -> add check to make sure strip < nstrips && strip > last strip......
-   	    while (unpacker.hasData()) {zs_work_digis_.push_back(SiStripDigi(unpacker.sampleNumber()+ipair*256,unpacker.adc()<<bits_shift));unpacker++;}
- 	  } catch (const cms::Exception& e) {
-            if ( edm::isDebugEnabled() ) {
-              edm::LogWarning(sistrip::mlRawToDigi_)
-                << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-                << " Clusters are not ordered for FED "
-                << *ifed << " channel " << iconn->fedCh()
-                << ": " << e.what();
-            }
-            detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
-            continue;
+	Registry regItem(key, 0, work.zs_digis.size(), 0);
+
+	try {
+          /// create unpacker
+	  sistrip::FEDBSChannelUnpacker unpacker = sistrip::FEDBSChannelUnpacker::zeroSuppressedLiteModeUnpacker(buffer->channel(iconn->fedCh()), 10);
+
+	  /// unpack -> add check to make sure strip < nstrips && strip > last strip......
+	  while (unpacker.hasData()) {work.zs_digis.push_back(SiStripDigi(unpacker.sampleNumber()+ipair*256,unpacker.adc()));unpacker++;}
+	} catch (const cms::Exception& e) {
+          if ( edm::isDebugEnabled() ) {
+            edm::LogWarning(sistrip::mlRawToDigi_)
+              << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+              << " Clusters are not ordered for FED "
+              << fed_id << " channel " << iconn->fedCh()
+              << ": " << e.what();
           }
+          detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
+          continue;
+        }  
 
-	  regItem.length = zs_work_digis_.size() - regItem.index;
-	  if (regItem.length > 0) {
-	    regItem.first = zs_work_digis_[regItem.index].strip();
-	    zs_work_registry_.push_back(regItem);
-	  }
+	regItem.length = work.zs_digis.size() - regItem.index;
+	if (regItem.length > 0) {
+	  regItem.first = work.zs_digis[regItem.index].strip();
+	  work.zs_registry.push_back(regItem);
+	}
+
+
+      } 
+
+      else if ((!legacy_ &&
+               (mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8  || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_CMOVERRIDE ||
+                mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_TOPBOT || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_TOPBOT_CMOVERRIDE ||
+                mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_BOTBOT || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_BOTBOT_CMOVERRIDE))
+           || (legacy_ && (lmode == sistrip::READOUT_MODE_LEGACY_ZERO_SUPPRESSED_LITE_REAL || lmode == sistrip::READOUT_MODE_LEGACY_ZERO_SUPPRESSED_LITE_FAKE))) {
 
+	Registry regItem(key, 0, work.zs_digis.size(), 0);
+
+	size_t bits_shift = 0;
+	if (mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_TOPBOT || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_TOPBOT_CMOVERRIDE) bits_shift = 1;
+	if (mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_BOTBOT || mode==sistrip::READOUT_MODE_ZERO_SUPPRESSED_LITE8_BOTBOT_CMOVERRIDE) bits_shift = 2;
+
+	try {
+          /// create unpacker
+          sistrip::FEDZSChannelUnpacker unpacker = sistrip::FEDZSChannelUnpacker::zeroSuppressedLiteModeUnpacker(buffer->channel(iconn->fedCh()));
+
+	  /// unpack -> add check to make sure strip < nstrips && strip > last strip......
+	  while (unpacker.hasData()) {work.zs_digis.push_back(SiStripDigi(unpacker.sampleNumber()+ipair*256,unpacker.adc()<<bits_shift));unpacker++;}
+	} catch (const cms::Exception& e) {
+          if ( edm::isDebugEnabled() ) {
+            edm::LogWarning(sistrip::mlRawToDigi_)
+              << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+              << " Clusters are not ordered for FED "
+              << fed_id << " channel " << iconn->fedCh()
+              << ": " << e.what();
+          }
+          detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
+          continue;
         }
-     
-	else if ((!legacy_ && mode == sistrip::READOUT_MODE_PREMIX_RAW)
-              || (legacy_ && lmode == sistrip::READOUT_MODE_LEGACY_PREMIX_RAW)
-                ) { 
 
-	  Registry regItem(key, 0, zs_work_digis_.size(), 0);
-	
-	  try {
+	regItem.length = work.zs_digis.size() - regItem.index;
+	if (regItem.length > 0) {
+	  regItem.first = work.zs_digis[regItem.index].strip();
+	  work.zs_registry.push_back(regItem);
+	}
 
-            /// create unpacker
-	    sistrip::FEDZSChannelUnpacker unpacker = sistrip::FEDZSChannelUnpacker::preMixRawModeUnpacker(buffer->channel(iconn->fedCh()));
-	    
-	    /// unpack -> add check to make sure strip < nstrips && strip > last strip......
-	    while (unpacker.hasData()) {zs_work_digis_.push_back(SiStripDigi(unpacker.sampleNumber()+ipair*256,unpacker.adcPreMix()));unpacker++;}
-	  } catch (const cms::Exception& e) {
-            if ( edm::isDebugEnabled() ) {
-              edm::LogWarning(sistrip::mlRawToDigi_)
-                << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-                << " Clusters are not ordered for FED "
-                << *ifed << " channel " << iconn->fedCh()
-                << ": " << e.what();
-            }
-            detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
-            continue;
-          }  
-
-	  regItem.length = zs_work_digis_.size() - regItem.index;
-	  if (regItem.length > 0) {
-	    regItem.first = zs_work_digis_[regItem.index].strip();
-	    zs_work_registry_.push_back(regItem);
-	  }
-          
+      }
 
-	} 
-     
-	else if ((!legacy_ && mode == sistrip::READOUT_MODE_VIRGIN_RAW)
-               || (legacy_ && (lmode == sistrip::READOUT_MODE_LEGACY_VIRGIN_RAW_REAL || lmode == sistrip::READOUT_MODE_LEGACY_VIRGIN_RAW_FAKE ))
-                ) {
+      else if ((!legacy_ && mode == sistrip::READOUT_MODE_PREMIX_RAW)
+            || (legacy_ && lmode == sistrip::READOUT_MODE_LEGACY_PREMIX_RAW)
+              ) { 
 
-	  std::vector<uint16_t> samples; 
+	Registry regItem(key, 0, work.zs_digis.size(), 0);
 
-	  /// create unpacker
-	  /// and unpack -> add check to make sure strip < nstrips && strip > last strip......
+	try {
 
-          uint8_t packet_code = buffer->packetCode(legacy_);
-          if ( packet_code == PACKET_CODE_VIRGIN_RAW ) {
-            sistrip::FEDRawChannelUnpacker unpacker = sistrip::FEDRawChannelUnpacker::virginRawModeUnpacker(buffer->channel(iconn->fedCh()));
-	    while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker++;}
+          /// create unpacker
+	  sistrip::FEDZSChannelUnpacker unpacker = sistrip::FEDZSChannelUnpacker::preMixRawModeUnpacker(buffer->channel(iconn->fedCh()));
+
+	  /// unpack -> add check to make sure strip < nstrips && strip > last strip......
+	  while (unpacker.hasData()) {work.zs_digis.push_back(SiStripDigi(unpacker.sampleNumber()+ipair*256,unpacker.adcPreMix()));unpacker++;}
+	} catch (const cms::Exception& e) {
+          if ( edm::isDebugEnabled() ) {
+            edm::LogWarning(sistrip::mlRawToDigi_)
+              << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+              << " Clusters are not ordered for FED "
+              << fed_id << " channel " << iconn->fedCh()
+              << ": " << e.what();
+          }
+          detids.push_back(iconn->detId()); //@@ Possible multiple entries (ok for Giovanni)
+          continue;
+        }  
+
+	regItem.length = work.zs_digis.size() - regItem.index;
+	if (regItem.length > 0) {
+	  regItem.first = work.zs_digis[regItem.index].strip();
+	  work.zs_registry.push_back(regItem);
+	}
+
+
+      } 
+
+      else if ((!legacy_ && mode == sistrip::READOUT_MODE_VIRGIN_RAW)
+             || (legacy_ && (lmode == sistrip::READOUT_MODE_LEGACY_VIRGIN_RAW_REAL || lmode == sistrip::READOUT_MODE_LEGACY_VIRGIN_RAW_FAKE ))
+              ) {
+
+	std::vector<uint16_t> samples; 
+
+	/// create unpacker
+	/// and unpack -> add check to make sure strip < nstrips && strip > last strip......
+
+        uint8_t packet_code = buffer->packetCode(legacy_);
+        if ( packet_code == PACKET_CODE_VIRGIN_RAW ) {
+          sistrip::FEDRawChannelUnpacker unpacker = sistrip::FEDRawChannelUnpacker::virginRawModeUnpacker(buffer->channel(iconn->fedCh()));
+	  while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker++;}
+        }
+        else {
+          if ( packet_code == PACKET_CODE_VIRGIN_RAW10 ) {
+            sistrip::FEDBSChannelUnpacker unpacker = sistrip::FEDBSChannelUnpacker::virginRawModeUnpacker(buffer->channel(iconn->fedCh()), 10);
+            while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker.sampleNumber();unpacker++;}
           }
-          else {
-            if ( packet_code == PACKET_CODE_VIRGIN_RAW10 ) {
-              sistrip::FEDBSChannelUnpacker unpacker = sistrip::FEDBSChannelUnpacker::virginRawModeUnpacker(buffer->channel(iconn->fedCh()), 10);
-              while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker.sampleNumber();unpacker++;}
-            }
-            else if ( packet_code == PACKET_CODE_VIRGIN_RAW8_BOTBOT ) {
-              sistrip::FEDBSChannelUnpacker unpacker = sistrip::FEDBSChannelUnpacker::virginRawModeUnpacker(buffer->channel(iconn->fedCh()), 8);
-	      while (unpacker.hasData()) {samples.push_back(( unpacker.adc()<<2 ));unpacker++;}
-            }
-            else if ( packet_code == PACKET_CODE_VIRGIN_RAW8_TOPBOT ) {
-              sistrip::FEDBSChannelUnpacker unpacker = sistrip::FEDBSChannelUnpacker::virginRawModeUnpacker(buffer->channel(iconn->fedCh()), 8);
-	      while (unpacker.hasData()) {samples.push_back(( unpacker.adc()<<1 ));unpacker++;}
-            }
+          else if ( packet_code == PACKET_CODE_VIRGIN_RAW8_BOTBOT ) {
+            sistrip::FEDBSChannelUnpacker unpacker = sistrip::FEDBSChannelUnpacker::virginRawModeUnpacker(buffer->channel(iconn->fedCh()), 8);
+	    while (unpacker.hasData()) {samples.push_back(( unpacker.adc()<<2 ));unpacker++;}
           }
-          if ( !samples.empty() ) { 
-            Registry regItem(key, 256*ipair, virgin_work_digis_.size(), samples.size());
-	    uint16_t physical;
-	    uint16_t readout; 
-	    for ( uint16_t i = 0, n = samples.size(); i < n; i++ ) {
-	      physical = i%128;
-	      readoutOrder( physical, readout );                 // convert index from physical to readout order
-	      (i/128) ? readout=readout*2+1 : readout=readout*2; // un-multiplex data
-	      virgin_work_digis_.push_back(  SiStripRawDigi( samples[readout] ) );
-	    }
-	    virgin_work_registry_.push_back( regItem );
+          else if ( packet_code == PACKET_CODE_VIRGIN_RAW8_TOPBOT ) {
+            sistrip::FEDBSChannelUnpacker unpacker = sistrip::FEDBSChannelUnpacker::virginRawModeUnpacker(buffer->channel(iconn->fedCh()), 8);
+	    while (unpacker.hasData()) {samples.push_back(( unpacker.adc()<<1 ));unpacker++;}
+          }
+        }
+        if ( !samples.empty() ) { 
+          Registry regItem(key, 256*ipair, work.virgin_digis.size(), samples.size());
+	  uint16_t physical;
+	  uint16_t readout; 
+	  for ( uint16_t i = 0, n = samples.size(); i < n; i++ ) {
+	    physical = i%128;
+	    readoutOrder( physical, readout );                 // convert index from physical to readout order
+	    (i/128) ? readout=readout*2+1 : readout=readout*2; // un-multiplex data
+	    work.virgin_digis.push_back(  SiStripRawDigi( samples[readout] ) );
 	  }
-	} 
-    
-	else if ((!legacy_ && mode == sistrip::READOUT_MODE_PROC_RAW)
-               || (legacy_ && (lmode == sistrip::READOUT_MODE_LEGACY_PROC_RAW_REAL || lmode == sistrip::READOUT_MODE_LEGACY_PROC_RAW_FAKE ))
-                ) {
-	
-	  std::vector<uint16_t> samples; 
-	
-	  /// create unpacker
-	  sistrip::FEDRawChannelUnpacker unpacker = sistrip::FEDRawChannelUnpacker::procRawModeUnpacker(buffer->channel(iconn->fedCh()));
-	
-	  /// unpack -> add check to make sure strip < nstrips && strip > last strip......
-	  while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker++;}
-	
-	  if ( !samples.empty() ) { 
-	    Registry regItem(key, 256*ipair, proc_work_digis_.size(), samples.size());
-	    for ( uint16_t i = 0, n = samples.size(); i < n; i++ ) {
-	      proc_work_digis_.push_back(  SiStripRawDigi( samples[i] ) );
-	    }
-	    proc_work_registry_.push_back( regItem );
+	  work.virgin_registry.push_back( regItem );
+	}
+      } 
+
+      else if ((!legacy_ && mode == sistrip::READOUT_MODE_PROC_RAW)
+             || (legacy_ && (lmode == sistrip::READOUT_MODE_LEGACY_PROC_RAW_REAL || lmode == sistrip::READOUT_MODE_LEGACY_PROC_RAW_FAKE ))
+              ) {
+
+	std::vector<uint16_t> samples; 
+
+	/// create unpacker
+	sistrip::FEDRawChannelUnpacker unpacker = sistrip::FEDRawChannelUnpacker::procRawModeUnpacker(buffer->channel(iconn->fedCh()));
+
+	/// unpack -> add check to make sure strip < nstrips && strip > last strip......
+	while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker++;}
+
+	if ( !samples.empty() ) { 
+	  Registry regItem(key, 256*ipair, work.proc_digis.size(), samples.size());
+	  for ( uint16_t i = 0, n = samples.size(); i < n; i++ ) {
+	    work.proc_digis.push_back(  SiStripRawDigi( samples[i] ) );
 	  }
-	} 
+	  work.proc_registry.push_back( regItem );
+	}
+      } 
 
-	else if ((!legacy_ && mode == sistrip::READOUT_MODE_SCOPE)
-               || (legacy_ && lmode == sistrip::READOUT_MODE_LEGACY_SCOPE)
-                ) {
-	
-	  std::vector<uint16_t> samples; 
-	
-	  /// create unpacker
-	  sistrip::FEDRawChannelUnpacker unpacker = sistrip::FEDRawChannelUnpacker::scopeModeUnpacker(buffer->channel(iconn->fedCh()));
+      else if ((!legacy_ && mode == sistrip::READOUT_MODE_SCOPE)
+             || (legacy_ && lmode == sistrip::READOUT_MODE_LEGACY_SCOPE)
+              ) {
 
-	  /// unpack -> add check to make sure strip < nstrips && strip > last strip......
-	  while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker++;}
-	
-	  if ( !samples.empty() ) { 
-	    Registry regItem(key, 0, scope_work_digis_.size(), samples.size());
-	    for ( uint16_t i = 0, n = samples.size(); i < n; i++ ) {
-	      scope_work_digis_.push_back(  SiStripRawDigi( samples[i] ) );
-	    }
-	    scope_work_registry_.push_back( regItem );
+	std::vector<uint16_t> samples; 
+
+	/// create unpacker
+	sistrip::FEDRawChannelUnpacker unpacker = sistrip::FEDRawChannelUnpacker::scopeModeUnpacker(buffer->channel(iconn->fedCh()));
+
+	/// unpack -> add check to make sure strip < nstrips && strip > last strip......
+	while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker++;}
+
+	if ( !samples.empty() ) { 
+	  Registry regItem(key, 0, work.scope_digis.size(), samples.size());
+	  for ( uint16_t i = 0, n = samples.size(); i < n; i++ ) {
+	    work.scope_digis.push_back(  SiStripRawDigi( samples[i] ) );
 	  }
-	} 
-	
-	else { // Unknown readout mode! => assume scope mode
+	  work.scope_registry.push_back( regItem );
+	}
+      } 
+
+      else { // Unknown readout mode! => assume scope mode
+
+	if ( edm::isDebugEnabled() ) {
+	  std::stringstream ss;
+	  ss << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+	     << " Unknown FED readout mode (" << mode
+	     << ")! Assuming SCOPE MODE..."; 
+	  edm::LogWarning(sistrip::mlRawToDigi_) << ss.str();
+	}
+
+	std::vector<uint16_t> samples; 
+
+	/// create unpacker
+	sistrip::FEDRawChannelUnpacker unpacker = sistrip::FEDRawChannelUnpacker::scopeModeUnpacker(buffer->channel(iconn->fedCh()));
+
+	/// unpack -> add check to make sure strip < nstrips && strip > last strip......
+	while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker++;}
+
+	if ( !samples.empty() ) { 
+	  Registry regItem(key, 0, work.scope_digis.size(), samples.size());
+	  for ( uint16_t i = 0, n = samples.size(); i < n; i++ ) {
+	    work.scope_digis.push_back(  SiStripRawDigi( samples[i] ) );
+	  }
+	  work.scope_registry.push_back( regItem );
 
 	  if ( edm::isDebugEnabled() ) {
 	    std::stringstream ss;
-	    ss << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-	       << " Unknown FED readout mode (" << mode
-	       << ")! Assuming SCOPE MODE..."; 
-	    edm::LogWarning(sistrip::mlRawToDigi_) << ss.str();
-	  }
-	
-	  std::vector<uint16_t> samples; 
-	
-	  /// create unpacker
-	  sistrip::FEDRawChannelUnpacker unpacker = sistrip::FEDRawChannelUnpacker::scopeModeUnpacker(buffer->channel(iconn->fedCh()));
-	
-	  /// unpack -> add check to make sure strip < nstrips && strip > last strip......
-	  while (unpacker.hasData()) {samples.push_back(unpacker.adc());unpacker++;}
-	
-	  if ( !samples.empty() ) { 
-	    Registry regItem(key, 0, scope_work_digis_.size(), samples.size());
-	    for ( uint16_t i = 0, n = samples.size(); i < n; i++ ) {
-	      scope_work_digis_.push_back(  SiStripRawDigi( samples[i] ) );
-	    }
-	    scope_work_registry_.push_back( regItem );
-	  
-	    if ( edm::isDebugEnabled() ) {
-	      std::stringstream ss;
-	      ss << "Extracted " << samples.size() 
-		 << " SCOPE MODE digis (samples[0] = " 
-		 << samples[0] 
-		 << ") from FED id/ch " 
-		 << iconn->fedId() 
-		 << "/" 
-		 << iconn->fedCh();
-	      LogTrace("SiStripRawToDigi") << ss.str();
-	    }
-	  }
-	  else if ( edm::isDebugEnabled() ) {
-	    edm::LogWarning(sistrip::mlRawToDigi_)
-	      << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-	      << " No SM digis found!"; 
+	    ss << "Extracted " << samples.size() 
+	       << " SCOPE MODE digis (samples[0] = " 
+	       << samples[0] 
+	       << ") from FED id/ch " 
+	       << iconn->fedId() 
+	       << "/" 
+	       << iconn->fedCh();
+	    LogTrace("SiStripRawToDigi") << ss.str();
 	  }
-	} 
-      } // channel loop
-    } // fed loop
-
-    // bad channels warning
-    unsigned int detIdsSize = detids.size();
-    if ( edm::isDebugEnabled() && detIdsSize ) {
-      std::ostringstream ss;
-      ss << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
-         << " Problems were found in data and " << detIdsSize << " channels could not be unpacked. "
-         << "See output of FED Hardware monitoring for more information. ";
-      edm::LogWarning(sistrip::mlRawToDigi_) << ss.str();
-    }
-    if( (errorThreshold_ != 0) && (detIdsSize > errorThreshold_) ) {
-      edm::LogError("TooManyErrors") << "Total number of errors = " << detIdsSize;
-    }
+	}
+	else if ( edm::isDebugEnabled() ) {
+	  edm::LogWarning(sistrip::mlRawToDigi_)
+	    << "[sistrip::RawToDigiUnpacker::" << __func__ << "]"
+	    << " No SM digis found!"; 
+	}
+      } 
+    } // channel loop
+  }
 
-    // update DetSetVectors
-    update(scope_mode, virgin_raw, proc_raw, zero_suppr, cm_values);
+  void RawToDigiUnpacker::WorkVectors::append( const WorkVectors& other ) {
+    auto appendRegistry = []( std::vector<Registry>& to, size_t offset, const std::vector<Registry>& from ) {
+      for ( auto const & reg : from ) { to.push_back( reg ); to.back().index += offset; }
+    };
+    appendRegistry( zs_registry, zs_digis.size(), other.zs_registry );
+    appendRegistry( virgin_registry, virgin_digis.size(), other.virgin_registry );
+    appendRegistry( scope_registry, scope_digis.size(), other.scope_registry );
+    appendRegistry( proc_registry, proc_digis.size(), other.proc_registry );
+    appendRegistry( cm_registry, cm_digis.size(), other.cm_registry );
+    zs_digis.insert( zs_digis.end(), other.zs_digis.begin(), other.zs_digis.end() );
+    virgin_digis.insert( virgin_digis.end(), other.virgin_digis.begin(), other.virgin_digis.end() );
+    scope_digis.insert( scope_digis.end(), other.scope_digis.begin(), other.scope_digis.end() );
+    proc_digis.insert( proc_digis.end(), other.proc_digis.begin(), other.proc_digis.end() );
+    cm_digis.insert( cm_digis.end(), other.cm_digis.begin(), other.cm_digis.end() );
+  }
 
-    // increment event counter
-    event_++;
-  
-    // no longer first event!
-    if ( first_ ) { first_ = false; }
-  
-    // final cleanup, just in case
-    cleanupWorkVectors();
+  void RawToDigiUnpacker::WorkVectors::clear() {
+    zs_registry.clear();      zs_digis.clear();
+    virgin_registry.clear();  virgin_digis.clear();
+    proc_registry.clear();    proc_digis.clear();
+    scope_registry.clear();   scope_digis.clear();
+    cm_registry.clear();      cm_digis.clear();
   }
 
   void RawToDigiUnpacker::update( RawDigis& scope_mode, RawDigis& virgin_raw, RawDigis& proc_raw, Digis& zero_suppr, RawDigis& common_mode ) {
   
-    if ( ! zs_work_registry_.empty() ) {
-      std::sort( zs_work_registry_.begin(), zs_work_registry_.end() );
+    if ( ! work_.zs_registry.empty() ) {
+      std::sort( work_.zs_registry.begin(), work_.zs_registry.end() );
       std::vector< edm::DetSet<SiStripDigi> > sorted_and_merged;
-      sorted_and_merged.reserve(  std::min(zs_work_registry_.size(), size_t(17000)) );
+      sorted_and_merged.reserve(  std::min(work_.zs_registry.size(), size_t(17000)) );
     
       bool errorInData = false;
-      std::vector<Registry>::iterator it = zs_work_registry_.begin(), it2 = it+1, end = zs_work_registry_.end();
+      std::vector<Registry>::iterator it = work_.zs_registry.begin(), it2 = it+1, end = work_.zs_registry.end();
       while (it < end) {
 	sorted_and_merged.push_back( edm::DetSet<SiStripDigi>(it->detid) );
 	std::vector<SiStripDigi> & digis = sorted_and_merged.back().data;
@@ -602,7 +652,7 @@ namespace sistrip {
 	digis.reserve(len);
 	// push them in
 	for (it2 = it+0; (it2 != end) && (it2->detid == it->detid); ++it2) {
-	  digis.insert( digis.end(), & zs_work_digis_[it2->index], & zs_work_digis_[it2->index + it2->length] );
+	  digis.insert( digis.end(), & work_.zs_digis[it2->index], & work_.zs_digis[it2->index + it2->length] );
 	}
 	it = it2;
       }
@@ -637,15 +687,15 @@ namespace sistrip {
     } 
   
     // Populate final DetSetVector container with VR data 
-    if ( !virgin_work_registry_.empty() ) {
+    if ( !work_.virgin_registry.empty() ) {
 
-      std::sort( virgin_work_registry_.begin(), virgin_work_registry_.end() );
+      std::sort( work_.virgin_registry.begin(), work_.virgin_registry.end() );
     
       std::vector< edm::DetSet<SiStripRawDigi> > sorted_and_merged;
-      sorted_and_merged.reserve( std::min(virgin_work_registry_.size(), size_t(17000)) );
+      sorted_and_merged.reserve( std::min(work_.virgin_registry.size(), size_t(17000)) );
     
       bool errorInData = false;
-      std::vector<Registry>::iterator it = virgin_work_registry_.begin(), it2, end = virgin_work_registry_.end();
+      std::vector<Registry>::iterator it = work_.virgin_registry.begin(), it2, end = work_.virgin_registry.end();
       while (it < end) {
 	sorted_and_merged.push_back( edm::DetSet<SiStripRawDigi>(it->detid) );
 	std::vector<SiStripRawDigi> & digis = sorted_and_merged.back().data;
@@ -666,7 +716,7 @@ namespace sistrip {
 	for (it2 = it+0; (it2 != end) && (it2->detid == it->detid); ++it2) {
 	  // data corruption. DO NOT 'break' here
 	  if (it->length != 256)  { isDetOk = false; continue; } 
-	  std::copy( & virgin_work_digis_[it2->index], & virgin_work_digis_[it2->index + it2->length], & digis[it2->first] );
+	  std::copy( & work_.virgin_digis[it2->index], & work_.virgin_digis[it2->index + it2->length], & digis[it2->first] );
 	}
 	if (!isDetOk) { errorInData = true; digis.clear(); it = it2; continue; } // skip whole det
 	it = it2;
@@ -692,14 +742,14 @@ namespace sistrip {
     }
   
     // Populate final DetSetVector container with VR data 
-    if ( !proc_work_registry_.empty() ) {
-      std::sort( proc_work_registry_.begin(), proc_work_registry_.end() );
+    if ( !work_.proc_registry.empty() ) {
+      std::sort( work_.proc_registry.begin(), work_.proc_registry.end() );
     
       std::vector< edm::DetSet<SiStripRawDigi> > sorted_and_merged;
-      sorted_and_merged.reserve( std::min(proc_work_registry_.size(), size_t(17000)) );
+      sorted_and_merged.reserve( std::min(work_.proc_registry.size(), size_t(17000)) );
     
       bool errorInData = false;
-      std::vector<Registry>::iterator it = proc_work_registry_.begin(), it2, end = proc_work_registry_.end();
+      std::vector<Registry>::iterator it = work_.proc_registry.begin(), it2, end = work_.proc_registry.end();
       while (it < end) {
 	sorted_and_merged.push_back( edm::DetSet<SiStripRawDigi>(it->detid) );
 	std::vector<SiStripRawDigi> & digis = sorted_and_merged.back().data;
@@ -721,7 +771,7 @@ namespace sistrip {
 	for (it2 = it+0; (it2 != end) && (it2->detid == it->detid); ++it2) {
 	  // data corruption. DO NOT 'break' here
 	  if (it->length != 256)  { isDetOk = false; continue; } 
-	  std::copy( & proc_work_digis_[it2->index], & proc_work_digis_[it2->index + it2->length], & digis[it2->first] );
+	  std::copy( & work_.proc_digis[it2->index], & work_.proc_digis[it2->index + it2->length], & digis[it2->first] );
 	}
 	// skip whole det
 	if (!isDetOk) { errorInData = true; digis.clear(); it = it2; continue; } 
@@ -748,18 +798,18 @@ namespace sistrip {
     }
   
     // Populate final DetSetVector container with SM data 
-    if ( !scope_work_registry_.empty() ) {
-      std::sort( scope_work_registry_.begin(), scope_work_registry_.end() );
+    if ( !work_.scope_registry.empty() ) {
+      std::sort( work_.scope_registry.begin(), work_.scope_registry.end() );
     
       std::vector< edm::DetSet<SiStripRawDigi> > sorted_and_merged;
-      sorted_and_merged.reserve( scope_work_registry_.size() );
+      sorted_and_merged.reserve( work_.scope_registry.size() );
     
       bool errorInData = false;
       std::vector<Registry>::iterator it, end;
-      for (it = scope_work_registry_.begin(), end = scope_work_registry_.end() ; it != end; ++it) {
+      for (it = work_.scope_registry.begin(), end = work_.scope_registry.end() ; it != end; ++it) {
 	sorted_and_merged.push_back( edm::DetSet<SiStripRawDigi>(it->detid) );
 	std::vector<SiStripRawDigi> & digis = sorted_and_merged.back().data;
-	digis.insert( digis.end(), & scope_work_digis_[it->index], & scope_work_digis_[it->index + it->length] );
+	digis.insert( digis.end(), & work_.scope_digis[it->index], & work_.scope_digis[it->index + it->length] );
       
 	if ( (it +1 != end) && (it->detid == (it+1)->detid) ) {
 	  errorInData = true; 
@@ -791,15 +841,15 @@ namespace sistrip {
     if ( extractCm_ ) {
 
       // Populate final DetSetVector container with VR data 
-      if ( !cm_work_registry_.empty() ) {
+      if ( !work_.cm_registry.empty() ) {
 
-	std::sort( cm_work_registry_.begin(), cm_work_registry_.end() );
+	std::sort( work_.cm_registry.begin(), work_.cm_registry.end() );
     
 	std::vector< edm::DetSet<SiStripRawDigi> > sorted_and_merged;
-	sorted_and_merged.reserve( std::min(cm_work_registry_.size(), size_t(17000)) );
+	sorted_and_merged.reserve( std::min(work_.cm_registry.size(), size_t(17000)) );
     
 	bool errorInData = false;
-	std::vector<Registry>::iterator it = cm_work_registry_.begin(), it2, end = cm_work_registry_.end();
+	std::vector<Registry>::iterator it = work_.cm_registry.begin(), it2, end = work_.cm_registry.end();
 	while (it < end) {
 	  sorted_and_merged.push_back( edm::DetSet<SiStripRawDigi>(it->detid) );
 	  std::vector<SiStripRawDigi> & digis = sorted_and_merged.back().data;
@@ -820,7 +870,7 @@ namespace sistrip {
 	  for (it2 = it+0; (it2 != end) && (it2->detid == it->detid); ++it2) {
 	    // data corruption. DO NOT 'break' here
 	    if (it->length != 2)  { isDetOk = false; continue; } 
-	    std::copy( & cm_work_digis_[it2->index], & cm_work_digis_[it2->index + it2->length], & digis[it2->first] );
+	    std::copy( & work_.cm_digis[it2->index], & work_.cm_digis[it2->index + it2->length], & digis[it2->first] );
 	  }
 	  if (!isDetOk) { errorInData = true; digis.clear(); it = it2; continue; } // skip whole det
 	  it = it2;
@@ -852,12 +902,8 @@ namespace sistrip {
   void RawToDigiUnpacker::cleanupWorkVectors() {
     // Clear working areas and registries
     
-    localRA.update(zs_work_digis_.size());
-    zs_work_registry_.clear();      zs_work_digis_.clear(); zs_work_digis_.shrink_to_fit(); assert(zs_work_digis_.capacity()==0);
-    virgin_work_registry_.clear();  virgin_work_digis_.clear();
-    proc_work_registry_.clear();    proc_work_digis_.clear();
-    scope_work_registry_.clear();   scope_work_digis_.clear();
-    cm_work_registry_.clear();      cm_work_digis_.clear();
+    localRA.update(work_.zs_digis.size());
+    work_.clear(); work_.zs_digis.shrink_to_fit(); assert(work_.zs_digis.capacity()==0);
   }
 
   void RawToDigiUnpacker::triggerFed( const FEDRawDataCollection& buffers, SiStripEventSummary& summary, const uint32_t& event ) {
@@ -65,6 +65,9 @@ namespace sistrip {
 
     inline void legacy( bool );
 
+    /// unpacks the FEDs in parallel (not when the EventSummary is read from the DAQ registers)
+    inline void parallelFeds( bool );
+
   private:
     
     /// fill DetSetVectors using registries
@@ -111,6 +114,19 @@ namespace sistrip {
       size_t index;
       uint16_t length;
     };
+
+    /// registries and digi collections filled while unpacking
+    struct WorkVectors {
+      std::vector<Registry> zs_registry, virgin_registry, scope_registry, proc_registry, cm_registry;
+      std::vector<SiStripDigi> zs_digis;
+      std::vector<SiStripRawDigi> virgin_digis, scope_digis, proc_digis, cm_digis;
+      /// appends the content of other, shifting its registry indices
+      void append( const WorkVectors& other );
+      void clear();
+    };
+
+    /// unpacks the channels of one FED
+    void unpackFed( uint16_t fed_id, const FEDRawData&, const SiStripFedCabling&, SiStripEventSummary&, bool& first_fed, WorkVectors&, DetIdCollection& );
     
     /// configurables
     int16_t headerBytes_;
@@ -132,20 +148,14 @@ namespace sistrip {
     bool doAPVEmulatorCheck_;
     bool legacy_;
     uint32_t errorThreshold_;
+    bool parallelFeds_;
     
-    /// registries
-    std::vector<Registry> zs_work_registry_;
-    std::vector<Registry> virgin_work_registry_;
-    std::vector<Registry> scope_work_registry_;
-    std::vector<Registry> proc_work_registry_;
-    std::vector<Registry> cm_work_registry_;
-    
-    /// digi collections
-    std::vector<SiStripDigi> zs_work_digis_;
-    std::vector<SiStripRawDigi> virgin_work_digis_; 
-    std::vector<SiStripRawDigi> scope_work_digis_; 
-    std::vector<SiStripRawDigi> proc_work_digis_;
-    std::vector<SiStripRawDigi> cm_work_digis_;
+    /// registries and digi collections
+    WorkVectors work_;
+
+    /// per FED registries, digi collections and bad modules, for parallel unpacking
+    std::vector<WorkVectors> fedWork_;
+    std::vector<DetIdCollection> fedDetIds_;
   };
   
 }
@@ -185,6 +195,8 @@ void sistrip::RawToDigiUnpacker::doAPVEmulatorCheck( bool do_APVEmulator_check)
 
 void sistrip::RawToDigiUnpacker::legacy( bool legacy ) { legacy_ = legacy; }
 
+void sistrip::RawToDigiUnpacker::parallelFeds( bool parallel ) { parallelFeds_ = parallel; }
+
 #endif // EventFilter_SiStripRawToDigi_SiStripRawToDigiUnpacker_H
 
 
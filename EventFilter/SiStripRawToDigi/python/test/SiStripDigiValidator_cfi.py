@@ -6,5 +6,6 @@ DigiValidator = cms.EDAnalyzer(
     TagCollection2 = cms.untracked.InputTag("siStripDigis","ZeroSuppressed"),
     RawCollection1 = cms.untracked.bool(False),
     RawCollection2 = cms.untracked.bool(False),
+    ThrowOnDifferences = cms.untracked.bool(False),
     )
 
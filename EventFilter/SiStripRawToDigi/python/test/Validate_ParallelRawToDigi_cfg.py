@@ -0,0 +1,79 @@
+import FWCore.ParameterSet.Config as cms
+
+# Unpacks the same FED buffers with the serial FED loop of
+# SiStripRawToDigiModule and with ParallelFEDs = True, in zero-suppressed
+# and virgin raw modes, and fails if the digis are not identical.
+
+process = cms.Process("ParallelRawToDigi")
+
+# ---- Data source ----
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(10) )
+
+# ---- Services ----
+process.load("FWCore.MessageService.MessageLogger_cfi")
+
+# ---- Conditions ----
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc', '')
+
+# ---- Digi sources ----
+process.load("EventFilter.SiStripRawToDigi.test.SiStripTrivialDigiSource_cfi")
+process.vrDigiSource = process.DigiSource.clone(
+    FedRawDataMode = True,
+    PedestalLevel = 100
+    )
+
+# ---- DigiToRaw ----
+process.load("EventFilter.SiStripRawToDigi.SiStripDigiToRaw_cfi")
+process.SiStripDigiToRaw.InputModuleLabel = 'DigiSource'
+process.SiStripDigiToRaw.InputDigiLabel = ''
+process.vrSiStripDigiToRaw = process.SiStripDigiToRaw.clone(
+    InputModuleLabel = 'vrDigiSource',
+    FedReadoutMode = 'VIRGIN_RAW'
+    )
+
+# ---- RawToDigi, serial and parallel ----
+process.load("EventFilter.SiStripRawToDigi.SiStripDigis_cfi")
+process.siStripDigis.ProductLabel = 'SiStripDigiToRaw'
+process.parallelSiStripDigis = process.siStripDigis.clone(
+    ParallelFEDs = cms.untracked.bool(True)
+    )
+process.vrSiStripDigis = process.siStripDigis.clone(
+    ProductLabel = 'vrSiStripDigiToRaw'
+    )
+process.vrParallelSiStripDigis = process.vrSiStripDigis.clone(
+    ParallelFEDs = cms.untracked.bool(True)
+    )
+
+# ---- Validation ----
+process.load("EventFilter.SiStripRawToDigi.test.SiStripDigiValidator_cfi")
+process.DigiValidator.TagCollection1 = "siStripDigis:ZeroSuppressed"
+process.DigiValidator.TagCollection2 = "parallelSiStripDigis:ZeroSuppressed"
+process.DigiValidator.ThrowOnDifferences = True
+process.vrDigiValidator = process.DigiValidator.clone(
+    TagCollection1 = "vrSiStripDigis:VirginRaw",
+    TagCollection2 = "vrParallelSiStripDigis:VirginRaw",
+    RawCollection1 = True,
+    RawCollection2 = True
+    )
+
+# ---- Sequence ----
+process.p = cms.Path(
+    process.DigiSource *
+    process.SiStripDigiToRaw *
+    process.siStripDigis *
+    process.parallelSiStripDigis *
+    process.DigiValidator *
+    process.vrDigiSource *
+    process.vrSiStripDigiToRaw *
+    process.vrSiStripDigis *
+    process.vrParallelSiStripDigis *
+    process.vrDigiValidator
+    )
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(1)
+    )
@@ -1,12 +1,14 @@
 #include "EventFilter/SiStripRawToDigi/test/plugins/SiStripDigiValidator.h"
 #include "DataFormats/Common/interface/Handle.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 SiStripDigiValidator::SiStripDigiValidator(const edm::ParameterSet& conf)
   : tag1_(conf.getUntrackedParameter<edm::InputTag>("TagCollection1")),
     tag2_(conf.getUntrackedParameter<edm::InputTag>("TagCollection2")),
     raw1_(conf.getUntrackedParameter<bool>("RawCollection1")),
     raw2_(conf.getUntrackedParameter<bool>("RawCollection2")),
+    throw_(conf.getUntrackedParameter<bool>("ThrowOnDifferences",false)),
     errors_(false),
     header_()
 {
@@ -55,6 +57,7 @@ void SiStripDigiValidator::endJob()
   else { ss << "Differences were found" << std::endl; }
 
   if (!errors_) { edm::LogVerbatim("SiStripDigiValidator") << ss.str(); }
+  else if (throw_) { throw cms::Exception("SiStripDigiValidator") << ss.str(); }
   else { edm::LogError("SiStripDigiValidator") << ss.str(); }
 
 }
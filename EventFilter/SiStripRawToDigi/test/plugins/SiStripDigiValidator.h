@@ -47,6 +47,8 @@ class SiStripDigiValidator : public edm::EDAnalyzer {
   edm::InputTag tag2_;
   bool raw1_;
   bool raw2_;
+  //fail the job, e.g. in unit tests, instead of only reporting the differences
+  bool throw_;
   //used to remember if there have been errors for message in endJob
   bool errors_;
 
@@ -45,7 +45,7 @@ namespace evf {
     //virtual void beginRun(edm::RunForOutput const&);
     void beginJob() override;
     void beginLuminosityBlock(edm::LuminosityBlockForOutput const&) override;
-    void endLuminosityBlock(edm::LuminosityBlockForOutput const&) override;
+    void closeLuminosityBlock(edm::LuminosityBlockForOutput const&) override;
 
   private:
     std::auto_ptr<Consumer> c_;
@@ -282,7 +282,7 @@ namespace evf {
   }
 
   template<typename Consumer>
-  void RecoEventOutputModuleForFU<Consumer>::endLuminosityBlock(edm::LuminosityBlockForOutput const& ls)
+  void RecoEventOutputModuleForFU<Consumer>::closeLuminosityBlock(edm::LuminosityBlockForOutput const& ls)
   {
     //edm::LogInfo("RecoEventOutputModuleForFU") << "end lumi";
     long filesize=0;
@@ -91,6 +91,16 @@ namespace edm {
     void consumesMany(const TypeToGet& id) {
       m_consumer->consumesMany<B>(id);
     }
+
+    template <typename ProductType, typename Record>
+    void esConsumes(ESInputTag const& tag) {
+      m_consumer->esConsumes<ProductType, Record>(tag);
+    }
+
+    template <typename ProductType, typename Record>
+    void esConsumes() {
+      m_consumer->esConsumes<ProductType, Record>();
+    }
     
 
   private:
@@ -21,12 +21,16 @@
 
 // system include files
 #include <atomic>
+#include <exception>
 
 // user include files
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
 #include "FWCore/Utilities/interface/thread_safety_macros.h"
 
 // forward declarations
 namespace edm {
+   class WaitingTask;
+
    namespace eventsetup {
       struct ComponentDescription;
       class DataKey;
@@ -44,6 +48,13 @@ namespace edm {
          void doGet(EventSetupRecord const& iRecord, DataKey const& iKey, bool iTransiently) const;
          void const* get(EventSetupRecord const&, DataKey const& iKey, bool iTransiently) const;
 
+         /**Makes the data in a separate task if it is not already cached. iTask is
+          run once the data is available, or right away if it already is. Any exception
+          is not passed to iTask but is kept and rethrown when the data is requested
+          with get(). iKey must stay valid until iTask has run.
+          */
+         void prefetchAsync(WaitingTask* iTask, EventSetupRecord const&, DataKey const& iKey) const;
+
          ///returns the description of the DataProxyProvider which owns this Proxy
          ComponentDescription const* providerDescription() const {
             return description_;
@@ -92,6 +103,9 @@ namespace edm {
          CMS_THREAD_SAFE mutable void const* cache_; //protected by a global mutex
          mutable std::atomic<bool> cacheIsValid_;
          mutable std::atomic<bool> nonTransientAccessRequested_;
+         mutable std::atomic<bool> prefetchRequested_;
+         mutable WaitingTaskList waitingTasks_;
+         CMS_THREAD_SAFE mutable std::exception_ptr prefetchException_; //protected by a global mutex
          ComponentDescription const* description_;
       };
    }
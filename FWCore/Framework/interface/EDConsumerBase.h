@@ -24,11 +24,14 @@
 #include <vector>
 #include <array>
 // user include files
+#include "FWCore/Framework/interface/DataKey.h"
+#include "FWCore/Framework/interface/EventSetupRecordKey.h"
 #include "FWCore/Framework/interface/ProductResolverIndexAndSkipBit.h"
 #include "FWCore/ServiceRegistry/interface/ConsumesInfo.h"
 #include "FWCore/Utilities/interface/TypeID.h"
 #include "FWCore/Utilities/interface/TypeToGet.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/ESInputTag.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
 #include "FWCore/Utilities/interface/SoATuple.h"
 #include "DataFormats/Provenance/interface/BranchType.h"
@@ -70,6 +73,10 @@ namespace edm {
 
     std::vector<ProductResolverIndexAndSkipBit> const& itemsToGetFrom(BranchType iType) const { return itemsToGetFromBranch_[iType]; }
 
+    typedef std::pair<eventsetup::EventSetupRecordKey, eventsetup::DataKey> ESItem;
+    ///EventSetup data declared via esConsumes which is prefetched before the module is called for an Event
+    std::vector<ESItem> const& esItemsToGetFromEvent() const { return esItemsToGetFromEvent_; }
+
     ///\return true if the product corresponding to the index was registered via consumes or mayConsume call
     bool registeredToConsume(ProductResolverIndex, bool, BranchType) const;
     
@@ -146,7 +153,24 @@ namespace edm {
       recordConsumes(B,id,edm::InputTag{},true);
     }
 
+    ///declares that the module gets ProductType from Record in each Event, only the data label of the tag is used
+    template <typename ProductType, typename Record>
+    void esConsumes(ESInputTag const& tag) {
+      recordESConsumes(eventsetup::EventSetupRecordKey::makeKey<Record>(),
+                       eventsetup::DataKey::makeTypeTag<ProductType>(),
+                       tag);
+    }
+
+    template <typename ProductType, typename Record>
+    void esConsumes() {
+      esConsumes<ProductType, Record>(ESInputTag{});
+    }
+
   private:
+    void recordESConsumes(eventsetup::EventSetupRecordKey const& iRecord,
+                          eventsetup::TypeTag const& iType,
+                          ESInputTag const& iTag);
+
     unsigned int recordConsumes(BranchType iBranch, TypeToGet const& iType, edm::InputTag const& iTag, bool iAlwaysGets);
 
     void throwTypeMismatch(edm::TypeID const&, EDGetToken) const;
@@ -190,6 +214,8 @@ namespace edm {
 
     std::array<std::vector<ProductResolverIndexAndSkipBit>, edm::NumBranchTypes> itemsToGetFromBranch_;
 
+    std::vector<ESItem> esItemsToGetFromEvent_;
+
     bool frozen_;
     bool containsCurrentProcessAlias_;
   };
@@ -36,8 +36,10 @@
 
 namespace edm {
    class ESInputTag;
+   class WaitingTask;
    
    namespace eventsetup {
+      class DataKey;
       class EventSetupProvider;
       class EventSetupRecord;
       template<class T> struct data_default_record_trait;
@@ -101,6 +103,11 @@ namespace edm {
         }
    
       const eventsetup::EventSetupRecord* find(const eventsetup::EventSetupRecordKey&) const;
+
+      ///starts making the data if the Record is available. iTask is run once the data is available
+      void prefetchAsync(WaitingTask* iTask,
+                         const eventsetup::EventSetupRecordKey&,
+                         const eventsetup::DataKey&) const;
       
       ///clears the oToFill vector and then fills it with the keys for all available records
       void fillAvailableRecordKeys(std::vector<eventsetup::EventSetupRecordKey>& oToFill) const;
@@ -72,6 +72,7 @@ namespace edm {
    class ESHandleExceptionFactory;
    class ESInputTag;
    class EventSetup;
+   class WaitingTask;
 
    namespace eventsetup {
       struct ComponentDescription;
@@ -148,6 +149,9 @@ namespace edm {
          ///returns false if no data available for key
          bool doGet(DataKey const& aKey, bool aGetTransiently = false) const;
 
+         ///starts making the data for aKey, if any, without waiting for it. iTask is run once the data is available
+         void prefetchAsync(WaitingTask* iTask, DataKey const& aKey) const;
+
          /**returns true only if someone has already requested data for this key
           and the data was retrieved
           */
@@ -55,10 +55,12 @@ Some examples of InputSource subclasses may be:
 #include <string>
 #include <chrono>
 #include <mutex>
+#include <vector>
 
 namespace edm {
   class ActivityRegistry;
   class BranchIDListHelper;
+  class BranchKey;
   class ConfigurationDescriptions;
   class HistoryAppender;
   class ParameterSet;
@@ -183,6 +185,10 @@ namespace edm {
     /// Returns nullptr if no resource shared between the Source and a DelayedReader
     std::pair<SharedResourcesAcquirer*,std::recursive_mutex*> resourceSharedWithDelayedReader();
 
+    /// Called by framework before beginJob with the keys of the Event products
+    /// provided by the source which are consumed by at least one module
+    void setConsumedEventProducts(std::vector<BranchKey> const& iKeys);
+
     /// Accessor for maximum number of events to be read.
     /// -1 is used for unlimited.
     int maxEvents() const {return maxEvents_;}
@@ -403,6 +409,7 @@ namespace edm {
     virtual void beginJob();
     virtual void endJob();
     virtual std::pair<SharedResourcesAcquirer*,std::recursive_mutex*> resourceSharedWithDelayedReader_();
+    virtual void setConsumedEventProducts_(std::vector<BranchKey> const&) {}
 
     virtual bool randomAccess_() const;
     virtual ProcessingController::ForwardState forwardState_() const;
@@ -22,6 +22,7 @@
 
 namespace edm {
 
+  class BranchKey;
   class ModuleDescription;
   class ProductRegistry;
   class Schedule;
@@ -72,5 +73,10 @@ namespace edm {
   void
   checkForModuleDependencyCorrectness(edm::PathsAndConsumesOfModulesBase const& iPnC,
                                       bool iPrintDependencies);
+
+  ///keys of the Event products which were not made in this process and which some module consumes
+  std::vector<BranchKey>
+  consumedEventProductsFromInput(edm::PathsAndConsumesOfModulesBase const& iPnC,
+                                 ProductRegistry const& iRegistry);
 }
 #endif
@@ -69,6 +69,7 @@
 #include "FWCore/Framework/src/GlobalSchedule.h"
 #include "FWCore/Framework/src/StreamSchedule.h"
 #include "FWCore/Framework/src/SystemTimeKeeper.h"
+#include "FWCore/Framework/src/CriticalPathScheduler.h"
 #include "FWCore/Framework/src/PreallocationConfiguration.h"
 #include "FWCore/MessageLogger/interface/ExceptionMessages.h"
 #include "FWCore/MessageLogger/interface/JobReport.h"
@@ -113,6 +114,7 @@ namespace edm {
   class PathStatusInserter;
   class EndPathStatusInserter;
   class WaitingTaskHolder;
+  class PathsAndConsumesOfModulesBase;
 
   
   class Schedule {
@@ -155,6 +157,10 @@ namespace edm {
                                bool cleaningUpAfterException = false);
 
     void beginJob(ProductRegistry const&);
+
+    /// Computes the module ranks if 'criticalPathScheduling' was requested in the options.
+    /// Must be called after the consumes information has been checked.
+    void initializeCriticalPathScheduling(PathsAndConsumesOfModulesBase const&);
     void endJob(ExceptionCollector & collector);
     
     void beginStream(unsigned int);
@@ -289,6 +295,7 @@ namespace edm {
     PreallocationConfiguration           preallocConfig_;
 
     edm::propagate_const<std::unique_ptr<SystemTimeKeeper>> summaryTimeKeeper_;
+    edm::propagate_const<std::unique_ptr<CriticalPathScheduler>> criticalPathScheduler_;
 
     std::vector<std::string> const* pathNames_;
     std::vector<std::string> const* endPathNames_;
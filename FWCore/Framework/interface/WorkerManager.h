@@ -74,6 +74,8 @@ namespace edm {
     
     AllWorkers const& allWorkers() const {return allWorkers_;}
 
+    UnscheduledCallProducer const& unscheduledWorkers() const {return unscheduled_;}
+
     void addToAllWorkers(Worker* w);
 
     ExceptionToActionTable const&  actionTable() const {return *actionTable_;}
@@ -85,6 +85,7 @@ namespace edm {
       void itemsToGet(BranchType, std::vector<ProductResolverIndexAndSkipBit>&) const;
       void itemsMayGet(BranchType, std::vector<ProductResolverIndexAndSkipBit>&) const;
       std::vector<ProductResolverIndexAndSkipBit> const& itemsToGetFrom(BranchType) const;
+      std::vector<EDConsumerBase::ESItem> const& esItemsToGetFromEvent() const;
 
       void updateLookup(BranchType iBranchType,
                         ProductResolverIndexHelper const&,
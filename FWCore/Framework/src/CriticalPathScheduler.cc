@@ -0,0 +1,212 @@
+// -*- C++ -*-
+//
+// Package:     FWCore/Framework
+// Class  :     CriticalPathScheduler
+//
+// Implementation:
+//     The ranks are computed once at beginJob from the consumes information.
+//  Only the event makespan is measured while processing.
+//
+
+// system include files
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+
+// user include files
+#include "CriticalPathScheduler.h"
+#include "DataFormats/Provenance/interface/ModuleDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/PathsAndConsumesOfModulesBase.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+
+using namespace edm;
+
+namespace {
+  enum class Visit {kNotVisited, kVisiting, kDone};
+}
+
+//
+// static data member definitions
+//
+const char* const CriticalPathScheduler::kOptionName = "criticalPathScheduling";
+
+//
+// constructors and destructor
+//
+CriticalPathScheduler::CriticalPathScheduler(ParameterSet const& iPSet, unsigned int iNumStreams):
+defaultModuleCost_(iPSet.getUntrackedParameter<double>("defaultModuleCost", 0.001)),
+referenceEventTime_(iPSet.getUntrackedParameter<double>("referenceEventTime", 0.)),
+criticalPathLength_(0.),
+serialLength_(0.),
+streamEventTimes_(iNumStreams, 0.),
+streamNumberOfEvents_(iNumStreams, 0)
+{
+  ParameterSet const& costs = iPSet.getUntrackedParameterSet("moduleCosts", ParameterSet());
+  for(auto const& label: costs.getParameterNamesForType<double>(false)) {
+    double c = costs.getUntrackedParameter<double>(label);
+    if(c < 0.) {
+      throw Exception(errors::Configuration)
+        << "The cost given in 'criticalPathScheduling.moduleCosts' for module '"<<label<<"' is negative.";
+    }
+    moduleCosts_.emplace(label, c);
+  }
+  streamEventTimers_.reserve(iNumStreams);
+  for(unsigned int i = 0; i < iNumStreams; ++i) {
+    streamEventTimers_.emplace_back();
+  }
+}
+
+//
+// member functions
+//
+void
+CriticalPathScheduler::initialize(PathsAndConsumesOfModulesBase const& iPnC) {
+  unsigned int maxID = 0;
+  for(auto const* desc: iPnC.allModules()) {
+    maxID = std::max(maxID, desc->id());
+  }
+  ranks_.assign(maxID+1, -1.);
+  orderedModuleIDs_.clear();
+
+  //modules which will be needed by some module on a Path or EndPath
+  std::vector<bool> needed(maxID+1, false);
+  std::vector<unsigned int> toVisit;
+  for(unsigned int i = 0; i < iPnC.paths().size(); ++i) {
+    for(auto const* desc: iPnC.modulesOnPath(i)) {
+      toVisit.push_back(desc->id());
+    }
+  }
+  for(unsigned int i = 0; i < iPnC.endPaths().size(); ++i) {
+    for(auto const* desc: iPnC.modulesOnEndPath(i)) {
+      toVisit.push_back(desc->id());
+    }
+  }
+  while(not toVisit.empty()) {
+    auto id = toVisit.back();
+    toVisit.pop_back();
+    if(needed[id]) { continue; }
+    needed[id] = true;
+    for(auto const* desc: iPnC.modulesWhoseProductsAreConsumedBy(id)) {
+      toVisit.push_back(desc->id());
+    }
+  }
+
+  //invert the consumes graph so we can walk from a producer to its consumers
+  std::vector<std::vector<unsigned int>> consumers(maxID+1);
+  for(auto const* desc: iPnC.allModules()) {
+    if(not needed[desc->id()]) { continue; }
+    for(auto const* producer: iPnC.modulesWhoseProductsAreConsumedBy(desc->id())) {
+      consumers[producer->id()].push_back(desc->id());
+    }
+  }
+
+  std::vector<double> costs(maxID+1, 0.);
+  for(auto const* desc: iPnC.allModules()) {
+    costs[desc->id()] = cost(desc->moduleLabel());
+  }
+
+  //rank = own cost + largest rank of any consumer, computed depth first.
+  // Cycles were already rejected by checkForModuleDependencyCorrectness.
+  std::vector<Visit> state(maxID+1, Visit::kNotVisited);
+  std::vector<std::pair<unsigned int, unsigned int>> stack;
+  for(auto const* desc: iPnC.allModules()) {
+    auto start = desc->id();
+    if(not needed[start] or state[start] == Visit::kDone) { continue; }
+    stack.emplace_back(start, 0);
+    state[start] = Visit::kVisiting;
+    while(not stack.empty()) {
+      auto& top = stack.back();
+      auto const& next = consumers[top.first];
+      if(top.second < next.size()) {
+        auto c = next[top.second++];
+        if(state[c] == Visit::kNotVisited) {
+          state[c] = Visit::kVisiting;
+          stack.emplace_back(c, 0);
+        } else {
+          assert(state[c] == Visit::kDone);
+        }
+        continue;
+      }
+      double downstream = 0.;
+      for(auto c: next) {
+        downstream = std::max(downstream, ranks_[c]);
+      }
+      ranks_[top.first] = costs[top.first] + downstream;
+      state[top.first] = Visit::kDone;
+      stack.pop_back();
+    }
+  }
+
+  criticalPathLength_ = 0.;
+  serialLength_ = 0.;
+  for(unsigned int id = 0; id <= maxID; ++id) {
+    if(not needed[id]) { continue; }
+    orderedModuleIDs_.push_back(id);
+    criticalPathLength_ = std::max(criticalPathLength_, ranks_[id]);
+    serialLength_ += costs[id];
+  }
+  std::stable_sort(orderedModuleIDs_.begin(), orderedModuleIDs_.end(),
+                   [this](unsigned int iLHS, unsigned int iRHS) {
+                     return ranks_[iLHS] < ranks_[iRHS];
+                   });
+}
+
+double
+CriticalPathScheduler::rank(unsigned int iModuleID) const {
+  if(iModuleID < ranks_.size()) {
+    return ranks_[iModuleID];
+  }
+  return -1.;
+}
+
+double
+CriticalPathScheduler::cost(std::string const& iLabel) const {
+  auto itFound = moduleCosts_.find(iLabel);
+  if(itFound == moduleCosts_.end()) {
+    return defaultModuleCost_;
+  }
+  return itFound->second;
+}
+
+void
+CriticalPathScheduler::startEvent(StreamID iID) {
+  auto& timer = streamEventTimers_[iID.value()];
+  timer.reset();
+  timer.start();
+}
+
+void
+CriticalPathScheduler::stopEvent(StreamID iID) {
+  auto const i = iID.value();
+  streamEventTimes_[i] += streamEventTimers_[i].stop();
+  ++streamNumberOfEvents_[i];
+}
+
+void
+CriticalPathScheduler::printReport(std::string const& iProcessName) const {
+  double totalTime = 0.;
+  unsigned int totalEvents = 0;
+  for(unsigned int i = 0; i < streamEventTimes_.size(); ++i) {
+    totalTime += streamEventTimes_[i];
+    totalEvents += streamNumberOfEvents_[i];
+  }
+  double const makespan = totalEvents == 0 ? 0. : totalTime/totalEvents;
+
+  LogVerbatim l("CriticalPathReport");
+  l << "CriticalPathReport Process: " << iProcessName << "\n"
+    << "CriticalPathReport ---------- Event Makespan Summary [sec] ----\n"
+    << "CriticalPathReport  Modules needed by Paths = " << orderedModuleIDs_.size() << "\n"
+    << "CriticalPathReport  Estimated serial time per event = " << std::setprecision(6) << serialLength_ << "\n"
+    << "CriticalPathReport  Estimated critical path per event = " << criticalPathLength_ << "\n"
+    << "CriticalPathReport  Measured makespan per event = " << makespan << " (" << totalEvents << " events)";
+  if(serialLength_ > 0.) {
+    l << "\nCriticalPathReport  Measured makespan / estimated serial time = " << makespan/serialLength_;
+  }
+  if(referenceEventTime_ > 0.) {
+    l << "\nCriticalPathReport  Makespan reduction w.r.t. reference = "
+      << std::setprecision(3) << 100.*(referenceEventTime_ - makespan)/referenceEventTime_ << "%";
+  }
+}
@@ -0,0 +1,105 @@
+#ifndef FWCore_Framework_CriticalPathScheduler_h
+#define FWCore_Framework_CriticalPathScheduler_h
+// -*- C++ -*-
+//
+// Package:     FWCore/Framework
+// Class  :     CriticalPathScheduler
+//
+/**\class CriticalPathScheduler CriticalPathScheduler.h "CriticalPathScheduler.h"
+
+ Description: Orders unscheduled producers by the length of their remaining critical path
+
+ Usage:
+    Enabled by adding to the process options
+ \code
+    criticalPathScheduling = cms.untracked.PSet(
+      moduleCosts = cms.untracked.PSet(
+        siPixelClusters = cms.untracked.double(0.004),
+        ...),
+      defaultModuleCost = cms.untracked.double(0.001),
+      referenceEventTime = cms.untracked.double(0.)
+    )
+ \endcode
+ All costs are given in seconds per event, e.g. taken from the 'TimeReport'
+ of a prior job.
+
+ Once the module dependency graph is known, each module which is transitively
+ consumed by a module on a Path or EndPath is assigned a rank which is its own
+ cost plus the largest rank of any module consuming its products. At the start
+ of each event the StreamSchedule requests the unscheduled producers in order
+ of increasing rank so that the module heading the longest remaining chain is
+ the last task spawned and therefore the first one run by the stream's thread.
+
+ NOTE: modules are started even if a filter on the Path consuming their data
+ would have rejected the event, so this mode trades extra work in rejected
+ events for a shorter latency of accepted ones.
+
+*/
+
+// system include files
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// user include files
+#include "FWCore/Utilities/interface/WallclockTimer.h"
+
+// forward declarations
+namespace edm {
+  class ParameterSet;
+  class PathsAndConsumesOfModulesBase;
+  class StreamID;
+
+  class CriticalPathScheduler
+  {
+  public:
+    CriticalPathScheduler(ParameterSet const& iPSet, unsigned int iNumStreams);
+
+    // ---------- const member functions ---------------------
+    ///module IDs ordered by increasing rank, i.e. in the order they should be requested
+    std::vector<unsigned int> const& orderedModuleIDs() const { return orderedModuleIDs_; }
+
+    double rank(unsigned int iModuleID) const;
+
+    ///length of the longest chain of dependent modules, in seconds
+    double criticalPathLength() const { return criticalPathLength_; }
+    ///sum of the costs of all modules needed by the Paths and EndPaths, in seconds
+    double serialLength() const { return serialLength_; }
+
+    void printReport(std::string const& iProcessName) const;
+
+    // ---------- static member functions --------------------
+    static const char* const kOptionName;
+
+    // ---------- member functions ---------------------------
+    void initialize(PathsAndConsumesOfModulesBase const& iPnC);
+
+    void startEvent(StreamID);
+    void stopEvent(StreamID);
+
+  private:
+    CriticalPathScheduler(const CriticalPathScheduler&) = delete; // stop default
+
+    const CriticalPathScheduler& operator=(const CriticalPathScheduler&) = delete; // stop default
+
+    double cost(std::string const& iLabel) const;
+
+    // ---------- member data --------------------------------
+    std::unordered_map<std::string, double> moduleCosts_;
+    double defaultModuleCost_;
+    double referenceEventTime_;
+
+    //indexed by module ID, negative if the module is not needed
+    std::vector<double> ranks_;
+    std::vector<unsigned int> orderedModuleIDs_;
+    double criticalPathLength_;
+    double serialLength_;
+
+    //each stream only touches its own entries
+    std::vector<WallclockTimer> streamEventTimers_;
+    std::vector<double> streamEventTimes_;
+    std::vector<unsigned int> streamNumberOfEvents_;
+  };
+}
+
+#endif
@@ -18,6 +18,9 @@
 #include "FWCore/Framework/interface/ComponentDescription.h"
 #include "FWCore/Framework/interface/MakeDataException.h"
 #include "FWCore/Framework/interface/EventSetupRecord.h"
+#include "FWCore/Concurrency/interface/SerialTaskQueue.h"
+#include "FWCore/Concurrency/interface/WaitingTask.h"
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
 
 
 //
@@ -26,6 +29,8 @@
 namespace edm {
    namespace eventsetup {
      static std::recursive_mutex s_esGlobalMutex;
+     //prefetches wait here for their turn instead of in a thread blocked on s_esGlobalMutex
+     static SerialTaskQueue s_prefetchQueue;
 //
 // static data member definitions
 //
@@ -43,6 +48,7 @@ DataProxy::DataProxy() :
    cache_(nullptr),
    cacheIsValid_(false),
    nonTransientAccessRequested_(false),
+   prefetchRequested_(false),
    description_(dummyDescription())
 {
 }
@@ -75,6 +81,10 @@ void DataProxy::clearCacheIsValid() {
    cacheIsValid_.store(false, std::memory_order_release);
    nonTransientAccessRequested_.store(false, std::memory_order_release);
    cache_ = nullptr;
+   //caches are only cleared at transition boundaries so no prefetch can be outstanding
+   waitingTasks_.reset();
+   prefetchRequested_.store(false, std::memory_order_release);
+   prefetchException_ = std::exception_ptr{};
 }
       
 void 
@@ -117,6 +127,10 @@ DataProxy::get(const EventSetupRecord& iRecord, const DataKey& iKey, bool iTrans
       nonTransientAccessRequested_.store(true, std::memory_order_release);
    }
 
+   //the data failed to be made while prefetching, report it as if made now
+   if(prefetchException_) {
+      std::rethrow_exception(prefetchException_);
+   }
    if(nullptr == cache_) {
       throwMakeException(iRecord, iKey);
    }
@@ -126,6 +140,42 @@ DataProxy::get(const EventSetupRecord& iRecord, const DataKey& iKey, bool iTrans
 void DataProxy::doGet(const EventSetupRecord& iRecord, const DataKey& iKey, bool iTransiently) const {
    get(iRecord, iKey, iTransiently);
 }
+
+void
+DataProxy::prefetchAsync(WaitingTask* iTask, const EventSetupRecord& iRecord, const DataKey& iKey) const
+{
+   if(cacheIsValid()) {
+      //nothing to wait for, same as adding to a WaitingTaskList which is done waiting
+      iTask->increment_ref_count();
+      if(0 == iTask->decrement_ref_count()) {
+         tbb::task::spawn(*iTask);
+      }
+      return;
+   }
+   waitingTasks_.add(iTask);
+   bool expected = false;
+   if(prefetchRequested_.compare_exchange_strong(expected, true)) {
+      //The data is made in a task of a serial queue so that the threads which requested it
+      // do other work, and at most one thread at a time waits for the global mutex.
+      auto token = ServiceRegistry::instance().presentToken();
+      s_prefetchQueue.push([this, &iRecord, &iKey, token]() {
+         ServiceRegistry::Operate guard(token);
+         try {
+            //Transient so that prefetching alone does not extend the lifetime of the data
+            get(iRecord, iKey, true);
+         } catch(...) {
+            //keep the exception for get() rather than making the data a second time, unless
+            // a synchronous get() retried and made the data before we got the lock
+            std::lock_guard<std::recursive_mutex> lock(s_esGlobalMutex);
+            if(!cacheIsValid()) {
+               prefetchException_ = std::current_exception();
+               cacheIsValid_.store(true, std::memory_order_release);
+            }
+         }
+         waitingTasks_.doneWaiting(std::exception_ptr{});
+      });
+   }
+}
       
       
 //
@@ -84,6 +84,17 @@ EDConsumerBase::checkIfEmpty(edm::InputTag const& iTag) {
   return iTag;
 }
 
+void
+EDConsumerBase::recordESConsumes(eventsetup::EventSetupRecordKey const& iRecord,
+                                 eventsetup::TypeTag const& iType,
+                                 ESInputTag const& iTag) {
+  eventsetup::DataKey key(iType, iTag.data().c_str());
+  ESItem item(iRecord, key);
+  if(std::find(esItemsToGetFromEvent_.begin(), esItemsToGetFromEvent_.end(), item) == esItemsToGetFromEvent_.end()) {
+    esItemsToGetFromEvent_.push_back(item);
+  }
+}
+
 unsigned int
 EDConsumerBase::recordConsumes(BranchType iBranch, TypeToGet const& iType, edm::InputTag const& iTag, bool iAlwaysGets) {
 
@@ -92,6 +92,17 @@ EventSetup::find(const eventsetup::EventSetupRecordKey& iKey) const
    return itFind->second;
 }
 
+void
+EventSetup::prefetchAsync(WaitingTask* iTask,
+                          const eventsetup::EventSetupRecordKey& iRecordKey,
+                          const eventsetup::DataKey& iDataKey) const
+{
+   auto const* record = find(iRecordKey);
+   if(nullptr != record) {
+      record->prefetchAsync(iTask, iDataKey);
+   }
+}
+
 void 
 EventSetup::fillAvailableRecordKeys(std::vector<eventsetup::EventSetupRecordKey>& oToFill) const
 {
@@ -205,6 +205,15 @@ EventSetupRecord::find(const DataKey& iKey) const
    return nullptr;
 }
       
+void
+EventSetupRecord::prefetchAsync(WaitingTask* iTask, const DataKey& aKey) const {
+   Proxies::const_iterator entry(proxies_.find(aKey));
+   if(entry != proxies_.end()) {
+      //use the key held by the Record since it outlives the prefetch
+      entry->second->prefetchAsync(iTask, *this, entry->first);
+   }
+}
+
 bool 
 EventSetupRecord::doGet(const DataKey& aKey, bool aGetTransiently) const {
    const DataProxy* proxy = find(aKey);
@@ -225,6 +225,11 @@ namespace edm {
     return resourceSharedWithDelayedReader_();
   }
 
+  void
+  InputSource::setConsumedEventProducts(std::vector<BranchKey> const& iKeys) {
+    setConsumedEventProducts_(iKeys);
+  }
+
   std::pair<SharedResourcesAcquirer*,std::recursive_mutex*>
   InputSource::resourceSharedWithDelayedReader_() {
     return std::pair<SharedResourcesAcquirer*,std::recursive_mutex*>(nullptr,nullptr);
@@ -4,9 +4,13 @@
 #include "FWCore/Framework/src/Worker.h"
 #include "throwIfImproperDependencies.h"
 
+#include "DataFormats/Provenance/interface/BranchKey.h"
+#include "DataFormats/Provenance/interface/ProductRegistry.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 
 #include <algorithm>
+#include <set>
+#include <unordered_map>
 namespace edm {
 
   PathsAndConsumesOfModules::~PathsAndConsumesOfModules() {
@@ -347,4 +351,58 @@ namespace edm {
     }
     graph::throwIfImproperDependencies(edgeToPathMap,pathIndexToModuleIndexOrder,pathNames,moduleIndexToNames);
   }
+
+  std::vector<BranchKey>
+  consumedEventProductsFromInput(edm::PathsAndConsumesOfModulesBase const& iPnC,
+                                 ProductRegistry const& iRegistry) {
+    //index the products coming from the input by module label so each consumes
+    // only needs to look at the few products with the same label
+    std::unordered_map<std::string, std::vector<BranchDescription const*>> labelToProducts;
+    std::vector<BranchDescription const*> allProducts;
+    for(auto const& item : iRegistry.productList()) {
+      BranchDescription const& desc = item.second;
+      if(desc.branchType() != InEvent or desc.produced() or desc.dropped()) {
+        continue;
+      }
+      labelToProducts[desc.moduleLabel()].push_back(&desc);
+      allProducts.push_back(&desc);
+    }
+
+    std::set<BranchKey> keys;
+    for(auto const* module : iPnC.allModules()) {
+      for(auto const& info : iPnC.consumesInfo(module->id())) {
+        if(info.branchType() != InEvent) {
+          continue;
+        }
+        std::vector<BranchDescription const*> const* candidates = &allProducts;
+        if(not info.label().empty()) {
+          auto itFound = labelToProducts.find(info.label());
+          if(itFound == labelToProducts.end()) {
+            continue;
+          }
+          candidates = &itFound->second;
+        }
+        for(auto const* desc : *candidates) {
+          if(not info.label().empty()) {
+            if(desc->productInstanceName() != info.instance()) {
+              continue;
+            }
+            if(not info.process().empty() and desc->processName() != info.process()) {
+              continue;
+            }
+          }
+          //for a View the element type can not be checked here so all products
+          // with a matching label are kept
+          if(info.kindOfType() == PRODUCT_TYPE and desc->unwrappedTypeID() != info.type()) {
+            continue;
+          }
+          if(info.label().empty() and info.kindOfType() != PRODUCT_TYPE) {
+            continue;
+          }
+          keys.insert(BranchKey(*desc));
+        }
+      }
+    }
+    return std::vector<BranchKey>(keys.begin(), keys.end());
+  }
 }
@@ -632,6 +632,13 @@ namespace edm {
       //});
     }
 
+    ParameterSet const& opts = proc_pset.getUntrackedParameterSet("options", ParameterSet());
+    if(opts.existsAs<ParameterSet>(CriticalPathScheduler::kOptionName, false)) {
+      criticalPathScheduler_ = std::make_unique<CriticalPathScheduler>(
+                                 opts.getUntrackedParameterSet(CriticalPathScheduler::kOptionName),
+                                 prealloc.numberOfStreams());
+    }
+
   } // Schedule::Schedule
 
 
@@ -699,6 +706,10 @@ namespace edm {
       return;
     }
 
+    if(criticalPathScheduler_) {
+      criticalPathScheduler_->printReport(streamSchedules_[0]->context().processContext()->processName());
+    }
+
     if (wantSummary_ == false) return;
     {
       TriggerReport tr;
@@ -1023,6 +1034,16 @@ namespace edm {
     globalSchedule_->beginJob(iRegistry);
   }
 
+  void Schedule::initializeCriticalPathScheduling(PathsAndConsumesOfModulesBase const& iPnC) {
+    if(not criticalPathScheduler_) {
+      return;
+    }
+    criticalPathScheduler_->initialize(iPnC);
+    for(auto& s: streamSchedules_) {
+      s->setCriticalPathScheduler(criticalPathScheduler_.get());
+    }
+  }
+
   void Schedule::beginStream(unsigned int iStreamID) {
     assert(iStreamID<streamSchedules_.size());
     streamSchedules_[iStreamID]->beginStream();
@@ -16,6 +16,7 @@
 #include "FWCore/Framework/src/ModuleHolder.h"
 #include "FWCore/Framework/src/WorkerT.h"
 #include "FWCore/Framework/src/ModuleRegistry.h"
+#include "FWCore/Framework/src/CriticalPathScheduler.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
@@ -153,6 +154,7 @@ namespace edm {
     results_inserter_(),
     trig_paths_(),
     end_paths_(),
+    criticalPathScheduler_(nullptr),
     total_events_(),
     total_passed_(),
     number_of_unscheduled_modules_(0),
@@ -570,6 +572,9 @@ namespace edm {
     workerManager_.setupOnDemandSystem(ep,es);
     
     ++total_events_;
+    if(criticalPathScheduler_) {
+      criticalPathScheduler_->startEvent(streamID_);
+    }
     auto serviceToken = ServiceRegistry::instance().presentToken();
     
     auto allPathsDone = make_waiting_task(tbb::task::allocate_root(),
@@ -581,6 +586,9 @@ namespace edm {
                                             if(iPtr) {
                                               ptr = *iPtr;
                                             }
+                                            if(criticalPathScheduler_) {
+                                              criticalPathScheduler_->stopEvent(streamID_);
+                                            }
                                             iTask.doneWaiting(finishProcessOneEvent(ptr));
                                           });
     //The holder guarantees that if the paths finish before the loop ends
@@ -615,6 +623,54 @@ namespace edm {
         it != itEnd; ++ it) {
       it->processOneOccurrenceAsync(pathsDone,ep, es, streamID_, &streamContext_);
     }
+
+    //request these last so the head of the longest chain is the first to run
+    if(criticalPathScheduler_) {
+      startCriticalPathWorkers(allPathsHolder, ep, es);
+    }
+  }
+
+  void
+  StreamSchedule::startCriticalPathWorkers(WaitingTaskHolder iHolder,
+                                           EventPrincipal& ep, EventSetup const& es) {
+    //Any exception is passed on to the modules consuming the products so
+    // it is not propagated here. We only hold the event open until the
+    // workers we started have finished.
+    auto workersDone = make_waiting_task(tbb::task::allocate_root(),
+                                         [iHolder](std::exception_ptr const*) mutable
+                                         {
+                                           iHolder.doneWaiting(std::exception_ptr{});
+                                         });
+    WaitingTaskHolder workersDoneHolder(workersDone);
+
+    ParentContext parentContext(&streamContext_);
+    for(auto worker: criticalPathWorkers_) {
+      worker->doWorkAsync<OccurrenceTraits<EventPrincipal, BranchActionStreamBegin>>(workersDone,
+                                                                                     ep,
+                                                                                     es,
+                                                                                     streamID_,
+                                                                                     parentContext,
+                                                                                     &streamContext_);
+    }
+  }
+
+  void
+  StreamSchedule::setCriticalPathScheduler(CriticalPathScheduler* iScheduler) {
+    criticalPathScheduler_ = iScheduler;
+    criticalPathWorkers_.clear();
+    if(nullptr == iScheduler) {
+      return;
+    }
+    std::map<unsigned int, Worker*> idToWorker;
+    for(auto worker: workerManager_.unscheduledWorkers()) {
+      idToWorker.emplace(worker->description().id(), worker);
+    }
+    for(auto id: iScheduler->orderedModuleIDs()) {
+      auto itFound = idToWorker.find(id);
+      if(itFound != idToWorker.end()) {
+        criticalPathWorkers_.push_back(itFound->second);
+      }
+    }
   }
   
   void
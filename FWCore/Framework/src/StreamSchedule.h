@@ -98,6 +98,7 @@ namespace edm {
 
   class ActivityRegistry;
   class BranchIDListHelper;
+  class CriticalPathScheduler;
   class EventSetup;
   class ExceptionCollector;
   class ExceptionToActionTable;
@@ -262,6 +263,10 @@ namespace edm {
     }
     
     StreamContext const& context() const { return streamContext_;}
+
+    /// Request the unscheduled producers at the start of each event in the
+    /// order given by the CriticalPathScheduler. We do not own the scheduler.
+    void setCriticalPathScheduler(CriticalPathScheduler* iScheduler);
   private:
     //Sentry class to only send a signal if an
     // exception occurs. An exception is identified
@@ -296,6 +301,9 @@ namespace edm {
     void finishedPaths(std::exception_ptr, WaitingTaskHolder,
                        EventPrincipal& ep, EventSetup const& es);
     std::exception_ptr finishProcessOneEvent(std::exception_ptr);
+
+    void startCriticalPathWorkers(WaitingTaskHolder,
+                                  EventPrincipal& ep, EventSetup const& es);
     
     void reportSkipped(EventPrincipal const& ep) const;
 
@@ -363,6 +371,10 @@ namespace edm {
     // has been marked for early deletion
     std::vector<EarlyDeleteHelper> earlyDeleteHelpers_;
 
+    //unscheduled workers in the order they are requested at the start of an event
+    std::vector<Worker*> criticalPathWorkers_;
+    CriticalPathScheduler* criticalPathScheduler_;
+
     int                            total_events_;
     int                            total_passed_;
     unsigned int                   number_of_unscheduled_modules_;
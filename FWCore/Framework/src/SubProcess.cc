@@ -231,6 +231,7 @@ namespace edm {
     pathsAndConsumesOfModules_.initialize(schedule_.get(), preg_);
     //NOTE: this may throw
     checkForModuleDependencyCorrectness(pathsAndConsumesOfModules_, false);
+    schedule_->initializeCriticalPathScheduling(pathsAndConsumesOfModules_);
     actReg_->preBeginJobSignal_(pathsAndConsumesOfModules_, processContext_);
     schedule_->beginJob(*preg_);
     for_all(subProcesses_, [](auto& subProcess){ subProcess.doBeginJob(); });
@@ -4,6 +4,7 @@
 
 #include "FWCore/Framework/src/Worker.h"
 #include "FWCore/Framework/src/EarlyDeleteHelper.h"
+#include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/ServiceRegistry/interface/StreamContext.h"
 #include "FWCore/Concurrency/interface/WaitingTask.h"
 #include "FWCore/Concurrency/interface/WaitingTaskHolder.h"
@@ -204,7 +205,7 @@ private:
   }
 
   
-  void Worker::prefetchAsync(WaitingTask* iTask, ParentContext const& parentContext, Principal const& iPrincipal) {
+  void Worker::prefetchAsync(WaitingTask* iTask, ParentContext const& parentContext, EventSetup const& iSetup, Principal const& iPrincipal) {
     // Prefetch products the module declares it consumes (not including the products it maybe consumes)
     std::vector<ProductResolverIndexAndSkipBit> const& items = itemsToGetFrom(iPrincipal.branchType());
 
@@ -225,6 +226,11 @@ private:
     }
     
     if(iPrincipal.branchType()==InEvent) {
+      //EventSetup data is made in parallel with the Event data rather than
+      // inside the module's call to get()
+      for(auto const& item : esItemsToGetFromEvent()) {
+        iSetup.prefetchAsync(iTask, item.first, item.second);
+      }
       preActionBeforeRunEventAsync(iTask,moduleCallingContext_,iPrincipal);
     }
     
@@ -24,6 +24,7 @@ the worker is reset().
 #include "DataFormats/Provenance/interface/ModuleDescription.h"
 #include "FWCore/MessageLogger/interface/ExceptionMessages.h"
 #include "FWCore/Framework/src/WorkerParams.h"
+#include "FWCore/Framework/interface/EDConsumerBase.h"
 #include "FWCore/Framework/interface/ExceptionActions.h"
 #include "FWCore/Framework/interface/ModuleContextSentry.h"
 #include "FWCore/Framework/interface/OccurrenceTraits.h"
@@ -278,6 +279,8 @@ namespace edm {
 
     virtual std::vector<ProductResolverIndexAndSkipBit> const& itemsToGetFrom(BranchType) const = 0;
 
+    virtual std::vector<EDConsumerBase::ESItem> const& esItemsToGetFromEvent() const = 0;
+
 
     virtual std::vector<ProductResolverIndex> const& itemsShouldPutInEvent() const = 0;
 
@@ -353,6 +356,7 @@ namespace edm {
         
     void prefetchAsync(WaitingTask*,
                        ParentContext const& parentContext,
+                       EventSetup const&,
                        Principal const& );
         
     void emitPostModuleEventPrefetchingSignal() {
@@ -842,10 +846,10 @@ namespace edm {
 
         auto ownRunTask = std::make_shared<DestroyTask>(runTask);
         auto token = ServiceRegistry::instance().presentToken();
-        auto selectionTask = make_waiting_task(tbb::task::allocate_root(), [ownRunTask,parentContext,&ep,token, this] (std::exception_ptr const* ) mutable {
+        auto selectionTask = make_waiting_task(tbb::task::allocate_root(), [ownRunTask,parentContext,&ep,&es,token, this] (std::exception_ptr const* ) mutable {
           
           ServiceRegistry::Operate guard(token);
-          prefetchAsync(ownRunTask->release(), parentContext, ep);
+          prefetchAsync(ownRunTask->release(), parentContext, es, ep);
         });
         prePrefetchSelectionAsync(selectionTask,streamID, &ep);
       } else {
@@ -860,7 +864,7 @@ namespace edm {
           moduleTask = new (tbb::task::allocate_root()) AcquireTask<T>(
             this, ep, es, parentContext, std::move(runTaskHolder));
         }
-        prefetchAsync(moduleTask, parentContext, ep);
+        prefetchAsync(moduleTask, parentContext, es, ep);
       }
     }
   }
@@ -1009,7 +1013,7 @@ namespace edm {
         //set count to 2 since wait_for_all requires value to not go to 0
         waitTask->set_ref_count(2);
         
-        prefetchAsync(waitTask.get(),parentContext, ep);
+        prefetchAsync(waitTask.get(),parentContext, es, ep);
         waitTask->decrement_ref_count();
         waitTask->wait_for_all();
       }
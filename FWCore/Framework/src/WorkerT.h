@@ -145,6 +145,8 @@ namespace edm {
     }
 
     std::vector<ProductResolverIndexAndSkipBit> const& itemsToGetFrom(BranchType iType) const final { return module_->itemsToGetFrom(iType); }
+
+    std::vector<EDConsumerBase::ESItem> const& esItemsToGetFromEvent() const final { return module_->esItemsToGetFromEvent(); }
     
     std::vector<ProductResolverIndex> const& itemsShouldPutInEvent() const override;
 
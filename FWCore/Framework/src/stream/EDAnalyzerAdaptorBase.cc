@@ -100,6 +100,12 @@ EDAnalyzerAdaptorBase::itemsToGetFrom(BranchType iType) const {
   return m_streamModules[0]->itemsToGetFrom(iType);
 }
 
+std::vector<edm::EDConsumerBase::ESItem> const&
+EDAnalyzerAdaptorBase::esItemsToGetFromEvent() const {
+  assert(not m_streamModules.empty());
+  return m_streamModules[0]->esItemsToGetFromEvent();
+}
+
 void
 EDAnalyzerAdaptorBase::updateLookup(BranchType iType,
                                     ProductResolverIndexHelper const& iHelper,
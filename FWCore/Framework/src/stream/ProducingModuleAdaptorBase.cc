@@ -104,6 +104,13 @@ namespace edm {
       return m_streamModules[0]->itemsToGetFrom(iType);
     }
 
+    template<typename T>
+    std::vector<edm::EDConsumerBase::ESItem> const&
+    ProducingModuleAdaptorBase<T>::esItemsToGetFromEvent() const {
+      assert(not m_streamModules.empty());
+      return m_streamModules[0]->esItemsToGetFromEvent();
+    }
+
     template< typename T>
     void
     ProducingModuleAdaptorBase<T>::modulesWhoseProductsAreConsumed(std::vector<ModuleDescription const*>& modules,
@@ -7,6 +7,7 @@
  *
  */
 
+#include <atomic>
 #include <iostream>
 
 #include "cppunit/extensions/HelperMacros.h"
@@ -34,6 +35,9 @@
 #include "FWCore/Framework/interface/DataProxyProvider.h"
 #include "FWCore/Framework/interface/EventSetupRecordProviderFactoryTemplate.h"
 #include "FWCore/Framework/test/DummyEventSetupRecordRetriever.h"
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
+#include "FWCore/Framework/interface/DataProxyTemplate.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 using namespace edm;
 namespace {
@@ -67,6 +71,9 @@ CPPUNIT_TEST(preferTest);
 CPPUNIT_TEST(introspectionTest);
 
 CPPUNIT_TEST(iovExtentionTest);
+CPPUNIT_TEST(prefetchTest);
+CPPUNIT_TEST(prefetchCachedTest);
+CPPUNIT_TEST(prefetchExceptionTest);
 
 CPPUNIT_TEST_SUITE_END();
 public:
@@ -94,6 +101,9 @@ public:
   void introspectionTest();
   
   void iovExtentionTest();
+  void prefetchTest();
+  void prefetchCachedTest();
+  void prefetchExceptionTest();
   
 };
 
@@ -757,3 +767,135 @@ void testEventsetup::iovExtentionTest()
 
 }
 
+void testEventsetup::prefetchTest()
+{
+   using edm::eventsetup::test::DummyProxyProvider;
+   using edm::eventsetup::test::DummyData;
+   DummyData kGood; kGood.value_ = 1;
+
+   eventsetup::EventSetupProvider provider;
+   provider.add(std::make_shared<DummyProxyProvider>(kGood));
+   EventSetup const& eventSetup = provider.eventSetupForInstance(IOVSyncValue::invalidIOVSyncValue());
+
+   auto const recordKey = eventsetup::EventSetupRecordKey::makeKey<DummyRecord>();
+   eventsetup::DataKey const dataKey(eventsetup::DataKey::makeTypeTag<DummyData>(), "");
+
+   std::atomic<unsigned int> nCalls{0};
+   auto waitTask = make_empty_waiting_task();
+   waitTask->set_ref_count(1);
+   //ask twice to check that the data is only made once and both requests are notified
+   for(unsigned int i = 0; i < 2; ++i) {
+      auto task = make_waiting_task(tbb::task::allocate_root(), [&nCalls, waitTask = waitTask.get()](std::exception_ptr const* iPtr) {
+         CPPUNIT_ASSERT(iPtr == nullptr);
+         ++nCalls;
+         waitTask->decrement_ref_count();
+      });
+      waitTask->increment_ref_count();
+      eventSetup.prefetchAsync(task, recordKey, dataKey);
+   }
+   waitTask->wait_for_all();
+   CPPUNIT_ASSERT(nCalls == 2);
+
+   edm::ESHandle<DummyData> data;
+   eventSetup.getData(data);
+   CPPUNIT_ASSERT(kGood.value_==data->value_);
+}
+
+namespace {
+   //counts how many times the data is made, and fails to make it if asked to
+   class CountingDummyProxy : public eventsetup::DataProxyTemplate<DummyRecord, edm::eventsetup::test::DummyData> {
+   public:
+      CountingDummyProxy(const edm::eventsetup::test::DummyData* iDummy, bool iThrow) : data_(iDummy), throw_(iThrow) {}
+      unsigned int nMakes_ = 0;
+   protected:
+      const value_type* make(const record_type&, const eventsetup::DataKey&) {
+         ++nMakes_;
+         if(throw_) {
+            throw cms::Exception("TestFailure")<<"failed to make the data";
+         }
+         return data_;
+      }
+      void invalidateCache() {
+      }
+   private:
+      const edm::eventsetup::test::DummyData* data_;
+      bool throw_;
+   };
+
+   class CountingDummyProxyProvider : public eventsetup::DataProxyProvider {
+   public:
+      CountingDummyProxyProvider(std::shared_ptr<CountingDummyProxy> iProxy) : proxy_(iProxy) {
+         usingRecord<DummyRecord>();
+      }
+      void newInterval(const eventsetup::EventSetupRecordKey&, const ValidityInterval&) {
+      }
+   protected:
+      void registerProxies(const eventsetup::EventSetupRecordKey&, KeyedProxies& iProxies) {
+         insertProxy(iProxies, proxy_);
+      }
+   private:
+      std::shared_ptr<CountingDummyProxy> proxy_;
+   };
+
+   //returns once the task given to prefetchAsync has run, and checks it was given no exception
+   void prefetchAndWait(EventSetup const& iEventSetup) {
+      auto const recordKey = eventsetup::EventSetupRecordKey::makeKey<DummyRecord>();
+      eventsetup::DataKey const dataKey(eventsetup::DataKey::makeTypeTag<edm::eventsetup::test::DummyData>(), "");
+
+      bool called = false;
+      auto waitTask = make_empty_waiting_task();
+      waitTask->set_ref_count(2);
+      auto task = make_waiting_task(tbb::task::allocate_root(), [&called, waitTask = waitTask.get()](std::exception_ptr const* iPtr) {
+         CPPUNIT_ASSERT(iPtr == nullptr);
+         called = true;
+         waitTask->decrement_ref_count();
+      });
+      iEventSetup.prefetchAsync(task, recordKey, dataKey);
+      waitTask->wait_for_all();
+      CPPUNIT_ASSERT(called);
+   }
+}
+
+void testEventsetup::prefetchCachedTest()
+{
+   using edm::eventsetup::test::DummyData;
+   DummyData kGood; kGood.value_ = 1;
+
+   auto proxy = std::make_shared<CountingDummyProxy>(&kGood, false);
+   eventsetup::EventSetupProvider provider;
+   provider.add(std::make_shared<CountingDummyProxyProvider>(proxy));
+   EventSetup const& eventSetup = provider.eventSetupForInstance(IOVSyncValue::invalidIOVSyncValue());
+
+   edm::ESHandle<DummyData> data;
+   eventSetup.getData(data);
+   CPPUNIT_ASSERT(proxy->nMakes_ == 1);
+
+   //the data is already there: the task runs without making it again
+   prefetchAndWait(eventSetup);
+   CPPUNIT_ASSERT(proxy->nMakes_ == 1);
+
+   eventSetup.getData(data);
+   CPPUNIT_ASSERT(kGood.value_==data->value_);
+   CPPUNIT_ASSERT(proxy->nMakes_ == 1);
+}
+
+void testEventsetup::prefetchExceptionTest()
+{
+   using edm::eventsetup::test::DummyData;
+   DummyData kGood; kGood.value_ = 1;
+
+   auto proxy = std::make_shared<CountingDummyProxy>(&kGood, true);
+   eventsetup::EventSetupProvider provider;
+   provider.add(std::make_shared<CountingDummyProxyProvider>(proxy));
+   EventSetup const& eventSetup = provider.eventSetupForInstance(IOVSyncValue::invalidIOVSyncValue());
+
+   //the failure is not given to the waiting task
+   prefetchAndWait(eventSetup);
+   CPPUNIT_ASSERT(proxy->nMakes_ == 1);
+
+   //but to every get(), without trying to make the data again
+   edm::ESHandle<DummyData> data;
+   CPPUNIT_ASSERT_THROW(eventSetup.getData(data), cms::Exception);
+   CPPUNIT_ASSERT_THROW(eventSetup.getData(data), cms::Exception);
+   CPPUNIT_ASSERT(proxy->nMakes_ == 1);
+}
@@ -10,6 +10,7 @@ F2=${LOCAL_TEST_DIR}/test_deepCall_unscheduled_fail_cfg.py
 F3=${LOCAL_TEST_DIR}/test_offPath_unscheduled_cfg.py
 F4=${LOCAL_TEST_DIR}/test_onPath_unscheduled_cfg.py
 F5=${LOCAL_TEST_DIR}/test_onPath_wrongOrder_unscheduled_fail_cfg.py
+F6=${LOCAL_TEST_DIR}/test_criticalPath_unscheduled_cfg.py
 
 (cmsRun $F1 ) > test_deepCall_unscheduled.log || die "Failure using $F1" $?
 diff ${LOCAL_TEST_DIR}/unit_test_outputs/test_deepCall_unscheduled.log test_deepCall_unscheduled.log || die "comparing test_deepCall_unscheduled.log" $?
@@ -23,5 +24,8 @@ diff ${LOCAL_TEST_DIR}/unit_test_outputs/test_onPath_unscheduled.log test_onPath
 
 !(cmsRun $F5 ) || die "Failure using $F5" $?
 
+(cmsRun $F6 ) > test_criticalPath_unscheduled.log 2>&1 || die "Failure using $F6" $?
+(grep 'CriticalPathReport  Estimated critical path per event = 0.016' test_criticalPath_unscheduled.log) || die "Missing CriticalPathReport from $F6" $?
+
 popd
 
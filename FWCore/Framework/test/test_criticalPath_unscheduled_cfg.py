@@ -0,0 +1,69 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+import FWCore.Framework.test.cmsExceptionsFatalOption_cff
+process.options = cms.untracked.PSet(
+    Rethrow = FWCore.Framework.test.cmsExceptionsFatalOption_cff.Rethrow,
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(2),
+    criticalPathScheduling = cms.untracked.PSet(
+        moduleCosts = cms.untracked.PSet(
+            one = cms.untracked.double(0.001),
+            result1 = cms.untracked.double(0.010),
+            result2 = cms.untracked.double(0.001)
+        ),
+        defaultModuleCost = cms.untracked.double(0.002),
+        referenceEventTime = cms.untracked.double(0.1)
+    )
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(10)
+)
+process.source = cms.Source("EmptySource")
+
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations   = cms.untracked.vstring('cout'),
+    categories = cms.untracked.vstring(
+        'CriticalPathReport'
+    ),
+    cout = cms.untracked.PSet(
+        default = cms.untracked.PSet (
+            limit = cms.untracked.int32(0)
+        ),
+        CriticalPathReport = cms.untracked.PSet(
+            limit=cms.untracked.int32(100000000)
+        )
+    )
+)
+
+process.one = cms.EDProducer("IntProducer",
+    ivalue = cms.int32(1)
+)
+
+process.result1 = cms.EDProducer("AddIntsProducer",
+    labels = cms.vstring('one')
+)
+
+process.result2 = cms.EDProducer("AddIntsProducer",
+    labels = cms.vstring('result1', 
+        'one')
+)
+
+process.result4 = cms.EDProducer("AddIntsProducer",
+    labels = cms.vstring('result2', 
+        'result2')
+)
+
+#never consumed by a module on a Path so must not be started
+process.unused = cms.EDProducer("FailingProducer")
+
+process.get = cms.EDAnalyzer("IntTestAnalyzer",
+    valueMustMatch = cms.untracked.int32(4),
+    moduleLabel = cms.untracked.string('result4')
+)
+
+process.t = cms.Task(process.one, process.result1, process.result2, process.result4, process.unused)
+
+process.p = cms.Path(process.get, process.t)
@@ -295,6 +295,11 @@ namespace edm {
     return primaryFileSequence_->goToEvent(eventID);
   }
 
+  void
+  PoolSource::setConsumedEventProducts_(std::vector<BranchKey> const& iKeys) {
+    primaryFileSequence_->setConsumedEventProducts(iKeys);
+  }
+
   void
   PoolSource::fillDescriptions(ConfigurationDescriptions & descriptions) {
 
@@ -67,6 +67,7 @@ namespace edm {
     ProcessingController::ReverseState reverseState_() const override;
 
     std::pair<SharedResourcesAcquirer*,std::recursive_mutex*> resourceSharedWithDelayedReader_() override;
+    void setConsumedEventProducts_(std::vector<BranchKey> const& iKeys) override;
     
     RootServiceChecker rootServiceChecker_;
     InputFileCatalog catalog_;
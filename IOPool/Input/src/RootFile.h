@@ -213,6 +213,7 @@ namespace edm {
     IndexIntoFile::IndexIntoFileItr indexIntoFileIter() const;
     void setPosition(IndexIntoFile::IndexIntoFileItr const& position);
     void initAssociationsFromSecondary(std::vector<BranchID> const&);
+    void enableEventReadAhead(std::vector<BranchKey> const& consumedKeys) {eventTree_.enableReadAhead(consumedKeys);}
 
     void setSignals(signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadSource,
                     signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadSource);
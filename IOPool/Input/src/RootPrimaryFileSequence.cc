@@ -17,6 +17,8 @@
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "Utilities/StorageFactory/interface/StorageFactory.h"
 
+#include "TTreeCacheUnzip.h"
+
 namespace edm {
   RootPrimaryFileSequence::RootPrimaryFileSequence(
                 ParameterSet const& pset,
@@ -33,7 +35,9 @@ namespace edm {
     treeCacheSize_(noEventSort_ ? pset.getUntrackedParameter<unsigned int>("cacheSize") : 0U),
     duplicateChecker_(new DuplicateChecker(pset)),
     usingGoToEvent_(false),
-    enablePrefetching_(false) {
+    enablePrefetching_(false),
+    parallelUnzip_(pset.getUntrackedParameter<bool>("parallelUnzip")),
+    consumedEventProducts_() {
 
     // The SiteLocalConfig controls the TTreeCache size and the prefetching settings.
     Service<SiteLocalConfig> pSLC;
@@ -44,6 +48,12 @@ namespace edm {
       enablePrefetching_ = pSLC->enablePrefetching();
     }
 
+    // ROOT's parallel unzipping is a process-wide setting, read by every TTree::SetCacheSize afterwards.
+    // It is set once for the job from the primary source, before any file is opened.
+    if(parallelUnzip_) {
+      TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kEnable);
+    }
+
     std::string branchesMustMatch = pset.getUntrackedParameter<std::string>("branchesMustMatch", std::string("permissive"));
     if(branchesMustMatch == std::string("strict")) branchesMustMatch_ = BranchDescription::Strict;
 
@@ -109,6 +119,17 @@ namespace edm {
     // If we can't delete all of it, then we can delete the parts we do not need.
     bool deleteIndexIntoFile = !usingGoToEvent_ && !(duplicateChecker_ && duplicateChecker_->checkingAllFiles() && !duplicateChecker_->checkDisabled());
     initTheFile(skipBadFiles, deleteIndexIntoFile, &input_, "primaryFiles", InputType::Primary);
+    if(rootFile() && parallelUnzip_) {
+      rootFile()->enableEventReadAhead(consumedEventProducts_);
+    }
+  }
+
+  void
+  RootPrimaryFileSequence::setConsumedEventProducts(std::vector<BranchKey> const& keys) {
+    consumedEventProducts_ = keys;
+    if(rootFile() && parallelUnzip_) {
+      rootFile()->enableEventReadAhead(consumedEventProducts_);
+    }
   }
 
   RootPrimaryFileSequence::RootFileSharedPtr
@@ -330,6 +351,11 @@ namespace edm {
                      "Note 3: Any sorting occurs independently in each input file (no sorting across input files).");
     desc.addUntracked<unsigned int>("cacheSize", roottree::defaultCacheSize)
         ->setComment("Size of ROOT TTree prefetch cache.  Affects performance.");
+    desc.addUntracked<bool>("parallelUnzip", false)
+        ->setComment("True:  Event branches consumed by the modules are put in the TTree cache without a learning phase,\n"
+                     "       and their baskets are decompressed ahead of time by ROOT implicit multi-threading tasks.\n"
+                     "       This enables parallel unzipping for the whole job, including any secondary input.\n"
+                     "False: Baskets are decompressed when a module reads the product.");
     std::string defaultString("permissive");
     desc.addUntracked<std::string>("branchesMustMatch", defaultString)
         ->setComment("'strict':     Branches in each input file must match those in the first file.\n"
@@ -15,6 +15,7 @@ RootPrimaryFileSequence: This is an InputSource
 #include "FWCore/Sources/interface/EventSkipperByID.h"
 #include "FWCore/Utilities/interface/get_underlying_safe.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
+#include "DataFormats/Provenance/interface/BranchKey.h"
 #include "DataFormats/Provenance/interface/ProcessHistoryID.h"
 
 #include <memory>
@@ -48,6 +49,7 @@ namespace edm {
     bool skipEvents(int offset);
     bool goToEvent(EventID const& eventID);
     void rewind_();
+    void setConsumedEventProducts(std::vector<BranchKey> const& keys);
     static void fillDescription(ParameterSetDescription & desc);
     ProcessingController::ForwardState forwardState() const;
     ProcessingController::ReverseState reverseState() const;
@@ -78,6 +80,8 @@ namespace edm {
     edm::propagate_const<std::shared_ptr<DuplicateChecker>> duplicateChecker_;
     bool usingGoToEvent_;
     bool enablePrefetching_;
+    bool parallelUnzip_;
+    std::vector<BranchKey> consumedEventProducts_;
   }; // class RootPrimaryFileSequence
 }
 #endif
@@ -1,12 +1,15 @@
 #include "RootTree.h"
 #include "RootDelayedReader.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
+#include "DataFormats/Provenance/interface/BranchKey.h"
 #include "InputFile.h"
 #include "TTree.h"
 #include "TTreeIndex.h"
 #include "TTreeCache.h"
+#include "TTreeCacheUnzip.h"
 
 #include <cassert>
 #include <iostream>
@@ -57,6 +60,7 @@ namespace edm {
     treeAutoFlush_(0),
     enablePrefetching_(enablePrefetching),
     enableTriggerCache_(branchType_ == InEvent),
+    readAheadBranches_(),
     rootDelayedReader_(new RootDelayedReader(*this, filePtr, inputType)),
     branchEntryInfoBranch_(metaTree_ ? getProductProvenanceBranch(metaTree_, branchType_) : (tree_ ? getProductProvenanceBranch(tree_, branchType_) : nullptr)),
     infoTree_(dynamic_cast<TTree*>(filePtr_.get() != nullptr ? filePtr->Get(BranchTypeToInfoTreeName(branchType).c_str()) : nullptr)) // backward compatibility
@@ -375,6 +379,10 @@ namespace edm {
     assert(treeCache_);
     assert(branchType_ == InEvent);
     assert(!rawTreeCache_);
+    if(!readAheadBranches_.empty()) {
+      trainReadAheadBranches();
+      return;
+    }
     treeCache_->SetLearnEntries(learningEntries_);
     tree_->SetCacheSize(static_cast<Long64_t>(cacheSize_));
     rawTreeCache_.reset(dynamic_cast<TTreeCache *>(filePtr_->GetCacheRead()));
@@ -398,6 +406,44 @@ namespace edm {
     assert(treeCache_->GetTree() == tree_);
   }
 
+  void
+  RootTree::trainReadAheadBranches() {
+    // The consumed branches are known, so there is no learning phase
+    // and the first cluster is already read (and unzipped) together.
+    filePtr_->SetCacheRead(treeCache_.get());
+    treeCache_->StartLearningPhase();
+    treeCache_->SetEntryRange(entryNumber_, tree_->GetEntries());
+    if (filePtr_->Get(poolNames::branchListIndexesBranchName().c_str()) != nullptr) {
+      treeCache_->AddBranch(poolNames::branchListIndexesBranchName().c_str(), kTRUE);
+    }
+    treeCache_->AddBranch(BranchTypeToAuxiliaryBranchName(branchType_).c_str(), kTRUE);
+    trainedSet_.clear();
+    triggerSet_.clear();
+    for(auto branch : readAheadBranches_) {
+      treeCache_->AddBranch(branch, kTRUE);
+      trainedSet_.insert(branch);
+    }
+    treeCache_->StopLearningPhase();
+    filePtr_->SetCacheRead(nullptr);
+    switchOverEntry_ = entryNumber_;
+    assert(treeCache_->GetTree() == tree_);
+  }
+
+  void
+  RootTree::enableReadAhead(std::vector<BranchKey> const& consumedKeys) {
+    if (cacheSize_ == 0) {
+      return;
+    }
+    readAheadBranches_.clear();
+    for(auto const& key : consumedKeys) {
+      auto itFound = branches_->find(key);
+      if(itFound != branches_->end() && itFound->second.productBranch_ != nullptr) {
+        readAheadBranches_.push_back(itFound->second.productBranch_);
+      }
+    }
+    resetTraining();
+  }
+
   void
   RootTree::stopTraining() {
     filePtr_->SetCacheRead(treeCache_.get());
@@ -416,6 +462,12 @@ namespace edm {
     // We make sure the treeCache_ is detached from the file,
     // so that ROOT does not also delete it.
     filePtr_->SetCacheRead(nullptr);
+    auto unzipCache = dynamic_cast<TTreeCacheUnzip*>(treeCache_.get());
+    if (unzipCache != nullptr && !readAheadBranches_.empty()) {
+      LogInfo("ParallelUnzip") << "Event tree baskets: unzipped " << unzipCache->GetNUnzip()
+                               << " found " << unzipCache->GetNFound()
+                               << " missed " << unzipCache->GetNMissed();
+    }
     // We *must* delete the TTreeCache here because the TFilePrefetch object
     // references the TFile.  If TFile is closed, before the TTreeCache is
     // deleted, the TFilePrefetch may continue to do TFile operations, causing
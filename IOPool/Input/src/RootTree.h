@@ -159,6 +159,7 @@ namespace edm {
     inline TTreeCache* selectCache(TBranch* branch, EntryNumber entryNumber) const;
     void trainCache(char const* branchNames);
     void resetTraining() {trainNow_ = true;}
+    void enableReadAhead(std::vector<BranchKey> const& consumedKeys);
 
     BranchType branchType() const {return branchType_;}
     
@@ -170,6 +171,7 @@ namespace edm {
     void setTreeMaxVirtualSize(int treeMaxVirtualSize);
     void startTraining();
     void stopTraining();
+    void trainReadAheadBranches();
 
     std::shared_ptr<InputFile> filePtr_;
 // We use bare pointers for pointers to some ROOT entities.
@@ -204,6 +206,9 @@ namespace edm {
 // effect on the primary treeCache_; all other caches have this explicitly disabled.
     bool enablePrefetching_;
     bool enableTriggerCache_;
+// If not empty, these branches are put into the cache directly instead of being learned.
+// The cache is a TTreeCacheUnzip if parallel unzipping is enabled for the job.
+    std::vector<TBranch*> readAheadBranches_;
     std::unique_ptr<RootDelayedReader> rootDelayedReader_;
 
     TBranch* branchEntryInfoBranch_; //backwards compatibility
@@ -0,0 +1,43 @@
+# Configuration file for PoolInputParallelUnzipTest
+# Same as PoolInputTest_cfg.py but the consumed Event branches are read ahead.
+# The unzip cache statistics of each file are printed to cout for TestPoolInput.sh.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations = cms.untracked.vstring('cout'),
+    categories = cms.untracked.vstring('ParallelUnzip'),
+    cout = cms.untracked.PSet(
+        threshold = cms.untracked.string('INFO'),
+        default = cms.untracked.PSet(
+            limit = cms.untracked.int32(0)
+        ),
+        ParallelUnzip = cms.untracked.PSet(
+            limit = cms.untracked.int32(-1)
+        )
+    )
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(2),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.OtherThing = cms.EDProducer("OtherThingProducer")
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer")
+
+process.source = cms.Source("PoolSource",
+    setRunNumber = cms.untracked.uint32(621),
+    parallelUnzip = cms.untracked.bool(True),
+    fileNames = cms.untracked.vstring('file:PoolInputTest.root', 
+        'file:PoolInputOther.root')
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis)
@@ -10,6 +10,10 @@ cp PoolInputTest.root PoolInputOther.root
 
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputTest_cfg.py || die 'Failure using PoolInputTest_cfg.py' $?
 
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputParallelUnzipTest_cfg.py >& ${LOCAL_TMP_DIR}/PoolInputParallelUnzipTest.txt || die 'Failure using PoolInputParallelUnzipTest_cfg.py' $?
+# the consumed baskets must have been unzipped ahead of time and then found in the unzip cache
+grep 'Event tree baskets' ${LOCAL_TMP_DIR}/PoolInputParallelUnzipTest.txt | awk '{u += $5; f += $7} END {exit !(u > 0 && f > 0)}' || die 'No baskets read from the unzip cache in PoolInputParallelUnzipTest_cfg.py' 1
+
 cmsRun ${LOCAL_TEST_DIR}/PrePool2FileInputTest_cfg.py || die 'Failure using PrePool2FileInputTest_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/Pool2FileInputTest_cfg.py || die 'Failure using Pool2FileInputTest_cfg.py' $?
 
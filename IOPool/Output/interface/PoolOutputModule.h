@@ -52,6 +52,7 @@ namespace edm {
     int const& splitLevel() const {return splitLevel_;}
     std::string const& basketOrder() const {return basketOrder_;}
     int const& treeMaxVirtualSize() const {return treeMaxVirtualSize_;}
+    bool const& concurrentFill() const {return concurrentFill_;}
     bool const& overrideInputFileSplitLevels() const {return overrideInputFileSplitLevels_;}
     DropMetaData const& dropMetaData() const {return dropMetaData_;}
     std::string const& catalog() const {return catalog_;}
@@ -181,6 +182,7 @@ namespace edm {
     int const splitLevel_;
     std::string basketOrder_;
     int const treeMaxVirtualSize_;
+    bool const concurrentFill_;
     int whyNotFastClonable_;
     DropMetaData dropMetaData_;
     std::string const moduleLabel_;
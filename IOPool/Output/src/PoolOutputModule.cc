@@ -51,6 +51,7 @@ namespace edm {
     splitLevel_(std::min<int>(pset.getUntrackedParameter<int>("splitLevel") + 1, 99)),
     basketOrder_(pset.getUntrackedParameter<std::string>("sortBaskets")),
     treeMaxVirtualSize_(pset.getUntrackedParameter<int>("treeMaxVirtualSize")),
+    concurrentFill_(pset.getUntrackedParameter<bool>("concurrentFill")),
     whyNotFastClonable_(pset.getUntrackedParameter<bool>("fastCloning") ? FileBlock::CanFastClone : FileBlock::DisabledInConfigFile),
     dropMetaData_(DropNone),
     moduleLabel_(pset.getParameter<std::string>("@module_label")),
@@ -451,6 +452,11 @@ namespace edm {
                      "Used by ROOT when fast copying. Affects performance.");
     desc.addUntracked<int>("treeMaxVirtualSize", -1)
         ->setComment("Size of ROOT TTree TBasket cache.  Affects performance.");
+    desc.addUntracked<bool>("concurrentFill", false)
+        ->setComment("True:  Serialize and compress the branches of an entry in parallel using ROOT implicit multi-threading,\n"
+                     "       only the writing of the baskets to the file stays serialized. Requires the ROOT implicit MT to be\n"
+                     "       enabled (the default of the InitRootHandlers service). Not used for trees being fast cloned.\n"
+                     "False: Fill the branches one after the other.");
     desc.addUntracked<bool>("fastCloning", true)
         ->setComment("True:  Allow fast copying, if possible.\n"
                      "False: Disable fast copying.");
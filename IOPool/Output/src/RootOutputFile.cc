@@ -144,6 +144,7 @@ namespace edm {
     for(int i = InEvent; i < NumBranchTypes; ++i) {
       BranchType branchType = static_cast<BranchType>(i);
       RootOutputTree *theTree = treePointers_[branchType];
+      theTree->setConcurrentFill(om_->concurrentFill());
       for(auto const& item : om_->selectedOutputItemList()[branchType]) {
         item.product_ = nullptr;
         BranchDescription const& desc = *item.branchDescription_;
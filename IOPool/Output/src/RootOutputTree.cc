@@ -297,6 +297,9 @@ namespace edm {
     clonedReadBranchNames_.clear();
     currentlyFastCloning_ = canFastClone && !readBranches_.empty();
     if(currentlyFastCloning_) {
+      // concurrent filling is not validated together with fast cloning,
+      // the tree is filled serially from now on
+      tree_->SetImplicitMT(false);
       fastCloneAuxBranches_ = canFastCloneAux;
       fastCloneTTree(tree, option);
       for(auto const& branch : readBranches_) {
@@ -311,6 +314,15 @@ namespace edm {
     }
   }
 
+  void
+  RootOutputTree::setConcurrentFill(bool concurrentFill) {
+    // With ROOT implicit MT, TTree::Fill and TTree::FlushBaskets serialize and
+    // compress the baskets of the branches as parallel tasks, only writing
+    // the baskets into the file is done serially. ROOT ignores the setting
+    // if implicit MT was not enabled for the job. Fast cloning turns it off.
+    tree_->SetImplicitMT(concurrentFill);
+  }
+
   void
   RootOutputTree::fillTree() {
     if(currentlyFastCloning_) {
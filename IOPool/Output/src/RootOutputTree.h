@@ -108,6 +108,8 @@ namespace edm {
     void setAutoFlush(Long64_t size) {
       tree_->SetAutoFlush(size);
     }
+
+    void setConcurrentFill(bool concurrentFill);
   private:
     static void fillTTree(std::vector<TBranch*> const& branches);
 // We use bare pointers for pointers to some ROOT entities.
@@ -28,6 +28,9 @@ code 1 | size 4 | protocol version 1 | pset 16 | run 4 | Init Header Size 4| Eve
 
 Protocol Version 11: identical to version 10, but incremented to keep in sync with event msg protocol version
 
+Protocol Version 12: added the compression dictionary after the description blob, the event msg protocol is unchanged
+code 1 | size 4 | protocol version 1 | pset 16 | run 4 | Init Header Size 4| Event Header Size 4| releaseTagLength 1 | ReleaseTag var| processNameLength 1 | processName var| outputModuleLabelLength 1 | outputModuleLabel var | outputModuleId 4 | HLT Trig count 4| HLT Trig Length 4 | HLT Trig names var | HLT Selection count 4| HLT Selection Length 4 | HLT Selection names var | L1 Trig Count 4| L1 TrigName len 4| L1 Trig Names var | adler32 chksum 4| desc legth 4 | description blob var | dict length 4 | ZSTD dictionary var
+
 */
 
 #ifndef IOPool_Streamer_InitMessage_h
@@ -38,7 +41,7 @@ Protocol Version 11: identical to version 10, but incremented to keep in sync wi
 
 struct Version
 {
-  Version(const uint8* pset):protocol_(11)
+  Version(const uint8* pset):protocol_(12)
   { std::copy(pset,pset+sizeof(pset_id_),&pset_id_[0]); }
 
   uint8 protocol_; // version of the protocol
@@ -97,6 +100,10 @@ public:
   std::string hostName() const;
   uint32 hostName_len() const {return host_name_len_;}
 
+  // dictionary the event data was compressed with, empty if none
+  uint32 dictLength() const { return dict_len_; }
+  const uint8* dictData() const { return dict_start_; }
+
 private:
   uint8* buf_;
   HeaderView head_;
@@ -128,6 +135,9 @@ private:
   // but is needed for the index file
   uint8* desc_start_; // point to the bytes
   uint32 desc_len_;
+
+  uint8* dict_start_; // point to the bytes
+  uint32 dict_len_;
 };
 
 #endif
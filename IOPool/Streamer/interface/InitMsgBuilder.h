@@ -22,6 +22,8 @@ public:
 
   uint8* startAddress() const { return buf_; }
   void setDataLength(uint32 registry_length);
+  /** Has to be called after setDataLength, the buffer must have room for the dictionary */
+  void setDictionary(uint8 const* dict, uint32 dict_length);
   uint8* dataAddress() const  { return data_addr_; }
   uint32 headerSize() const {return data_addr_-buf_;}
   uint32 size() const ;
@@ -11,6 +11,7 @@
 #include "TBufferFile.h"
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "DataFormats/Provenance/interface/BranchIDList.h"
@@ -58,6 +59,8 @@ struct SerializeDataBuffer
 
 class EventMsgBuilder;
 class InitMsgBuilder;
+struct ZSTD_CCtx_s;
+struct ZSTD_CDict_s;
 namespace edm
 {
   
@@ -65,6 +68,13 @@ namespace edm
   class ModuleCallingContext;
   class ThinnedAssociationsHelper;
 
+  enum StreamerCompressionAlgo {
+    UNCOMPRESSED = 0,
+    ZLIB = 1,
+    LZ4 = 2,
+    ZSTD = 3
+  };
+
   class StreamSerializer
   {
 
@@ -77,7 +87,7 @@ namespace edm
                           ThinnedAssociationsHelper const& thinnedAssociationsHelper);
 
     int serializeEvent(EventForOutput const& event, ParameterSetID const& selectorConfig,
-                       bool use_compression, int compression_level,
+                       StreamerCompressionAlgo compressionAlgo, int compression_level,
                        SerializeDataBuffer &data_buffer);
 
     /**
@@ -90,10 +100,55 @@ namespace edm
                                        std::vector<unsigned char> &outputBuffer,
                                        int compressionLevel);
 
+    /**
+     * Same as compressBuffer but writes a LZ4 frame. The frame header
+     * is used by the reader to tell the data apart from zlib data.
+     */
+    static unsigned int compressBufferLZ4(unsigned char *inputBuffer,
+                                          unsigned int inputSize,
+                                          std::vector<unsigned char> &outputBuffer,
+                                          int compressionLevel);
+
+    /**
+     * Same as compressBuffer but writes a ZSTD frame. The frame header
+     * is used by the reader to tell the data apart from zlib data.
+     */
+    static unsigned int compressBufferZSTD(unsigned char *inputBuffer,
+                                           unsigned int inputSize,
+                                           std::vector<unsigned char> &outputBuffer,
+                                           int compressionLevel);
+
+    /**
+     * Trains a ZSTD dictionary of at most maxDictionarySize bytes on the
+     * given serialized events. Returns an empty dictionary if there are
+     * too few or too small samples to train on.
+     */
+    static std::vector<unsigned char> trainZSTDDictionary(std::vector<std::vector<unsigned char>> const& samples,
+                                                          unsigned int maxDictionarySize);
+
+    /**
+     * Events serialized with ZSTD are compressed using the given dictionary
+     * from now on. The dictionary has to be stored in the INIT message.
+     */
+    void setZSTDDictionary(std::vector<unsigned char> const& dictionary, int compressionLevel);
+    std::vector<unsigned char> const& zstdDictionary() const { return zstdDictionary_; }
+
+    /**
+     * Same as compressBufferZSTD but uses the dictionary given to
+     * setZSTDDictionary.
+     */
+    unsigned int compressBufferZSTDWithDictionary(unsigned char *inputBuffer,
+                                                  unsigned int inputSize,
+                                                  std::vector<unsigned char> &outputBuffer);
+
   private:
 
     SelectedProducts const* selections_;
     edm::propagate_const<TClass*> tc_;
+
+    std::vector<unsigned char> zstdDictionary_;
+    std::shared_ptr<ZSTD_CDict_s> zstdCDict_;
+    std::shared_ptr<ZSTD_CCtx_s> zstdCCtx_;
   };
 
 }
@@ -20,11 +20,13 @@ namespace edm {
 
     /**Reads a Streamer file */
     explicit StreamerInputFile(std::string const& name,
-      std::shared_ptr<EventSkipperByID> eventSkipperByID = std::shared_ptr<EventSkipperByID>());
+      std::shared_ptr<EventSkipperByID> eventSkipperByID = std::shared_ptr<EventSkipperByID>(),
+      bool memoryMapFiles = false);
 
     /** Multiple Streamer files */
     explicit StreamerInputFile(std::vector<std::string> const& names,
-      std::shared_ptr<EventSkipperByID> eventSkipperByID = std::shared_ptr<EventSkipperByID>());
+      std::shared_ptr<EventSkipperByID> eventSkipperByID = std::shared_ptr<EventSkipperByID>(),
+      bool memoryMapFiles = false);
 
     ~StreamerInputFile();
 
@@ -44,6 +46,7 @@ namespace edm {
   private:
 
     void openStreamerFile(std::string const& name);
+    bool mapStreamerFile(std::string const& name);
     IOSize readBytes(char* buf, IOSize nBytes);
     IOOffset skipBytes(IOSize nBytes);
 
@@ -78,6 +81,13 @@ namespace edm {
 
     edm::propagate_const<std::unique_ptr<Storage>> storage_;
 
+    /** If set, local files are memory mapped and the event messages are
+        read in place instead of being copied into eventBuf_ */
+    bool memoryMapFiles_;
+    char* mappedData_;
+    IOSize mappedSize_;
+    IOSize mappedPosition_;
+
     bool endOfFile_;
   };
 }
@@ -23,6 +23,7 @@
 
 class InitMsgView;
 class EventMsgView;
+struct ZSTD_DDict_s;
 
 namespace edm {
   class BranchIDListHelper;
@@ -61,6 +62,19 @@ namespace edm {
                                          unsigned int inputSize,
                                          std::vector<unsigned char>& outputBuffer,
                                          unsigned int expectedFullSize);
+    static unsigned int uncompressBufferLZ4(unsigned char* inputBuffer,
+                                            unsigned int inputSize,
+                                            std::vector<unsigned char>& outputBuffer,
+                                            unsigned int expectedFullSize);
+    /**
+     * The dictionary has to be the one stored in the INIT message if the
+     * events were compressed with a dictionary, nullptr otherwise.
+     */
+    static unsigned int uncompressBufferZSTD(unsigned char* inputBuffer,
+                                             unsigned int inputSize,
+                                             std::vector<unsigned char>& outputBuffer,
+                                             unsigned int expectedFullSize,
+                                             ZSTD_DDict_s const* dictionary = nullptr);
   protected:
     static void declareStreamers(SendDescs const& descs);
     static void buildClassCache(SendDescs const& descs);
@@ -105,6 +119,7 @@ namespace edm {
 
     std::string processName_;
     unsigned int protocolVersion_;
+    std::shared_ptr<ZSTD_DDict_s> zstdDictionary_;
   }; //end-of-class-def
 } // end of namespace-edm
   
@@ -28,7 +28,6 @@ namespace edm {
     void doOutputHeader(InitMsgBuilder const& init_message) override;
     void doOutputEvent(EventMsgBuilder const& msg) override;
     void beginLuminosityBlock(edm::LuminosityBlockForOutput const&) override;
-    void endLuminosityBlock(edm::LuminosityBlockForOutput const&) override;
 
   private:
     edm::propagate_const<std::unique_ptr<Consumer>> c_;
@@ -74,10 +73,6 @@ namespace edm {
   void
   StreamerOutputModule<Consumer>::beginLuminosityBlock(edm::LuminosityBlockForOutput const&) {}
 
-  template<typename Consumer>
-  void
-  StreamerOutputModule<Consumer>::endLuminosityBlock(edm::LuminosityBlockForOutput const&) {}
-
   template<typename Consumer>
   void
   StreamerOutputModule<Consumer>::fillDescriptions(ConfigurationDescriptions& descriptions) {
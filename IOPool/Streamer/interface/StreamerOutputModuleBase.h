@@ -6,10 +6,12 @@
 #include "IOPool/Streamer/interface/MsgTools.h"
 #include "IOPool/Streamer/interface/StreamSerializer.h"
 #include <memory>
+#include <string>
 #include <vector>
 
 class InitMsgBuilder;
 class EventMsgBuilder;
+class EventMsgView;
 namespace edm {
   class ParameterSetDescription;
 
@@ -29,14 +31,19 @@ namespace edm {
     void writeRun(RunForOutput const&) override;
     void writeLuminosityBlock(LuminosityBlockForOutput const&) override;
     void write(EventForOutput const& e) override;
+    void endLuminosityBlock(LuminosityBlockForOutput const&) final;
 
     virtual void start() = 0;
     virtual void stop() = 0;
     virtual void doOutputHeader(InitMsgBuilder const& init_message) = 0;
     virtual void doOutputEvent(EventMsgBuilder const& msg) = 0;
+    // called at the end of a luminosity block, once all its events were given to doOutputEvent
+    virtual void closeLuminosityBlock(LuminosityBlockForOutput const&) {}
 
     std::unique_ptr<InitMsgBuilder> serializeRegistry();
     std::unique_ptr<EventMsgBuilder> serializeEvent(EventForOutput const& e); 
+    std::unique_ptr<EventMsgBuilder> compressTrainingEvent(EventMsgView const& view);
+    void writeTrainingEvents();
     Trig getTriggerResults(EDGetTokenT<TriggerResults> const& token, EventForOutput const& e) const;
     void setHltMask(EventForOutput const& e);
     void setLumiSection();
@@ -46,8 +53,20 @@ namespace edm {
 
     int maxEventSize_;
     bool useCompression_;
+    std::string compressionAlgoStr_;
+    StreamerCompressionAlgo compressionAlgo_;
     int compressionLevel_;
 
+    // The first events of each run are kept uncompressed until a ZSTD
+    // dictionary is trained on them, the INIT message carrying the
+    // dictionary is written when the training is done. The training is
+    // cut short at the end of a luminosity block which has events, so that
+    // its events are written with it.
+    unsigned int dictionaryTrainingEvents_;
+    unsigned int maxDictionarySize_;
+    bool trainingDictionary_;
+    std::vector<std::vector<char>> trainingEventMessages_;
+
     // test luminosity sections
     int lumiSectionInterval_;  
     double timeInSecSinceUTC;
@@ -36,6 +36,9 @@ void dumpInitHeader(const InitMsgView* view)
     std::cout << "Checksum for Registry data = " << view->adler32_chksum()
               << " Hostname = " << view->hostName() << std::endl;
   }
+  if (view->protocolVersion() >= 12) {
+    std::cout << "Compression dictionary length = " << view->dictLength() << std::endl;
+  }
 
   //PSet 16 byte non-printable representation, stored in message.
   uint8 vpset[16];
@@ -27,7 +27,9 @@ InitMsgView::InitMsgView(void* buf) :
   host_name_start_(nullptr),
   host_name_len_(0),
   desc_start_(nullptr),
-  desc_len_(0) {
+  desc_len_(0),
+  dict_start_(nullptr),
+  dict_len_(0) {
   if (protocolVersion() == 2) {
       std::cout << "Protocol Version 2 encountered" << std::endl;
       release_start_ = buf_ + sizeof(InitHeader) - (sizeof(uint32)*2);
@@ -99,6 +101,12 @@ InitMsgView::InitMsgView(void* buf) :
   desc_start_ = pos;
   desc_len_ = convert32(desc_start_);
   desc_start_ += sizeof(char_uint32);
+
+  if (protocolVersion() > 11) {
+    pos = desc_start_ + desc_len_;
+    dict_len_ = convert32(pos);
+    dict_start_ = pos + sizeof(char_uint32);
+  }
 }
 
 uint32 InitMsgView::run() const
@@ -89,8 +89,22 @@ InitMsgBuilder::InitMsgBuilder(void* buf, uint32 size,
 void InitMsgBuilder::setDataLength(uint32 len)
 {
   convert(len,data_addr_-sizeof(char_uint32));
+  // empty dictionary unless set afterwards
+  convert((uint32)0, data_addr_ + len);
   InitHeader* h = (InitHeader*)buf_;
-  new (&h->header_) Header(Header::INIT, data_addr_ - buf_ + len);
+  new (&h->header_) Header(Header::INIT, data_addr_ - buf_ + len + sizeof(char_uint32));
+}
+
+void InitMsgBuilder::setDictionary(uint8 const* dict, uint32 dict_length)
+{
+  uint32 len = convert32(data_addr_-sizeof(char_uint32));
+  uint8* pos = data_addr_ + len;
+  assert(pos + sizeof(char_uint32) + dict_length <= buf_ + size_);
+  convert(dict_length, pos);
+  pos += sizeof(char_uint32);
+  memcpy(pos, dict, dict_length);
+  InitHeader* h = (InitHeader*)buf_;
+  new (&h->header_) Header(Header::INIT, pos - buf_ + dict_length);
 }
 
 
@@ -22,8 +22,12 @@
 #include "FWCore/ServiceRegistry/interface/Service.h"
 
 #include "zlib.h"
+#include "lz4frame.h"
+#include "zstd.h"
+#include "zdict.h"
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -34,7 +38,10 @@ namespace edm {
    */
   StreamSerializer::StreamSerializer(SelectedProducts const* selections):
     selections_(selections),
-    tc_(getTClass(typeid(SendEvent))) {
+    tc_(getTClass(typeid(SendEvent))),
+    zstdDictionary_(),
+    zstdCDict_(),
+    zstdCCtx_() {
   }
 
   /**
@@ -127,7 +134,7 @@ namespace edm {
    */
   int StreamSerializer::serializeEvent(EventForOutput const& event,
                                        ParameterSetID const& selectorConfig,
-                                       bool use_compression, int compression_level,
+                                       StreamerCompressionAlgo compressionAlgo, int compression_level,
                                        SerializeDataBuffer& data_buffer) {
 
     EventSelectionIDVector selectionIDs = event.eventSelectionIDs();
@@ -222,9 +229,25 @@ namespace edm {
     // compress before return if we need to
     // should test if compressed already - should never be?
     //   as double compression can have problems
-    if(use_compression) {
-      unsigned int dest_size =
-        compressBuffer(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+    if(compressionAlgo != UNCOMPRESSED) {
+      unsigned int dest_size = 0;
+      switch(compressionAlgo) {
+        case ZLIB:
+          dest_size = compressBuffer(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          break;
+        case LZ4:
+          dest_size = compressBufferLZ4(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          break;
+        case ZSTD:
+          if(zstdCDict_) {
+            dest_size = compressBufferZSTDWithDictionary(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_);
+          } else {
+            dest_size = compressBufferZSTD(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          }
+          break;
+        default:
+          break;
+      }
       if(dest_size != 0) {
         data_buffer.ptr_ = &data_buffer.comp_buf_[0]; // reset to point at compressed area
         data_buffer.curr_space_used_ = dest_size;
@@ -278,4 +301,121 @@ namespace edm {
 
     return resultSize;
   }
+
+  unsigned int
+  StreamSerializer::compressBufferLZ4(unsigned char *inputBuffer,
+                                      unsigned int inputSize,
+                                      std::vector<unsigned char> &outputBuffer,
+                                      int compressionLevel) {
+    LZ4F_preferences_t prefs;
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.compressionLevel = compressionLevel;
+    // store the original size so the reader can check it
+    prefs.frameInfo.contentSize = inputSize;
+
+    size_t const dest_size = LZ4F_compressFrameBound(inputSize, &prefs);
+    if(outputBuffer.size() < dest_size) outputBuffer.resize(dest_size);
+
+    size_t const ret = LZ4F_compressFrame(&outputBuffer[0], dest_size, inputBuffer, inputSize, &prefs);
+    if(LZ4F_isError(ret)) {
+      FDEBUG(9) << "LZ4 compression error: " << LZ4F_getErrorName(ret) << std::endl;
+      std::cerr << "LZ4 compression error: " << LZ4F_getErrorName(ret) << std::endl;
+      return 0;
+    }
+    FDEBUG(1) << " original size = " << inputSize
+              << " final size = " << ret
+              << " ratio = " << double(ret)/double(inputSize)
+              << std::endl;
+    return ret;
+  }
+
+  unsigned int
+  StreamSerializer::compressBufferZSTD(unsigned char *inputBuffer,
+                                       unsigned int inputSize,
+                                       std::vector<unsigned char> &outputBuffer,
+                                       int compressionLevel) {
+    size_t const dest_size = ZSTD_compressBound(inputSize);
+    if(outputBuffer.size() < dest_size) outputBuffer.resize(dest_size);
+
+    size_t const ret = ZSTD_compress(&outputBuffer[0], dest_size, inputBuffer, inputSize, compressionLevel);
+    if(ZSTD_isError(ret)) {
+      FDEBUG(9) << "ZSTD compression error: " << ZSTD_getErrorName(ret) << std::endl;
+      std::cerr << "ZSTD compression error: " << ZSTD_getErrorName(ret) << std::endl;
+      return 0;
+    }
+    FDEBUG(1) << " original size = " << inputSize
+              << " final size = " << ret
+              << " ratio = " << double(ret)/double(inputSize)
+              << std::endl;
+    return ret;
+  }
+
+  std::vector<unsigned char>
+  StreamSerializer::trainZSTDDictionary(std::vector<std::vector<unsigned char>> const& samples,
+                                        unsigned int maxDictionarySize) {
+    std::vector<unsigned char> samplesBuffer;
+    std::vector<size_t> samplesSizes;
+    samplesSizes.reserve(samples.size());
+    for(auto const& sample : samples) {
+      samplesBuffer.insert(samplesBuffer.end(), sample.begin(), sample.end());
+      samplesSizes.push_back(sample.size());
+    }
+
+    std::vector<unsigned char> dictionary(maxDictionarySize);
+    if(samplesBuffer.empty() or dictionary.empty()) {
+      dictionary.clear();
+      return dictionary;
+    }
+    size_t const ret = ZDICT_trainFromBuffer(&dictionary[0], dictionary.size(),
+                                             &samplesBuffer[0], &samplesSizes[0], samplesSizes.size());
+    if(ZDICT_isError(ret)) {
+      FDEBUG(9) << "ZSTD dictionary training failed: " << ZDICT_getErrorName(ret) << std::endl;
+      dictionary.clear();
+      return dictionary;
+    }
+    FDEBUG(1) << " trained ZSTD dictionary of size " << ret
+              << " on " << samplesSizes.size() << " events"
+              << std::endl;
+    dictionary.resize(ret);
+    return dictionary;
+  }
+
+  void
+  StreamSerializer::setZSTDDictionary(std::vector<unsigned char> const& dictionary, int compressionLevel) {
+    zstdDictionary_ = dictionary;
+    zstdCDict_.reset();
+    if(zstdDictionary_.empty()) {
+      return;
+    }
+    ZSTD_CDict* cdict = ZSTD_createCDict(&zstdDictionary_[0], zstdDictionary_.size(), compressionLevel);
+    if(cdict == nullptr) {
+      throw cms::Exception("StreamTranslation","ZSTD dictionary error")
+        << "Could not create the ZSTD compression dictionary\n";
+    }
+    zstdCDict_ = std::shared_ptr<ZSTD_CDict>(cdict, ZSTD_freeCDict);
+    if(not zstdCCtx_) {
+      zstdCCtx_ = std::shared_ptr<ZSTD_CCtx>(ZSTD_createCCtx(), ZSTD_freeCCtx);
+    }
+  }
+
+  unsigned int
+  StreamSerializer::compressBufferZSTDWithDictionary(unsigned char *inputBuffer,
+                                                     unsigned int inputSize,
+                                                     std::vector<unsigned char> &outputBuffer) {
+    size_t const dest_size = ZSTD_compressBound(inputSize);
+    if(outputBuffer.size() < dest_size) outputBuffer.resize(dest_size);
+
+    size_t const ret = ZSTD_compress_usingCDict(zstdCCtx_.get(), &outputBuffer[0], dest_size,
+                                                inputBuffer, inputSize, zstdCDict_.get());
+    if(ZSTD_isError(ret)) {
+      FDEBUG(9) << "ZSTD compression error: " << ZSTD_getErrorName(ret) << std::endl;
+      std::cerr << "ZSTD compression error: " << ZSTD_getErrorName(ret) << std::endl;
+      return 0;
+    }
+    FDEBUG(1) << " original size = " << inputSize
+              << " final size = " << ret
+              << " ratio = " << double(ret)/double(inputSize)
+              << std::endl;
+    return ret;
+  }
 }
@@ -10,9 +10,17 @@
 #include "Utilities/StorageFactory/interface/IOFlags.h"
 #include "Utilities/StorageFactory/interface/StorageFactory.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace edm {
 
   StreamerInputFile::~StreamerInputFile() {
@@ -20,7 +28,8 @@ namespace edm {
   }
 
   StreamerInputFile::StreamerInputFile(std::string const& name,
-                                       std::shared_ptr<EventSkipperByID> eventSkipperByID) :
+                                       std::shared_ptr<EventSkipperByID> eventSkipperByID,
+                                       bool memoryMapFiles) :
     startMsg_(),
     currentEvMsg_(),
     headerBuf_(1000*1000),
@@ -35,13 +44,18 @@ namespace edm {
     currProto_(0),
     newHeader_(false),
     storage_(),
+    memoryMapFiles_(memoryMapFiles),
+    mappedData_(nullptr),
+    mappedSize_(0),
+    mappedPosition_(0),
     endOfFile_(false) {
     openStreamerFile(name);
     readStartMessage();
   }
 
   StreamerInputFile::StreamerInputFile(std::vector<std::string> const& names,
-                                       std::shared_ptr<EventSkipperByID> eventSkipperByID) :
+                                       std::shared_ptr<EventSkipperByID> eventSkipperByID,
+                                       bool memoryMapFiles) :
     startMsg_(),
     currentEvMsg_(),
     headerBuf_(1000*1000),
@@ -55,6 +69,10 @@ namespace edm {
     currRun_(0),
     currProto_(0),
     newHeader_(false),
+    memoryMapFiles_(memoryMapFiles),
+    mappedData_(nullptr),
+    mappedSize_(0),
+    mappedPosition_(0),
     endOfFile_(false) {
     openStreamerFile(names.at(0));
     ++currentFile_;
@@ -71,6 +89,12 @@ namespace edm {
     currentFileName_ = name;
     logFileAction("  Initiating request to open file ");
 
+    if(memoryMapFiles_ && mapStreamerFile(name)) {
+      currentFileOpen_ = true;
+      logFileAction("  Successfully mapped file ");
+      return;
+    }
+
     IOOffset size = -1;
     if(StorageFactory::get()->check(name, &size)) {
       try {
@@ -93,9 +117,51 @@ namespace edm {
     logFileAction("  Successfully opened file ");
   }
 
+  bool
+  StreamerInputFile::mapStreamerFile(std::string const& name) {
+    // Only local files can be mapped, everything else goes through the StorageFactory
+    std::string path = name;
+    if(path.compare(0, 5, "file:") == 0) {
+      path = path.substr(5);
+    } else if(path.find(':') != std::string::npos) {
+      return false;
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+    // MAP_PRIVATE so that ROOT may write into the buffers it deserializes
+    // from without touching the file
+    void* data = ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    int const mapErrno = errno;
+    ::close(fd);
+    if(data == MAP_FAILED) {
+      LogWarning("StreamerInputFile") << "Could not memory map " << path << ": "
+                                      << std::strerror(mapErrno) << ", falling back to reading the file";
+      return false;
+    }
+    ::madvise(data, st.st_size, MADV_SEQUENTIAL);
+    mappedData_ = static_cast<char*>(data);
+    mappedSize_ = st.st_size;
+    mappedPosition_ = 0;
+    return true;
+  }
+
   void
   StreamerInputFile::closeStreamerFile() {
-    if(currentFileOpen_ && storage_) {
+    if(currentFileOpen_ && mappedData_) {
+      ::munmap(mappedData_, mappedSize_);
+      mappedData_ = nullptr;
+      mappedSize_ = 0;
+      mappedPosition_ = 0;
+      logFileAction("  Closed file ");
+    } else if(currentFileOpen_ && storage_) {
       storage_->close();
       logFileAction("  Closed file ");
     }
@@ -103,6 +169,12 @@ namespace edm {
   }
 
   IOSize StreamerInputFile::readBytes(char *buf, IOSize nBytes) {
+    if(mappedData_) {
+      IOSize n = std::min(nBytes, mappedSize_ - mappedPosition_);
+      std::memcpy(buf, mappedData_ + mappedPosition_, n);
+      mappedPosition_ += n;
+      return n;
+    }
     IOSize n = 0;
     try {
       n = storage_->read(buf, nBytes);
@@ -116,6 +188,11 @@ namespace edm {
   }
 
   IOOffset StreamerInputFile::skipBytes(IOSize nBytes) {
+    if(mappedData_) {
+      IOSize n = std::min(nBytes, mappedSize_ - mappedPosition_);
+      mappedPosition_ += n;
+      return n;
+    }
     IOOffset n = 0;
     try {
       // We wish to return the number of bytes skipped, not the final offset.
@@ -225,10 +302,19 @@ namespace edm {
     if(endOfFile_) return 0;
 
     bool eventRead = false;
+    char* eventStart = &eventBuf_[0];
     while(!eventRead) {
 
       IOSize nWant = sizeof(EventHeader);
-      IOSize nGot = readBytes(&eventBuf_[0], nWant);
+      IOSize nGot = 0;
+      if(mappedData_) {
+        // the event is used in place, the mapping stays valid until the file is closed
+        eventStart = mappedData_ + mappedPosition_;
+        nGot = skipBytes(nWant);
+      } else {
+        eventStart = &eventBuf_[0];
+        nGot = readBytes(eventStart, nWant);
+      }
       if(nGot == 0) {
         // no more data available
         endOfFile_ = true;
@@ -239,7 +325,7 @@ namespace edm {
           << "Failed reading streamer file, first read in readEventMessage\n"
           << "Requested " << nWant << " bytes, read function returned " << nGot << " bytes\n";
       }
-      HeaderView head(&eventBuf_[0]);
+      HeaderView head(eventStart);
       uint32 code = head.code();
 
       // If it is not an event then something is wrong.
@@ -255,14 +341,22 @@ namespace edm {
       }
       eventRead = true;
       if(eventSkipperByID_) {
-        EventHeader *evh = (EventHeader *)(&eventBuf_[0]);
+        EventHeader *evh = (EventHeader *)(eventStart);
         if(eventSkipperByID_->skipIt(convert32(evh->run_), convert32(evh->lumi_), convert64(evh->event_))) {
           eventRead = false;
         }
       }
       nWant = eventSize - sizeof(EventHeader);
-      if(eventRead) {
+      if(eventRead && mappedData_) {
+        nGot = skipBytes(nWant);
+        if(nGot != nWant) {
+          throw Exception(errors::FileReadError, "StreamerInputFile::readEventMessage")
+            << "Failed reading streamer file, mapped event in readEventMessage is truncated\n"
+            << "Requested " << nWant << " bytes, file has " << nGot << " bytes left\n";
+        }
+      } else if(eventRead) {
         if(eventBuf_.size() < eventSize) eventBuf_.resize(eventSize);
+        eventStart = &eventBuf_[0];
         nGot = readBytes(&eventBuf_[sizeof(EventHeader)], nWant);
         if(nGot != nWant) {
           throw Exception(errors::FileReadError, "StreamerInputFile::readEventMessage")
@@ -278,7 +372,7 @@ namespace edm {
         }
       }
     }
-    currentEvMsg_ = std::make_shared<EventMsgView>((void*)&eventBuf_[0]); // propagate_const<T> has no reset() function
+    currentEvMsg_ = std::make_shared<EventMsgView>((void*)eventStart); // propagate_const<T> has no reset() function
     return 1;
   }
 
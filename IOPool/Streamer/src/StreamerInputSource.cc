@@ -17,6 +17,8 @@
 #include "DataFormats/Provenance/interface/ThinnedAssociationsHelper.h"
 
 #include "zlib.h"
+#include "lz4frame.h"
+#include "zstd.h"
 
 #include "DataFormats/Common/interface/RefCoreStreamer.h"
 #include "FWCore/Utilities/interface/WrappedClassName.h"
@@ -38,6 +40,19 @@
 namespace edm {
   namespace {
     int const init_size = 1024*1024;
+
+    // The LZ4 and ZSTD frames start with a magic number (stored little endian)
+    // which can never be the first bytes of a zlib stream, so the format of the
+    // event data does not need to change.
+    bool isBufferLZ4(unsigned char const* inputBuffer, unsigned int inputSize) {
+      return inputSize >= 4 && inputBuffer[0] == 0x04 && inputBuffer[1] == 0x22 &&
+             inputBuffer[2] == 0x4D && inputBuffer[3] == 0x18;
+    }
+
+    bool isBufferZSTD(unsigned char const* inputBuffer, unsigned int inputSize) {
+      return inputSize >= 4 && inputBuffer[0] == 0x28 && inputBuffer[1] == 0xB5 &&
+             inputBuffer[2] == 0x2F && inputBuffer[3] == 0xFD;
+    }
   }
 
   StreamerInputSource::StreamerInputSource(
@@ -51,7 +66,8 @@ namespace edm {
     eventPrincipalHolder_(),
     adjustEventToNewProductRegistry_(false),
     processName_(),
-    protocolVersion_(0U) {
+    protocolVersion_(0U),
+    zstdDictionary_() {
   }
 
   StreamerInputSource::~StreamerInputSource() {}
@@ -171,6 +187,17 @@ namespace edm {
     }
 
     sd->initializeTransients();
+
+    // the events following this INIT message may be compressed with its dictionary
+    zstdDictionary_.reset();
+    if(initView.dictLength() != 0) {
+      ZSTD_DDict* ddict = ZSTD_createDDict(initView.dictData(), initView.dictLength());
+      if(ddict == nullptr) {
+        throw cms::Exception("StreamTranslation","Registry deserialization error")
+          << "Could not read the ZSTD dictionary of the INIT message\n";
+      }
+      zstdDictionary_ = std::shared_ptr<ZSTD_DDict>(ddict, ZSTD_freeDDict);
+    }
     return sd;
   }
 
@@ -227,24 +254,25 @@ namespace edm {
         << " chksum from event = " << adler32_chksum << " from header = "
         << eventView.adler32_chksum() << " host name = " << eventView.hostName() << std::endl;
     }
+    xbuf_.Reset();
     if(origsize != 78 && origsize != 0) {
       // compressed
-      dest_size = uncompressBuffer(const_cast<unsigned char*>((unsigned char const*)eventView.eventData()),
-                                   eventView.eventLength(), dest_, origsize);
+      unsigned char* compressed = const_cast<unsigned char*>((unsigned char const*)eventView.eventData());
+      unsigned int const compressedSize = eventView.eventLength();
+      if(isBufferLZ4(compressed, compressedSize)) {
+        dest_size = uncompressBufferLZ4(compressed, compressedSize, dest_, origsize);
+      } else if(isBufferZSTD(compressed, compressedSize)) {
+        dest_size = uncompressBufferZSTD(compressed, compressedSize, dest_, origsize, zstdDictionary_.get());
+      } else {
+        dest_size = uncompressBuffer(compressed, compressedSize, dest_, origsize);
+      }
+      xbuf_.SetBuffer(&dest_[0],dest_size,kFALSE);
     } else { // not compressed
-      // we need to copy anyway the buffer as we are using dest in xbuf
+      // The event is streamed directly from the message buffer. The buffer is
+      // not adopted and is only read while deserializing below, so no copy is needed.
       dest_size = eventView.eventLength();
-      dest_.resize(dest_size);
-      unsigned char* pos = (unsigned char*) &dest_[0];
-      unsigned char const* from = (unsigned char const*) eventView.eventData();
-      std::copy(from,from+dest_size,pos);
+      xbuf_.SetBuffer(const_cast<unsigned char*>((unsigned char const*)eventView.eventData()),dest_size,kFALSE);
     }
-    //TBuffer xbuf(TBuffer::kRead, dest_size,
-    //             (char const*) &dest[0],kFALSE);
-    //TBuffer xbuf(TBuffer::kRead, eventView.eventLength(),
-    //             (char const*) eventView.eventData(),kFALSE);
-    xbuf_.Reset();
-    xbuf_.SetBuffer(&dest_[0],dest_size,kFALSE);
     RootDebug tracer(10,10);
 
     //We do not yet know which EventPrincipal we will use, therefore
@@ -384,6 +412,79 @@ namespace edm {
     return (unsigned int) uncompressedSize;
   }
 
+  unsigned int
+  StreamerInputSource::uncompressBufferLZ4(unsigned char* inputBuffer,
+                                           unsigned int inputSize,
+                                           std::vector<unsigned char>& outputBuffer,
+                                           unsigned int expectedFullSize) {
+    FDEBUG(1) << "Uncompress LZ4: original size = " << expectedFullSize
+              << ", compressed size = " << inputSize
+              << std::endl;
+    if(outputBuffer.size() < expectedFullSize) outputBuffer.resize(expectedFullSize);
+
+    LZ4F_decompressionContext_t context;
+    size_t ret = LZ4F_createDecompressionContext(&context, LZ4F_VERSION);
+    if(LZ4F_isError(ret)) {
+      throw cms::Exception("StreamDeserialization","Uncompression error")
+        << "Could not create LZ4 context: " << LZ4F_getErrorName(ret) << "\n";
+    }
+    std::shared_ptr<void> contextGuard(nullptr, [context](void*) { LZ4F_freeDecompressionContext(context); });
+
+    size_t uncompressedSize = 0;
+    size_t consumed = 0;
+    do {
+      size_t dstSize = outputBuffer.size() - uncompressedSize;
+      size_t srcSize = inputSize - consumed;
+      ret = LZ4F_decompress(context, &outputBuffer[uncompressedSize], &dstSize,
+                            inputBuffer + consumed, &srcSize, nullptr);
+      if(LZ4F_isError(ret)) {
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+          << "Error code = " << LZ4F_getErrorName(ret) << "\n ";
+      }
+      uncompressedSize += dstSize;
+      consumed += srcSize;
+      // a frame larger than the declared size is an error, not a reason to grow
+    } while(ret != 0 && consumed < inputSize && uncompressedSize < outputBuffer.size());
+
+    if(ret != 0 || uncompressedSize != expectedFullSize) {
+      throw cms::Exception("StreamDeserialization","Uncompression error")
+        << "mismatch event lengths should be" << expectedFullSize << " got "
+        << uncompressedSize << "\n";
+    }
+    return (unsigned int) uncompressedSize;
+  }
+
+  unsigned int
+  StreamerInputSource::uncompressBufferZSTD(unsigned char* inputBuffer,
+                                            unsigned int inputSize,
+                                            std::vector<unsigned char>& outputBuffer,
+                                            unsigned int expectedFullSize,
+                                            ZSTD_DDict_s const* dictionary) {
+    FDEBUG(1) << "Uncompress ZSTD: original size = " << expectedFullSize
+              << ", compressed size = " << inputSize
+              << std::endl;
+    if(outputBuffer.size() < expectedFullSize) outputBuffer.resize(expectedFullSize);
+
+    size_t ret = 0;
+    if(dictionary != nullptr) {
+      std::unique_ptr<ZSTD_DCtx, size_t(*)(ZSTD_DCtx*)> context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+      ret = ZSTD_decompress_usingDDict(context.get(), &outputBuffer[0], expectedFullSize,
+                                       inputBuffer, inputSize, dictionary);
+    } else {
+      ret = ZSTD_decompress(&outputBuffer[0], expectedFullSize, inputBuffer, inputSize);
+    }
+    if(ZSTD_isError(ret)) {
+      throw cms::Exception("StreamDeserialization","Uncompression error")
+        << "Error code = " << ZSTD_getErrorName(ret) << "\n ";
+    }
+    if(ret != expectedFullSize) {
+      throw cms::Exception("StreamDeserialization","Uncompression error")
+        << "mismatch event lengths should be" << expectedFullSize << " got "
+        << ret << "\n";
+    }
+    return (unsigned int) ret;
+  }
+
   void StreamerInputSource::resetAfterEndRun() {
      // called from an online streamer source to reset after a stop command
      // so an enable command will work
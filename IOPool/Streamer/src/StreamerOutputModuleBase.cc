@@ -2,12 +2,15 @@
 #include "IOPool/Streamer/interface/StreamerOutputModuleBase.h"
 
 #include "IOPool/Streamer/interface/InitMsgBuilder.h"
+#include "IOPool/Streamer/interface/EventMessage.h"
 #include "IOPool/Streamer/interface/EventMsgBuilder.h"
 #include "FWCore/Framework/interface/EventForOutput.h"
 #include "FWCore/Framework/interface/EventSelector.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Adler32Calculator.h"
 #include "FWCore/Utilities/interface/DebugMacros.h"
+#include "FWCore/Utilities/interface/Exception.h"
 //#include "FWCore/Utilities/interface/Digest.h"
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 #include "DataFormats/Common/interface/TriggerResults.h"
@@ -21,6 +24,8 @@
 #include <unistd.h>
 #include <vector>
 #include "zlib.h"
+#include "lz4hc.h"
+#include "zstd.h"
 
 namespace {
   //A utility function that packs bits from source into bytes, with
@@ -60,7 +65,13 @@ namespace edm {
     selections_(&keptProducts()[InEvent]),
     maxEventSize_(ps.getUntrackedParameter<int>("max_event_size")),
     useCompression_(ps.getUntrackedParameter<bool>("use_compression")),
+    compressionAlgoStr_(ps.getUntrackedParameter<std::string>("compression_algorithm")),
+    compressionAlgo_(ZLIB),
     compressionLevel_(ps.getUntrackedParameter<int>("compression_level")),
+    dictionaryTrainingEvents_(ps.getUntrackedParameter<unsigned int>("zstd_dictionary_training_events")),
+    maxDictionarySize_(ps.getUntrackedParameter<unsigned int>("zstd_dictionary_size")),
+    trainingDictionary_(false),
+    trainingEventMessages_(),
     lumiSectionInterval_(ps.getUntrackedParameter<int>("lumiSection_interval")),
     serializer_(selections_),
     serializeDataBuffer_(),
@@ -81,18 +92,34 @@ namespace edm {
     gettimeofday(&now, &dummyTZ);
     timeInSecSinceUTC = static_cast<double>(now.tv_sec) + (static_cast<double>(now.tv_usec)/1000000.0);
 
+    if(compressionAlgoStr_ == "ZLIB") {
+      compressionAlgo_ = ZLIB;
+    } else if(compressionAlgoStr_ == "LZ4") {
+      compressionAlgo_ = LZ4;
+    } else if(compressionAlgoStr_ == "ZSTD") {
+      compressionAlgo_ = ZSTD;
+    } else {
+      throw cms::Exception("StreamerOutputModuleBase", "Compression type unknown")
+        << "Unknown compression algorithm '" << compressionAlgoStr_ << "'. Supported types are ZLIB, LZ4 and ZSTD\n";
+    }
+
     if(useCompression_ == true) {
+      // the largest level each library accepts
+      int const maxLevel = compressionAlgo_ == ZSTD ? ZSTD_maxCLevel() : (compressionAlgo_ == LZ4 ? LZ4HC_CLEVEL_MAX : 9);
       if(compressionLevel_ <= 0) {
         FDEBUG(9) << "Compression Level = " << compressionLevel_
                   << " no compression" << std::endl;
         compressionLevel_ = 0;
         useCompression_ = false;
-      } else if(compressionLevel_ > 9) {
+      } else if(compressionLevel_ > maxLevel) {
         FDEBUG(9) << "Compression Level = " << compressionLevel_
-                  << " using max compression level 9" << std::endl;
-        compressionLevel_ = 9;
+                  << " using max compression level " << maxLevel << std::endl;
+        compressionLevel_ = maxLevel;
       }
     }
+    if(!useCompression_) {
+      compressionAlgo_ = UNCOMPRESSED;
+    }
     serializeDataBuffer_.bufs_.resize(maxEventSize_);
     int got_host = gethostname(host_name_, 255);
     if(got_host != 0) strncpy(host_name_, "noHostNameFoundOrTooLong", sizeof(host_name_));
@@ -108,6 +135,12 @@ namespace edm {
   void
   StreamerOutputModuleBase::beginRun(RunForOutput const&) {
     start();
+    if(compressionAlgo_ == ZSTD && dictionaryTrainingEvents_ > 0) {
+      // the INIT message is written by writeTrainingEvents()
+      serializer_.setZSTDDictionary(std::vector<unsigned char>(), compressionLevel_);
+      trainingDictionary_ = true;
+      return;
+    }
     std::unique_ptr<InitMsgBuilder>  init_message = serializeRegistry();
     doOutputHeader(*init_message);
     serializeDataBuffer_.header_buf_.clear();
@@ -116,6 +149,7 @@ namespace edm {
 
   void
   StreamerOutputModuleBase::endRun(RunForOutput const&) {
+    if(trainingDictionary_) writeTrainingEvents();
     stop();
   }
 
@@ -124,6 +158,7 @@ namespace edm {
 
   void
   StreamerOutputModuleBase::endJob() {
+    if(trainingDictionary_) writeTrainingEvents();
     stop();  // for closing of files, notify storage manager, etc.
   }
 
@@ -133,12 +168,88 @@ namespace edm {
   void
   StreamerOutputModuleBase::writeLuminosityBlock(LuminosityBlockForOutput const&) {}
 
+  void
+  StreamerOutputModuleBase::endLuminosityBlock(LuminosityBlockForOutput const& lb) {
+    // the events of a block may not be held back past its end, e.g. when
+    // each block goes to its own file; a block without events leaves the
+    // training to the following ones rather than train on nothing
+    if(trainingDictionary_ && !trainingEventMessages_.empty()) writeTrainingEvents();
+    closeLuminosityBlock(lb);
+  }
+
   void
   StreamerOutputModuleBase::write(EventForOutput const& e) {
     std::unique_ptr<EventMsgBuilder> msg = serializeEvent(e);
+    if(trainingDictionary_) {
+      char const* start = (char const*)msg->startAddress();
+      trainingEventMessages_.emplace_back(start, start + msg->size());
+      if(trainingEventMessages_.size() >= dictionaryTrainingEvents_) writeTrainingEvents();
+      return;
+    }
     doOutputEvent(*msg); // You can't use msg in StreamerOutputModuleBase after this point
   }
 
+  void
+  StreamerOutputModuleBase::writeTrainingEvents() {
+    trainingDictionary_ = false;
+
+    std::vector<std::vector<unsigned char>> samples;
+    samples.reserve(trainingEventMessages_.size());
+    for(auto& buf : trainingEventMessages_) {
+      EventMsgView view(&buf[0]);
+      samples.emplace_back(view.eventData(), view.eventData() + view.eventLength());
+    }
+    // If the training fails (e.g. too few events in the run) the events
+    // are compressed without a dictionary.
+    std::vector<unsigned char> dictionary = StreamSerializer::trainZSTDDictionary(samples, maxDictionarySize_);
+    FDEBUG(9) << "ZSTD dictionary of size " << dictionary.size()
+              << " trained on " << samples.size() << " events" << std::endl;
+    serializer_.setZSTDDictionary(dictionary, compressionLevel_);
+
+    std::unique_ptr<InitMsgBuilder>  init_message = serializeRegistry();
+    doOutputHeader(*init_message);
+    serializeDataBuffer_.header_buf_.clear();
+    serializeDataBuffer_.header_buf_.shrink_to_fit();
+
+    for(auto& buf : trainingEventMessages_) {
+      EventMsgView view(&buf[0]);
+      std::unique_ptr<EventMsgBuilder> msg = compressTrainingEvent(view);
+      doOutputEvent(*msg);
+    }
+    trainingEventMessages_.clear();
+    trainingEventMessages_.shrink_to_fit();
+  }
+
+  std::unique_ptr<EventMsgBuilder>
+  StreamerOutputModuleBase::compressTrainingEvent(EventMsgView const& view) {
+    unsigned char* src = const_cast<unsigned char*>(view.eventData());
+    unsigned int const eventSize = view.eventLength();
+    std::vector<unsigned char>& comp_buf = serializeDataBuffer_.comp_buf_;
+    unsigned int dest_size = serializer_.zstdDictionary().empty() ?
+      StreamSerializer::compressBufferZSTD(src, eventSize, comp_buf, compressionLevel_) :
+      serializer_.compressBufferZSTDWithDictionary(src, eventSize, comp_buf);
+    unsigned char* data = (dest_size != 0) ? &comp_buf[0] : src;
+    unsigned int const data_size = (dest_size != 0) ? dest_size : eventSize;
+
+    unsigned int new_size = data_size + 50000;
+    if(serializeDataBuffer_.bufs_.size() < new_size) serializeDataBuffer_.bufs_.resize(new_size);
+
+    std::vector<bool> l1bits;
+    view.l1TriggerBits(l1bits);
+    std::vector<unsigned char> hltbits(view.hltCount() == 0 ? 1 : 1 + (view.hltCount()-1)/4);
+    view.hltTriggerBits(&hltbits[0]);
+
+    auto msg = std::make_unique<EventMsgBuilder>(
+                              &serializeDataBuffer_.bufs_[0], serializeDataBuffer_.bufs_.size(), view.run(),
+                              view.event(), view.lumi(), view.outModId(), view.droppedEventsCount(),
+                              l1bits, &hltbits[0], view.hltCount(),
+                              (uint32)cms::Adler32((char const*)data, data_size), host_name_);
+    msg->setOrigDataSize(dest_size != 0 ? eventSize : 0);
+    std::copy(data, data + data_size, msg->eventAddr());
+    msg->setEventLength(data_size);
+    return msg;
+  }
+
   std::unique_ptr<InitMsgBuilder>
   StreamerOutputModuleBase::serializeRegistry() {
 
@@ -147,7 +258,8 @@ namespace edm {
     // resize bufs_ to reflect space used in serializer_ + header
     // I just added an overhead for header of 50000 for now
     unsigned int src_size = serializeDataBuffer_.currentSpaceUsed();
-    unsigned int new_size = src_size + 50000;
+    std::vector<unsigned char> const& dictionary = serializer_.zstdDictionary();
+    unsigned int new_size = src_size + dictionary.size() + 50000;
     if(serializeDataBuffer_.header_buf_.size() < new_size) serializeDataBuffer_.header_buf_.resize(new_size);
 
     //Build the INIT Message
@@ -194,6 +306,9 @@ namespace edm {
     unsigned char* src = serializeDataBuffer_.bufferPointer();
     std::copy(src, src + src_size, init_message->dataAddress());
     init_message->setDataLength(src_size);
+    if(!dictionary.empty()) {
+      init_message->setDictionary(&dictionary[0], dictionary.size());
+    }
     return init_message;
   }
 
@@ -264,7 +379,9 @@ namespace edm {
       setLumiSection();
     }
 
-    serializer_.serializeEvent(e, selectorConfig(), useCompression_, compressionLevel_, serializeDataBuffer_);
+    // events kept for the dictionary training are compressed later
+    StreamerCompressionAlgo const compressionAlgo = trainingDictionary_ ? UNCOMPRESSED : compressionAlgo_;
+    serializer_.serializeEvent(e, selectorConfig(), compressionAlgo, compressionLevel_, serializeDataBuffer_);
 
     // resize bufs_ to reflect space used in serializer_ + header
     // I just added an overhead for header of 50000 for now
@@ -291,7 +408,7 @@ namespace edm {
     unsigned char* src = serializeDataBuffer_.bufferPointer();
     std::copy(src,src + src_size, msg->eventAddr());
     msg->setEventLength(src_size);
-    if(useCompression_) msg->setOrigDataSize(serializeDataBuffer_.currentEventSize());
+    if(compressionAlgo != UNCOMPRESSED) msg->setOrigDataSize(serializeDataBuffer_.currentEventSize());
 
     l1bit_.clear();  //Clear up for the next event to come.
     return msg;
@@ -304,7 +421,15 @@ namespace edm {
     desc.addUntracked<bool>("use_compression", true)
         ->setComment("If True, compression will be used to write streamer file.");
     desc.addUntracked<int>("compression_level", 1)
-        ->setComment("ROOT compression level to use.");
+        ->setComment("Compression level to use, its range depends on 'compression_algorithm'.");
+    desc.addUntracked<std::string>("compression_algorithm", "ZLIB")
+        ->setComment("Algorithm used to compress the events: 'ZLIB', 'LZ4' or 'ZSTD'.");
+    desc.addUntracked<unsigned int>("zstd_dictionary_training_events", 0)
+        ->setComment("If not 0 and 'compression_algorithm' is 'ZSTD', a dictionary is trained on this many events\n"
+                     "at the start of each run and stored in the INIT message. The INIT message and these events\n"
+                     "are only written once the training is done, or at the end of the luminosity block if sooner.");
+    desc.addUntracked<unsigned int>("zstd_dictionary_size", 112640)
+        ->setComment("Maximum size in bytes of the trained ZSTD dictionary.");
     desc.addUntracked<int>("lumiSection_interval", 0)
         ->setComment("If 0, use lumi section number from event.\n"
                      "If not 0, the interval in seconds between fake lumi sections.");
@@ -0,0 +1,7 @@
+import FWCore.ParameterSet.Config as cms
+
+from NewStreamIn_cfg import process
+
+process.source.fileNames = ['file:teststreamfile_zstd.dat']
+process.source.memoryMapFiles = cms.untracked.bool(True)
+process.out.fileName = 'myout_zstd.root'
@@ -0,0 +1,6 @@
+import FWCore.ParameterSet.Config as cms
+
+from NewStreamIn_cfg import process
+
+process.source.fileNames = ['file:teststreamfile_zstddict.dat']
+process.out.fileName = 'myout_zstddict.root'
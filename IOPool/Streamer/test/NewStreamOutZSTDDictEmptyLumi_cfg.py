@@ -0,0 +1,23 @@
+import FWCore.ParameterSet.Config as cms
+
+from NewStreamOutZSTDDict_cfg import process
+
+# the first luminosity block has no event: the dictionary must be trained
+# on the events of the second one
+transitions = [cms.PSet(type = cms.untracked.string("IsFile"),
+                        id = cms.untracked.EventID(0,0,0)),
+               cms.PSet(type = cms.untracked.string("IsRun"),
+                        id = cms.untracked.EventID(1,0,0)),
+               cms.PSet(type = cms.untracked.string("IsLumi"),
+                        id = cms.untracked.EventID(1,1,0)),
+               cms.PSet(type = cms.untracked.string("IsLumi"),
+                        id = cms.untracked.EventID(1,2,0))]
+transitions += [cms.PSet(type = cms.untracked.string("IsEvent"),
+                         id = cms.untracked.EventID(1,2,i)) for i in range(1,31)]
+
+process.source = cms.Source("TestSource",
+    transitions = cms.untracked.VPSet(transitions)
+)
+process.maxEvents.input = -1
+
+process.out.fileName = 'teststreamfile_zstddict_emptylumi.dat'
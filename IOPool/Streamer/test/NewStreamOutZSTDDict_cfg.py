@@ -0,0 +1,6 @@
+import FWCore.ParameterSet.Config as cms
+
+from NewStreamOutZSTD_cfg import process
+
+process.out.fileName = 'teststreamfile_zstddict.dat'
+process.out.zstd_dictionary_training_events = cms.untracked.uint32(20)
@@ -0,0 +1,7 @@
+import FWCore.ParameterSet.Config as cms
+
+from NewStreamOut_cfg import process
+
+process.out.fileName = 'teststreamfile_zstd.dat'
+process.out.compression_algorithm = cms.untracked.string('ZSTD')
+process.out.compression_level = 3
@@ -21,6 +21,13 @@ cmsRun --parameter-set NewStreamIn_cfg.py  > in  2>&1 || die "cmsRun NewStreamIn
 cmsRun --parameter-set NewStreamIn2_cfg.py  > in2  2>&1 || die "cmsRun NewStreamIn2_cfg.py" $?
 cmsRun --parameter-set NewStreamCopy_cfg.py  > copy  2>&1 || die "cmsRun NewStreamCopy_cfg.py" $?
 cmsRun --parameter-set NewStreamCopy2_cfg.py  > copy2  2>&1 || die "cmsRun NewStreamCopy2_cfg.py" $?
+cmsRun --parameter-set NewStreamOutZSTD_cfg.py  > outzstd  2>&1 || die "cmsRun NewStreamOutZSTD_cfg.py" $?
+cmsRun --parameter-set NewStreamInMapped_cfg.py  > inmapped  2>&1 || die "cmsRun NewStreamInMapped_cfg.py" $?
+cmsRun --parameter-set NewStreamOutZSTDDict_cfg.py  > outzstddict  2>&1 || die "cmsRun NewStreamOutZSTDDict_cfg.py" $?
+cmsRun --parameter-set NewStreamInZSTDDict_cfg.py  > inzstddict  2>&1 || die "cmsRun NewStreamInZSTDDict_cfg.py" $?
+cmsRun --parameter-set NewStreamOutZSTDDictEmptyLumi_cfg.py  > outzstddictemptylumi  2>&1 || die "cmsRun NewStreamOutZSTDDictEmptyLumi_cfg.py" $?
+cmsRun --parameter-set NewStreamInZSTDDictEmptyLumi_cfg.py  > inzstddictemptylumi  2>&1 || die "cmsRun NewStreamInZSTDDictEmptyLumi_cfg.py" $?
+DiagStreamerFile teststreamfile_zstddict_emptylumi.dat > diagzstddictemptylumi 2>&1 || die "DiagStreamerFile teststreamfile_zstddict_emptylumi.dat" $?
 
 # echo "CHECKSUM = 1" > out
 # echo "CHECKSUM = 1" > in
@@ -30,6 +37,11 @@ ANS_OUT=`grep CHECKSUM out`
 ANS_IN=`grep CHECKSUM in`
 ANS_IN2=`grep CHECKSUM in2`
 ANS_COPY=`grep CHECKSUM copy`
+ANS_OUT_ZSTD=`grep CHECKSUM outzstd`
+ANS_IN_MAPPED=`grep CHECKSUM inmapped`
+ANS_IN_ZSTD_DICT=`grep CHECKSUM inzstddict`
+ANS_OUT_ZSTD_DICT_EMPTY_LUMI=`grep CHECKSUM outzstddictemptylumi`
+ANS_IN_ZSTD_DICT_EMPTY_LUMI=`grep CHECKSUM inzstddictemptylumi`
 
 if [ "${ANS_OUT_SIZE}" == "0" ]
 then
@@ -55,5 +67,29 @@ then
     RC=1
 fi
 
+if [ "${ANS_OUT}" != "${ANS_OUT_ZSTD}" ] || [ "${ANS_OUT}" != "${ANS_IN_MAPPED}" ]
+then
+    echo "New Stream Test Failed (ZSTD compressed or memory mapped out!=in)"
+    RC=1
+fi
+
+if [ "${ANS_OUT}" != "${ANS_IN_ZSTD_DICT}" ]
+then
+    echo "New Stream Test Failed (ZSTD dictionary out!=in)"
+    RC=1
+fi
+
+if [ "${ANS_OUT_ZSTD_DICT_EMPTY_LUMI}" == "" ] || [ "${ANS_OUT_ZSTD_DICT_EMPTY_LUMI}" != "${ANS_IN_ZSTD_DICT_EMPTY_LUMI}" ]
+then
+    echo "New Stream Test Failed (ZSTD dictionary after an empty luminosity block out!=in)"
+    RC=1
+fi
+
+if grep -q "Compression dictionary length = 0" diagzstddictemptylumi || ! grep -q "Compression dictionary length" diagzstddictemptylumi
+then
+    echo "New Stream Test Failed (no ZSTD dictionary trained after an empty luminosity block)"
+    RC=1
+fi
+
 #rm -rf ${OUTDIR}
 exit ${RC}
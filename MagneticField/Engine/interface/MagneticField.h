@@ -53,6 +53,12 @@ class MagneticField
   virtual GlobalVector inTeslaUnchecked (const GlobalPoint& gp) const {
     return inTesla(gp);  // default dummy implementation
   }
+
+  /// Field values at the n global points gp, in Tesla. Derived classes can
+  /// implement it to share the volume search and to vectorize the interpolation.
+  virtual void inTeslaBatch (const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+    for (unsigned int i=0; i!=n; ++i) b[i] = inTesla(gp[i]);  // default implementation
+  }
   
   /// The nominal field value for this map in kGauss
   int nominalValue() const {  
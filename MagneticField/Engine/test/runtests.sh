@@ -0,0 +1,5 @@
+#!/bin/bash
+
+function die { echo $1: status $2 ;  exit $2; }
+
+cmsRun ${LOCAL_TEST_DIR}/testMagneticFieldBatch_cfg.py || die 'Failure using testMagneticFieldBatch_cfg.py' $?
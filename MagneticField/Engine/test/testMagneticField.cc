@@ -12,6 +12,9 @@
  *  TOSCA = input test tables, searches for the corresponding volume/sector determined from the file name and path.
  *  TOSCAFileList = file with a list of TOSCA tables
  *  TOSCASecorComparison: compare each if the listed TOSCA txt tables with those of the other sectors
+ *
+ *  compareBatch: compare MagneticField::inTeslaBatch with inTesla on numberOfPoints points, along
+ *  straight tracks crossing volume boundaries and at random; throws if they differ
  * 
  *  \author N. Amapane - CERN
  */
@@ -25,6 +28,7 @@
 #include "FWCore/Framework/interface/MakerMacros.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include "MagneticField/Engine/interface/MagneticField.h"
 #include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
@@ -43,6 +47,7 @@
 #include <sstream>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
 #include <libgen.h>
 #include <boost/lexical_cast.hpp>
 
@@ -71,6 +76,8 @@ class testMagneticField : public edm::EDAnalyzer {
     OuterRadius = pset.getUntrackedParameter<double>("OuterRadius",900);
     //    half length of test cylinder
     HalfLength = pset.getUntrackedParameter<double>("HalfLength",2400);
+    //    compare the batched field queries with the single point ones
+    compareBatch = pset.getUntrackedParameter<bool>("compareBatch", false);
     
   }
 
@@ -94,6 +101,10 @@ class testMagneticField : public edm::EDAnalyzer {
    if (outputFile!="") {
      writeValidationTable(numberOfPoints,outputFile);
    }
+
+   if (compareBatch) {
+     validateBatch(numberOfPoints);
+   }
    
    if (inputFileType == "TOSCA") {
      validateVsTOSCATable(inputFile);
@@ -123,6 +134,7 @@ class testMagneticField : public edm::EDAnalyzer {
   }
   
   void writeValidationTable(int npoints, string filename);
+  void validateBatch(int npoints);
   void validate(string filename, string type="xyz");
   void validateVsTOSCATable(string filename);
 
@@ -143,6 +155,7 @@ class testMagneticField : public edm::EDAnalyzer {
   double OuterRadius;
   double InnerRadius;
   double HalfLength;
+  bool compareBatch;
 };
 
 
@@ -159,6 +172,48 @@ void testMagneticField::writeValidationTable(int npoints, string filename) {
   }
 }
 
+void testMagneticField::validateBatch(int npoints) {
+  GlobalPointProvider p(InnerRadius, OuterRadius, -Geom::pi(), Geom::pi(), -HalfLength, HalfLength);
+
+  // tracks of 40 points, 5 cm apart, as the stages of a Runge-Kutta step of several states;
+  // the last batch is of scattered points
+  vector<GlobalPoint> points;
+  const int pointsPerTrack = 40;
+  while (int(points.size()) + pointsPerTrack <= npoints/2) {
+    GlobalPoint start = p.getPoint();
+    GlobalVector dir = (p.getPoint() - start).unit();
+    for (int i = 0; i<pointsPerTrack; ++i) points.push_back(start + 5.f*i*dir);
+  }
+  while (int(points.size()) < npoints) points.push_back(p.getPoint());
+
+  vector<GlobalVector> batch(points.size());
+  const unsigned int batchSize = 100;
+  for (unsigned int first = 0; first < points.size(); first += batchSize) {
+    unsigned int n = std::min(batchSize, (unsigned int)(points.size()) - first);
+    field->inTeslaBatch(&points[first], &batch[first], n);
+  }
+
+  int fail = 0;
+  float maxdelta=0.;
+  for (unsigned int i = 0; i<points.size(); ++i) {
+    GlobalVector single = field->inTesla(points[i]);
+    float delta = (batch[i]-single).mag();
+    maxdelta = std::max(maxdelta, delta);
+    // the same up to a float rounding, in case the compiler contracts to FMA
+    if (delta > 1.e-5*(1.+single.mag())) {
+      ++fail;
+      cout << " Discrepancy at: " << points[i] << " R " << points[i].perp()
+	   << " batch: " << batch[i] << " single: " << single << endl;
+    }
+  }
+  cout << endl << " testMagneticField::validateBatch: tested " << points.size()
+       << " points " << fail << " failures; max delta = " << maxdelta
+       << endl << endl;
+  if (fail) {
+    throw cms::Exception("testMagneticField") << "inTeslaBatch differs from inTesla at " << fail << " points";
+  }
+}
+
 void testMagneticField::validate(string filename, string type) {  
   ifstream file(filename.c_str());
   string line;
@@ -0,0 +1,19 @@
+# Compares the batched field queries (MagneticField::inTeslaBatch) with
+# the single point ones on the full field map; fails if they differ.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("MAGNETICFIELDTEST")
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1)
+)
+
+process.load("MagneticField.Engine.volumeBasedMagneticField_160812_cfi")
+
+process.testField  = cms.EDAnalyzer("testMagneticField",
+    compareBatch = cms.untracked.bool(True),
+    numberOfPoints = cms.untracked.int32(100000)
+)
+process.p1 = cms.Path(process.testField)
@@ -24,7 +24,9 @@ using namespace std;
 class testMagGeometryAnalyzer : public edm::EDAnalyzer {
  public:
   /// Constructor
-  testMagGeometryAnalyzer(const edm::ParameterSet& pset) {};
+  testMagGeometryAnalyzer(const edm::ParameterSet& pset) :
+    benchmarkThreads(pset.getUntrackedParameter<unsigned int>("benchmarkThreads", 0)),
+    benchmarkLookups(pset.getUntrackedParameter<int>("benchmarkLookups", 1000000)) {};
 
   /// Destructor
   virtual ~testMagGeometryAnalyzer() {};
@@ -37,6 +39,10 @@ class testMagGeometryAnalyzer : public edm::EDAnalyzer {
   
  private:
   void testGrids( const vector<MagVolume6Faces const*>& bvol);
+
+  // Measure findVolume throughput from 1 to benchmarkThreads threads (0: skip)
+  unsigned int benchmarkThreads;
+  int benchmarkLookups;
 };
 
 using namespace edm;
@@ -55,6 +61,11 @@ void testMagGeometryAnalyzer::analyze(const edm::Event & event, const edm::Event
   //FIXME: the region to be tested is specified inside.
   exe.testFindVolume(10000000);
 
+  // Measure the lookup rate for an increasing number of threads
+  for (unsigned int n = 1; n <= benchmarkThreads; n *= 2) {
+    exe.testFindVolumeThroughput(benchmarkLookups, n);
+  }
+
   // Test that random points are inside one and only one volume
   // exe.testInside(100000,0.03); 
 
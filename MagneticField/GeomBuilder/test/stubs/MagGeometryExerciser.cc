@@ -9,9 +9,15 @@
 #include "MagneticField/GeomBuilder/test/stubs/MagGeometryExerciser.h"
 #include "MagneticField/VolumeBasedEngine/interface/MagGeometry.h"
 #include "MagneticField/VolumeGeometry/interface/MagVolume6Faces.h"
+#include "DataFormats/GeometryVector/interface/GlobalVector.h"
 #include "GlobalPointProvider.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <thread>
 
 using namespace std;
 
@@ -90,6 +96,58 @@ bool MagGeometryExerciser::testFindVolume(const GlobalPoint & gp){
 
 
 
+//----------------------------------------------------------------------
+// Measure the findVolume rate with nThreads threads, each one walking
+// along straight lines from the origin in 1 cm steps as a propagator
+// would, so that consecutive lookups are close to each other.
+void MagGeometryExerciser::testFindVolumeThroughput(int ntry, unsigned int nThreads){
+
+  cout << "-----------------------------------------------------" << endl
+       << " findVolume throughput test, " << nThreads << " threads" << endl;
+
+  float maxZ = 1999.9;
+  if (theGeometry->geometryVersion>=160812) maxZ=2399.9;
+  const float maxR = 899.9;
+
+  std::atomic<int> failures{0};
+  auto walk = [&](unsigned int seed) {
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> cosTheta(-1.f, 1.f);
+    std::uniform_real_distribution<float> phi(-Geom::fpi(), Geom::fpi());
+    int nFailed = 0;
+    int n = 0;
+    while (n < ntry) {
+      float ct = cosTheta(engine);
+      float st = std::sqrt(1.f-ct*ct);
+      float p = phi(engine);
+      GlobalVector dir(st*std::cos(p), st*std::sin(p), ct);
+      for (float s = 0.f; n < ntry; s += 1.f, ++n) {
+        GlobalPoint gp(s*dir.x(), s*dir.y(), s*dir.z());
+        if (gp.perp() > maxR || std::abs(gp.z()) > maxZ) break;
+        if (theGeometry->findVolume(gp) == nullptr) ++nFailed;
+      }
+    }
+    failures += nFailed;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < nThreads; ++i) {
+    threads.emplace_back(walk, i+1);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  double lookups = double(ntry)*nThreads;
+  cout << " Lookups: " << lookups << " Failures: " << failures
+       << " Time: " << elapsed.count() << " s"
+       << " Rate: " << lookups/elapsed.count() << " lookups/s"
+       << " (" << lookups/elapsed.count()/nThreads << " per thread)" << endl
+       << "-----------------------------------------------------" << endl;
+}
+
 //----------------------------------------------------------------------
 // Check that a set of points is inside() one and only one volume.
 void MagGeometryExerciser::testInside(int ntry, float tolerance) {
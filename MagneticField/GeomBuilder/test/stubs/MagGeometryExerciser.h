@@ -25,6 +25,7 @@ public:
 
   void testFindVolume(int ntry = 100000); // findVolume(random) test
   void testInside(int ntry = 100000, float tolerance=0.);     // inside(random) test
+  void testFindVolumeThroughput(int ntry = 1000000, unsigned int nThreads = 1); // findVolume lookups/s, track-like points
 
   //  void testFieldRandom(int ntry = 1000);// fieldInTesla vs MagneticField::inTesla (random)
   //  void testFieldVol1();  // fieldInTesla within vol 1 (tiny region)
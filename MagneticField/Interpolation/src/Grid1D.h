@@ -19,10 +19,12 @@ public:
 
 
   Scalar step() const {return 1./stepinv_;}
+  Scalar stepInverse() const {return stepinv_;}
   Scalar lower() const {return lower_;}
   Scalar upper() const {return upper_;}
   int nodes() const {return  edges_+2;}
   int cells() const {return  edges_+1;}
+  int edges() const {return  edges_;}
 
   Scalar node( int i) const { return i*step() + lower();}
 
@@ -3,6 +3,9 @@
 #include "Grid3D.h"
 #include "MagneticField/VolumeGeometry/interface/MagExceptions.h"
 
+#include <algorithm>
+#include <cmath>
+
 void
 LinearGridInterpolator3D::throwGridInterpolator3DException(void)
 {
@@ -119,3 +122,55 @@ LinearGridInterpolator3D::interpolate( Scalar a, Scalar b, Scalar c)
 
 
 }
+
+namespace {
+
+  constexpr unsigned int chunk = 32;
+
+  // same as Grid1D::index(a,f) followed by Grid1D::normalize(i,f), without branches
+  inline void cellsAndFractions(const Grid1D& g, const float* a, int* ind, float* f, unsigned int n)
+  {
+    const float lower = g.lower();
+    const float stepinv = g.stepInverse();
+    const float edges = g.edges();
+    for (unsigned int l=0; l!=n; ++l) {
+      float x = (a[l]-lower)*stepinv;
+      float i = std::trunc(x);
+      float d = x - i;  // exact, as the fractional part given by modff
+      d += std::max(-i,0.f) + std::max(i-edges,0.f);
+      ind[l] = int(std::min(std::max(i,0.f),edges));
+      f[l] = d;
+    }
+  }
+
+}
+
+void
+LinearGridInterpolator3D::interpolate( const Scalar* a, const Scalar* b, const Scalar* c, ReturnType* result, unsigned int n)
+{
+  int s1 = grid.stride1();
+  int s2 = grid.stride2();
+  int s3 = grid.stride3();
+
+  int i[chunk], j[chunk], k[chunk];
+  Scalar s[chunk], t[chunk], u[chunk];
+  for (unsigned int first=0; first<n; first+=chunk) {
+    unsigned int m = std::min(chunk, n-first);
+    cellsAndFractions(grida, a+first, i, s, m);
+    cellsAndFractions(gridb, b+first, j, t, m);
+    cellsAndFractions(gridc, c+first, k, u, m);
+
+    for (unsigned int l=0; l!=m; ++l) {
+      int ind = grid.index(i[l],j[l],k[l]);
+      ValueType r = ((1.f-s[l])*(1.f-t[l])*u[l])*(grid(ind      +s3) - grid(ind      ));
+      r =  r + ((1.f-s[l])*     t[l] *u[l])*(grid(ind   +s2+s3) - grid(ind   +s2));
+      r =  r + (s[l]      *(1.f-t[l])*u[l])*(grid(ind+s1   +s3) - grid(ind+s1   ));
+      r =  r + (s[l]      *     t[l] *u[l])*(grid(ind+s1+s2+s3) - grid(ind+s1+s2));
+      r =  r + (           (1.f-s[l])*t[l])*(grid(ind   +s2   ) - grid(ind      ));
+      r =  r + (         s[l]        *t[l])*(grid(ind+s1+s2   ) - grid(ind+s1   ));
+      r =  r + (                     s[l])*(grid(ind+s1      ) - grid(ind      ));
+      result[first+l] =  r +                                      grid(ind      );
+    }
+  }
+}
+
@@ -33,6 +33,10 @@ public:
   void throwGridInterpolator3DException(void);
   
   ReturnType interpolate( Scalar a, Scalar b, Scalar c); 
+
+  /// Interpolation at n points given in grid coordinates, with the same result as interpolate(a,b,c);
+  /// the cell indices and weights are computed in a loop over the points that can be vectorized
+  void interpolate( const Scalar* a, const Scalar* b, const Scalar* c, ReturnType* result, unsigned int n);
   //  Value operator()( Scalar a, Scalar b, Scalar c) {return interpolate(a,b,c);}
 
 private:
@@ -15,3 +15,16 @@ MFGrid::LocalVector MFGrid3D::valueInTesla( const LocalPoint& p) const
   }
 
 }
+
+void MFGrid3D::valuesInTesla( const LocalPoint* p, LocalVector* b, unsigned int n) const
+{
+  try {
+    uncheckedValuesInTesla( p, b, n);
+  }
+  catch ( GridInterpolator3DException& outside) {
+    double *limits = outside.limits();
+    LocalPoint lower = fromGridFrame( limits[0], limits[1], limits[2]);
+    LocalPoint upper = fromGridFrame( limits[3], limits[4], limits[5]);
+    throw MagVolumeOutsideValidity( lower, upper);
+  }
+}
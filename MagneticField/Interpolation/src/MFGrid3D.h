@@ -51,9 +51,17 @@ public:
 
   LocalVector valueInTesla( const LocalPoint& p) const override;
 
+  void valuesInTesla( const LocalPoint* p, LocalVector* b, unsigned int n) const override;
+
   /// Interpolated field value at given point; does not check for exceptions
   virtual LocalVector uncheckedValueInTesla( const LocalPoint& p) const = 0;
 
+  /// Interpolated field values at n points; does not check for exceptions.
+  /// The default implementation calls uncheckedValueInTesla for each point.
+  virtual void uncheckedValuesInTesla( const LocalPoint* p, LocalVector* b, unsigned int n) const {
+    for (unsigned int i=0; i!=n; ++i) b[i] = uncheckedValueInTesla( p[i]);
+  }
+
 protected:
 
   using GridType =  Grid3D;
@@ -1,6 +1,7 @@
 #include "RectangularCartesianMFGrid.h"
 #include "binary_ifstream.h"
 #include "LinearGridInterpolator3D.h"
+#include <algorithm>
 
 #include <iostream>
 
@@ -97,6 +98,25 @@ RectangularCartesianMFGrid::uncheckedValueInTesla( const LocalPoint& p) const
   return LocalVector(value);
 }
 
+void
+RectangularCartesianMFGrid::uncheckedValuesInTesla( const LocalPoint* p, LocalVector* b, unsigned int n) const
+{
+  constexpr unsigned int chunk = 32;
+  float x[chunk], y[chunk], z[chunk];
+  GridType::ReturnType value[chunk];
+  LinearGridInterpolator3D interpol( grid_);
+  for (unsigned int first=0; first<n; first+=chunk) {
+    unsigned int m = std::min(chunk, n-first);
+    for (unsigned int l=0; l!=m; ++l) {
+      x[l] = p[first+l].x();
+      y[l] = p[first+l].y();
+      z[l] = p[first+l].z();
+    }
+    interpol.interpolate( x, y, z, value, m);
+    for (unsigned int l=0; l!=m; ++l) b[first+l] = LocalVector(value[l]);
+  }
+}
+
 void RectangularCartesianMFGrid::toGridFrame( const LocalPoint& p, 
 					      double& a, double& b, double& c) const
 {
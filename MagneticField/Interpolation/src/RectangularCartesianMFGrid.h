@@ -14,6 +14,8 @@ public:
 
   LocalVector uncheckedValueInTesla( const LocalPoint& p) const override;
 
+  void uncheckedValuesInTesla( const LocalPoint* p, LocalVector* b, unsigned int n) const override;
+
   void dump() const override;
 
   void toGridFrame( const LocalPoint& p, double& a, double& b, double& c) const override;
@@ -1,6 +1,7 @@
 #include "RectangularCylindricalMFGrid.h"
 #include "binary_ifstream.h"
 #include "LinearGridInterpolator3D.h"
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -103,6 +104,30 @@ MFGrid::LocalVector RectangularCylindricalMFGrid::uncheckedValueInTesla( const L
   return LocalVector(value);
 }
 
+void RectangularCylindricalMFGrid::uncheckedValuesInTesla( const LocalPoint* p, LocalVector* b, unsigned int n) const
+{
+  const float minimalSignificantR = 1e-6; // [cm], as in uncheckedValueInTesla
+  const bool onAxis = grid_.grida().lower() < minimalSignificantR;
+  constexpr unsigned int chunk = 32;
+  float r[chunk], phi[chunk], z[chunk];
+  GridType::ReturnType value[chunk];
+  LinearGridInterpolator3D interpol( grid_);
+  for (unsigned int first=0; first<n; first+=chunk) {
+    unsigned int m = std::min(chunk, n-first);
+    for (unsigned int l=0; l!=m; ++l) {
+      r[l] = p[first+l].perp();
+      phi[l] = p[first+l].phi();
+      z[l] = p[first+l].z();
+    }
+    interpol.interpolate( r, phi, z, value, m);
+    for (unsigned int l=0; l!=m; ++l) {
+      // the points on the axis are interpolated in z only
+      if (onAxis && r[l] < minimalSignificantR) b[first+l] = uncheckedValueInTesla( p[first+l]);
+      else b[first+l] = LocalVector(value[l]);
+    }
+  }
+}
+
 void RectangularCylindricalMFGrid::toGridFrame( const LocalPoint& p, 
 					      double& a, double& b, double& c) const
 {
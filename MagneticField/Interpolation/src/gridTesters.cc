@@ -93,3 +93,46 @@ int grid3d_t() {
   delete grid;
   return 0;
 }
+
+
+#include <random>
+
+// the batched interpolation against the scalar one, on a grid with random
+// values, at random points inside and just outside of the grid
+int gridBatch_t() {
+
+  Grid1D ga(0.,10.,6);
+  Grid1D gb(-10.,10.,11);
+  Grid1D gc(-20.,20.,21);
+
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> value(-4.f,4.f);
+  std::vector< Grid3D::BVector>  data;
+  data.reserve(ga.nodes()*gb.nodes()*gc.nodes());
+  for (int i=0; i<ga.nodes()*gb.nodes()*gc.nodes(); ++i)
+    data.push_back(Grid3D::BVector(value(rng),value(rng),value(rng)));
+  Grid3D grid(ga,gb,gc,data);
+  LinearGridInterpolator3D inter(grid);
+
+  constexpr unsigned int n = 1000;
+  std::uniform_real_distribution<float> a(-0.5f,10.5f), b(-10.5f,10.5f), c(-20.5f,20.5f);
+  std::vector<Grid3D::Scalar> pa(n), pb(n), pc(n);
+  for (unsigned int l=0; l!=n; ++l) { pa[l]=a(rng); pb[l]=b(rng); pc[l]=c(rng); }
+  // nodes and cell edges
+  for (int l=0; l!=50; ++l) { pa[l]=2*(l%6); pb[l]=-10+2*(l%11); pc[l]=-20+2*(l%21); }
+
+  std::vector<LinearGridInterpolator3D::ReturnType> batch(n);
+  inter.interpolate(pa.data(),pb.data(),pc.data(),batch.data(),n);
+
+  int fail = 0;
+  for (unsigned int l=0; l!=n; ++l) {
+    auto scalar = inter.interpolate(pa[l],pb[l],pc[l]);
+    // the same up to a float rounding, in case the compiler contracts to FMA
+    if ((batch[l]-scalar).mag() > 1.e-5f*(1.f+scalar.mag())) {
+      std::cout << "at " << pa[l] << " " << pb[l] << " " << pc[l] << ": batch " << batch[l] << " scalar " << scalar << std::endl;
+      ++fail;
+    }
+  }
+  std::cout << "gridBatch_t: " << fail << " failures out of " << n << " points" << std::endl;
+  return fail ? 1 : 0;
+}
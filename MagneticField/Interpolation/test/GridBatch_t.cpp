@@ -0,0 +1,6 @@
+int gridBatch_t();
+
+
+int main() {
+  return  gridBatch_t();
+}
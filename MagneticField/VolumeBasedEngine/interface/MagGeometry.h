@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <atomic>
+#include <memory>
 
 class MagBLayer;
 class MagESector;
@@ -42,7 +43,10 @@ public:
   /// Return field vector at the specified global point
   GlobalVector fieldInTesla(const GlobalPoint & gp) const;
 
-  /// Find a volume
+  /// Find a volume.
+  /// The last volume found is cached per thread, and the volumes found in
+  /// each cell of a coarse (R, phi, Z) grid are kept as hints shared by all
+  /// threads; the layered search is only used when both miss.
   MagVolume const * findVolume(const GlobalPoint & gp, double tolerance=0.) const;
 
   // Deprecated, will be removed
@@ -59,10 +63,23 @@ private:
   // Linear search (for debug purposes only)
   MagVolume const* findVolume1(const GlobalPoint & gp, double tolerance=0.) const;
 
+  // Search through the barrel layers and endcap sectors
+  MagVolume const* findVolumeInLayers(const GlobalPoint & gp, double tolerance) const;
+
+  // Index of the hint grid cell containing gp, -1 if outside the grid
+  int gridIndex(const GlobalPoint & gp) const;
+
 
   bool inBarrel(const GlobalPoint& gp) const;
 
-  mutable std::atomic<MagVolume const*> lastVolume; // Cache last volume found
+  // Identifies this geometry in the per-thread cache of the last volume found
+  const unsigned int cacheId;
+
+  // Last volume found in each grid cell; written concurrently, a stale
+  // entry only costs an extra inside() check.
+  std::unique_ptr<std::atomic<MagVolume const*>[]> theVolumeGrid;
+  float theGridMaxR;
+  float theGridMaxZ;
 
   std::vector<MagBLayer const*> theBLayers;
   std::vector<MagESector const*> theESectors;
@@ -42,6 +42,9 @@ class VolumeBasedMagneticField : public MagneticField {
 
   GlobalVector inTeslaUnchecked ( const GlobalPoint& g) const override;
 
+  /// Consecutive points in the same volume are interpolated in one call
+  void inTeslaBatch ( const GlobalPoint* g, GlobalVector* b, unsigned int n) const override;
+
   const MagVolume * findVolume(const GlobalPoint & gp) const;
 
   bool isDefined(const GlobalPoint& gp) const override;
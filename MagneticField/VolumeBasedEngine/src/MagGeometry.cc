@@ -11,15 +11,35 @@
 #include "MagneticField/Layers/interface/MagESector.h"
 
 #include "Utilities/BinningTools/interface/PeriodicBinFinderInPhi.h"
+#include "DataFormats/GeometryVector/interface/Pi.h"
 
 #include "FWCore/Utilities/interface/isFinite.h"
 
 #include "MagneticField/Layers/interface/MagVerbosity.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <algorithm>
+
 using namespace std;
 using namespace edm;
 
+namespace {
+  // Last volume found by each thread, valid only for the geometry with the
+  // same cacheId: the pointer of a deleted geometry could be reused.
+  struct LastVolume {
+    unsigned int geometry = 0;
+    MagVolume const* volume = nullptr;
+  };
+  thread_local LastVolume lastVolume;
+
+  std::atomic<unsigned int> nextCacheId{1};
+
+  // Hint grid: 25 cm cells in R and Z, 10 degrees in phi.
+  constexpr float gridCellSize = 25.f;
+  constexpr int   gridPhiBins = 36;
+  constexpr float gridMaxR = 900.f;
+}
+
 MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer *>& tbl,
 			 const std::vector<MagESector *>& tes,
 			 const std::vector<MagVolume6Faces*>& tbv,
@@ -31,7 +51,7 @@ MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer const*>& t
 			 const std::vector<MagESector const*>& tes,
 			 const std::vector<MagVolume6Faces const*>& tbv,
 			 const std::vector<MagVolume6Faces const*>& tev) : 
-  lastVolume(nullptr), theBLayers(tbl), theESectors(tes), theBVolumes(tbv), theEVolumes(tev), cacheLastVolume(true), geometryVersion(geomVersion)
+  cacheId(nextCacheId++), theBLayers(tbl), theESectors(tes), theBVolumes(tbv), theEVolumes(tev), cacheLastVolume(true), geometryVersion(geomVersion)
 {
   vector<double> rBorders;
 
@@ -56,6 +76,14 @@ MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer const*>& t
   int nEBins = theESectors.size();
   theEndcapBinFinder = new PeriodicBinFinderInPhi<float>(theESectors.front()->minPhi()+Geom::pi()/nEBins, nEBins);
 
+  // The grid covers the whole map (|Z| < 24 m since version 160812).
+  theGridMaxR = gridMaxR;
+  theGridMaxZ = (geometryVersion>=160812 ? 2400.f : 2000.f);
+  int nR = theGridMaxR/gridCellSize;
+  int nZ = 2.f*theGridMaxZ/gridCellSize;
+  size_t nCells = size_t(nR)*nZ*gridPhiBins;
+  theVolumeGrid.reset(new std::atomic<MagVolume const*>[nCells]);
+  for (size_t i = 0; i < nCells; ++i) theVolumeGrid[i].store(nullptr, std::memory_order_relaxed);
 }
 
 MagGeometry::~MagGeometry(){
@@ -132,15 +160,61 @@ MagGeometry::findVolume1(const GlobalPoint & gp, double tolerance) const {
   return found;
 }
 
-// Use hierarchical structure for fast lookup.
+int MagGeometry::gridIndex(const GlobalPoint & gp) const {
+  float R = gp.perp();
+  float Z = gp.z();
+  // written so that NaNs are outside
+  if (!(R < theGridMaxR && fabs(Z) < theGridMaxZ)) return -1;
+  int nR = theGridMaxR/gridCellSize;
+  int iR = R/gridCellSize;
+  int iZ = (Z+theGridMaxZ)/gridCellSize;
+  int iPhi = (gp.barePhi()+Geom::fpi())*(gridPhiBins/Geom::ftwoPi());
+  iR = std::min(iR, nR-1);
+  iPhi = std::min(std::max(iPhi, 0), gridPhiBins-1);
+  return (iZ*nR + iR)*gridPhiBins + iPhi;
+}
+
+// Check the per-thread and per-cell caches before searching the layers.
 MagVolume const* 
 MagGeometry::findVolume(const GlobalPoint & gp, double tolerance) const{
   // Check volume cache
-  auto lastVolumeCheck = lastVolume.load(std::memory_order_acquire);
-  if (lastVolumeCheck!=nullptr && lastVolumeCheck->inside(gp)){
-    return lastVolumeCheck;
+  LastVolume& last = lastVolume;
+  if (cacheLastVolume && last.geometry==cacheId && last.volume!=nullptr && last.volume->inside(gp)){
+    return last.volume;
+  }
+
+  MagVolume const* result=nullptr;
+  int cell = gridIndex(gp);
+  if (cell >= 0) {
+    auto hint = theVolumeGrid[cell].load(std::memory_order_acquire);
+    if (hint!=nullptr && hint->inside(gp, tolerance)) result = hint;
+  }
+
+  if (result==nullptr) {
+    result = findVolumeInLayers(gp, tolerance);
+
+    if (result==nullptr && tolerance < 0.0001) {
+      // If search fails, retry with a 300 micron tolerance.
+      // This is a hack for thin gaps on air-iron boundaries,
+      // which will not be present anymore once surfaces are matched.
+      if (verbose::debugOut) cout << "Increasing the tolerance to 0.03" <<endl;
+      result = findVolumeInLayers(gp, 0.03);
+    }
+
+    if (result!=nullptr && cell >= 0) theVolumeGrid[cell].store(result, std::memory_order_release);
+  }
+
+  if (cacheLastVolume) {
+    last.geometry = cacheId;
+    last.volume = result;
   }
 
+  return result;
+}
+
+// Use hierarchical structure for fast lookup.
+MagVolume const* 
+MagGeometry::findVolumeInLayers(const GlobalPoint & gp, double tolerance) const{
   MagVolume const* result=nullptr;
   if (inBarrel(gp)) { // Barrel
     double R = gp.perp();
@@ -166,17 +240,6 @@ MagGeometry::findVolume(const GlobalPoint & gp, double tolerance) const{
 		    << (result==nullptr? " failed " : " OK ") <<endl;
   }
 
-
-  if (result==nullptr && tolerance < 0.0001) {
-    // If search fails, retry with a 300 micron tolerance.
-    // This is a hack for thin gaps on air-iron boundaries,
-    // which will not be present anymore once surfaces are matched.
-    if (verbose::debugOut) cout << "Increasing the tolerance to 0.03" <<endl;
-    result = findVolume(gp, 0.03);
-  }
-
-  if (cacheLastVolume) lastVolume.store(result,std::memory_order_release);
-
   return result;
 }
 
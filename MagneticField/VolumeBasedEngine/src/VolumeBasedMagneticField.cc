@@ -1,5 +1,6 @@
 #include "MagneticField/VolumeBasedEngine/interface/VolumeBasedMagneticField.h"
 #include "DataFormats/GeometryVector/interface/GlobalVector.h"
+#include "MagneticField/VolumeGeometry/interface/MagVolume.h"
 
 VolumeBasedMagneticField::VolumeBasedMagneticField( int geomVersion,
 						    const std::vector<MagBLayer *>& theBLayers,
@@ -57,6 +58,36 @@ GlobalVector VolumeBasedMagneticField::inTeslaUnchecked(const GlobalPoint& gp) c
 }
 
 
+void VolumeBasedMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* b, unsigned int n) const {
+  auto inMap = [&](const GlobalPoint& g) {
+    return !(paramField && paramField->isDefined(g)) && isDefined(g);
+  };
+
+  auto volume = [&](const GlobalPoint& g) -> MagVolume const * {
+    return inMap(g) ? field->findVolume(g) : nullptr;
+  };
+
+  // the volume of the first point of a run is the one found when the previous run ended
+  unsigned int i = 0;
+  MagVolume const * v = n>0 ? volume(gp[0]) : nullptr;
+  while (i<n) {
+    if (v==nullptr) {
+      // parametrization, outside of the map or no volume found: same as inTesla
+      b[i] = inTesla(gp[i]);
+      ++i;
+      if (i<n) v = volume(gp[i]);
+      continue;
+    }
+    unsigned int j = i+1;
+    MagVolume const * next = nullptr;
+    while (j<n && (next = volume(gp[j]))==v) ++j;
+    v->inTeslaBatch(gp+i, b+i, j-i);
+    i = j;
+    v = next;
+  }
+}
+
+
 const MagVolume * VolumeBasedMagneticField::findVolume(const GlobalPoint & gp) const
 {
   return field->findVolume(gp);
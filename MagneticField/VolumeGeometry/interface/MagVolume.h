@@ -47,6 +47,9 @@ public:
     return fieldInTesla( gp);
   }
 
+  /// Field at n global points, interpolated by the provider in one call
+  void inTeslaBatch ( const ::GlobalPoint* gp, ::GlobalVector* b, unsigned int n) const override;
+
   /// Temporary hack to pass information on material. Will eventually be replaced!
   bool isIron() const {return isIronFlag;}
   void setIsIron(bool iron) {isIronFlag = iron;}
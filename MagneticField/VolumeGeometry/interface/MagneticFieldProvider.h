@@ -29,6 +29,13 @@ public:
    */
   virtual LocalVectorType valueInTesla( const LocalPointType& p) const = 0;
 
+  /** Returns the field vectors in the local frame at the n local positions p.
+   *  The default implementation calls valueInTesla for each point.
+   */
+  virtual void valuesInTesla( const LocalPointType* p, LocalVectorType* b, unsigned int n) const {
+    for (unsigned int i=0; i!=n; ++i) b[i] = valueInTesla(p[i]);
+  }
+
   /** Returns the field vector in the global frame, at global position p
    * Not needed, the MagVolume does the transformation to global!
    */
@@ -3,6 +3,8 @@
 #include "MagneticField/VolumeGeometry/interface/MagVolume.h"
 #include "MagneticField/VolumeGeometry/interface/MagneticFieldProvider.h"
 
+#include <algorithm>
+
 MagVolume::~MagVolume() {
   if (theProviderOwned) delete theProvider;
 }
@@ -18,3 +20,16 @@ MagVolume::GlobalVector MagVolume::fieldInTesla( const GlobalPoint& gp) const
   return toGlobal( theProvider->valueInTesla( toLocal(gp)))*theScalingFactor;
 }
 
+void MagVolume::inTeslaBatch( const ::GlobalPoint* gp, ::GlobalVector* b, unsigned int n) const
+{
+  constexpr unsigned int chunk = 32;
+  LocalPoint lp[chunk];
+  LocalVector lb[chunk];
+  for (unsigned int i=0; i<n; i+=chunk) {
+    unsigned int m = std::min(chunk, n-i);
+    for (unsigned int j=0; j!=m; ++j) lp[j] = toLocal( gp[i+j]);
+    theProvider->valuesInTesla( lp, lb, m);
+    for (unsigned int j=0; j!=m; ++j) b[i+j] = toGlobal( lb[j])*theScalingFactor;
+  }
+}
+
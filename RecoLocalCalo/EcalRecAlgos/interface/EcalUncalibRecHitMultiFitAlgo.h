@@ -9,10 +9,17 @@
 
 #include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitRecAbsAlgo.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "DataFormats/EcalDigi/interface/EcalDataFrame.h"
 
 #include "CondFormats/EcalObjects/interface/EcalPedestals.h"
 #include "CondFormats/EcalObjects/interface/EcalGainRatios.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseShapes.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseCovariances.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <array>
+#include <vector>
 
 
 #include "TMatrixDSym.h"
@@ -26,6 +33,22 @@ class EcalUncalibRecHitMultiFitAlgo
   EcalUncalibRecHitMultiFitAlgo();
   ~EcalUncalibRecHitMultiFitAlgo() { };
   EcalUncalibratedRecHit makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX);
+
+  /// inputs of makeRecHits for one channel
+  struct Channel {
+    EcalDataFrame dataFrame;
+    const EcalPedestals::Item * aped;
+    const EcalMGPAGainRatio * aGain;
+    const EcalPulseShapes::Item * aPulse;
+    const EcalPulseCovariances::Item * aPulseCov;
+  };
+  /** makeRecHit for all the channels, in the order of channels. Those with all the
+   *  samples in gain 12 are fitted together with PulseChiSqSNNLSBatch, the others
+   *  one by one with makeRecHit. The channels with a sample in gain 0 are accepted,
+   *  but EcalUncalibRecHitWorkerMultiFit leaves them out, as it does not use the
+   *  multifit for them.
+   */
+  void makeRecHits(const std::vector<Channel> &channels, const SampleMatrixGainArray &noisecors, const BXVector &activeBX, std::vector<EcalUncalibratedRecHit> &result);
   void disableErrorCalculation() { _computeErrors = false; }
   void setDoPrefit(bool b) { _doPrefit = b; }
   void setPrefitMaxChiSq(double x) { _prefitMaxChiSq = x; }
@@ -37,8 +60,20 @@ class EcalUncalibRecHitMultiFitAlgo
   void setGainSwitchUseMaxSample(bool b) { _gainSwitchUseMaxSample = b; }
   
  private:
+   void fitBatch(unsigned int n, const BXVector &activeBX, std::vector<EcalUncalibratedRecHit> &result);
+
    PulseChiSqSNNLS _pulsefunc;
    PulseChiSqSNNLS _pulsefuncSingle;
+   PulseChiSqSNNLSBatch _batchfunc;
+   PulseChiSqSNNLSBatch _batchfuncSingle;
+   // inputs of the channels of the current batch
+   std::array<unsigned int,PulseChiSqSNNLSBatch::W> _batchindex;
+   std::array<DetId,PulseChiSqSNNLSBatch::W> _batchid;
+   std::array<double,PulseChiSqSNNLSBatch::W> _batchpedval;
+   std::array<SampleVector,PulseChiSqSNNLSBatch::W> _batchamplitudes;
+   std::array<SampleMatrix,PulseChiSqSNNLSBatch::W> _batchnoisecov;
+   std::array<FullSampleVector,PulseChiSqSNNLSBatch::W> _batchfullpulse;
+   std::array<FullSampleMatrix,PulseChiSqSNNLSBatch::W> _batchfullpulsecov;
    bool _computeErrors;
    bool _doPrefit;
    double _prefitMaxChiSq;
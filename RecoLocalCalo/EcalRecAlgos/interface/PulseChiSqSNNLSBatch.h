@@ -0,0 +1,95 @@
+#ifndef PulseChiSqSNNLSBatch_h
+#define PulseChiSqSNNLSBatch_h
+
+#define EIGEN_NO_DEBUG // kill throws in eigen code
+#include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
+
+/** The fit of PulseChiSqSNNLS for several channels at once.
+ *
+ *  The inputs and the matrices of the fit are stored with the channel as
+ *  innermost index, so that the covariance updates, the Cholesky
+ *  decompositions, the triangular solves and the products of the NNLS are
+ *  loops over the channels which the compiler vectorizes. Each channel
+ *  follows its own active set and converges on its own, the channels which
+ *  are done are masked. The pulses are not permuted: the unconstrained
+ *  problem is solved as a system of all the pulses, with identity rows for
+ *  the constrained ones, so that all the channels solve a system of the
+ *  same size. The results agree with PulseChiSqSNNLS up to rounding.
+ *
+ *  All the channels of a batch fit the same pulses, which is the case of the
+ *  channels without gain switch: the only pedestal is the optional dynamic
+ *  pedestal of gain 12, and there are no step corrections of bad samples.
+ */
+
+class PulseChiSqSNNLSBatch {
+  public:
+
+    /// maximum number of channels in a batch
+    static constexpr unsigned int W = 8;
+
+    PulseChiSqSNNLSBatch();
+    ~PulseChiSqSNNLSBatch();
+
+    /// sets the inputs of channel i, as given to PulseChiSqSNNLS::DoFit
+    void setChannel(unsigned int i, const SampleVector &samples, const SampleMatrix &samplecov, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov);
+
+    /// fits the first n channels, with a dynamic pedestal (bx 100) added to the pulses if required
+    void DoFit(unsigned int n, const BXVector &bxs, bool dynamicPedestal);
+
+    /// the pulses of the fit, in the order of X and Errors for all the channels
+    const BXVector &BXs() const { return _bxs; }
+
+    double X(unsigned int i, unsigned int ipulse) const { return _ampvecmin[ipulse][i]; }
+    double Errors(unsigned int i, unsigned int ipulse) const { return _errvec[ipulse][i]; }
+    double ChiSq(unsigned int i) const { return _chisq[i]; }
+    bool Status(unsigned int i) const { return _status[i]; }
+
+    void disableErrorCalculation() { _computeErrors = false; }
+    void setMaxIters(int n) { _maxiters = n;}
+    void setMaxIterWarnings(bool b) { _maxiterwarnings = b;}
+
+  protected:
+
+    static constexpr unsigned int NS = SampleVector::RowsAtCompileTime;
+    static constexpr unsigned int NFS = FullSampleVector::RowsAtCompileTime;
+    static constexpr unsigned int NP = PulseVectorSize;
+
+    void Minimize(const bool *fit, bool *status);
+    void NNLS(const bool *fit);
+    void OnePulseMinimize(const bool *fit);
+    void updateCov(const bool *fit);
+    void computeNormalEquations();
+    void solveUnconstrained(const bool *solve, double (*x)[W]) const;
+    void ComputeChiSq(double *chisq) const;
+    void ComputeApproxUncertainty(unsigned int ipulse, double *err) const;
+    void solveL(double (*v)[W]) const;
+
+    double _samples[NS][W];
+    double _sampvec[NS][W];
+    double _samplecov[NS][NS][W];
+    double _fullpulse[NFS][W];
+    double _fullpulsecov[NFS][NFS][W];
+
+    double _pulsemat[NS][NP][W];
+    double _covdecompL[NS][NS][W];
+    double _aTamat[NP][NP][W];
+    double _aTbvec[NP][W];
+
+    double _ampvec[NP][W];
+    double _ampvecmin[NP][W];
+    double _errvec[NP][W];
+    bool _passive[NP][W];
+    unsigned int _nP[W];
+
+    double _chisq[W];
+    bool _status[W];
+
+    BXVector _bxs;
+    unsigned int _npulsetot;
+
+    bool _computeErrors;
+    int _maxiters;
+    bool _maxiterwarnings;
+};
+
+#endif
@@ -22,6 +22,10 @@ EcalUncalibRecHitMultiFitAlgo::EcalUncalibRecHitMultiFitAlgo() :
   _pulsefuncSingle.disableErrorCalculation();
   _pulsefuncSingle.setMaxIters(1);
   _pulsefuncSingle.setMaxIterWarnings(false);
+
+  _batchfuncSingle.disableErrorCalculation();
+  _batchfuncSingle.setMaxIters(1);
+  _batchfuncSingle.setMaxIterWarnings(false);
     
 }
 
@@ -173,8 +177,18 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
   bool usePrefit = false;
   if (_doPrefit) {
     status = _pulsefuncSingle.DoFit(amplitudes,noisecov,_singlebx,fullpulse,fullpulsecov,gainsPedestal,badSamples);
-    amplitude = status ? _pulsefuncSingle.X()[0] : 0.;
-    amperr = status ? _pulsefuncSingle.Errors()[0] : 0.;
+
+    //the pedestal and step pulses are fitted too, and the pulses are permuted by the fit
+    unsigned int ipulseintime = 0;
+    for (unsigned int ipulse=0; ipulse<_pulsefuncSingle.BXs().rows(); ++ipulse) {
+      if (_pulsefuncSingle.BXs().coeff(ipulse)==0) {
+        ipulseintime = ipulse;
+        break;
+      }
+    }
+
+    amplitude = status ? _pulsefuncSingle.X()[ipulseintime] : 0.;
+    amperr = status ? _pulsefuncSingle.Errors()[ipulseintime] : 0.;
     chisq = _pulsefuncSingle.ChiSq();
     
     if (chisq < _prefitMaxChiSq) {
@@ -225,3 +239,143 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
   return rh;
 }
 
+
+void EcalUncalibRecHitMultiFitAlgo::makeRecHits(const std::vector<Channel> &channels, const SampleMatrixGainArray &noisecors, const BXVector &activeBX, std::vector<EcalUncalibratedRecHit> &result) {
+
+  const unsigned int nsample = EcalDataFrame::MAXSAMPLES;
+
+  result.clear();
+  result.resize(channels.size());
+
+  FullSampleVector fullpulse(FullSampleVector::Zero());
+  FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
+
+  unsigned int n = 0;
+  for (unsigned int ich=0; ich<channels.size(); ++ich) {
+    auto const & ch = channels[ich];
+
+    for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
+      fullpulse(i+7) = ch.aPulse->pdfval[i];
+    for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
+      for (int j=0; j<EcalPulseShape::TEMPLATESAMPLES; ++j)
+        fullpulsecov(i+7,j+7) = ch.aPulseCov->covval[i][j];
+
+    // the gain switches change the pulses of the fit, they are done one by one,
+    // as are the samples with gain 0 which isSaturated() misses when there are
+    // less than 5 of them
+    bool allGain12 = true;
+    for (unsigned int iSample = 0; iSample < nsample; iSample++)
+      allGain12 &= ch.dataFrame.sample(iSample).gainId()==1;
+    if (!allGain12) {
+      result[ich] = makeRecHit(ch.dataFrame, ch.aped, ch.aGain, noisecors, fullpulse, fullpulsecov, activeBX);
+      continue;
+    }
+
+    // all the samples have gain 12, as in makeRecHit
+    SampleVector &amplitudes = _batchamplitudes[n];
+    for (unsigned int iSample = 0; iSample < nsample; iSample++) {
+      double adc = ch.dataFrame.sample(iSample).adc();
+      amplitudes[iSample] = _dynamicPedestals ? adc : adc - ch.aped->mean_x12;
+    }
+
+    SampleMatrix &noisecov = _batchnoisecov[n];
+    noisecov = ch.aped->rms_x12*ch.aped->rms_x12*noisecors[0];
+    if (!_dynamicPedestals && _addPedestalUncertainty>0.) {
+      //add fully correlated component to noise covariance to inflate pedestal uncertainty
+      noisecov += _addPedestalUncertainty*_addPedestalUncertainty*SampleMatrix::Ones();
+    }
+
+    _batchfullpulse[n] = fullpulse;
+    _batchfullpulsecov[n] = fullpulsecov;
+    _batchpedval[n] = ch.aped->mean_x12;
+    _batchid[n] = ch.dataFrame.id();
+    _batchindex[n] = ich;
+    if (++n==PulseChiSqSNNLSBatch::W) {
+      fitBatch(n, activeBX, result);
+      n = 0;
+    }
+  }
+  if (n>0) fitBatch(n, activeBX, result);
+}
+
+void EcalUncalibRecHitMultiFitAlgo::fitBatch(unsigned int n, const BXVector &activeBX, std::vector<EcalUncalibratedRecHit> &result) {
+
+  double amplitude[PulseChiSqSNNLSBatch::W], amperr[PulseChiSqSNNLSBatch::W], chisq[PulseChiSqSNNLSBatch::W];
+  bool usePrefit[PulseChiSqSNNLSBatch::W];
+  for (unsigned int i=0; i<n; ++i) {
+    double jitter = 0.;
+    result[_batchindex[i]] = EcalUncalibratedRecHit(_batchid[i], 0., _batchpedval[i], jitter, 0., 0);
+  }
+
+  //optimized one-pulse fit for hlt
+  unsigned int nfit = 0;
+  unsigned int fitted[PulseChiSqSNNLSBatch::W];
+  if (_doPrefit) {
+    for (unsigned int i=0; i<n; ++i)
+      _batchfuncSingle.setChannel(i,_batchamplitudes[i],_batchnoisecov[i],_batchfullpulse[i],_batchfullpulsecov[i]);
+    _batchfuncSingle.DoFit(n,_singlebx,_dynamicPedestals);
+    for (unsigned int i=0; i<n; ++i) {
+      bool status = _batchfuncSingle.Status(i);
+      amplitude[i] = status ? _batchfuncSingle.X(i,0) : 0.;
+      amperr[i] = status ? _batchfuncSingle.Errors(i,0) : 0.;
+      chisq[i] = _batchfuncSingle.ChiSq(i);
+      usePrefit[i] = chisq[i] < _prefitMaxChiSq;
+      if (!usePrefit[i]) fitted[nfit++] = i;
+    }
+  }
+  else {
+    for (unsigned int i=0; i<n; ++i) {
+      usePrefit[i] = false;
+      fitted[nfit++] = i;
+    }
+  }
+
+  if (nfit>0) {
+    for (unsigned int k=0; k<nfit; ++k) {
+      unsigned int i = fitted[k];
+      _batchfunc.setChannel(k,_batchamplitudes[i],_batchnoisecov[i],_batchfullpulse[i],_batchfullpulsecov[i]);
+    }
+    if(!_computeErrors) _batchfunc.disableErrorCalculation();
+    _batchfunc.DoFit(nfit,activeBX,_dynamicPedestals);
+
+    const BXVector &bxs = _batchfunc.BXs();
+    unsigned int ipulseintime = 0;
+    for (unsigned int ipulse=0; ipulse<bxs.rows(); ++ipulse) {
+      if (bxs.coeff(ipulse)==0) {
+        ipulseintime = ipulse;
+        break;
+      }
+    }
+
+    for (unsigned int k=0; k<nfit; ++k) {
+      unsigned int i = fitted[k];
+      bool status = _batchfunc.Status(k);
+      chisq[i] = _batchfunc.ChiSq(k);
+      if (!status) {
+        edm::LogWarning("EcalUncalibRecHitMultiFitAlgo::makeRecHit") << "Failed Fit" << std::endl;
+      }
+      amplitude[i] = status ? _batchfunc.X(k,ipulseintime) : 0.;
+      amperr[i] = status ? _batchfunc.Errors(k,ipulseintime) : 0.;
+
+      // the pedestal of gain 12, the gain of the maximum sample
+      auto & rh = result[_batchindex[i]];
+      for (unsigned int ipulse=0; ipulse<bxs.rows(); ++ipulse) {
+        int bx = bxs.coeff(ipulse);
+        if (bx!=0 && std::abs(bx)<100) {
+          rh.setOutOfTimeAmplitude(bx+5, status ? _batchfunc.X(k,ipulse) : 0.);
+        }
+        else if (bx==100) {
+          rh.setPedestal(status ? _batchfunc.X(k,ipulse) : 0.);
+        }
+      }
+    }
+  }
+
+  for (unsigned int i=0; i<n; ++i) {
+    auto & rh = result[_batchindex[i]];
+    rh.setAmplitude(amplitude[i]);
+    rh.setChi2(chisq[i]);
+    rh.setAmplitudeError(amperr[i]);
+  }
+
+}
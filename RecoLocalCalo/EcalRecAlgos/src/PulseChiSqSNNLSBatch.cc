@@ -0,0 +1,567 @@
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+// All the loops over c are over the channels of the batch: they are the
+// innermost ones, with the same trip count, to be vectorized.
+
+constexpr unsigned int PulseChiSqSNNLSBatch::W;
+
+PulseChiSqSNNLSBatch::PulseChiSqSNNLSBatch() :
+  _npulsetot(0),
+  _computeErrors(true),
+  _maxiters(50),
+  _maxiterwarnings(true)
+{
+  // the channels which are not set in a batch are fitted for nothing,
+  // but with inputs which give finite numbers
+  SampleVector samples = SampleVector::Zero();
+  SampleMatrix samplecov = SampleMatrix::Identity();
+  FullSampleVector fullpulse = FullSampleVector::Zero();
+  FullSampleMatrix fullpulsecov = FullSampleMatrix::Zero();
+  for (unsigned int i=0; i<W; ++i) setChannel(i,samples,samplecov,fullpulse,fullpulsecov);
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int j=0; j<NS; ++j)
+      for (unsigned int c=0; c<W; ++c) _covdecompL[i][j][c] = i==j ? 1. : 0.;
+}
+
+PulseChiSqSNNLSBatch::~PulseChiSqSNNLSBatch() {
+
+}
+
+void PulseChiSqSNNLSBatch::setChannel(unsigned int c, const SampleVector &samples, const SampleMatrix &samplecov, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov) {
+
+  for (unsigned int i=0; i<NS; ++i) {
+    _samples[i][c] = samples.coeff(i);
+    for (unsigned int j=0; j<NS; ++j) _samplecov[i][j][c] = samplecov.coeff(i,j);
+  }
+  for (unsigned int i=0; i<NFS; ++i) {
+    _fullpulse[i][c] = fullpulse.coeff(i);
+    for (unsigned int j=0; j<NFS; ++j) _fullpulsecov[i][j][c] = fullpulsecov.coeff(i,j);
+  }
+}
+
+void PulseChiSqSNNLSBatch::DoFit(unsigned int n, const BXVector &bxs, bool dynamicPedestal) {
+
+  const unsigned int npulse = bxs.rows();
+
+  _bxs = bxs;
+  if (dynamicPedestal) {
+    _bxs.resize(npulse+1);
+    _bxs[npulse] = 100; //bx values >=100 indicate dynamic pedestals
+  }
+  _npulsetot = _bxs.rows();
+
+  bool fit[W];
+  for (unsigned int c=0; c<W; ++c) fit[c] = c<n;
+
+  //initialize pulse template matrix
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int p=0; p<NP; ++p)
+      for (unsigned int c=0; c<W; ++c) _pulsemat[i][p][c] = 0.;
+  for (unsigned int p=0; p<npulse; ++p) {
+    int offset = 7-3-_bxs.coeff(p);
+    for (unsigned int i=0; i<NS; ++i)
+      for (unsigned int c=0; c<W; ++c) _pulsemat[i][p][c] = _fullpulse[i+offset][c];
+  }
+  if (dynamicPedestal) {
+    for (unsigned int i=0; i<NS; ++i)
+      for (unsigned int c=0; c<W; ++c) _pulsemat[i][npulse][c] = 1.;
+  }
+
+  for (unsigned int p=0; p<NP; ++p)
+    for (unsigned int c=0; c<W; ++c) {
+      _ampvec[p][c] = 0.;
+      _errvec[p][c] = 0.;
+      _passive[p][c] = false;
+    }
+  for (unsigned int c=0; c<W; ++c) {
+    _nP[c] = 0;
+    _chisq[c] = 0.;
+    _status[c] = false;
+  }
+
+  if (_npulsetot==1 && std::abs(_bxs.coeff(0))<100) {
+    for (unsigned int c=0; c<W; ++c) _ampvec[0][c] = _samples[_bxs.coeff(0) + 5][c];
+  }
+
+  //unconstrain pedestals already for first iteration since they should always be non-zero
+  if (dynamicPedestal) {
+    for (unsigned int c=0; c<W; ++c) {
+      _passive[npulse][c] = true;
+      _nP[c] = 1;
+    }
+  }
+
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int c=0; c<W; ++c) _sampvec[i][c] = _samples[i][c];
+
+  //do the actual fit
+  Minimize(fit,_status);
+  for (unsigned int p=0; p<NP; ++p)
+    for (unsigned int c=0; c<W; ++c) _ampvecmin[p][c] = _ampvec[p][c];
+
+  if(!_computeErrors) return;
+
+  //compute MINOS-like uncertainties for in-time amplitude
+  unsigned int ipulseintime = 0;
+  for (; ipulseintime<_npulsetot; ++ipulseintime) {
+    if (_bxs.coeff(ipulseintime)==0) break;
+  }
+  if (ipulseintime==_npulsetot) return;
+
+  bool witherr[W];
+  bool any = false;
+  for (unsigned int c=0; c<W; ++c) {
+    witherr[c] = fit[c] && _status[c];
+    any |= witherr[c];
+  }
+  if (!any) return;
+
+  double approxerr[W], chisq0[W], x0[W];
+  ComputeApproxUncertainty(ipulseintime,approxerr);
+  for (unsigned int c=0; c<W; ++c) {
+    chisq0[c] = _chisq[c];
+    x0[c] = _ampvecmin[ipulseintime][c];
+  }
+
+  //remove in time pulse from the fit
+  for (unsigned int c=0; c<W; ++c) {
+    if (witherr[c] && _passive[ipulseintime][c]) {
+      _passive[ipulseintime][c] = false;
+      --_nP[c];
+    }
+  }
+  double pulseintime[NS][W];
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int c=0; c<W; ++c) {
+      pulseintime[i][c] = _pulsemat[i][ipulseintime][c];
+      _pulsemat[i][ipulseintime][c] = witherr[c] ? 0. : pulseintime[i][c];
+    }
+
+  //two point interpolation for upper uncertainty when amplitude is away from boundary
+  double xplus100[W];
+  for (unsigned int c=0; c<W; ++c) {
+    xplus100[c] = x0[c] + approxerr[c];
+    if (witherr[c]) _ampvec[ipulseintime][c] = xplus100[c];
+  }
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int c=0; c<W; ++c)
+      if (witherr[c]) _sampvec[i][c] = _samples[i][c] - _ampvec[ipulseintime][c]*pulseintime[i][c];
+
+  bool status[W];
+  Minimize(witherr,status);
+  double chisqplus100[W];
+  ComputeChiSq(chisqplus100);
+
+  bool withminus[W];
+  double sigmaplus[W];
+  any = false;
+  for (unsigned int c=0; c<W; ++c) {
+    if (witherr[c]) {
+      _status[c] = status[c];
+      witherr[c] = status[c];
+    }
+    sigmaplus[c] = std::abs(xplus100[c]-x0[c])/sqrt(chisqplus100[c]-chisq0[c]);
+    //if amplitude is sufficiently far from the boundary, compute also the lower uncertainty and average them
+    withminus[c] = witherr[c] && (x0[c]/sigmaplus[c]) > 0.5;
+    any |= withminus[c];
+  }
+
+  if (any) {
+    double xminus100[W];
+    for (unsigned int c=0; c<W; ++c) {
+      xminus100[c] = std::max(0.,x0[c]-approxerr[c]);
+      if (withminus[c]) _ampvec[ipulseintime][c] = xminus100[c];
+    }
+    for (unsigned int i=0; i<NS; ++i)
+      for (unsigned int c=0; c<W; ++c)
+        if (withminus[c]) _sampvec[i][c] = _samples[i][c] - _ampvec[ipulseintime][c]*pulseintime[i][c];
+
+    Minimize(withminus,status);
+    double chisqminus100[W];
+    ComputeChiSq(chisqminus100);
+
+    for (unsigned int c=0; c<W; ++c) {
+      if (!withminus[c]) continue;
+      _status[c] = status[c];
+      witherr[c] = status[c];
+      double sigmaminus = std::abs(xminus100[c]-x0[c])/sqrt(chisqminus100[c]-chisq0[c]);
+      _errvec[ipulseintime][c] = 0.5*(sigmaplus[c] + sigmaminus);
+    }
+  }
+
+  for (unsigned int c=0; c<W; ++c) {
+    if (!witherr[c]) continue;
+    if (!withminus[c]) _errvec[ipulseintime][c] = sigmaplus[c];
+    _chisq[c] = chisq0[c];
+  }
+
+}
+
+void PulseChiSqSNNLSBatch::Minimize(const bool *fit, bool *status) {
+
+  bool running[W];
+  for (unsigned int c=0; c<W; ++c) {
+    running[c] = fit[c];
+    if (fit[c]) status[c] = false;
+  }
+
+  double chisqnow[W];
+  for (int iter=0; ; ++iter) {
+
+    bool any = false;
+    for (unsigned int c=0; c<W; ++c) {
+      if (running[c] && iter>=_maxiters) {
+        if (_maxiterwarnings) {
+          LogDebug("PulseChiSqSNNLSBatch::Minimize") << "Max Iterations reached at iter " << iter;
+        }
+        running[c] = false;
+      }
+      any |= running[c];
+    }
+    if (!any) break;
+
+    updateCov(running);
+    if (_npulsetot>1) {
+      NNLS(running);
+    }
+    else {
+      //special case for one pulse fit (performance optimized)
+      OnePulseMinimize(running);
+    }
+
+    ComputeChiSq(chisqnow);
+    for (unsigned int c=0; c<W; ++c) {
+      if (!running[c]) continue;
+      status[c] = true;
+      double deltachisq = chisqnow[c]-_chisq[c];
+      _chisq[c] = chisqnow[c];
+      if (std::abs(deltachisq)<1e-3) running[c] = false;
+    }
+  }
+
+}
+
+void PulseChiSqSNNLSBatch::updateCov(const bool *fit) {
+
+  double cov[NS][NS][W];
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int j=0; j<NS; ++j)
+      for (unsigned int c=0; c<W; ++c) cov[i][j][c] = _samplecov[i][j][c];
+
+  // a pulse of zero amplitude adds zeros
+  for (unsigned int ipulse=0; ipulse<_npulsetot; ++ipulse) {
+    int bx = _bxs.coeff(ipulse);
+    if (std::abs(bx)>=100) continue; //no contribution to covariance from pedestal
+
+    unsigned int firstsamplet = std::max(0,bx + 3);
+    unsigned int offset = 7-3-bx;
+
+    double ampsq[W];
+    for (unsigned int c=0; c<W; ++c) ampsq[c] = _ampvec[ipulse][c]*_ampvec[ipulse][c];
+    for (unsigned int i=firstsamplet; i<NS; ++i)
+      for (unsigned int j=firstsamplet; j<NS; ++j)
+        for (unsigned int c=0; c<W; ++c) cov[i][j][c] += ampsq[c]*_fullpulsecov[i+offset][j+offset][c];
+  }
+
+  // Cholesky decomposition, in place in the lower triangle
+  for (unsigned int j=0; j<NS; ++j) {
+    for (unsigned int k=0; k<j; ++k)
+      for (unsigned int c=0; c<W; ++c) cov[j][j][c] -= cov[j][k][c]*cov[j][k][c];
+    for (unsigned int c=0; c<W; ++c) cov[j][j][c] = std::sqrt(cov[j][j][c]);
+    for (unsigned int i=j+1; i<NS; ++i) {
+      for (unsigned int k=0; k<j; ++k)
+        for (unsigned int c=0; c<W; ++c) cov[i][j][c] -= cov[i][k][c]*cov[j][k][c];
+      for (unsigned int c=0; c<W; ++c) cov[i][j][c] /= cov[j][j][c];
+    }
+  }
+
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int j=0; j<=i; ++j)
+      for (unsigned int c=0; c<W; ++c) _covdecompL[i][j][c] = fit[c] ? cov[i][j][c] : _covdecompL[i][j][c];
+
+}
+
+void PulseChiSqSNNLSBatch::solveL(double (*v)[W]) const {
+
+  for (unsigned int i=0; i<NS; ++i) {
+    for (unsigned int k=0; k<i; ++k)
+      for (unsigned int c=0; c<W; ++c) v[i][c] -= _covdecompL[i][k][c]*v[k][c];
+    for (unsigned int c=0; c<W; ++c) v[i][c] /= _covdecompL[i][i][c];
+  }
+
+}
+
+void PulseChiSqSNNLSBatch::ComputeChiSq(double *chisq) const {
+
+  double resvec[NS][W];
+  for (unsigned int i=0; i<NS; ++i) {
+    for (unsigned int c=0; c<W; ++c) resvec[i][c] = 0.;
+    for (unsigned int p=0; p<_npulsetot; ++p)
+      for (unsigned int c=0; c<W; ++c) resvec[i][c] += _pulsemat[i][p][c]*_ampvec[p][c];
+    for (unsigned int c=0; c<W; ++c) resvec[i][c] -= _sampvec[i][c];
+  }
+  solveL(resvec);
+
+  for (unsigned int c=0; c<W; ++c) chisq[c] = 0.;
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int c=0; c<W; ++c) chisq[c] += resvec[i][c]*resvec[i][c];
+
+}
+
+void PulseChiSqSNNLSBatch::ComputeApproxUncertainty(unsigned int ipulse, double *err) const {
+  //compute approximate uncertainties
+  //(using 1/second derivative since full Hessian is not meaningful in
+  //presence of positive amplitude boundaries.)
+
+  double pulse[NS][W];
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int c=0; c<W; ++c) pulse[i][c] = _pulsemat[i][ipulse][c];
+  solveL(pulse);
+
+  for (unsigned int c=0; c<W; ++c) err[c] = 0.;
+  for (unsigned int i=0; i<NS; ++i)
+    for (unsigned int c=0; c<W; ++c) err[c] += pulse[i][c]*pulse[i][c];
+  for (unsigned int c=0; c<W; ++c) err[c] = 1./std::sqrt(err[c]);
+
+}
+
+void PulseChiSqSNNLSBatch::computeNormalEquations() {
+
+  double invcovp[NS][NP][W];
+  double invcovs[NS][W];
+  for (unsigned int i=0; i<NS; ++i) {
+    for (unsigned int p=0; p<_npulsetot; ++p)
+      for (unsigned int c=0; c<W; ++c) invcovp[i][p][c] = _pulsemat[i][p][c];
+    for (unsigned int c=0; c<W; ++c) invcovs[i][c] = _sampvec[i][c];
+  }
+  for (unsigned int i=0; i<NS; ++i) {
+    for (unsigned int k=0; k<i; ++k) {
+      for (unsigned int p=0; p<_npulsetot; ++p)
+        for (unsigned int c=0; c<W; ++c) invcovp[i][p][c] -= _covdecompL[i][k][c]*invcovp[k][p][c];
+      for (unsigned int c=0; c<W; ++c) invcovs[i][c] -= _covdecompL[i][k][c]*invcovs[k][c];
+    }
+    for (unsigned int p=0; p<_npulsetot; ++p)
+      for (unsigned int c=0; c<W; ++c) invcovp[i][p][c] /= _covdecompL[i][i][c];
+    for (unsigned int c=0; c<W; ++c) invcovs[i][c] /= _covdecompL[i][i][c];
+  }
+
+  for (unsigned int p=0; p<_npulsetot; ++p) {
+    for (unsigned int q=0; q<=p; ++q) {
+      for (unsigned int c=0; c<W; ++c) _aTamat[p][q][c] = 0.;
+      for (unsigned int i=0; i<NS; ++i)
+        for (unsigned int c=0; c<W; ++c) _aTamat[p][q][c] += invcovp[i][p][c]*invcovp[i][q][c];
+      for (unsigned int c=0; c<W; ++c) _aTamat[q][p][c] = _aTamat[p][q][c];
+    }
+    for (unsigned int c=0; c<W; ++c) _aTbvec[p][c] = 0.;
+    for (unsigned int i=0; i<NS; ++i)
+      for (unsigned int c=0; c<W; ++c) _aTbvec[p][c] += invcovp[i][p][c]*invcovs[i][c];
+  }
+
+}
+
+void PulseChiSqSNNLSBatch::solveUnconstrained(const bool *solve, double (*x)[W]) const {
+
+  // the unconstrained pulses of each channel are gathered in a system of the
+  // size of the largest number of them, completed with identity rows
+  unsigned int n = 0;
+  unsigned int idx[NP][W];
+  for (unsigned int c=0; c<W; ++c) {
+    unsigned int k = 0;
+    if (solve[c]) {
+      for (unsigned int p=0; p<_npulsetot; ++p)
+        if (_passive[p][c]) idx[k++][c] = p;
+    }
+    n = std::max(n,k);
+    for (; k<NP; ++k) idx[k][c] = NP;
+  }
+
+  double ldlt[NP][NP][W];
+  double y[NP][W];
+  for (unsigned int k=0; k<n; ++k) {
+    for (unsigned int l=0; l<=k; ++l)
+      for (unsigned int c=0; c<W; ++c)
+        ldlt[k][l][c] = idx[k][c]<NP ? _aTamat[idx[k][c]][idx[l][c]][c] : (k==l ? 1. : 0.);
+    for (unsigned int c=0; c<W; ++c) y[k][c] = idx[k][c]<NP ? _aTbvec[idx[k][c]][c] : 0.;
+  }
+
+  // LDLT decomposition, in place in the lower triangle
+  double ld[NP][W];
+  double invd[NP][W];
+  for (unsigned int j=0; j<n; ++j) {
+    for (unsigned int k=0; k<j; ++k)
+      for (unsigned int c=0; c<W; ++c) {
+        ld[k][c] = ldlt[j][k][c]*ldlt[k][k][c];
+        ldlt[j][j][c] -= ldlt[j][k][c]*ld[k][c];
+      }
+    // zero pivots give zero components, as in Eigen::LDLT
+    for (unsigned int c=0; c<W; ++c)
+      invd[j][c] = std::abs(ldlt[j][j][c]) > std::numeric_limits<double>::min() ? 1./ldlt[j][j][c] : 0.;
+    for (unsigned int i=j+1; i<n; ++i) {
+      for (unsigned int k=0; k<j; ++k)
+        for (unsigned int c=0; c<W; ++c) ldlt[i][j][c] -= ldlt[i][k][c]*ld[k][c];
+      for (unsigned int c=0; c<W; ++c) ldlt[i][j][c] *= invd[j][c];
+    }
+  }
+
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int k=0; k<i; ++k)
+      for (unsigned int c=0; c<W; ++c) y[i][c] -= ldlt[i][k][c]*y[k][c];
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int c=0; c<W; ++c) y[i][c] *= invd[i][c];
+  for (unsigned int i=n; i-- > 0; )
+    for (unsigned int k=i+1; k<n; ++k)
+      for (unsigned int c=0; c<W; ++c) y[i][c] -= ldlt[k][i][c]*y[k][c];
+
+  for (unsigned int k=0; k<n; ++k)
+    for (unsigned int c=0; c<W; ++c)
+      if (idx[k][c]<NP) x[idx[k][c]][c] = y[k][c];
+
+}
+
+void PulseChiSqSNNLSBatch::NNLS(const bool *fit) {
+
+  //Fast NNLS (fnnls) algorithm as per http://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.157.9203&rep=rep1&type=pdf
+  //run by each channel, the channels in the same phase compute together
+
+  const unsigned int npulse = _npulsetot;
+  const unsigned int maxnP = std::min(npulse,NS);
+
+  computeNormalEquations();
+
+  enum Phase {done, update, solve};
+  Phase phase[W];
+  int iter[W];
+  int idxwmax[W];
+  double wmax[W];
+  double threshold[W];
+  for (unsigned int c=0; c<W; ++c) {
+    //can only perform the update step if solution is guaranteed viable
+    phase[c] = !fit[c] ? done : (_nP[c]==0 ? update : solve);
+    iter[c] = 0;
+    idxwmax[c] = -1;
+    wmax[c] = 0.0;
+    threshold[c] = 1e-11;
+  }
+
+  // end of the iteration of channel c
+  auto next = [&](unsigned int c) {
+    ++iter[c];
+    //adaptive convergence threshold to avoid infinite loops but still
+    //ensure best value is used
+    if (iter[c] % 16 == 0) {
+      threshold[c] *= 2;
+    }
+    phase[c] = update;
+  };
+
+  double updatework[NP][W];
+  double ampvecpermtest[NP][W];
+  while (true) {
+
+    bool anyupdate = false;
+    bool anysolve = false;
+    for (unsigned int c=0; c<W; ++c) {
+      anyupdate |= phase[c]==update;
+      anysolve |= phase[c]==solve;
+    }
+    if (!anyupdate && !anysolve) break;
+
+    if (anyupdate) {
+      for (unsigned int p=0; p<npulse; ++p) {
+        for (unsigned int c=0; c<W; ++c) updatework[p][c] = _aTbvec[p][c];
+        for (unsigned int q=0; q<npulse; ++q)
+          for (unsigned int c=0; c<W; ++c) updatework[p][c] -= _aTamat[p][q][c]*_ampvec[q][c];
+      }
+
+      for (unsigned int c=0; c<W; ++c) {
+        if (phase[c]!=update) continue;
+        if (_nP[c]==maxnP) { phase[c] = done; continue; }
+
+        int idxwmaxprev = idxwmax[c];
+        double wmaxprev = wmax[c];
+        wmax[c] = -std::numeric_limits<double>::max();
+        for (unsigned int p=0; p<npulse; ++p) {
+          if (!_passive[p][c] && updatework[p][c]>wmax[c]) {
+            wmax[c] = updatework[p][c];
+            idxwmax[c] = p;
+          }
+        }
+
+        //convergence
+        if (wmax[c]<threshold[c] || (idxwmax[c]==idxwmaxprev && wmax[c]==wmaxprev)) { phase[c] = done; continue; }
+
+        //worst case protection
+        if (iter[c]>=500) {
+          LogDebug("PulseChiSqSNNLSBatch::NNLS()") << "Max Iterations reached at iter " << iter[c];
+          phase[c] = done;
+          continue;
+        }
+
+        //unconstrain parameter
+        _passive[idxwmax[c]][c] = true;
+        ++_nP[c];
+        phase[c] = solve;
+        anysolve = true;
+      }
+    }
+
+    if (!anysolve) continue;
+
+    //solve for unconstrained parameters
+    bool solving[W];
+    for (unsigned int c=0; c<W; ++c) solving[c] = phase[c]==solve;
+    solveUnconstrained(solving,ampvecpermtest);
+
+    for (unsigned int c=0; c<W; ++c) {
+      if (phase[c]!=solve) continue;
+
+      //check solution
+      bool positive = true;
+      for (unsigned int p=0; p<npulse; ++p)
+        positive &= (!_passive[p][c] || ampvecpermtest[p][c] > 0);
+      if (positive) {
+        for (unsigned int p=0; p<npulse; ++p)
+          if (_passive[p][c]) _ampvec[p][c] = ampvecpermtest[p][c];
+        next(c);
+        continue;
+      }
+
+      //update parameter vector
+      unsigned int minratioidx=0;
+      double minratio = std::numeric_limits<double>::max();
+      for (unsigned int p=0; p<npulse; ++p) {
+        if (_passive[p][c] && ampvecpermtest[p][c]<=0.) {
+          const double c_ampvec = _ampvec[p][c];
+          const double ratio = c_ampvec/(c_ampvec-ampvecpermtest[p][c]);
+          if (ratio<minratio) {
+            minratio = ratio;
+            minratioidx = p;
+          }
+        }
+      }
+
+      for (unsigned int p=0; p<npulse; ++p)
+        if (_passive[p][c]) _ampvec[p][c] += minratio*(ampvecpermtest[p][c] - _ampvec[p][c]);
+
+      //avoid numerical problems with later ==0. check
+      _ampvec[minratioidx][c] = 0.;
+      _passive[minratioidx][c] = false;
+      --_nP[c];
+      if (_nP[c]==0) next(c);
+    }
+  }
+
+}
+
+void PulseChiSqSNNLSBatch::OnePulseMinimize(const bool *fit) {
+
+  computeNormalEquations();
+  for (unsigned int c=0; c<W; ++c) {
+    if (fit[c]) _ampvec[0][c] = std::max(0.,_aTbvec[0][c]/_aTamat[0][0][c]);
+  }
+
+}
@@ -0,0 +1,161 @@
+/* Unit test for EcalUncalibRecHitMultiFitAlgo:
+   the batched fit of makeRecHits against makeRecHit, on random digis
+
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitMultiFitAlgo.h"
+#include "DataFormats/EcalDetId/interface/EBDetId.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+class testEcalUncalibRecHitMultiFitAlgo: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testEcalUncalibRecHitMultiFitAlgo);
+  CPPUNIT_TEST(testBatch);
+  CPPUNIT_TEST(testBatchPrefit);
+  CPPUNIT_TEST(testBatchDynamicPedestals);
+  CPPUNIT_TEST(testBatchDynamicPedestalsPrefit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown(){}
+
+  void testBatch() { compare(false, false); }
+  void testBatchPrefit() { compare(true, false); }
+  void testBatchDynamicPedestals() { compare(false, true); }
+  void testBatchDynamicPedestalsPrefit() { compare(true, true); }
+
+private:
+  void compare(bool prefit, bool dynamicPedestals);
+
+  static const int nchannels = 1000;
+  SampleMatrixGainArray noisecors_;
+  std::vector<EcalPedestals::Item> peds_;
+  std::vector<EcalMGPAGainRatio> gains_;
+  std::vector<EcalPulseShapes::Item> pulses_;
+  std::vector<EcalPulseCovariances::Item> pulsecovs_;
+  std::vector<std::array<uint16_t,EcalDataFrame::MAXSAMPLES> > data_;
+  std::vector<EcalUncalibRecHitMultiFitAlgo::Channel> channels_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testEcalUncalibRecHitMultiFitAlgo);
+
+void testEcalUncalibRecHitMultiFitAlgo::setUp(){
+
+  // a barrel pulse shape and the correlations of the noise of gain 12
+  const double pulse[EcalPulseShape::TEMPLATESAMPLES] = {1.13979e-02, 7.58151e-01, 1.00000e+00, 8.87744e-01, 6.73548e-01, 4.74332e-01,
+                                                         3.19561e-01, 2.15144e-01, 1.47464e-01, 1.01087e-01, 6.93181e-02, 4.75044e-02};
+  const double cor[EcalDataFrame::MAXSAMPLES] = {1.00000, 0.71073, 0.55721, 0.46089, 0.40449, 0.35931, 0.33924, 0.32439, 0.31581, 0.30481};
+  for (auto & noisecor : noisecors_)
+    for (int i=0; i<EcalDataFrame::MAXSAMPLES; ++i)
+      for (int j=0; j<EcalDataFrame::MAXSAMPLES; ++j)
+        noisecor(i,j) = cor[std::abs(i-j)];
+  SampleMatrix noiseL = SampleDecompLLT(noisecors_[0]).matrixL();
+
+  std::mt19937 rng(12345);
+  std::normal_distribution<double> gauss;
+  std::exponential_distribution<double> energy(0.05);
+  std::uniform_real_distribution<double> flat(0.,1.);
+
+  peds_.resize(nchannels);
+  gains_.resize(nchannels);
+  pulses_.resize(nchannels);
+  pulsecovs_.resize(nchannels);
+  data_.resize(nchannels);
+  for (int k=0; k<nchannels; ++k) {
+    auto & ped = peds_[k];
+    ped.mean_x12 = 200.+5.*flat(rng);
+    ped.rms_x12 = 1.+0.5*flat(rng);
+    ped.mean_x6 = 200.; ped.rms_x6 = 1.;
+    ped.mean_x1 = 200.; ped.rms_x1 = 1.;
+    gains_[k].setGain12Over6(2.);
+    gains_[k].setGain6Over1(6.);
+    for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i) {
+      pulses_[k].pdfval[i] = i==2 ? pulse[i] : pulse[i]*(1.+0.03*gauss(rng));
+      for (int j=0; j<EcalPulseShape::TEMPLATESAMPLES; ++j)
+        pulsecovs_[k].covval[i][j] = (i==2 || j==2) ? 0. : 1.e-5*std::exp(-0.5*std::abs(i-j));
+    }
+
+    // correlated noise, an in-time pulse and some out-of-time pileup
+    SampleVector samples;
+    for (int i=0; i<EcalDataFrame::MAXSAMPLES; ++i) samples[i] = gauss(rng);
+    samples = ped.rms_x12*(noiseL*samples);
+    for (int bx=-5; bx<5; ++bx) {
+      double amplitude = 0.;
+      if (bx==0) amplitude = flat(rng)<0.3 ? 0. : energy(rng)*(flat(rng)<0.02 ? 300. : 1.);
+      else if (flat(rng)<0.4) amplitude = 0.2*energy(rng);
+      for (int i=0; i<EcalDataFrame::MAXSAMPLES; ++i) {
+        int ip = i-3-bx;
+        if (ip>=0 && ip<EcalPulseShape::TEMPLATESAMPLES) samples[i] += amplitude*pulses_[k].pdfval[ip];
+      }
+    }
+
+    // the largest pulses switch to gain 6, and a few channels have a single sample in gain 0
+    bool gain0 = flat(rng)<0.01;
+    for (int i=0; i<EcalDataFrame::MAXSAMPLES; ++i) {
+      double adc = samples[i]+ped.mean_x12;
+      int gainId = 1;
+      if (gain0 && i==5) {
+        adc = 4095.; gainId = 0;
+      } else if (adc>4000.) {
+        adc = 0.5*adc; gainId = 2;
+      }
+      data_[k][i] = EcalMGPASample(std::max(0,std::min(4095,int(std::round(adc)))), gainId).raw();
+    }
+  }
+
+  channels_.clear();
+  for (int k=0; k<nchannels; ++k) {
+    EBDetId id(1+k/360, 1+k%360);
+    EcalDataFrame frame(edm::DataFrame(id.rawId(), data_[k].data(), EcalDataFrame::MAXSAMPLES));
+    channels_.push_back({frame, &peds_[k], &gains_[k], &pulses_[k], &pulsecovs_[k]});
+  }
+}
+
+void testEcalUncalibRecHitMultiFitAlgo::compare(bool prefit, bool dynamicPedestals){
+
+  // with dynamic pedestals the pedestal takes the place of one of the pulses
+  BXVector activeBX(dynamicPedestals ? 9 : 10);
+  for (int i=0; i<activeBX.rows(); ++i) activeBX[i] = i-(dynamicPedestals ? 4 : 5);
+
+  EcalUncalibRecHitMultiFitAlgo single, batch;
+  for (auto algo : {&single, &batch}) {
+    algo->setDoPrefit(prefit);
+    algo->setPrefitMaxChiSq(25.);
+    algo->setDynamicPedestals(dynamicPedestals);
+  }
+
+  std::vector<EcalUncalibratedRecHit> hits;
+  batch.makeRecHits(channels_, noisecors_, activeBX, hits);
+  CPPUNIT_ASSERT(hits.size()==channels_.size());
+
+  // the errors of some of the channels with gain switch, fitted by makeRecHit in both cases, are NaN
+  auto close = [](double x, double y) { return (std::isnan(x) && std::isnan(y)) || std::abs(x-y) <= 1.e-6*(1.+std::abs(x)); };
+  FullSampleVector fullpulse(FullSampleVector::Zero());
+  FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
+  for (unsigned int k=0; k<channels_.size(); ++k) {
+    for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i) {
+      fullpulse(i+7) = pulses_[k].pdfval[i];
+      for (int j=0; j<EcalPulseShape::TEMPLATESAMPLES; ++j)
+        fullpulsecov(i+7,j+7) = pulsecovs_[k].covval[i][j];
+    }
+    auto const & ch = channels_[k];
+    auto expected = single.makeRecHit(ch.dataFrame, ch.aped, ch.aGain, noisecors_, fullpulse, fullpulsecov, activeBX);
+    auto const & hit = hits[k];
+
+    CPPUNIT_ASSERT(hit.id()==expected.id());
+    CPPUNIT_ASSERT(close(expected.amplitude(), hit.amplitude()));
+    CPPUNIT_ASSERT(close(expected.amplitudeError(), hit.amplitudeError()));
+    CPPUNIT_ASSERT(close(expected.chi2(), hit.chi2()));
+    CPPUNIT_ASSERT(close(expected.pedestal(), hit.pedestal()));
+    for (unsigned int ibx=0; ibx<EcalDataFrame::MAXSAMPLES; ++ibx)
+      CPPUNIT_ASSERT(close(expected.outOfTimeAmplitude(ibx), hit.outOfTimeAmplitude(ibx)));
+  }
+}
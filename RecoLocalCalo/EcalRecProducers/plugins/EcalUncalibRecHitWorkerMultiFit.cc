@@ -22,6 +22,16 @@
 #include <FWCore/ParameterSet/interface/ParameterSetDescription.h>
 #include <FWCore/ParameterSet/interface/EmptyGroupDescription.h>
 
+namespace {
+  // the sample before the first saturated one, -2 without saturation
+  int findLastSampleBeforeSaturation(const EcalDataFrame& frame) {
+    for(unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++) {
+      if ( frame.sample(iSample).gainId() == 0 ) return iSample-1;
+    }
+    return -2;
+  }
+}
+
 EcalUncalibRecHitWorkerMultiFit::EcalUncalibRecHitWorkerMultiFit(const edm::ParameterSet&ps,edm::ConsumesCollector& c) :
   EcalUncalibRecHitWorkerBaseClass(ps,c)
 {
@@ -35,6 +45,8 @@ EcalUncalibRecHitWorkerMultiFit::EcalUncalibRecHitWorkerMultiFit(const edm::Para
 
   // uncertainty calculation (CPU intensive)
   ampErrorCalculation_ = ps.getParameter<bool>("ampErrorCalculation");
+  // fit the channels without gain switch in batches
+  batchFit_ = ps.getParameter<bool>("batchFit");
   useLumiInfoRunHeader_ = ps.getParameter<bool>("useLumiInfoRunHeader");
   
   if (useLumiInfoRunHeader_) {
@@ -284,6 +296,29 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
     FullSampleVector fullpulse(FullSampleVector::Zero());
     FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
 
+    // with the batch fit the amplitudes of all the channels of the multifit
+    // are computed first, in the order in which they are used below
+    std::vector<EcalUncalibratedRecHit> multiFitHits;
+    unsigned int iMultiFit = 0;
+    if (batchFit_) {
+        std::vector<EcalUncalibRecHitMultiFitAlgo::Channel> channels;
+        channels.reserve(digis.size());
+        for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg) {
+            EcalDataFrame frame(*itdg);
+            if (findLastSampleBeforeSaturation(frame) >= -1) continue;
+            if (barrel) {
+                unsigned int hashedIndex = EBDetId(frame.id()).hashedIndex();
+                channels.push_back({frame, &peds->barrel(hashedIndex), &gains->barrel(hashedIndex),
+                                    &pulseshapes->barrel(hashedIndex), &pulsecovariances->barrel(hashedIndex)});
+            } else {
+                unsigned int hashedIndex = EEDetId(frame.id()).hashedIndex();
+                channels.push_back({frame, &peds->endcap(hashedIndex), &gains->endcap(hashedIndex),
+                                    &pulseshapes->endcap(hashedIndex), &pulsecovariances->endcap(hashedIndex)});
+            }
+        }
+        multiFitMethod_.makeRecHits(channels, noisecor(barrel), activeBX, multiFitHits);
+    }
+
     result.reserve(result.size() + digis.size());
     for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg)
     {
@@ -340,13 +375,7 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
             << "! something wrong with EcalTimeCalibConstants in your DB? ";
 	}
 
-        int lastSampleBeforeSaturation = -2;
-        for(unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++) {
-          if ( ((EcalDataFrame)(*itdg)).sample(iSample).gainId() == 0 ) {
-            lastSampleBeforeSaturation=iSample-1;
-            break;
-          }
-        }
+        int lastSampleBeforeSaturation = findLastSampleBeforeSaturation(*itdg);
 
         // === amplitude computation ===
 
@@ -371,7 +400,11 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
             // multifit
             const SampleMatrixGainArray &noisecors = noisecor(barrel);
             
-            result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+            if (batchFit_) {
+                result.push_back(multiFitHits[iMultiFit++]);
+            } else {
+                result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+            }
             auto & uncalibRecHit = result.back();
             
             // === time computation ===
@@ -551,6 +584,7 @@ EcalUncalibRecHitWorkerMultiFit::getAlgoDescription() {
  edm::ParameterSetDescription psd;
  psd.addNode(edm::ParameterDescription<std::vector<int>>("activeBXs", {-5,-4,-3,-2,-1,0,1,2,3,4}, true) and
 	      edm::ParameterDescription<bool>("ampErrorCalculation", true, true) and
+	      edm::ParameterDescription<bool>("batchFit", false, true) and
 	      edm::ParameterDescription<bool>("useLumiInfoRunHeader", true, true) and
 	      edm::ParameterDescription<int>("bunchSpacing", 0, true) and
 	      edm::ParameterDescription<bool>("doPrefitEB", false, true) and
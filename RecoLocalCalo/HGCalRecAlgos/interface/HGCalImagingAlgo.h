@@ -15,6 +15,7 @@
 #include "DataFormats/EgammaReco/interface/BasicCluster.h"
 
 #include "RecoLocalCalo/HGCalRecAlgos/interface/RecHitTools.h"
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
 
 // C/C++ headers
 #include <string>
@@ -80,10 +81,7 @@ HGCalImagingAlgo(const std::vector<double>& vecDeltas_in, double kappa_in, doubl
         verbosity(the_verbosity),
         initialized(false),
         points(2*(maxlayer+1)),
-        minpos(2*(maxlayer+1),{
-                {0.0f,0.0f}
-        }),
-        maxpos(2*(maxlayer+1),{ {0.0f,0.0f} })
+        tiles(2*(maxlayer+1))
 {
 }
 
@@ -112,10 +110,7 @@ HGCalImagingAlgo(const std::vector<double>& vecDeltas_in, double kappa_in, doubl
         verbosity(the_verbosity),
         initialized(false),
         points(2*(maxlayer+1)),
-	minpos(2*(maxlayer+1),{
-                {0.0f,0.0f}
-        }),
-	maxpos(2*(maxlayer+1),{ {0.0f,0.0f} })
+        tiles(2*(maxlayer+1))
 {
 }
 
@@ -148,11 +143,6 @@ void reset(){
                 it.clear();
                 std::vector<KDNode>().swap(it);
         }
-        for(unsigned int i = 0; i < minpos.size(); i++)
-        {
-                minpos[i][0]=0.; minpos[i][1]=0.;
-                maxpos[i][0]=0.; maxpos[i][1]=0.;
-        }
 }
 void computeThreshold();
 
@@ -256,7 +246,6 @@ struct Hexel {
 
 };
 
-typedef KDTreeLinkerAlgo<Hexel,2> KDTree;
 typedef KDTreeNodeInfoT<Hexel,2> KDNode;
 
 
@@ -276,8 +265,8 @@ std::vector<size_t> sort_by_delta(const std::vector<KDNode> &v){
 std::vector<std::vector<KDNode> > points;   //a vector of vectors of hexels, one for each layer
 //@@EM todo: the number of layers should be obtained programmatically - the range is 1-n instead of 0-n-1...
 
-std::vector<std::array<float,2> > minpos;
-std::vector<std::array<float,2> > maxpos;
+// used for speedy search, one for each layer
+std::vector<HGCalLayerTiles> tiles;
 
 
 //these functions should be in a helper class.
@@ -289,9 +278,9 @@ inline double distance2(const Hexel &pt1, const Hexel &pt2) {   //distance squar
 inline double distance(const Hexel &pt1, const Hexel &pt2) {   //2-d distance on the layer (x-y)
         return std::sqrt(distance2(pt1,pt2));
 }
-double calculateLocalDensity(std::vector<KDNode> &, KDTree &, const unsigned int);   //return max density
-double calculateDistanceToHigher(std::vector<KDNode> &);
-int findAndAssignClusters(std::vector<KDNode> &, KDTree &, double, KDTreeBox &, const unsigned int);
+double calculateLocalDensity(std::vector<KDNode> &, HGCalLayerTiles &, const unsigned int);   //return max density
+double calculateDistanceToHigher(std::vector<KDNode> &, HGCalLayerTiles &);
+int findAndAssignClusters(std::vector<KDNode> &, HGCalLayerTiles &, double, const unsigned int);
 math::XYZPoint calculatePosition(std::vector<KDNode> &);
 
 // attempt to find subclusters within a given set of hexels
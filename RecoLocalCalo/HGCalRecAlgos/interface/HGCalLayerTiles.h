@@ -0,0 +1,81 @@
+#ifndef RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+#define RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/** Fixed grid of square tiles over the hits of one layer.
+ *
+ *  The hits are sorted by tile, row after row, and their coordinates,
+ *  weights and ranks are stored as separate arrays in that order: the
+ *  hits of consecutive tiles of a row are contiguous, so that a search
+ *  around a point is a few loops over contiguous ranges. The tiles are
+ *  at least as large as the search distance given to build, hence the
+ *  density within that distance only needs the 3x3 tiles around a point.
+ *  Hits are identified by their index in the order they were added.
+ */
+
+class HGCalLayerTiles
+{
+public:
+
+  // maximum number of tiles along x and y
+  static const int maxTilesPerSide = 256;
+
+  void clear() {
+    x_.clear(); y_.clear(); weight_.clear();
+  }
+
+  void push_back(double x, double y, double weight) {
+    x_.push_back(x); y_.push_back(y); weight_.push_back(weight);
+  }
+
+  unsigned int size() const { return x_.size(); }
+
+  // sorts the hits in tiles of at least delta_c covering all of them
+  void build(float delta_c);
+
+  // sum of the weights of the hits closer than delta_c to (x,y), including any hit at (x,y)
+  double density(double x, double y, float delta_c) const;
+
+  // sets the rank of each hit (0 for the first) from the list of hits in rank order
+  void setRanks(const std::vector<size_t>& order);
+
+  // index of the closest hit of lower rank than hit i, considering only hits within
+  // dist2 (squared distance), which is updated to the squared distance found;
+  // ties go to the hit of highest rank, -1 if none is found
+  int nearestHigher(unsigned int i, double& dist2) const;
+
+  // calls f with the index of each hit in the tiles overlapping the square of half
+  // side d centred on (x,y)
+  template <typename F>
+  void forEachInBox(double x, double y, float d, F f) const {
+    const int ix0 = tileX(x-d), ix1 = tileX(x+d);
+    const int iy0 = tileY(y-d), iy1 = tileY(y+d);
+    for (int iy = iy0; iy <= iy1; ++iy) {
+      const unsigned int end = first_[iy*nx_+ix1+1];
+      for (unsigned int j = first_[iy*nx_+ix0]; j < end; ++j) f(index_[j]);
+    }
+  }
+
+private:
+
+  int tileX(double x) const { return std::min(nx_-1, std::max(0, int((x-minx_)*invSize_))); }
+  int tileY(double y) const { return std::min(ny_-1, std::max(0, int((y-miny_)*invSize_))); }
+
+  // input hits, in the order they were added
+  std::vector<double> x_, y_, weight_;
+  std::vector<unsigned int> rank_;
+
+  // hits sorted by tile
+  std::vector<double> tx_, ty_, tweight_;
+  std::vector<unsigned int> trank_, index_;
+  // first sorted hit of each tile, plus the end
+  std::vector<unsigned int> first_;
+
+  int nx_ = 1, ny_ = 1;
+  double minx_ = 0., miny_ = 0., size_ = 1., invSize_ = 1.;
+};
+
+#endif
@@ -10,6 +10,8 @@
 //
 #include "DataFormats/CaloRecHit/interface/CaloID.h"
 
+#include "tbb/parallel_for.h"
+
 void HGCalImagingAlgo::populate(const HGCRecHitCollection& hits){
   //loop over all hits and create the Hexel structure, skip energies below ecut
 
@@ -18,7 +20,6 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection& hits){
     computeThreshold();
   }
 
-  std::vector<bool> firstHit(2*(maxlayer+1), true);
   for (unsigned int i=0;i<hits.size();++i) {
 
     const HGCRecHit& hgrh = hits[i];
@@ -48,18 +49,6 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection& hits){
     //here's were the KDNode is passed its dims arguments - note that these are *copied* from the Hexel
     points[layer].emplace_back(Hexel(hgrh,detid,isHalf,sigmaNoise,thickness,&rhtools_),position.x(),position.y());
 
-    // for each layer, store the minimum and maximum x and y coordinates for the KDTreeBox boundaries
-    if(firstHit[layer]){
-      minpos[layer][0] = position.x(); minpos[layer][1] = position.y();
-      maxpos[layer][0] = position.x(); maxpos[layer][1] = position.y();
-      firstHit[layer] = false;
-    }else{
-      minpos[layer][0] = std::min((float)position.x(),minpos[layer][0]);
-      minpos[layer][1] = std::min((float)position.y(),minpos[layer][1]);
-      maxpos[layer][0] = std::max((float)position.x(),maxpos[layer][0]);
-      maxpos[layer][1] = std::max((float)position.y(),maxpos[layer][1]);
-    }
-
   } // end loop hits
 
 }
@@ -69,22 +58,21 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection& hits){
 void HGCalImagingAlgo::makeClusters()
 {
 
-  // used for speedy search
-  std::vector<KDTree> hit_kdtree(2*(maxlayer+1));
-
-  //assign all hits in each layer to a cluster core or halo
-  for (unsigned int i = 0; i <= 2*maxlayer+1; ++i) {
-    KDTreeBox bounds(minpos[i][0],maxpos[i][0],
-		     minpos[i][1],maxpos[i][1]);
-
-    hit_kdtree[i].build(points[i],bounds);
+  std::vector<double> maxdensity(2*(maxlayer+1), 0.);
 
-    unsigned int actualLayer = i > maxlayer ? (i-(maxlayer+1)) : i; // maps back from index used for KD trees to actual layer
+  // the layers are independent until the clusters are numbered
+  tbb::parallel_for(0U, 2*maxlayer+2, 1U, [&](unsigned int i) {
+    unsigned int actualLayer = i > maxlayer ? (i-(maxlayer+1)) : i; // maps back from index used for tiles to actual layer
 
-    double maxdensity = calculateLocalDensity(points[i],hit_kdtree[i], actualLayer); // also stores rho (energy density) for each point (node)
+    maxdensity[i] = calculateLocalDensity(points[i],tiles[i], actualLayer); // also stores rho (energy density) for each point (node)
     // calculate distance to nearest point with higher density storing distance (delta) and point's index
-    calculateDistanceToHigher(points[i]);
-    findAndAssignClusters(points[i],hit_kdtree[i],maxdensity,bounds,actualLayer);
+    calculateDistanceToHigher(points[i],tiles[i]);
+  });
+
+  //assign all hits in each layer to a cluster core or halo
+  for (unsigned int i = 0; i <= 2*maxlayer+1; ++i) {
+    unsigned int actualLayer = i > maxlayer ? (i-(maxlayer+1)) : i;
+    findAndAssignClusters(points[i],tiles[i],maxdensity[i],actualLayer);
   }
   //make the cluster vector
 }
@@ -206,7 +194,7 @@ math::XYZPoint HGCalImagingAlgo::calculatePosition(std::vector<KDNode> &v){
   return math::XYZPoint(0, 0, 0);
 }
 
-double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd, KDTree &lp, const unsigned int layer){
+double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd, HGCalLayerTiles &lp, const unsigned int layer){
 
   double maxdensity = 0.;
   float delta_c; // maximum search distance (critical distance) for local density calculation
@@ -214,29 +202,26 @@ double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd, KDTree &
   else if( layer <= lastLayerFH) delta_c = vecDeltas[1];
   else delta_c = vecDeltas[2];
 
+  lp.clear();
+  for(auto const& it: nd)
+    lp.push_back(it.data.x,it.data.y,it.data.weight);
+  lp.build(delta_c);
+
   // for each node calculate local density rho and store it
   for(unsigned int i = 0; i < nd.size(); ++i){
-    // speec up search by looking within +/- delta_c window only
-    KDTreeBox search_box(nd[i].dims[0]-delta_c,nd[i].dims[0]+delta_c,
-			 nd[i].dims[1]-delta_c,nd[i].dims[1]+delta_c);
-    std::vector<KDNode> found;
-    lp.search(search_box,found);
-    const unsigned int found_size = found.size();
-    for(unsigned int j = 0; j < found_size; j++){
-      if(distance(nd[i].data,found[j].data) < delta_c){
-	    nd[i].data.rho += found[j].data.weight;
-	    if(nd[i].data.rho > maxdensity) maxdensity = nd[i].data.rho;
-      }
-    } // end loop found
+    // speed up search by looking in the tiles within +/- delta_c only
+    nd[i].data.rho += lp.density(nd[i].data.x,nd[i].data.y,delta_c);
+    if(nd[i].data.rho > maxdensity) maxdensity = nd[i].data.rho;
   } // end loop nodes
   return maxdensity;
 }
 
-double HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd){
+double HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd, HGCalLayerTiles &lp){
 
 
   //sort vector of Hexels by decreasing local density
   std::vector<size_t> rs = sorted_indices(nd);
+  lp.setRanks(rs);
 
   double maxdensity = 0.0;
   int nearestHigher = -1;
@@ -265,25 +250,18 @@ double HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd){
   for(unsigned int oi = 1; oi < nd_size; ++oi){ // start from second-highest density
     dist2 = max_dist2;
     unsigned int i = rs[oi];
-    // we only need to check up to oi since hits
-    // are ordered by decreasing density
-    // and all points coming BEFORE oi are guaranteed to have higher rho
-    // and the ones AFTER to have lower rho
-    for(unsigned int oj = 0; oj < oi; ++oj){
-      unsigned int j = rs[oj];
-      double tmp = distance2(nd[i].data, nd[j].data);
-      if(tmp <= dist2){ //this "<=" instead of "<" addresses the (rare) case when there are only two hits
-	    dist2 = tmp;
-	    nearestHigher = j;
-      }
-    }
+    // we only need to check the points coming BEFORE oi since hits
+    // are ordered by decreasing density, looking in the tiles around
+    // the hit first; among points at the same distance the last one
+    // in density order is kept, the (rare) case of only two hits included
+    nearestHigher = lp.nearestHigher(i, dist2);
     nd[i].data.delta = std::sqrt(dist2);
     nd[i].data.nearestHigher = nearestHigher; //this uses the original unsorted hitlist
   }
   return maxdensity;
 }
 
-int HGCalImagingAlgo::findAndAssignClusters(std::vector<KDNode> &nd,KDTree &lp, double maxdensity, KDTreeBox &bounds, const unsigned int layer){
+int HGCalImagingAlgo::findAndAssignClusters(std::vector<KDNode> &nd,HGCalLayerTiles &lp, double maxdensity, const unsigned int layer){
 
   //this is called once per layer and endcap...
   //so when filling the cluster temporary vector of Hexels we resize each time by the number
@@ -346,37 +324,29 @@ int HGCalImagingAlgo::findAndAssignClusters(std::vector<KDNode> &nd,KDTree &lp,
   //assign points closer than dc to other clusters to border region
   //and find critical border density
   std::vector<double> rho_b(clusterIndex,0.);
-  lp.clear();
-  lp.build(nd,bounds);
   //now loop on all hits again :( and check: if there are hits from another cluster within d_c -> flag as border hit
+  //the tiles hold the indices of the hits, so they see the cluster indices just assigned
   for(unsigned int i = 0; i < nd_size; ++i){
     int ci = nd[i].data.clusterIndex;
     bool flag_isolated = true;
     if(ci != -1){
-      KDTreeBox search_box(nd[i].dims[0]-delta_c,nd[i].dims[0]+delta_c,
-			   nd[i].dims[1]-delta_c,nd[i].dims[1]+delta_c);
-      std::vector<KDNode> found;
-      lp.search(search_box,found);
-
-      const unsigned int found_size = found.size();
-      for(unsigned int j = 0; j < found_size; j++){ // start from 0 here instead of 1
+      lp.forEachInBox(nd[i].data.x,nd[i].data.y,delta_c,[&](unsigned int j){
 	    //check if the hit is not within d_c of another cluster
-	    if(found[j].data.clusterIndex!=-1){
-	      float dist = distance(found[j].data,nd[i].data);
-	      if(dist < delta_c && found[j].data.clusterIndex!=ci){
+	    if(nd[j].data.clusterIndex!=-1){
+	      float dist = distance(nd[j].data,nd[i].data);
+	      if(dist < delta_c && nd[j].data.clusterIndex!=ci){
 	        //in which case we assign it to the border
 	        nd[i].data.isBorder = true;
-	        break;
 	      }
-	      //because we are using two different containers, we have to make sure that we don't unflag the
+	      //we have to make sure that we don't unflag the
 	      // hit when it finds *itself* closer than delta_c
-	      if(dist < delta_c && dist != 0. && found[j].data.clusterIndex==ci){
+	      if(dist < delta_c && dist != 0. && nd[j].data.clusterIndex==ci){
 	        // in this case it is not an isolated hit
             // the dist!=0 is because the hit being looked at is also inside the search box and at dist==0
 	        flag_isolated = false;
 	      }
 	    }
-      }
+	  });
       if(flag_isolated) nd[i].data.isBorder = true; //the hit is more than delta_c from any of its brethren
     }
     //check if this border hit has density larger than the current rho_b and update
@@ -0,0 +1,112 @@
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
+
+#include <numeric>
+
+// odr-used by std::min
+const int HGCalLayerTiles::maxTilesPerSide;
+
+void HGCalLayerTiles::build(float delta_c) {
+
+  const unsigned int n = x_.size();
+
+  double maxx = 0., maxy = 0.;
+  minx_ = 0.;
+  miny_ = 0.;
+  if (n > 0) {
+    auto xr = std::minmax_element(x_.begin(), x_.end());
+    auto yr = std::minmax_element(y_.begin(), y_.end());
+    minx_ = *xr.first; maxx = *xr.second;
+    miny_ = *yr.first; maxy = *yr.second;
+  }
+
+  // tiles no smaller than delta_c, and not many more tiles than hits
+  const int maxTiles = std::min(maxTilesPerSide, std::max(1, int(std::sqrt(double(n)))));
+  size_ = std::max(double(delta_c), std::max(maxx-minx_, maxy-miny_)/maxTiles);
+  invSize_ = 1./size_;
+  nx_ = std::min(maxTilesPerSide, int((maxx-minx_)*invSize_)+1);
+  ny_ = std::min(maxTilesPerSide, int((maxy-miny_)*invSize_)+1);
+
+  // counting sort of the hits by tile, keeping their order within a tile
+  std::vector<unsigned int> tile(n);
+  first_.assign(nx_*ny_+1, 0);
+  for (unsigned int i = 0; i < n; ++i) {
+    tile[i] = tileY(y_[i])*nx_ + tileX(x_[i]);
+    ++first_[tile[i]+1];
+  }
+  std::partial_sum(first_.begin(), first_.end(), first_.begin());
+
+  tx_.resize(n); ty_.resize(n); tweight_.resize(n);
+  index_.resize(n);
+  std::vector<unsigned int> next(first_.begin(), first_.end()-1);
+  for (unsigned int i = 0; i < n; ++i) {
+    const unsigned int j = next[tile[i]]++;
+    tx_[j] = x_[i];
+    ty_[j] = y_[i];
+    tweight_[j] = weight_[i];
+    index_[j] = i;
+  }
+}
+
+double HGCalLayerTiles::density(double x, double y, float delta_c) const {
+  double rho = 0.;
+  const int ix0 = tileX(x-delta_c), ix1 = tileX(x+delta_c);
+  const int iy0 = tileY(y-delta_c), iy1 = tileY(y+delta_c);
+  for (int iy = iy0; iy <= iy1; ++iy) {
+    const unsigned int end = first_[iy*nx_+ix1+1];
+    for (unsigned int j = first_[iy*nx_+ix0]; j < end; ++j) {
+      const double dx = x - tx_[j];
+      const double dy = y - ty_[j];
+      rho += std::sqrt(dx*dx + dy*dy) < delta_c ? tweight_[j] : 0.;
+    }
+  }
+  return rho;
+}
+
+void HGCalLayerTiles::setRanks(const std::vector<size_t>& order) {
+  rank_.resize(order.size());
+  for (unsigned int k = 0; k < order.size(); ++k) rank_[order[k]] = k;
+  trank_.resize(index_.size());
+  for (unsigned int j = 0; j < index_.size(); ++j) trank_[j] = rank_[index_[j]];
+}
+
+int HGCalLayerTiles::nearestHigher(unsigned int i, double& dist2) const {
+
+  const double x = x_[i], y = y_[i];
+  const unsigned int rank = rank_[i];
+  const int ix = tileX(x), iy = tileY(y);
+  int nearest = -1;
+  unsigned int nearestRank = 0;
+
+  auto scan = [&](int iy, int ix0, int ix1) {
+    const unsigned int end = first_[iy*nx_+ix1+1];
+    for (unsigned int j = first_[iy*nx_+ix0]; j < end; ++j) {
+      if (trank_[j] >= rank) continue;
+      const double dx = x - tx_[j];
+      const double dy = y - ty_[j];
+      const double tmp = dx*dx + dy*dy;
+      if (tmp < dist2 || (tmp == dist2 && (nearest < 0 || trank_[j] > nearestRank))) {
+        dist2 = tmp;
+        nearest = index_[j];
+        nearestRank = trank_[j];
+      }
+    }
+  };
+
+  // rings of tiles around the tile of the hit: the hits beyond ring r are
+  // farther than r tiles, so the search stops once a closer hit is found
+  const int maxr = std::max(std::max(ix, nx_-1-ix), std::max(iy, ny_-1-iy));
+  for (int r = 0; r <= maxr; ++r) {
+    const int ix0 = std::max(0, ix-r), ix1 = std::min(nx_-1, ix+r);
+    for (int jy = std::max(0, iy-r); jy <= std::min(ny_-1, iy+r); ++jy) {
+      if (jy == iy-r || jy == iy+r) {
+        scan(jy, ix0, ix1);
+      } else {
+        if (ix-r >= 0) scan(jy, ix-r, ix-r);
+        if (ix+r < nx_) scan(jy, ix+r, ix+r);
+      }
+    }
+    const double reach = r*size_;
+    if (dist2 < reach*reach*(1.-1e-9)) break;
+  }
+  return nearest;
+}
@@ -0,0 +1,111 @@
+// Checks HGCalLayerTiles against linear searches over all the hits of a
+// layer: the densities, the nearest hit of higher density with the tie
+// rule of HGCalImagingAlgo, and the hits found around each hit, on random
+// layers, on layers of hits on a lattice where distances are often equal,
+// and on empty or single hit layers.
+
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+int main() {
+  std::mt19937 rng(12345);
+  std::normal_distribution<double> gauss(0., 30.);
+  std::uniform_real_distribution<double> flat(0., 1.);
+  const float delta_c = 2.f;
+
+  unsigned int failures = 0;
+  for (int trial = 0; trial < 40; ++trial) {
+    const int n = trial < 20 ? trial*53 : 3000;
+    const bool lattice = trial%3 == 0;
+    std::vector<double> x(n), y(n), weight(n), rho(n);
+    for (int i = 0; i < n; ++i) {
+      if (lattice) {
+        x[i] = 1.5*std::round(gauss(rng)/1.5);
+        y[i] = 1.5*std::round(gauss(rng)/1.5);
+      } else {
+        x[i] = gauss(rng) + (i%2 ? 60. : 0.);
+        y[i] = gauss(rng);
+      }
+      weight[i] = flat(rng);
+    }
+
+    HGCalLayerTiles tiles;
+    for (int i = 0; i < n; ++i) tiles.push_back(x[i], y[i], weight[i]);
+    tiles.build(delta_c);
+    if (tiles.size() != unsigned(n)) {
+      std::cout << "trial " << trial << ": " << tiles.size() << " hits instead of " << n << "\n";
+      ++failures;
+      continue;
+    }
+
+    for (int i = 0; i < n; ++i) {
+      double expected = 0.;
+      std::vector<char> found(n, 0);
+      tiles.forEachInBox(x[i], y[i], delta_c, [&](unsigned int j) { found[j] = 1; });
+      for (int j = 0; j < n; ++j) {
+        const double dx = x[i]-x[j], dy = y[i]-y[j];
+        if (std::sqrt(dx*dx+dy*dy) < delta_c) {
+          expected += weight[j];
+          if (!found[j]) {
+            std::cout << "trial " << trial << ": hit " << j << " missing around hit " << i << "\n";
+            ++failures;
+          }
+        }
+      }
+      // the tiles sum the weights in another order
+      rho[i] = tiles.density(x[i], y[i], delta_c);
+      if (std::abs(rho[i]-expected) > 1.e-9*expected) {
+        std::cout << "trial " << trial << ": density " << rho[i] << " of hit " << i << " instead of " << expected << "\n";
+        ++failures;
+      }
+    }
+    if (n == 0) continue;
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rho[a] > rho[b]; });
+    tiles.setRanks(order);
+
+    double maxd2 = 0.;
+    for (int j = 0; j < n; ++j) {
+      const double dx = x[order[0]]-x[j], dy = y[order[0]]-y[j];
+      maxd2 = std::max(maxd2, dx*dx+dy*dy);
+    }
+    // as in HGCalImagingAlgo::calculateDistanceToHigher: at equal distance
+    // the last hit in density order wins
+    for (int oi = 1; oi < n; ++oi) {
+      const unsigned int i = order[oi];
+      double expected2 = maxd2;
+      int expected = -1;
+      for (int oj = 0; oj < oi; ++oj) {
+        const unsigned int j = order[oj];
+        const double dx = x[i]-x[j], dy = y[i]-y[j];
+        const double d2 = dx*dx+dy*dy;
+        if (d2 <= expected2) {
+          expected2 = d2;
+          expected = j;
+        }
+      }
+      double dist2 = maxd2;
+      const int nearest = tiles.nearestHigher(i, dist2);
+      if (nearest != expected || dist2 != expected2) {
+        std::cout << "trial " << trial << ": nearest higher " << nearest << " at " << dist2 << " of hit " << i
+                  << " instead of " << expected << " at " << expected2 << "\n";
+        ++failures;
+      }
+    }
+  }
+
+  if (failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  std::cout << "HGCalLayerTiles agrees with the linear searches" << std::endl;
+  return 0;
+}
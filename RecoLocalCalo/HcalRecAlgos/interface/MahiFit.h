@@ -12,7 +12,8 @@
 #include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
 #include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFunctor.h"
 
-#include <Math/Functor.h>
+#include <map>
+#include <memory>
 
 struct MahiNnlsWorkspace {
 
@@ -160,10 +161,11 @@ class MahiFit
   unsigned int bxSizeConf_;
   int bxOffsetConf_;
 
-  //for pulse shapes
+  //for pulse shapes, kept for each template since the channels
+  //of an event switch between a few of them
   int cntsetPulseShape_;
-  std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
-  std::unique_ptr<ROOT::Math::Functor> pfunctor_;
+  FitterFuncs::PulseShapeFunctor* psfPtr_;
+  std::map<const HcalPulseShapes::Shape*, std::unique_ptr<FitterFuncs::PulseShapeFunctor> > psfCache_;
 
 }; 
 #endif
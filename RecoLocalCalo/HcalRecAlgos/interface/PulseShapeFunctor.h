@@ -43,6 +43,10 @@ namespace FitterFuncs{
      void getPulseShape(std::array<double,HcalConst::maxSamples>& fillPulseShape) { 
        fillPulseShape = pulse_shape_;
      }
+
+     // pulse shape of unit height at pulseTime, as left by singlePulseShapeFunc
+     // without slew, read from tables precomputed on first use
+     void getPulseShape(double pulseTime, std::array<double,HcalConst::maxSamples>& fillPulseShape);
      
    private:
      std::array<float,HcalConst::maxPSshapeBin> pulse_hist;
@@ -52,6 +56,10 @@ namespace FitterFuncs{
      std::vector<float> accVarLenIdxZEROVec, diffVarItvlIdxZEROVec;
      std::vector<float> accVarLenIdxMinusOneVec, diffVarItvlIdxMinusOneVec;
      void funcShape(std::array<double,HcalConst::maxSamples> & ntmpbin, const double &pulseTime, const double &pulseHeight,const double &slew);
+     void fillPulseShapeTables();
+     // binned pulse shape for each ns of start time and rounding of the first bin,
+     // linear in the fractional part of the start time
+     std::vector<std::array<float,HcalConst::maxSamples> > shapeBase_, shapeSlope_;
      double psFit_x[HcalConst::maxSamples], psFit_y[HcalConst::maxSamples], psFit_erry[HcalConst::maxSamples], psFit_erry2[HcalConst::maxSamples], psFit_slew[HcalConst::maxSamples];
      
      unsigned nSamplesToFit_;
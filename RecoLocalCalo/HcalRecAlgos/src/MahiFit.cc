@@ -3,7 +3,9 @@
 
 MahiFit::MahiFit() :
   fullTSSize_(19), 
-  fullTSofInterest_(8)
+  fullTSofInterest_(8),
+  cntsetPulseShape_(0),
+  psfPtr_(nullptr)
 {}
 
 double MahiFit::getSiPMDarkCurrent(double darkCurrent, double fcByPE, double lambda) const {
@@ -277,22 +279,9 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
   float t0=meanTime_;
   if (applyTimeSlew_) t0+=hcalTimeSlew_delay->delay(std::max(1.0, itQ), slewFlavor_);
 
-  nnlsWork_.pulseN.fill(0);
-  nnlsWork_.pulseM.fill(0);
-  nnlsWork_.pulseP.fill(0);
-
-  const double xx[4]={t0, 1.0, 0.0, 3};
-  const double xxm[4]={-nnlsWork_.dt+t0, 1.0, 0.0, 3};
-  const double xxp[4]={ nnlsWork_.dt+t0, 1.0, 0.0, 3};
-
-  (*pfunctor_)(&xx[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseN);
-
-  (*pfunctor_)(&xxm[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseM);
-  
-  (*pfunctor_)(&xxp[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseP);
+  psfPtr_->getPulseShape(t0, nnlsWork_.pulseN);
+  psfPtr_->getPulseShape(-nnlsWork_.dt+t0, nnlsWork_.pulseM);
+  psfPtr_->getPulseShape( nnlsWork_.dt+t0, nnlsWork_.pulseP);
 
   //in the 2018+ case where the sample of interest (SOI) is in TS3, add an extra offset to align 
   //with previous SOI=TS4 case assumed by psfPtr_->getPulseShape()
@@ -498,9 +487,12 @@ void MahiFit::resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps) {
 
   // only the pulse shape itself from PulseShapeFunctor is used for Mahi
   // the uncertainty terms calculated inside PulseShapeFunctor are used for Method 2 only
-  psfPtr_.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,false,
-						   1,0,2.5,0,0.00065,1,10));
-  pfunctor_ = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(psfPtr_.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
+  auto & psf = psfCache_[&ps];
+  if (!psf) {
+    psf = std::make_unique<FitterFuncs::PulseShapeFunctor>(ps,false,false,false,false,
+							     1,0,2.5,0,0.00065,1,10);
+  }
+  psfPtr_ = psf.get();
 
 }
 
@@ -79,7 +79,7 @@ namespace FitterFuncs{
     if( edm::isNotFinite(offset_start) ){ //Check for nan
       ++ cntNANinfit;
     }else{
-      if( offset_start == 1.0 ){ offset_start = 0.; i_start-=1; } //Deal with boundary
+      if( offset_start == 1.0 && i_start > 0 ){ offset_start = 0.; i_start-=1; } //Deal with boundary
 
       const int bin_start        = (int) offset_start; //bin off to integer
       const int bin_0_start      = ( offset_start < bin_start + 0.5 ? bin_start -1 : bin_start ); //Round it
@@ -106,6 +106,54 @@ namespace FitterFuncs{
     return;
   }
 
+  void PulseShapeFunctor::fillPulseShapeTables() {
+    constexpr int ns_per_bx = HcalConst::nsPerBX;
+    constexpr int num_ns = HcalConst::nsPerBX*HcalConst::maxSamples;
+    constexpr int num_bx = num_ns/ns_per_bx;
+    shapeBase_.assign(2*num_ns, std::array<float,HcalConst::maxSamples>());
+    shapeSlope_.assign(2*num_ns, std::array<float,HcalConst::maxSamples>());
+    for(int i_start=0; i_start<num_ns; ++i_start){
+      const int iTS_start        = i_start/ns_per_bx;
+      const int distTo25ns_start = HcalConst::nsPerBX - 1 - i_start%ns_per_bx;
+      for(int bin_0_start=-1; bin_0_start<1; ++bin_0_start){
+	auto & base  = shapeBase_ [2*i_start+bin_0_start+1];
+	auto & slope = shapeSlope_[2*i_start+bin_0_start+1];
+	base.fill(0.f);
+	slope.fill(0.f);
+	base [iTS_start] = (bin_0_start == -1 ? accVarLenIdxMinusOneVec  [distTo25ns_start] : accVarLenIdxZEROVec  [distTo25ns_start]);
+	slope[iTS_start] = (bin_0_start == -1 ? diffVarItvlIdxMinusOneVec[distTo25ns_start] : diffVarItvlIdxZEROVec[distTo25ns_start]);
+	for(int iTS = iTS_start+1; iTS < num_bx; ++iTS){
+	  int bin_idx = distTo25ns_start + 1 + (iTS-iTS_start-1)*ns_per_bx + bin_0_start;
+	  base [iTS] = acc25nsVec[bin_idx];
+	  slope[iTS] = diff25nsItvlVec[bin_idx];
+	}
+      }
+    }
+  }
+
+  void PulseShapeFunctor::getPulseShape(double pulseTime, std::array<double,HcalConst::maxSamples>& fillPulseShape) {
+    constexpr int num_ns = HcalConst::nsPerBX*HcalConst::maxSamples;
+    if( shapeBase_.empty() ) fillPulseShapeTables();
+
+    // same start time and offset as funcShape with no slew
+    int i_start         = ( -HcalConst::iniTimeShift - pulseTime >0 ? 0 : (int)std::abs(-HcalConst::iniTimeShift-pulseTime) + 1);
+    double offset_start = i_start - HcalConst::iniTimeShift - pulseTime;
+    if( offset_start == 1.0 && i_start > 0 ){ offset_start = 0.; i_start-=1; }
+
+    // pulses starting before the first bin or after the last one, and nan
+    if( !(offset_start >= 0. && offset_start < 1.) || i_start >= num_ns ){
+      funcShape(fillPulseShape, pulseTime, 1.0, 0.0);
+      return;
+    }
+
+    const int bin_0_start = ( offset_start < 0.5 ? -1 : 0 );
+    const double factor = offset_start - bin_0_start - 0.5;
+    const auto & base  = shapeBase_ [2*i_start+bin_0_start+1];
+    const auto & slope = shapeSlope_[2*i_start+bin_0_start+1];
+    for(int i=0; i<HcalConst::maxSamples; ++i)
+      fillPulseShape[i] = base[i] + factor * slope[i];
+  }
+
   PulseShapeFunctor::~PulseShapeFunctor() {
   }
 
@@ -0,0 +1,114 @@
+// -*- C++ -*-
+//
+// Package:    RecoLocalCalo/HcalRecAlgos
+// Class:      MahiFitBenchmark
+//
+/**\class MahiFitBenchmark MahiFitBenchmark.cc
+
+ Description: times MahiFit on recorded HBHEChannelInfo objects
+
+ Implementation:
+     The channel infos are saved by HBHEPhase1Reconstructor with
+     saveInfos = True. Each channel is fitted with the Mahi parameters
+     of the "algorithm" PSet, and the time per fitted channel and the
+     total energy are printed at the end of the job, so that changes of
+     MahiFit can be timed and checked on the same digis.
+*/
+
+#include <memory>
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/HRRealTime.h"
+
+#include "DataFormats/HcalRecHit/interface/HcalRecHitCollections.h"
+#include "CondFormats/DataRecord/interface/HcalTimeSlewRecord.h"
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
+
+class MahiFitBenchmark : public edm::one::EDAnalyzer<edm::one::WatchRuns> {
+public:
+  explicit MahiFitBenchmark(const edm::ParameterSet&);
+
+private:
+  void beginRun(const edm::Run&, const edm::EventSetup&) override;
+  void endRun(const edm::Run&, const edm::EventSetup&) override {}
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob() override;
+
+  edm::EDGetTokenT<HBHEChannelInfoCollection> tok_;
+  HcalPulseShapes pulseShapes_;
+  const HcalTimeSlew* timeSlew_;
+  MahiFit mahi_;
+
+  unsigned long long nChannels_;
+  unsigned long long nFitted_;
+  edm::HRTimeType time_;
+  double energy_;
+};
+
+MahiFitBenchmark::MahiFitBenchmark(const edm::ParameterSet& iConfig) :
+  tok_(consumes<HBHEChannelInfoCollection>(iConfig.getParameter<edm::InputTag>("src"))),
+  timeSlew_(nullptr),
+  nChannels_(0),
+  nFitted_(0),
+  time_(0),
+  energy_(0)
+{
+  const edm::ParameterSet& conf = iConfig.getParameter<edm::ParameterSet>("algorithm");
+  mahi_.setParameters(conf.getParameter<bool>("dynamicPed"),
+		      conf.getParameter<double>("ts4Thresh"),
+		      conf.getParameter<double>("chiSqSwitch"),
+		      conf.getParameter<bool>("applyTimeSlew"), HcalTimeSlew::Medium,
+		      conf.getParameter<double>("meanTime"),
+		      conf.getParameter<double>("timeSigmaHPD"),
+		      conf.getParameter<double>("timeSigmaSiPM"),
+		      conf.getParameter<std::vector<int>>("activeBXs"),
+		      conf.getParameter<int>("nMaxItersMin"),
+		      conf.getParameter<int>("nMaxItersNNLS"),
+		      conf.getParameter<double>("deltaChiSqThresh"),
+		      conf.getParameter<double>("nnlsThresh"));
+}
+
+void MahiFitBenchmark::beginRun(const edm::Run&, const edm::EventSetup& iSetup)
+{
+  edm::ESHandle<HcalTimeSlew> delay;
+  iSetup.get<HcalTimeSlewRecord>().get("HBHE", delay);
+  timeSlew_ = &*delay;
+}
+
+void MahiFitBenchmark::analyze(const edm::Event& iEvent, const edm::EventSetup&)
+{
+  edm::Handle<HBHEChannelInfoCollection> infos;
+  iEvent.getByToken(tok_, infos);
+
+  float energy, time, chi2;
+  bool useTriple;
+  for (auto const& info : *infos) {
+    ++nChannels_;
+    if (info.isDropped()) continue;
+    edm::HRTimeType start = edm::hrRealTime();
+    mahi_.setPulseShapeTemplate(pulseShapes_.getShape(info.recoShape()));
+    mahi_.phase1Apply(info, energy, time, useTriple, chi2, timeSlew_);
+    time_ += edm::hrRealTime() - start;
+    ++nFitted_;
+    energy_ += energy;
+  }
+}
+
+void MahiFitBenchmark::endJob()
+{
+  edm::LogPrint("MahiFitBenchmark") << "fitted " << nFitted_ << " of " << nChannels_ << " channels, "
+				    << (nFitted_ ? double(time_)/nFitted_ : 0.) << " clock per channel, "
+				    << "total energy " << energy_;
+}
+
+DEFINE_FWK_MODULE(MahiFitBenchmark);
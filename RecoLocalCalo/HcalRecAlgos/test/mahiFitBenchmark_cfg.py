@@ -0,0 +1,34 @@
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+from Configuration.AlCa.GlobalTag import GlobalTag
+
+# Times MahiFit on the HBHEChannelInfo objects saved by hbheprereco
+# with saveInfos = True, e.g.
+#   cmsRun mahiFitBenchmark_cfg.py inputFiles=file:infos.root globalTag=auto:run2_data
+
+options = VarParsing('analysis')
+options.register('globalTag', 'auto:run2_data', VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string, "global tag of the recorded data")
+options.parseArguments()
+
+process = cms.Process("MahiBenchmark")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.GlobalTag = GlobalTag(process.GlobalTag, options.globalTag, '')
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(options.maxEvents) )
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+from RecoLocalCalo.HcalRecProducers.HBHEPhase1Reconstructor_cfi import hbheprereco
+
+process.benchmark = cms.EDAnalyzer("MahiFitBenchmark",
+    src = cms.InputTag("hbheprereco"),
+    algorithm = hbheprereco.algorithm.clone()
+)
+
+process.p = cms.Path(process.benchmark)
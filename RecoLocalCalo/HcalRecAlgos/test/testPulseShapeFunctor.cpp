@@ -0,0 +1,54 @@
+// Checks that PulseShapeFunctor::getPulseShape(pulseTime, shape), which reads
+// the precomputed tables, gives the same pulse as funcShape, as left by
+// singlePulseShapeFunc with unit height, for the HPD, SiPM and HF templates:
+// at random times and on the ns and half ns boundaries of the tables.
+// singlePulseShapeFunc reads the time slew of the 25 ns slice of the time,
+// which only exists from -100 to 150 ns.
+
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFunctor.h"
+
+#include <array>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+  HcalPulseShapes shapes;
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<double> flat(-100., 150.);
+
+  std::vector<double> times(100000);
+  for(auto & t : times) t = flat(rng);
+  // including -93.5 ns, where the pulse starts exactly one ns before the first bin
+  for(int k = -15; k < 485; ++k) times.push_back(-HcalConst::iniTimeShift + 0.5*k);
+
+  unsigned int failures = 0;
+  for(int shapeType : {105, 125, 203, 207, 301}) {
+    // as in MahiFit
+    FitterFuncs::PulseShapeFunctor functor(shapes.getShape(shapeType), false, false, false, false,
+                                           1, 0, 2.5, 0, 0.00065, 1, 10);
+    std::array<double,HcalConst::maxSamples> expected, actual;
+    for(double t : times) {
+      double x[3] = {t, 1.0, 0.0};
+      functor.singlePulseShapeFunc(x);
+      functor.getPulseShape(expected);
+      functor.getPulseShape(t, actual);
+      if(actual != expected) {
+        if(failures < 10) {
+          std::cout << "shape " << shapeType << ", time " << t << ":";
+          for(int i = 0; i < HcalConst::maxSamples; ++i) std::cout << " " << expected[i] << "/" << actual[i];
+          std::cout << "\n";
+        }
+        ++failures;
+      }
+    }
+  }
+
+  if(failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  std::cout << "getPulseShape and funcShape agree on " << times.size() << " times" << std::endl;
+  return 0;
+}
@@ -0,0 +1,286 @@
+//----------------------------------------------------------------------------
+//! \class PixelUnionFindClusterizer
+//! \brief Threshold-based clustering on sorted pixels, see the header.
+//!
+//! The electrons are computed exactly as in
+//! PixelThresholdClusterizer::copy_to_buffer, and the seeds and the pixels
+//! are visited in the same order as in PixelThresholdClusterizer::make_cluster,
+//! which is what makes the output identical.
+//----------------------------------------------------------------------------
+
+#include "PixelUnionFindClusterizer.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <numeric>
+
+namespace {
+
+  // per thread work space, kept from one module to the next
+  struct Scratch {
+    std::vector<uint32_t> key;
+    std::vector<unsigned int> order;
+    std::vector<unsigned int> unique;      // input pixel -> sorted pixel
+    std::vector<uint16_t> row, col;        // sorted pixels
+    std::vector<int> adc;
+    std::vector<std::array<int,8>> neighbours;
+    std::vector<unsigned int> parent, size;
+    std::vector<int> charge;
+    std::vector<char> consumed, done;
+  };
+
+  thread_local Scratch scratch_;
+
+  unsigned int find(std::vector<unsigned int>& parent, unsigned int i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  }
+
+}
+
+//----------------------------------------------------------------------------
+//! Constructor: same parameters as PixelThresholdClusterizer.
+//----------------------------------------------------------------------------
+PixelUnionFindClusterizer::PixelUnionFindClusterizer
+  (edm::ParameterSet const& conf) :
+    theBatchSize(0),
+    thePixelThreshold( conf.getParameter<int>("ChannelThreshold") ),
+    theSeedThreshold( conf.getParameter<int>("SeedThreshold") ),
+    theClusterThreshold( conf.getParameter<int>("ClusterThreshold") ),
+    theClusterThreshold_L1( conf.getParameter<int>("ClusterThreshold_L1") ),
+    theConversionFactor( conf.getParameter<int>("VCaltoElectronGain") ),
+    theConversionFactor_L1( conf.getParameter<int>("VCaltoElectronGain_L1") ),
+    theOffset( conf.getParameter<int>("VCaltoElectronOffset") ),
+    theOffset_L1( conf.getParameter<int>("VCaltoElectronOffset_L1") ),
+    theStackADC_( conf.exists("AdcFullScaleStack") ? conf.getParameter<int>("AdcFullScaleStack") : 255 ),
+    theFirstStack_( conf.exists("FirstStackLayer") ? conf.getParameter<int>("FirstStackLayer") : 5 ),
+    theElectronPerADCGain_( conf.exists("ElectronPerADCGain") ? conf.getParameter<double>("ElectronPerADCGain") : 135. ),
+    doMissCalibrate( conf.getUntrackedParameter<bool>("MissCalibrate",true) )
+{
+}
+
+PixelUnionFindClusterizer::~PixelUnionFindClusterizer() {}
+
+void PixelUnionFindClusterizer::clusterizeDetUnit( const edm::DetSet<PixelDigi> & input,
+						   const PixelGeomDetUnit * pixDet,
+						   const TrackerTopology* tTopo,
+						   const std::vector<short>& badChannels,
+						   edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) {
+  fill(input, tTopo, theModule);
+  clusterize(theModule);
+  moveTo(theModule, output);
+}
+
+void PixelUnionFindClusterizer::clusterizeDetUnit( const edmNew::DetSet<SiPixelCluster> & input,
+						   const PixelGeomDetUnit * pixDet,
+						   const TrackerTopology* tTopo,
+						   const std::vector<short>& badChannels,
+						   edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) {
+  fill(input, tTopo, theModule);
+  clusterize(theModule);
+  moveTo(theModule, output);
+}
+
+void PixelUnionFindClusterizer::addToBatch( const edm::DetSet<PixelDigi> & input, const TrackerTopology* tTopo) {
+  if (theBatchSize == theBatch.size()) theBatch.emplace_back();
+  fill(input, tTopo, theBatch[theBatchSize++]);
+}
+
+void PixelUnionFindClusterizer::clusterizeBatch() {
+  tbb::parallel_for(0U, theBatchSize, [this](unsigned int i) { clusterize(theBatch[i]); });
+}
+
+void PixelUnionFindClusterizer::fillFromBatch( unsigned int i, edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) {
+  assert(i < theBatchSize);
+  moveTo(theBatch[i], output);
+}
+
+//----------------------------------------------------------------------------
+//! Convert the digis to electrons and keep the pixels above threshold.
+//----------------------------------------------------------------------------
+void PixelUnionFindClusterizer::fill( const edm::DetSet<PixelDigi> & input, const TrackerTopology* tTopo, Module& module) {
+  module.clear();
+  module.sumDuplicates = false;
+
+  uint32_t detid = input.detId();
+  int layer = (DetId(detid).subdetId()==1) ? tTopo->pxbLayer(detid) : 0;
+  module.clusterThreshold = (layer==1) ? theClusterThreshold_L1 : theClusterThreshold;
+
+  DigiIterator begin = input.begin();
+  DigiIterator end   = input.end();
+  theElectrons.assign(end-begin, 0);
+  int * electron = theElectrons.data();
+  if ( doMissCalibrate ) {
+    if (layer==1) {
+      (*theSiPixelGainCalibrationService_).calibrate(detid,begin,end,theConversionFactor_L1, theOffset_L1,electron);
+    } else {
+      (*theSiPixelGainCalibrationService_).calibrate(detid,begin,end,theConversionFactor,    theOffset,  electron);
+    }
+  } else {
+    int i=0;
+    for(DigiIterator di = begin; di != end; ++di) {
+      auto adc = di->adc();
+      const float gain = theElectronPerADCGain_; // default: 1 ADC = 135 electrons
+      const float pedestal = 0.; //
+      electron[i] = int(adc * gain + pedestal);
+      if (layer>=theFirstStack_) {
+	if (theStackADC_==1&&adc==1) {
+	  electron[i] = int(255*135); // Arbitrarily use overflow value.
+	}
+	if (theStackADC_>1&&theStackADC_!=255&&adc>=1){
+	  const float gain = theElectronPerADCGain_; // default: 1 ADC = 135 electrons
+	  electron[i] = int((adc-1) * gain * 255/float(theStackADC_-1));
+	}
+      }
+      ++i;
+    }
+  }
+
+  int i=0;
+  for(DigiIterator di = begin; di != end; ++di) {
+    int adc = electron[i++];
+    if(adc<100) adc=100; // put all negative pixel charges into the 100 elec bin
+    if ( adc >= thePixelThreshold) {
+      module.row.push_back(di->row());
+      module.col.push_back(di->column());
+      module.adc.push_back(adc);
+    }
+  }
+}
+
+void PixelUnionFindClusterizer::fill( const edmNew::DetSet<SiPixelCluster> & input, const TrackerTopology* tTopo, Module& module) {
+  module.clear();
+  module.sumDuplicates = true;
+
+  uint32_t detid = input.detId();
+  int layer = (DetId(detid).subdetId()==1) ? tTopo->pxbLayer(detid) : 0;
+  module.clusterThreshold = (layer==1) ? theClusterThreshold_L1 : theClusterThreshold;
+
+  for(ClusterIterator ci = input.begin(); ci != input.end(); ++ci) {
+    for(int i = 0; i < ci->size(); ++i) {
+      const SiPixelCluster::Pixel pixel = ci->pixel(i);
+      if ( pixel.adc >= thePixelThreshold) {
+	module.row.push_back(pixel.x);
+	module.col.push_back(pixel.y);
+	module.adc.push_back(pixel.adc);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+//!  \brief Label the connected pixels and build the clusters.
+//!  Only uses the per thread scratch space and the module itself.
+//----------------------------------------------------------------------------
+void PixelUnionFindClusterizer::clusterize( Module& module) const {
+  auto & s = scratch_;
+  const unsigned int n = module.adc.size();
+  if (n == 0) return;
+
+  // sort by (column, row), keeping the input order of duplicated pixels
+  s.key.resize(n);
+  for (unsigned int k = 0; k < n; ++k) s.key[k] = (uint32_t(module.col[k]) << 16) | module.row[k];
+  s.order.resize(n);
+  std::iota(s.order.begin(), s.order.end(), 0U);
+  std::stable_sort(s.order.begin(), s.order.end(), [&](unsigned int a, unsigned int b) { return s.key[a] < s.key[b]; });
+
+  s.unique.resize(n);
+  s.row.clear(); s.col.clear(); s.adc.clear();
+  for (unsigned int j = 0; j < n; ++j) {
+    unsigned int k = s.order[j];
+    if (j == 0 || s.key[k] != s.key[s.order[j-1]]) {
+      s.row.push_back(module.row[k]);
+      s.col.push_back(module.col[k]);
+      s.adc.push_back(module.adc[k]);
+    } else if (module.sumDuplicates) {
+      s.adc.back() += module.adc[k];
+    } else {
+      s.adc.back() = module.adc[k];
+    }
+    s.unique[k] = s.row.size()-1;
+  }
+  const unsigned int nu = s.row.size();
+
+  // neighbours, in the order PixelThresholdClusterizer scans them:
+  // (c-1,r-1) (c-1,r) (c-1,r+1) (c,r-1) (c,r+1) (c+1,r-1) (c+1,r) (c+1,r+1)
+  s.neighbours.assign(nu, std::array<int,8>{{-1,-1,-1,-1,-1,-1,-1,-1}});
+  s.parent.resize(nu);
+  std::iota(s.parent.begin(), s.parent.end(), 0U);
+  auto link = [&](unsigned int i, unsigned int q, unsigned int slot) {
+    s.neighbours[i][slot] = q;
+    s.neighbours[q][7-slot] = i;
+    unsigned int a = find(s.parent, i), b = find(s.parent, q);
+    if (a < b) s.parent[b] = a; else if (b < a) s.parent[a] = b;
+  };
+  unsigned int p = 0;  // first pixel of the previous column that can touch pixel i
+  for (unsigned int i = 0; i < nu; ++i) {
+    int r = s.row[i], c = s.col[i];
+    if (i > 0 && s.col[i-1] == c && s.row[i-1]+1 == r) link(i, i-1, 3);
+    while (p < i && (s.col[p] < c-1 || (s.col[p] == c-1 && s.row[p]+1 < r))) ++p;
+    for (unsigned int q = p; q < i && s.col[q] == c-1 && s.row[q] <= r+1; ++q)
+      link(i, q, s.row[q]+1-r);
+  }
+
+  // size and charge of the components, as SiPixelCluster would count it
+  s.size.assign(nu, 0);
+  s.charge.assign(nu, 0);
+  for (unsigned int i = 0; i < nu; ++i) {
+    unsigned int root = find(s.parent, i);
+    ++s.size[root];
+    s.charge[root] += uint16_t(s.adc[i]);
+  }
+
+  s.consumed.assign(nu, 0);
+  s.done.assign(nu, 0);
+  auto & output = module.clusters;
+  auto rowLess = [](SiPixelCluster const & cl1,SiPixelCluster const & cl2) { return cl1.minPixelRow() < cl2.minPixelRow();};
+  for (unsigned int k = 0; k < n; ++k) {
+    if (module.adc[k] < theSeedThreshold) continue;
+    unsigned int seed = s.unique[k];
+    // already used in a cluster, or the merged charge is below the seed threshold
+    if (s.consumed[seed] || s.adc[seed] < theSeedThreshold) continue;
+    unsigned int root = find(s.parent, seed);
+    if (s.done[root]) continue;
+    if (s.size[root] <= AccretionCluster::MAXSIZE) {
+      // the whole component makes one cluster
+      s.done[root] = 1;
+      if (s.charge[root] < module.clusterThreshold) continue;
+    }
+
+    AccretionCluster acluster;
+    unsigned int members[AccretionCluster::MAXSIZE];
+    acluster.add(SiPixelCluster::PixelPos(s.row[seed], s.col[seed]), s.adc[seed]);
+    members[0] = seed;
+    s.consumed[seed] = 1;
+    while ( ! acluster.empty()) {
+      auto cur = members[acluster.top()]; acluster.pop();
+      for (auto q : s.neighbours[cur]) {
+	if (q < 0 || s.consumed[q]) continue;
+	if (!acluster.add(SiPixelCluster::PixelPos(s.row[q], s.col[q]), s.adc[q])) goto endClus;
+	members[acluster.isize-1] = q;
+	s.consumed[q] = 1;
+      }
+    }
+  endClus:
+    SiPixelCluster cluster(acluster.isize,acluster.adc, acluster.x,acluster.y, acluster.xmin,acluster.ymin);
+    if ( cluster.charge() >= module.clusterThreshold) {
+      output.push_back( std::move(cluster) );
+      std::push_heap(output.begin(),output.end(),rowLess);
+    }
+  }
+  // sort by row (x)
+  std::sort_heap(output.begin(),output.end(),rowLess);
+}
+
+void PixelUnionFindClusterizer::moveTo( Module& module, edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) const {
+  assert(output.empty());
+  for (auto & cluster : module.clusters) output.push_back( std::move(cluster) );
+  module.clusters.clear();
+}
@@ -0,0 +1,107 @@
+#ifndef RecoLocalTracker_SiPixelClusterizer_PixelUnionFindClusterizer_H
+#define RecoLocalTracker_SiPixelClusterizer_PixelUnionFindClusterizer_H
+
+//-----------------------------------------------------------------------
+//! \class PixelUnionFindClusterizer
+//! \brief Threshold-based clustering on sorted pixels, modules in parallel.
+//!
+//! Produces exactly the same SiPixelClusters as PixelThresholdClusterizer,
+//! with the same pixel order and the same order of the clusters, without
+//! the nrow * ncol SiPixelArrayBuffer.
+//!
+//! The pixels above the channel threshold are sorted by (column, row).
+//! A single pass over the sorted pixels finds the 8 neighbours of each
+//! pixel and labels the connected components with a union-find, which
+//! also gives the number of pixels and the charge of each component.
+//! The seeds are then considered in the order of the digis, as in
+//! PixelThresholdClusterizer: a component that fits in one cluster is
+//! dropped at once if it is below the cluster threshold, otherwise the
+//! pixels are visited breadth-first from the seed through the neighbour
+//! lists, in the order in which PixelThresholdClusterizer visits the
+//! buffer, so that the pixels of the clusters come out in the same order.
+//!
+//! The producer fills a batch of modules with addToBatch(), which
+//! converts the digis to electrons (the gain calibration service is not
+//! thread safe), then clusterizeBatch() clusterizes the modules of the
+//! batch in parallel with TBB, and fillFromBatch() moves the clusters of
+//! each module to the output, in the order the modules were added.
+//!
+//! Assumes, as PixelThresholdClusterizer does, that the channel and seed
+//! thresholds are above 1 electron.  Cluster splitting is not supported,
+//! as it is not in PixelThresholdClusterizer.
+//-----------------------------------------------------------------------
+
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "PixelClusterizerBase.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <cstdint>
+#include <vector>
+
+
+class dso_hidden PixelUnionFindClusterizer final : public PixelClusterizerBase {
+ public:
+
+  PixelUnionFindClusterizer(edm::ParameterSet const& conf);
+  ~PixelUnionFindClusterizer() override;
+
+  // Full I/O in DetSet, one module at a time
+  void clusterizeDetUnit( const edm::DetSet<PixelDigi> & input,
+			  const PixelGeomDetUnit * pixDet,
+			  const TrackerTopology* tTopo,
+			  const std::vector<short>& badChannels,
+			  edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) override;
+  void clusterizeDetUnit( const edmNew::DetSet<SiPixelCluster> & input,
+                          const PixelGeomDetUnit * pixDet,
+                          const TrackerTopology* tTopo,
+                          const std::vector<short>& badChannels,
+                          edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) override;
+
+  //! Batched interface
+  void clearBatch() { theBatchSize = 0; }
+  unsigned int batchSize() const { return theBatchSize; }
+  void addToBatch( const edm::DetSet<PixelDigi> & input, const TrackerTopology* tTopo);
+  void clusterizeBatch();
+  void fillFromBatch( unsigned int i, edmNew::DetSetVector<SiPixelCluster>::FastFiller& output);
+
+ private:
+
+  //! The pixels of a module, in input order, and its clusters
+  struct Module {
+    int clusterThreshold;
+    bool sumDuplicates;   // pixels of overlapping clusters add up, duplicate digis replace each other
+    std::vector<uint16_t> row, col;
+    std::vector<int> adc;
+    std::vector<SiPixelCluster> clusters;
+
+    void clear() { row.clear(); col.clear(); adc.clear(); clusters.clear(); }
+  };
+
+  void fill( const edm::DetSet<PixelDigi> & input, const TrackerTopology* tTopo, Module& module);
+  void fill( const edmNew::DetSet<SiPixelCluster> & input, const TrackerTopology* tTopo, Module& module);
+  void clusterize( Module& module) const;
+  void moveTo( Module& module, edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) const;
+
+  Module theModule;                 // used by clusterizeDetUnit
+  std::vector<Module> theBatch;     // reused from one batch to the next
+  unsigned int theBatchSize;
+  std::vector<int> theElectrons;
+
+  const int thePixelThreshold;  // Pixel threshold in electrons
+  const int theSeedThreshold;   // Seed threshold in electrons
+  const int theClusterThreshold;    // Cluster threshold in electrons
+  const int theClusterThreshold_L1; // Cluster threshold in electrons for Layer 1
+  const int theConversionFactor;    // adc to electron conversion factor
+  const int theConversionFactor_L1; // adc to electron conversion factor for Layer 1
+  const int theOffset;              // adc to electron conversion offset
+  const int theOffset_L1;           // adc to electron conversion offset for Layer 1
+
+  const int   theStackADC_;          // The maximum ADC count for the stack layers
+  const int   theFirstStack_;        // The index of the first stack layer
+  const double theElectronPerADCGain_;  //  ADC to electrons conversion
+
+  const bool doMissCalibrate; // Use calibration or not
+};
+
+#endif
@@ -14,6 +14,7 @@
 // Our own stuff
 #include "SiPixelClusterProducer.h"
 #include "PixelThresholdClusterizer.h"
+#include "PixelUnionFindClusterizer.h"
 
 // Geometry
 #include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
@@ -51,9 +52,11 @@
     theSiPixelGainCalibration_(nullptr), 
     clusterMode_( conf.getUntrackedParameter<std::string>("ClusterMode","PixelThresholdClusterizer") ),
     clusterizer_(nullptr),          // the default, in case we fail to make one
+    unionFindClusterizer_(nullptr),
     readyToCluster_(false),   // since we obviously aren't
     maxTotalClusters_( conf.getParameter<int32_t>( "maxNumberOfClusters" ) ),
-    payloadType_( conf.getParameter<std::string>( "payloadType" ) )
+    payloadType_( conf.getParameter<std::string>( "payloadType" ) ),
+    modulesPerBatch_( conf.getUntrackedParameter<unsigned int>("ModulesPerBatch", 64) )
   {
     if ( clusterMode_ == "PixelThresholdReclusterizer" )
       tPixelClusters = consumes<SiPixelClusterCollectionNew>( conf.getParameter<edm::InputTag>("src") );
@@ -115,6 +118,8 @@
     // on each DetUnit
     if ( clusterMode_ == "PixelThresholdReclusterizer" )
       run(*inputClusters, geom, *output );
+    else if ( unionFindClusterizer_ )
+      runBatched(*inputDigi, *output );
     else
       run(*inputDigi, geom, *output );
 
@@ -136,11 +141,18 @@
       clusterizer_->setSiPixelGainCalibrationService(theSiPixelGainCalibration_);
       readyToCluster_ = true;
     } 
+    else if ( clusterMode_ == "PixelUnionFindClusterizer" ) {
+      unionFindClusterizer_ = new PixelUnionFindClusterizer(conf);
+      clusterizer_ = unionFindClusterizer_;
+      clusterizer_->setSiPixelGainCalibrationService(theSiPixelGainCalibration_);
+      readyToCluster_ = true;
+    }
     else {
       edm::LogError("SiPixelClusterProducer") << "[SiPixelClusterProducer]:"
 		<<" choice " << clusterMode_ << " is invalid.\n"
 		<< "Possible choices:\n" 
-		<< "    PixelThresholdClusterizer";
+		<< "    PixelThresholdClusterizer\n"
+		<< "    PixelUnionFindClusterizer";
       readyToCluster_ = false;
     }
   }
@@ -210,6 +222,44 @@
   }
 
 
+  //---------------------------------------------------------------------------
+  //!  Same as run(), with the modules clusterized in parallel by batches of
+  //!  modulesPerBatch_; the output is filled in the order of the input.
+  //---------------------------------------------------------------------------
+  void SiPixelClusterProducer::runBatched(const edm::DetSetVector<PixelDigi> & input,
+                                          edmNew::DetSetVector<SiPixelCluster> & output) {
+    int numberOfClusters = 0;
+
+    auto DSViter = input.begin();
+    while ( DSViter != input.end() ) {
+      auto first = DSViter;
+      unionFindClusterizer_->clearBatch();
+      for( ; DSViter != input.end() && unionFindClusterizer_->batchSize() < modulesPerBatch_; DSViter++) {
+        unionFindClusterizer_->addToBatch(*DSViter, tTopo_);
+      }
+
+      unionFindClusterizer_->clusterizeBatch();
+
+      unsigned int i = 0;
+      for( auto iter = first; iter != DSViter; ++iter, ++i) {
+        {
+        edmNew::DetSetVector<SiPixelCluster>::FastFiller spc(output, iter->detId());
+        unionFindClusterizer_->fillFromBatch(i, spc);
+        if ( spc.empty() ) {
+          spc.abort();
+        } else {
+          numberOfClusters += spc.size();
+        }
+        } // spc is not deleted and detsetvector updated
+        if ((maxTotalClusters_ >= 0) && (numberOfClusters > maxTotalClusters_)) {
+          edm::LogError("TooManyClusters") <<  "Limit on the number of clusters exceeded. An empty cluster collection will be produced instead.\n";
+          edmNew::DetSetVector<SiPixelCluster> empty;
+          empty.swap(output);
+          return;
+        }
+      }
+    }
+  }
 
 
 #include "FWCore/PluginManager/interface/ModuleDef.h"
@@ -12,8 +12,10 @@
 //! edm::DetSetVector<SiPixelCluster>.
 //!
 //! SiPixelClusterProducer invokes one of descendents from PixelClusterizerBase,
-//! e.g. PixelThresholdClusterizer (which is the only available option 
-//! right now).  SiPixelClusterProducer loads the PixelDigis,
+//! e.g. PixelThresholdClusterizer (the default) or PixelUnionFindClusterizer,
+//! chosen with the untracked ClusterMode parameter; the latter clusterizes
+//! ModulesPerBatch modules at a time in parallel, with the same output.
+//! SiPixelClusterProducer loads the PixelDigis,
 //! and then iterates over DetIds, invoking PixelClusterizer's clusterizeDetUnit
 //! to perform the clustering.  clusterizeDetUnit() returns a DetSetVector of
 //! SiPixelClusters, which are then recorded in the event.
@@ -30,6 +32,8 @@
 
 #include "PixelClusterizerBase.h"
 
+class PixelUnionFindClusterizer;
+
 //#include "Geometry/CommonDetUnit/interface/TrackingGeometry.h"
 
 #include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
@@ -66,6 +70,10 @@
              const edm::ESHandle<TrackerGeometry> & geom,
              edmNew::DetSetVector<SiPixelCluster> & output);
 
+    //--- Execute PixelUnionFindClusterizer on batches of modules in parallel.
+    void runBatched(const edm::DetSetVector<PixelDigi> & input,
+                    edmNew::DetSetVector<SiPixelCluster> & output);
+
   private:
     edm::EDGetTokenT<SiPixelClusterCollectionNew>  tPixelClusters;
     edm::EDGetTokenT<edm::DetSetVector<PixelDigi>> tPixelDigi;
@@ -73,6 +81,7 @@
     SiPixelGainCalibrationServiceBase * theSiPixelGainCalibration_;
     const std::string clusterMode_;         // user's choice of the clusterizer
     PixelClusterizerBase * clusterizer_;    // what we got (for now, one ptr to base class)
+    PixelUnionFindClusterizer * unionFindClusterizer_; // same as clusterizer_, if it supports batches
     bool readyToCluster_;                   // needed clusterizers valid => good to go!
     const TrackerTopology* tTopo_;          // needed to get correct layer number
 
@@ -80,6 +89,9 @@
     const int32_t maxTotalClusters_;
 
     const std::string payloadType_;
+
+    //! Number of modules clusterized in parallel by PixelUnionFindClusterizer
+    const unsigned int modulesPerBatch_;
   };
 
 
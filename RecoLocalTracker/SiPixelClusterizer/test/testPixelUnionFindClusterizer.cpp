@@ -0,0 +1,188 @@
+// Checks that PixelUnionFindClusterizer produces the same clusters as
+// PixelThresholdClusterizer, pixel by pixel and in the same order, on
+// random modules: isolated pixels, clusters of all sizes, components
+// larger than the 256 pixel truncation, and duplicated digis.
+
+#include "RecoLocalTracker/SiPixelClusterizer/plugins/PixelThresholdClusterizer.h"
+#include "RecoLocalTracker/SiPixelClusterizer/plugins/PixelUnionFindClusterizer.h"
+
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/SiPixelDetId/interface/PixelSubdetector.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetType.h"
+#include "Geometry/TrackerGeometryBuilder/interface/RectangularPixelTopology.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  constexpr int nrows = 160;
+  constexpr int ncols = 416;
+
+  edm::ParameterSet configuration() {
+    edm::ParameterSet conf;
+    conf.addParameter<int>("ChannelThreshold", 1000);
+    conf.addParameter<int>("SeedThreshold", 1000);
+    conf.addParameter<int>("ClusterThreshold", 4000);
+    conf.addParameter<int>("ClusterThreshold_L1", 4000);
+    conf.addParameter<int>("VCaltoElectronGain", 65);
+    conf.addParameter<int>("VCaltoElectronGain_L1", 65);
+    conf.addParameter<int>("VCaltoElectronOffset", -414);
+    conf.addParameter<int>("VCaltoElectronOffset_L1", -414);
+    conf.addParameter<bool>("SplitClusters", false);
+    // no gain calibration service, 1 ADC = 135 electrons
+    conf.addUntrackedParameter<bool>("MissCalibrate", false);
+    return conf;
+  }
+
+  // a module with nblobs groups of pixels of random size and density,
+  // and some noise; the digis are sorted by channel, as in the raw data,
+  // and some of them are duplicated
+  edm::DetSet<PixelDigi> randomModule(std::mt19937& rng, uint32_t detId, int nblobs) {
+    std::uniform_int_distribution<int> row(0, nrows-1), col(0, ncols-1);
+    std::uniform_int_distribution<int> adc(1, 255), lowAdc(1, 12), size(0, 24);
+    std::uniform_real_distribution<float> flat(0.f, 1.f);
+
+    std::vector<PixelDigi> digis;
+    for(int b = 0; b < nblobs; ++b) {
+      int r0 = row(rng), c0 = col(rng);
+      int dr = size(rng), dc = size(rng);
+      float density = 0.2f + 0.8f * flat(rng);
+      for(int r = r0; r <= std::min(r0+dr, nrows-1); ++r)
+        for(int c = c0; c <= std::min(c0+dc, ncols-1); ++c)
+          if(flat(rng) < density)
+            digis.emplace_back(r, c, flat(rng) < 0.2f ? lowAdc(rng) : adc(rng));
+    }
+    for(int n = 0; n < 50; ++n)
+      digis.emplace_back(row(rng), col(rng), flat(rng) < 0.5f ? lowAdc(rng) : adc(rng));
+    for(int n = 0, size = digis.size(); size > 0 && n < 5; ++n)
+      digis.push_back(digis[std::uniform_int_distribution<int>(0, size-1)(rng)]);
+    std::stable_sort(digis.begin(), digis.end(),
+                     [](PixelDigi const& a, PixelDigi const& b) { return a.channel() < b.channel(); });
+
+    edm::DetSet<PixelDigi> module(detId);
+    module.data = std::move(digis);
+    return module;
+  }
+
+  bool identical(edmNew::DetSetVector<SiPixelCluster> const& expected,
+                 edmNew::DetSetVector<SiPixelCluster> const& actual) {
+    if(expected.size() != actual.size() || expected.dataSize() != actual.dataSize()) {
+      std::cout << "  " << expected.dataSize() << " clusters expected, " << actual.dataSize() << " found\n";
+      return false;
+    }
+    for(auto e = expected.begin(), a = actual.begin(); e != expected.end(); ++e, ++a) {
+      if(e->detId() != a->detId() || e->size() != a->size())
+        return false;
+      for(unsigned int i = 0; i < e->size(); ++i) {
+        auto const& ec = (*e)[i];
+        auto const& ac = (*a)[i];
+        if(ec.size() != ac.size()) {
+          std::cout << "  cluster " << i << ": " << ec.size() << " pixels expected, " << ac.size() << " found\n";
+          return false;
+        }
+        for(int p = 0; p < ec.size(); ++p) {
+          auto ep = ec.pixel(p);
+          auto ap = ac.pixel(p);
+          if(ep.x != ap.x || ep.y != ap.y || ep.adc != ap.adc) {
+            std::cout << "  cluster " << i << ", pixel " << p << ": (" << ep.x << ", " << ep.y << ", " << ep.adc
+                      << ") expected, (" << ap.x << ", " << ap.y << ", " << ap.adc << ") found\n";
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+}
+
+int main() {
+  auto conf = configuration();
+  PixelThresholdClusterizer threshold(conf);
+  PixelUnionFindClusterizer unionFind(conf);
+
+  GeomDetEnumerators::SubDetector subdet = GeomDetEnumerators::PixelEndcap;
+  PixelGeomDetType type(new RectangularPixelTopology(nrows, ncols, 0.01, 0.015, false, 80, 52, 2, 2, 2, 8),
+                        "test", subdet);
+  // endcap modules, which do not need a TrackerTopology to find their layer
+  uint32_t firstDetId = DetId(DetId::Tracker, PixelSubdetector::PixelEndcap).rawId();
+  PixelGeomDetUnit det(new Plane(Surface::PositionType(), Surface::RotationType()), &type, firstDetId);
+  std::vector<short> badChannels;
+
+  std::mt19937 rng(12345);
+  unsigned int failures = 0;
+  constexpr int nmodules = 500;
+  std::vector<edm::DetSet<PixelDigi>> modules;
+  for(int m = 0; m < nmodules; ++m)
+    modules.push_back(randomModule(rng, firstDetId + m, m % 100));
+
+  // one module at a time, from digis and then reclustering the clusters
+  for(int m = 0; m < nmodules; ++m) {
+    uint32_t detId = modules[m].detId();
+    edmNew::DetSetVector<SiPixelCluster> expected, actual;
+    {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller ff(expected, detId);
+      threshold.clusterizeDetUnit(modules[m], &det, nullptr, badChannels, ff);
+    }
+    {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller ff(actual, detId);
+      unionFind.clusterizeDetUnit(modules[m], &det, nullptr, badChannels, ff);
+    }
+    if(!identical(expected, actual)) {
+      std::cout << "module " << m << ": different clusters from digis\n";
+      ++failures;
+      continue;
+    }
+    if(expected.empty())
+      continue;
+
+    edmNew::DetSetVector<SiPixelCluster> reExpected, reActual;
+    {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller ff(reExpected, detId);
+      threshold.clusterizeDetUnit(*expected.begin(), &det, nullptr, badChannels, ff);
+    }
+    {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller ff(reActual, detId);
+      unionFind.clusterizeDetUnit(*expected.begin(), &det, nullptr, badChannels, ff);
+    }
+    if(!identical(reExpected, reActual)) {
+      std::cout << "module " << m << ": different clusters from clusters\n";
+      ++failures;
+    }
+  }
+
+  // the batched interface, in batches of 64 modules
+  for(int first = 0; first < nmodules; first += 64) {
+    int last = std::min(first + 64, nmodules);
+    edmNew::DetSetVector<SiPixelCluster> expected, actual;
+    for(int m = first; m < last; ++m) {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller ff(expected, modules[m].detId());
+      threshold.clusterizeDetUnit(modules[m], &det, nullptr, badChannels, ff);
+    }
+    unionFind.clearBatch();
+    for(int m = first; m < last; ++m)
+      unionFind.addToBatch(modules[m], nullptr);
+    unionFind.clusterizeBatch();
+    for(unsigned int i = 0; i < unionFind.batchSize(); ++i) {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller ff(actual, modules[first+i].detId());
+      unionFind.fillFromBatch(i, ff);
+    }
+    if(!identical(expected, actual)) {
+      std::cout << "batch of modules " << first << "-" << last-1 << ": different clusters\n";
+      ++failures;
+    }
+  }
+
+  if(failures) {
+    std::cout << failures << " failures" << std::endl;
+    return 1;
+  }
+  std::cout << "PixelUnionFindClusterizer and PixelThresholdClusterizer agree on " << nmodules << " modules" << std::endl;
+  return 0;
+}
@@ -47,8 +47,14 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
 
   template<class T> void clusterizeDetUnit_(const T&, output_t::TSFastFiller&) const;
 
+  // same result as the strip by strip loop of clusterizeDetUnit_: the noise and the
+  // bad strips of the whole module are gathered first, the thresholds are evaluated
+  // for all the digis in vectorizable loops, and the candidates are then built from
+  // the precomputed flags
+  template<class Iter> void clusterizeVectorized_(Det const&, Iter, Iter, output_t::TSFastFiller&) const;
+
   ThreeThresholdAlgorithm(float, float, float, unsigned, unsigned, unsigned, std::string qualityLabel,
-			  bool removeApvShots, float minGoodCharge);
+			  bool removeApvShots, float minGoodCharge, bool vectorized = false);
 
 
     //constant methods with state information
@@ -68,6 +74,7 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
   uint8_t MaxSequentialHoles, MaxSequentialBad, MaxAdjacentBad;
   bool RemoveApvShots;
   float minGoodCharge;
+  bool Vectorized;
 
 };
 
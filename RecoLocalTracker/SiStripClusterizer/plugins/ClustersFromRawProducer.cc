@@ -133,6 +133,9 @@ namespace {
     
     StripClusterizerAlgorithm & clusterizer;
     SiStripRawProcessingAlgorithms & rawAlgos;
+    // the raw processing algorithms keep per-module state (common modes, APV flags):
+    // modules filled on demand from different threads take turns
+    std::mutex rawAlgosMutex;
     
     
     // March 2012: add flag for disabling APVe check in configuration
@@ -417,7 +420,10 @@ try { // edmNew::CapacityExaustedException
 	//rawAlgos_->subtractorCMN->subtract( id, digis);
 	//rawAlgos_->suppressor->suppress( digis, zsdigis);
 	uint16_t firstAPV = ipair*2;
-	rawAlgos.SuppressVirginRawData(id, firstAPV,digis, zsdigis);
+	{
+	  std::lock_guard<std::mutex> guard(rawAlgosMutex);
+	  rawAlgos.SuppressVirginRawData(id, firstAPV,digis, zsdigis);
+	}
  	for( edm::DetSet<SiStripDigi>::const_iterator it = zsdigis.begin(); it!=zsdigis.end(); it++) {
 	  clusterizer.stripByStripAdd(state, it->strip(), it->adc(), record);
 	}
@@ -441,7 +447,10 @@ try { // edmNew::CapacityExaustedException
 	//rawAlgos_->subtractorCMN->subtract( id, digis);
 	//rawAlgos_->suppressor->suppress( digis, zsdigis);
 	uint16_t firstAPV = ipair*2;
-	rawAlgos.SuppressProcessedRawData(id, firstAPV,digis, zsdigis);
+	{
+	  std::lock_guard<std::mutex> guard(rawAlgosMutex);
+	  rawAlgos.SuppressProcessedRawData(id, firstAPV,digis, zsdigis);
+	}
 	for( edm::DetSet<SiStripDigi>::const_iterator it = zsdigis.begin(); it!=zsdigis.end(); it++) {
 	  clusterizer.stripByStripAdd(state, it->strip(), it->adc(), record);
 	}
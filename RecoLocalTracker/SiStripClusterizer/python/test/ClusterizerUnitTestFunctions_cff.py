@@ -1,4 +1,5 @@
 import FWCore.ParameterSet.Config as cms    
+import random
 
 def ClusterizerTest(label, params, detunitlist) :
     return  cms.PSet(
@@ -7,6 +8,32 @@ def ClusterizerTest(label, params, detunitlist) :
         Tests = cms.VPSet() + detunitlist
         )
 
+def ComparisonTest(label, params, referenceParams, detunitlist) :
+    """The clusters of each DetUnit are compared with those of the reference
+    clusterizer instead of the expected ones"""
+    test = ClusterizerTest(label, params, detunitlist)
+    test.ReferenceParameters = referenceParams
+    return test
+
+def RandomDetUnits(seed, count, ndigis=64) :
+    """DetUnits with random digis, noises, gains and bad strips, and no
+    expected clusters, for use in a ComparisonTest"""
+    rng = random.Random(seed)
+    units = []
+    for unit in range(count) :
+        # ClusterizerUnitTesterESProducer assigns the gains to the APVs in
+        # the order they are seen, so use the same gain for all of them
+        gain = rng.choice([0.8, 1., 1.25])
+        strips = sorted(rng.sample(range(768), ndigis))
+        digis = [ digi( strip,
+                        rng.choice([0, rng.randint(1, 10), rng.randint(1, 40), rng.randint(1, 255)]),
+                        rng.choice([1., 2., 3.5, 5.]),
+                        gain,
+                        rng.random() > 0.05 )
+                  for strip in strips ]
+        units.append( DetUnit( "random %d/%d" % (seed, unit), digis, [] ) )
+    return units
+
 def DetUnit(label, digis, clusters, invalid=False) :
     return cms.PSet(
         Label = cms.string(label),
@@ -10,7 +10,9 @@ clusterizerTests = ClusterizerTest( "Default Clusterizer Settings",
                                               MaxSequentialHoles = cms.uint32(0),
                                               MaxSequentialBad   = cms.uint32(1),
                                     MaxAdjacentBad     = cms.uint32(0),
-                                              QualityLabel = cms.string("")
+                                              QualityLabel = cms.string(""),
+                                              RemoveApvShots = cms.bool(False),
+                                              clusterChargeCut = cms.PSet(value = cms.double(-1.0))
                                     ),
                                     [
     DetUnit( "[] = []",
@@ -241,3 +243,22 @@ clusterizerTests = ClusterizerTest( "Default Clusterizer Settings",
                ] )
     ]
                                            )
+
+# the same tests, with the module-at-a-time path of ThreeThresholdAlgorithm
+vectorizedClusterizerTests = clusterizerTests.clone( Label = "Vectorized Clusterizer" )
+vectorizedClusterizerTests.ClusterizerParameters.Algorithm = "VectorizedThreeThresholdAlgorithm"
+
+# random modules, clustered by both paths of ThreeThresholdAlgorithm
+randomVectorizedClusterizerTests = ComparisonTest( "Vectorized vs strip by strip, random modules",
+                                                   vectorizedClusterizerTests.ClusterizerParameters.clone(),
+                                                   clusterizerTests.ClusterizerParameters.clone(),
+                                                   RandomDetUnits(1, 100) )
+
+randomVectorizedHolesClusterizerTests = ComparisonTest( "Vectorized vs strip by strip, random modules with holes and bad neighbours",
+                                                        vectorizedClusterizerTests.ClusterizerParameters.clone( MaxSequentialHoles = 1,
+                                                                                                                MaxSequentialBad = 2,
+                                                                                                                MaxAdjacentBad = 1 ),
+                                                        clusterizerTests.ClusterizerParameters.clone( MaxSequentialHoles = 1,
+                                                                                                      MaxSequentialBad = 2,
+                                                                                                      MaxAdjacentBad = 1 ),
+                                                        RandomDetUnits(2, 100) )
@@ -23,7 +23,10 @@ process.SiStripQualityRcdSource = cms.ESSource( "EmptyESSource",
 
 process.load("RecoLocalTracker.SiStripClusterizer.test.ClusterizerUnitTestFunctions_cff")
 process.load("RecoLocalTracker.SiStripClusterizer.test.ClusterizerUnitTests_cff")
-testDefinition = cms.VPSet() + [ process.clusterizerTests ]
+testDefinition = cms.VPSet() + [ process.clusterizerTests,
+                                  process.vectorizedClusterizerTests,
+                                  process.randomVectorizedClusterizerTests,
+                                  process.randomVectorizedHolesClusterizerTests ]
 
 process.es           = cms.ESProducer("ClusterizerUnitTesterESProducer", ClusterizerTestGroups = testDefinition  )
 process.runUnitTests = cms.EDAnalyzer("ClusterizerUnitTester",           ClusterizerTestGroups = testDefinition  )
@@ -9,7 +9,7 @@ std::auto_ptr<StripClusterizerAlgorithm> StripClusterizerAlgorithmFactory::
 create(const edm::ParameterSet& conf) {
   std::string algorithm = conf.getParameter<std::string>("Algorithm");
 
-  if(algorithm == "ThreeThresholdAlgorithm") {
+  if(algorithm == "ThreeThresholdAlgorithm" || algorithm == "VectorizedThreeThresholdAlgorithm") {
     return std::auto_ptr<StripClusterizerAlgorithm>(
 	   new ThreeThresholdAlgorithm(
 	       conf.getParameter<double>("ChannelThreshold"),
@@ -20,7 +20,8 @@ create(const edm::ParameterSet& conf) {
 	       conf.getParameter<unsigned>("MaxAdjacentBad"),
 	       conf.getParameter<std::string>("QualityLabel"),
 	       conf.getParameter<bool>("RemoveApvShots"),
-               clusterChargeCut(conf)
+               clusterChargeCut(conf),
+	       algorithm == "VectorizedThreeThresholdAlgorithm"
            ));
   }
 
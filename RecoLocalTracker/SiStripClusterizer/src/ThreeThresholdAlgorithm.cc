@@ -1,17 +1,20 @@
 #include "RecoLocalTracker/SiStripClusterizer/interface/ThreeThresholdAlgorithm.h"
 #include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
 #include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
+#include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <vector>
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "DataFormats/SiStripCluster/interface/SiStripClusterTools.h"
 
 ThreeThresholdAlgorithm::
 ThreeThresholdAlgorithm(float chan, float seed, float cluster, unsigned holes, unsigned bad, unsigned adj, std::string qL, 
-			bool removeApvShots, float minGoodCharge) 
+			bool removeApvShots, float minGoodCharge, bool vectorized) 
   : ChannelThreshold( chan ), SeedThreshold( seed ), ClusterThresholdSquared( cluster*cluster ),
-    MaxSequentialHoles( holes ), MaxSequentialBad( bad ), MaxAdjacentBad( adj ), RemoveApvShots(removeApvShots), minGoodCharge(minGoodCharge) {
+    MaxSequentialHoles( holes ), MaxSequentialBad( bad ), MaxAdjacentBad( adj ), RemoveApvShots(removeApvShots), minGoodCharge(minGoodCharge),
+    Vectorized( vectorized ) {
   qualityLabel = (qL);
 }
 
@@ -39,6 +42,11 @@ clusterizeDetUnit_(const digiDetSet& digis, output_t::TSFastFiller& output) cons
     ApvCleaner.clean(digis,scan,end);
   }
 
+  if(Vectorized) {
+    clusterizeVectorized_(det, scan, end, output);
+    return;
+  }
+
   State state(det);
   while( scan != end ) {
     while( scan != end  && !candidateEnded(state, scan->strip() ) ) 
@@ -47,6 +55,115 @@ clusterizeDetUnit_(const digiDetSet& digis, output_t::TSFastFiller& output) cons
   }
 }
 
+namespace {
+
+  // the digis of a module and their thresholds, reused from one module to the next
+  struct ModuleBuffer {
+    std::vector<uint16_t> strip;
+    std::vector<uint8_t> adc;
+    std::vector<float> noise;
+    std::vector<uint8_t> keep, seed;
+  };
+
+  thread_local ModuleBuffer buffer_;
+
+  // bad strips of a module, unpacked once from the quality ranges
+  class BadStrips {
+  public:
+    static constexpr uint16_t kMaxStrips = 6*128;
+
+    explicit BadStrips(StripClusterizerAlgorithm::Det const & det) : det_(det) {
+      for(auto it = det.qualityRange.first; it != det.qualityRange.second; ++it) {
+	auto fs = det.quality->decode(*it);
+	for(unsigned int s = fs.firstStrip; s < std::min<unsigned int>(fs.firstStrip+fs.range, kMaxStrips); ++s) flag_[s] = 1;
+      }
+    }
+    ~BadStrips() {
+      for(auto it = det_.qualityRange.first; it != det_.qualityRange.second; ++it) {
+	auto fs = det_.quality->decode(*it);
+	for(unsigned int s = fs.firstStrip; s < std::min<unsigned int>(fs.firstStrip+fs.range, kMaxStrips); ++s) flag_[s] = 0;
+      }
+    }
+
+    bool operator()(uint16_t strip) const { return strip < kMaxStrips ? flag_[strip] : det_.bad(strip); }
+    bool allBetween(uint16_t L, uint16_t R) const { while( ++L < R  &&  (*this)(L) ); return L == R; }
+
+  private:
+    StripClusterizerAlgorithm::Det const & det_;
+    static thread_local uint8_t flag_[kMaxStrips];
+  };
+
+  thread_local uint8_t BadStrips::flag_[BadStrips::kMaxStrips] = {};
+
+}
+
+template<class Iter>
+void ThreeThresholdAlgorithm::
+clusterizeVectorized_(Det const & det, Iter scan, Iter end, output_t::TSFastFiller& output) const {
+  auto & buf = buffer_;
+  const unsigned int n = end - scan;
+  buf.strip.resize(n); buf.adc.resize(n); buf.noise.resize(n);
+  buf.keep.resize(n); buf.seed.resize(n);
+
+  // gather the digis, their noise and whether they are on bad strips
+  for(unsigned int i = 0; i < n; ++i) { buf.strip[i] = scan[i].strip(); buf.adc[i] = scan[i].adc(); }
+  for(unsigned int i = 0; i < n; ++i) buf.noise[i] = det.noise(buf.strip[i]);
+  BadStrips bad(det);
+  for(unsigned int i = 0; i < n; ++i) buf.keep[i] = !bad(buf.strip[i]);
+
+  // channel and seed thresholds for all the digis, as in addToCandidate
+  uint16_t const * strip = buf.strip.data();
+  uint8_t const * adc = buf.adc.data();
+  float const * noise = buf.noise.data();
+  uint8_t * keep = buf.keep.data();
+  uint8_t * seed = buf.seed.data();
+  for(unsigned int i = 0; i < n; ++i) {
+    keep[i] &= !( adc[i] < static_cast<uint8_t>( noise[i] * ChannelThreshold) );
+    seed[i] = !( adc[i] < static_cast<uint8_t>( noise[i] * SeedThreshold) );
+  }
+
+  State state(det);
+  auto ended = [&](uint16_t testStrip) {
+    uint16_t holes = testStrip - state.lastStrip - 1;
+    return ( ( (!state.ADCs.empty())  & (holes > MaxSequentialHoles ) ) &&
+	     ( holes > MaxSequentialBad || !bad.allBetween( state.lastStrip, testStrip ) ) );
+  };
+  auto endVectorized = [&]() {
+    if(candidateAccepted(state)) {
+      // applyGains, without branches on the saturation
+      uint16_t first = firstStrip(state);
+      uint8_t * adcs = state.ADCs.data();
+      const unsigned int size = state.ADCs.size();
+      for(unsigned int j = 0; j < size; ++j) {
+	auto charge = int( float(adcs[j])/SiStripGain::getApvGain((first+j)/128, det.gainRange) + 0.5f );
+	uint8_t scaled = charge > 1022 ? 255 : ( charge >  253 ? 254 : charge );
+	adcs[j] = adcs[j] < 254 ? scaled : adcs[j];
+      }
+      // appendBadNeighbors
+      uint8_t max = MaxAdjacentBad;
+      while(0 < max--) {
+	if( bad( firstStrip(state)-1) ) { state.ADCs.insert( state.ADCs.begin(), 0);  }
+	if( bad(  state.lastStrip + 1) ) { state.ADCs.push_back(0); state.lastStrip++; }
+      }
+      if(siStripClusterTools::chargePerCM(state.det().detId, state.ADCs.begin(), state.ADCs.end()) > minGoodCharge)
+	output.push_back(SiStripCluster(firstStrip(state), state.ADCs.begin(), state.ADCs.end()));
+    }
+    clearCandidate(state);
+  };
+
+  for(unsigned int i = 0; i < n; ++i) {
+    if( ended(strip[i]) ) endVectorized();
+    if( !keep[i] ) continue;
+    // addToCandidate
+    if(state.candidateLacksSeed) state.candidateLacksSeed = !seed[i];
+    if(state.ADCs.empty()) state.lastStrip = strip[i] - 1; // begin candidate
+    while( ++state.lastStrip < strip[i] ) state.ADCs.push_back(0); // pad holes
+    state.ADCs.push_back( adc[i] );
+    state.noiseSquared += noise[i]*noise[i];
+  }
+  if(n != 0) endVectorized();
+}
+
 inline 
 bool ThreeThresholdAlgorithm::
 candidateEnded(State const & state, const uint16_t& testStrip) const {
@@ -11,11 +11,19 @@
 void ClusterizerUnitTester::
 analyze(const edm::Event&, const edm::EventSetup& es) {
   detId=0;
+  failures=0;
   for(iter_t group = testGroups.begin(); group < testGroups.end(); group++) {
     clusterizer = StripClusterizerAlgorithmFactory::create(group->getParameter<PSet>("ClusterizerParameters"));
     clusterizer->initialize(es);
+    reference.reset();
+    if(group->exists("ReferenceParameters")) {
+      reference = StripClusterizerAlgorithmFactory::create(group->getParameter<PSet>("ReferenceParameters"));
+      reference->initialize(es);
+    }
     testTheGroup(*group);
   }
+  if(failures)
+    throw cms::Exception("Failed") << failures << " clusterizer tests failed.\n";
 }
 
 void ClusterizerUnitTester::
@@ -42,7 +50,10 @@ runTheTest(const PSet& test) {
   constructDigis(digiset, digis);
 
   output_t expected;
-  constructClusters(clusterset, expected);
+  if(reference)
+    reference->clusterize(digis, expected);
+  else
+    constructClusters(clusterset, expected);
 
   output_t result;
   result.reserve(2*clusterset.size(),8*clusterset.size());
@@ -57,6 +68,7 @@ runTheTest(const PSet& test) {
   }
   catch(cms::Exception e) {
     std::cout << ( e << "Input:\n" << printDigis(digiset));
+    failures++;
   }
 }
 
@@ -43,7 +43,10 @@ class ClusterizerUnitTester : public edm::EDAnalyzer {
   
   VPSet testGroups;
   std::unique_ptr<StripClusterizerAlgorithm> clusterizer;
+  // if set, the expected clusters are those of the reference clusterizer
+  std::unique_ptr<StripClusterizerAlgorithm> reference;
   uint32_t detId;
+  unsigned failures;
 };
 
 #endif
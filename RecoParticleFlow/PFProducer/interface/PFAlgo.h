@@ -64,6 +64,8 @@ class PFAlgo {
   void setPFMuonAlgo(PFMuonAlgo* algo) {pfmu_ =algo;}
   void setMuonHandle(const edm::Handle<reco::MuonCollection>&);
   void setDebug( bool debug ) {debug_ = debug; connector_.setDebug(debug_);}
+  /// process the blocks concurrently, when the algorithms used allow it
+  void setConcurrentBlocks( bool concurrent ) {concurrentBlocks_ = concurrent;}
 
   void setParameters(double nSigmaECAL,
                      double nSigmaHCAL, 
@@ -239,16 +241,34 @@ class PFAlgo {
   
  protected:
 
+  /// candidates reconstructed from one block, added to the
+  /// event collections in the order of the blocks
+  struct BlockOutput {
+    reco::PFCandidateCollection                 candidates;
+    reco::PFCandidateCollection                 electronCandidates;
+    reco::PFCandidateElectronExtraCollection    electronExtra;
+    reco::PFCandidatePhotonExtraCollection      photonExtra;
+  };
+
   /// process one block. can be reimplemented in more sophisticated 
-  /// algorithms
+  /// algorithms. Blocks may be processed concurrently: the results
+  /// go to out, and the block lists are not to be modified
   virtual void processBlock( const reco::PFBlockRef& blockref,
                              std::list<reco::PFBlockRef>& hcalBlockRefs, 
-                             std::list<reco::PFBlockRef>& ecalBlockRefs ); 
+                             std::list<reco::PFBlockRef>& ecalBlockRefs,
+                             BlockOutput& out ); 
+
+  /// whether processBlock can run on several blocks at the same time:
+  /// not with the electron and photon algorithms, which keep the results
+  /// of the last block, nor with the debug printouts
+  virtual bool processBlocksConcurrently() const;
   
   /// Reconstruct a charged particle from a track
-  /// Returns the index of the newly created candidate in pfCandidates_
+  /// Returns the index of the newly created candidate in candidates
   /// Michalis added a flag here to treat muons inside jets
-  unsigned reconstructTrack( const reco::PFBlockElement& elt,bool allowLoose= false);
+  unsigned reconstructTrack( const reco::PFBlockElement& elt,
+                             reco::PFCandidateCollection& candidates,
+                             bool allowLoose= false);
 
   /// Reconstruct a neutral particle from a cluster. 
   /// If chargedEnergy is specified, the neutral 
@@ -258,6 +278,7 @@ class PFAlgo {
 
   unsigned reconstructCluster( const reco::PFCluster& cluster,
                                double particleEnergy,
+                               reco::PFCandidateCollection& candidates,
 			       bool useDirection = false,
 			       double particleX=0.,
 			       double particleY=0.,
@@ -335,6 +356,7 @@ class PFAlgo {
   bool               useHO_;
   int                algo_;
   bool               debug_;
+  bool               concurrentBlocks_;
 
   /// Variables for PFElectrons
   std::string mvaWeightFileEleID_;
@@ -32,7 +32,11 @@ class PFAlgoTestBenchConversions : public PFAlgo {
   /// algorithms
   void processBlock( const reco::PFBlockRef& blockref,
                              std::list<reco::PFBlockRef>& hcalBlockRefs, 
-			     std::list<reco::PFBlockRef>& ecalBlockRefs ) override;
+			     std::list<reco::PFBlockRef>& ecalBlockRefs,
+			     BlockOutput& out ) override;
+
+  /// the blocks are printed one after the other
+  bool processBlocksConcurrently() const override { return false; }
   
 
  private:
@@ -118,7 +118,8 @@ class PFBlockAlgo {
   // run all of the importers and build KDtrees
   void buildElements(const edm::Event&);
   
-  /// build blocks
+  /// build blocks, in increasing order of their smallest element, the
+  /// elements of a block being in decreasing order of their index
   void findBlocks();
 
   /// sets debug printout flag
@@ -136,21 +137,18 @@ class PFBlockAlgo {
   
  private:
   
-  /// compute missing links in the blocks 
-  /// (the recursive procedure does not build all links)  
+  /// a link found between two elements, from < to
+  struct Link {
+    unsigned from;
+    unsigned to;
+    double dist;
+  };
+
+  /// set the links of a block made of the n elements elems, given their
+  /// index localIndex in the block
   void packLinks(reco::PFBlock& block, 
-		 const std::unordered_map<std::pair<unsigned int,unsigned int>,PFBlockLink>& links) const; 
-  
-  /// Avoid to check links when not useful
-  inline bool linkPrefilter(const reco::PFBlockElement* last, 
-			    const reco::PFBlockElement* next) const;
-
-  /// check whether 2 elements are linked. Returns distance and linktype
-  inline void link( const reco::PFBlockElement* el1, 
-		    const reco::PFBlockElement* el2, 
-		    PFBlockLink::Type& linktype, 
-		    reco::PFBlock::LinkTest& linktest,
-		    double& dist) const;
+		 const unsigned* elems, unsigned n,
+		 const std::vector<unsigned>& localIndex) const; 
   
   std::unique_ptr< reco::PFBlockCollection >    blocks_;
   
@@ -158,6 +156,11 @@ class PFBlockAlgo {
   ElementList       elements_; 
   std::vector<ElementList::value_type::pointer> bare_elements_;
   ElementRanges     ranges_;
+
+  /// links found between the elements, in compressed rows
+  std::vector<unsigned> linkFirst_;
+  std::vector<unsigned> linkTo_;
+  std::vector<double>   linkDist_;
   
   /// if true, debug printouts activated
   bool   debug_;
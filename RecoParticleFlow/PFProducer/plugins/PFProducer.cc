@@ -399,6 +399,8 @@ PFProducer::PFProducer(const edm::ParameterSet& iConfig) {
 
   pfAlgo_->setDebug( debug_ );
 
+  pfAlgo_->setConcurrentBlocks( iConfig.getUntrackedParameter<bool>("concurrentBlocks",true) );
+
 }
 
 
@@ -19,6 +19,8 @@ particleFlowTmp = cms.EDProducer("PFProducer",
     # Verbose and debug flags
     verbose = cms.untracked.bool(False),
     debug = cms.untracked.bool(False),
+    # Process the blocks concurrently, when the algorithms used allow it
+    concurrentBlocks = cms.untracked.bool(True),
 
     # Use HO clusters in PF hadron reconstruction
     useHO = cms.bool(True),                                 
@@ -10,7 +10,8 @@ using namespace reco;
  
 void PFAlgoTestBenchElectrons::processBlock(const reco::PFBlockRef& blockref,
 					    std::list<PFBlockRef>& hcalBlockRefs,
-					    std::list<PFBlockRef>& ecalBlockRefs)
+					    std::list<PFBlockRef>& ecalBlockRefs,
+					    BlockOutput& out)
 {
 
   //cout<<"electron test bench: process block"
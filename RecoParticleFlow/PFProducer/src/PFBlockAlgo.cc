@@ -7,57 +7,57 @@
 
 #include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
 
+#include <atomic>
+#include <numeric>
 #include <stdexcept>
 #include <algorithm>
 #include "TMath.h"
 
+#include "tbb/parallel_for.h"
+
 using namespace std;
 using namespace reco;
 
 #define INIT_ENTRY(name) {#name,name}
 
 namespace {
-  class QuickUnion{
-  std::vector<unsigned> id_;
-  std::vector<unsigned> size_;
-  int count_;
+  // union-find which can be updated from several threads: a root is only
+  // ever linked below a smaller index, by a compare-and-swap, so that the
+  // root of a set is always its smallest element
+  class ConcurrentUnion{
+    std::vector<std::atomic<unsigned> > id_;
 
   public:
-    QuickUnion(const unsigned NBranches) {
-      count_ = NBranches;
-      id_.resize(NBranches);
-      size_.resize(NBranches);
-      for( unsigned i = 0; i < NBranches; ++i ) {
-	id_[i] = i;
-	size_[i] = 1;
-      }
+    ConcurrentUnion(const unsigned NBranches) : id_(NBranches) {
+      for( unsigned i = 0; i < NBranches; ++i ) id_[i] = i;
     }
-    
-    int count() const { return count_; }
-    
+
     unsigned find(unsigned p) {
-      while( p != id_[p] ) {
-	id_[p] = id_[id_[p]];
-	p = id_[p];
+      unsigned parent = id_[p].load(std::memory_order_relaxed);
+      while( p != parent ) {
+        // path halving, harmless if another thread got there first
+        unsigned grandparent = id_[parent].load(std::memory_order_relaxed);
+        id_[p].compare_exchange_weak(parent,grandparent,std::memory_order_relaxed);
+        p = grandparent;
+        parent = id_[p].load(std::memory_order_relaxed);
       }
       return p;
     }
-    
-    bool connected(unsigned p, unsigned q) { return find(p) == find(q); }
-    
+
     void unite(unsigned p, unsigned q) {
-      unsigned rootP = find(p);
-      unsigned rootQ = find(q);
-      id_[p] = q;
-      
-      if(size_[rootP] < size_[rootQ] ) { 
-	id_[rootP] = rootQ; size_[rootQ] += size_[rootP]; 
-      } else { 
-	id_[rootQ] = rootP; size_[rootP] += size_[rootQ]; 
+      while( true ) {
+        p = find(p);
+        q = find(q);
+        if( p == q ) return;
+        if( p < q ) std::swap(p,q);
+        unsigned expected = p;
+        if( id_[p].compare_exchange_strong(expected,q,std::memory_order_relaxed) ) return;
       }
-      --count_;
     }
   };
+
+  // elements whose links are tested in one task
+  constexpr unsigned linkChunkSize = 32;
 }
 
 
@@ -153,174 +153,145 @@ PFBlockAlgo::~PFBlockAlgo() {
 
 void PFBlockAlgo::findBlocks() {
   // Glowinski & Gouzevitch
-  for( const auto& kdtree : kdtrees_ ) {
-    kdtree->process();
-  }  
+  // each kdtree fills the multilinks of its own element type, so they can run together
+  tbb::parallel_for(0UL, kdtrees_.size(), 1UL, [this](unsigned long k) {
+      kdtrees_[k]->process();
+    });
   // !Glowinski & Gouzevitch
   // the blocks have not been passed to the event, and need to be cleared
   if( blocks_.get() ) blocks_->clear();
   else                blocks_.reset( new reco::PFBlockCollection );
-  blocks_->reserve(elements_.size());
 
-  QuickUnion qu(bare_elements_.size());
-  const auto elem_size = bare_elements_.size();
-  for( unsigned i = 0; i < elem_size; ++i ) {
-    for( unsigned j = 0; j < elem_size; ++j ) {
-      if( qu.connected(i,j) || j == i ) continue;
-      if( !linkTests_[linkTestSquare_[bare_elements_[i]->type()][bare_elements_[j]->type()]] ) {
-        j = ranges_[bare_elements_[j]->type()].second;
-        continue;
-      }
-      auto p1(bare_elements_[i]), p2(bare_elements_[j]);
-      const PFBlockElement::Type type1 = p1->type();
-      const PFBlockElement::Type type2 = p2->type();
-      const unsigned index = linkTestSquare_[type1][type2];
-      if( linkTests_[index]->linkPrefilter(p1,p2) ) {
-        const double dist = linkTests_[index]->testLink(p1,p2);
-        // compute linking info if it is possible
-        if( dist > -0.5 ) {
-          qu.unite(i,j);
+  // the link tests are symmetric: each pair is tested once, the elements
+  // being connected as the links are found
+  const unsigned elem_size = bare_elements_.size();
+  const unsigned nchunks = (elem_size + linkChunkSize - 1)/linkChunkSize;
+  ConcurrentUnion cu(elem_size);
+  std::vector<std::vector<Link> > chunkLinks(nchunks);
+  tbb::parallel_for(0UL, (unsigned long)nchunks, 1UL, [&](unsigned long chunk) {
+      auto& found = chunkLinks[chunk];
+      const unsigned last = std::min(elem_size, unsigned(chunk+1)*linkChunkSize);
+      for( unsigned i = chunk*linkChunkSize; i < last; ++i ) {
+        const auto p1 = bare_elements_[i];
+        const PFBlockElement::Type type1 = p1->type();
+        for( unsigned j = i+1; j < elem_size; ++j ) {
+          const auto p2 = bare_elements_[j];
+          const PFBlockElement::Type type2 = p2->type();
+          const unsigned index = linkTestSquare_[type1][type2];
+          if( !linkTests_[index] ) {
+            j = ranges_[type2].second;
+            continue;
+          }
+          if( linkTests_[index]->linkPrefilter(p1,p2) ) {
+            const double dist = linkTests_[index]->testLink(p1,p2);
+            // compute linking info if it is possible
+            if( dist > -0.5 ) {
+              found.push_back({i,j,dist});
+              cu.unite(i,j);
+            }
+          }
         }
       }
+    });
+
+  // links in compressed rows: those of element i to larger indices are
+  // linkTo_[linkFirst_[i]] to linkTo_[linkFirst_[i+1]-1]
+  linkFirst_.assign(elem_size+1,0);
+  linkTo_.clear();
+  linkDist_.clear();
+  for( const auto& found : chunkLinks ) {
+    for( const auto& l : found ) {
+      ++linkFirst_[l.from+1];
+      linkTo_.push_back(l.to);
+      linkDist_.push_back(l.dist);
     }
   }
-  
-  std::unordered_multimap<unsigned,unsigned> blocksmap(elements_.size());
-  std::vector<unsigned> keys;
-  keys.reserve(elements_.size());
-  for( unsigned i = 0; i < elements_.size(); ++i ) {
-    unsigned key = i; 
-    while( key != qu.find(key) ) key = qu.find(key); // make sure we always find the root node...
-    auto pos  = std::lower_bound(keys.begin(),keys.end(),key);
-    if( pos == keys.end() || *pos != key ) {
-      keys.insert(pos,key);      
+  std::partial_sum(linkFirst_.begin(),linkFirst_.end(),linkFirst_.begin());
+
+  // one block per set, in the order of their smallest element, the elements
+  // of a block being sorted by decreasing index.
+  // The elements are in the order in which the unordered_multimap of
+  // libstdc++ used to return them, now independent of the standard library.
+  // The order of the blocks, and so of the PFCandidates made from them, is
+  // intentionally not the former one: that was the order of the roots of a
+  // sequential union-find, which depended on every pair of elements it
+  // visited and cannot be reproduced without that quadratic loop.
+  std::vector<unsigned> blockOf(elem_size);
+  std::vector<unsigned> blockFirst(1,0);
+  for( unsigned i = 0; i < elem_size; ++i ) {
+    const unsigned root = cu.find(i);
+    if( root == i ) {
+      blockOf[i] = blockFirst.size()-1;
+      blockFirst.push_back(0);
+    } else {
+      blockOf[i] = blockOf[root];
     }
-    blocksmap.emplace(key,i);
+    ++blockFirst[blockOf[i]+1];
+  }
+  std::partial_sum(blockFirst.begin(),blockFirst.end(),blockFirst.begin());
+  const unsigned nblocks = blockFirst.size()-1;
+  std::vector<unsigned> blockElements(elem_size);
+  std::vector<unsigned> next(blockFirst.begin()+1,blockFirst.end());
+  for( unsigned i = 0; i < elem_size; ++i ) {
+    blockElements[--next[blockOf[i]]] = i;
   }
 
-  PFBlockLink::Type linktype = PFBlockLink::NONE;
-  PFBlock::LinkTest linktest = PFBlock::LINKTEST_RECHIT;
-  for( auto key : keys ) {
-    blocks_->push_back( reco::PFBlock() );
-    auto range = blocksmap.equal_range(key);
-    auto& the_block = blocks_->back();
-    ElementList::value_type::pointer p1(bare_elements_[range.first->second]);
-    the_block.addElement(p1);
-    const unsigned block_size = blocksmap.count(key) + 1;
-    //reserve up to 1M or 8MB; pay rehash cost for more
-    std::unordered_map<std::pair<unsigned int,unsigned int>, PFBlockLink > links(min(1000000u,block_size*block_size));
-    auto itr = range.first;
-    ++itr;
-    for( ; itr != range.second; ++itr ) {
-      ElementList::value_type::pointer p2(bare_elements_[itr->second]);
-      const PFBlockElement::Type type1 = p1->type();
-      const PFBlockElement::Type type2 = p2->type();        
-      the_block.addElement(p2);
-      linktest = PFBlock::LINKTEST_RECHIT; //rechit by default 
-      linktype = static_cast<PFBlockLink::Type>(1<<(type1-1)|1<<(type2-1));
-      const unsigned index = linkTestSquare_[type1][type2];
-      if( nullptr != linkTests_[index] ) {
-        const double dist = linkTests_[index]->testLink(p1,p2);
-        links.emplace( std::make_pair(p1->index(), p2->index()) ,
-                       PFBlockLink( linktype, linktest, dist,
-                                    p1->index(), p2->index() ) );
+  blocks_->resize(nblocks);
+  std::vector<unsigned> localIndex(elem_size);
+  tbb::parallel_for(0UL, (unsigned long)nblocks, 1UL, [&](unsigned long b) {
+      auto& the_block = (*blocks_)[b];
+      const unsigned* elems = blockElements.data() + blockFirst[b];
+      const unsigned n = blockFirst[b+1] - blockFirst[b];
+      for( unsigned k = 0; k < n; ++k ) {
+        the_block.addElement(bare_elements_[elems[k]]);
+        localIndex[elems[k]] = k;
       }
-    }
-    packLinks( the_block, links );    
-  }
-  
+      packLinks( the_block, elems, n, localIndex );
+    });
+
   bare_elements_.clear();
   elements_.clear();
 }
 
 void 
 PFBlockAlgo::packLinks( reco::PFBlock& block, 
-			   const std::unordered_map<std::pair<unsigned int,unsigned int>,PFBlockLink>& links ) const {
-  constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
-  
-  const edm::OwnVector< reco::PFBlockElement >& els = block.elements();
-  
+			const unsigned* elems, unsigned n,
+			const std::vector<unsigned>& localIndex ) const {
   block.bookLinkData();
-  unsigned elsize = els.size();
-  //First Loop: update all link data
-  for( unsigned i1=0; i1<elsize; ++i1 ) {
-    for( unsigned i2=0; i2<i1; ++i2 ) {
-      
-      // no reflexive link
-      //if( i1==i2 ) continue;
-      
-      double dist = -1;
-      
-      bool linked = false;
-      PFBlock::LinkTest linktest 
-	= PFBlock::LINKTEST_RECHIT; 
-
-      // are these elements already linked ?
-      // this can be optimized
-      const auto link_itr = links.find(std::make_pair(i2,i1));
-      if( link_itr != links.end() ) {
-	dist = link_itr->second.dist();
-	linktest = link_itr->second.test();
-	linked = true;
-      }      
-      
-      if(!linked) {
-        const PFBlockElement::Type type1 = els[i1].type();
-        const PFBlockElement::Type type2 = els[i2].type();
-        const auto minmax = std::minmax(type1,type2);
-        const unsigned index = rowsize*minmax.second + minmax.first;
-	PFBlockLink::Type linktype = PFBlockLink::NONE;
-	bool bTestLink = ( nullptr == linkTests_[index] ? false : linkTests_[index]->linkPrefilter(&(els[i1]),&(els[i2])) );
-	if (bTestLink) link( & els[i1], & els[i2], linktype, linktest, dist);
-      }
 
-      //loading link data according to link test used: RECHIT 
-      //block.setLink( i1, i2, chi2, block.linkData() );
+  // the first element of the block is linked to every element for which
+  // a link test is defined, without prefilter
+  std::vector<bool> linkedToFirst(n,false);
+  for( unsigned k = 0; k < n; ++k ) {
+    const unsigned i = elems[k];
+    for( unsigned l = linkFirst_[i]; l < linkFirst_[i+1]; ++l ) {
+      const unsigned k2 = localIndex[linkTo_[l]];
+      if( k2 == 0 ) linkedToFirst[k] = true;
 #ifdef PFLOW_DEBUG
       if( debug_ )
-	cout << "Setting link between elements " << i1 << " and " << i2
-	     << " of dist =" << dist << " computed from link test "
-	     << linktest << endl;
+	cout << "Setting link between elements " << k2 << " and " << k
+	     << " of dist =" << linkDist_[l] << " computed from link test "
+	     << PFBlock::LINKTEST_RECHIT << endl;
 #endif
-      block.setLink( i1, i2, dist, block.linkData(), linktest );
+      block.setLink( k2, k, linkDist_[l], block.linkData(), PFBlock::LINKTEST_RECHIT );
     }
   }
 
-}
-
-// see plugins/linkers for the functions that calculate distances
-// for each available link type
-inline bool
-PFBlockAlgo::linkPrefilter(const reco::PFBlockElement* last, 
-			      const reco::PFBlockElement* next) const {
-  constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
-  const PFBlockElement::Type type1 = (last)->type();
-  const PFBlockElement::Type type2 = (next)->type();
-  const unsigned index = rowsize*std::max(type1,type2) + std::min(type1,type2);
-  bool result =  linkTests_[index]->linkPrefilter(last,next);
-  return result;  
-}
-
-inline void 
-PFBlockAlgo::link( const reco::PFBlockElement* el1, 
-		      const reco::PFBlockElement* el2, 
-		      PFBlockLink::Type& linktype, 
-		      reco::PFBlock::LinkTest& linktest,
-		      double& dist) const {
-  constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
-  dist=-1.0;
-  linktest = PFBlock::LINKTEST_RECHIT; //rechit by default 
-  const PFBlockElement::Type type1 = el1->type();
-  const PFBlockElement::Type type2 = el2->type();
-  linktype = static_cast<PFBlockLink::Type>(1<<(type1-1)|1<<(type2-1));
-  const unsigned index = rowsize*std::max(type1,type2) + std::min(type1,type2);
-  if(debug_ ) { 
-    std::cout << " PFBlockAlgo links type1 " << type1 
-	      << " type2 " << type2 << std::endl;
+  const auto p1 = bare_elements_[elems[0]];
+  for( unsigned k = 1; k < n; ++k ) {
+    if( linkedToFirst[k] ) continue;
+    const auto p2 = bare_elements_[elems[k]];
+    const unsigned index = linkTestSquare_[p1->type()][p2->type()];
+    if( !linkTests_[index] || linkTests_[index]->linkPrefilter(p1,p2) ) continue;
+    const double dist = linkTests_[index]->testLink(p1,p2);
+#ifdef PFLOW_DEBUG
+    if( debug_ )
+      cout << "Setting link between elements " << 0 << " and " << k
+	   << " of dist =" << dist << " computed from link test "
+	   << PFBlock::LINKTEST_RECHIT << endl;
+#endif
+    block.setLink( 0, k, dist, block.linkData(), PFBlock::LINKTEST_RECHIT );
   }
-  
-  // index is always checked in the preFilter above, no need to check here
-  dist = linkTests_[index]->testLink(el1,el2);
 }
 
 void PFBlockAlgo::updateEventSetup(const edm::EventSetup& es) {
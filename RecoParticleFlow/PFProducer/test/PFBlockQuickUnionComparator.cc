@@ -0,0 +1,274 @@
+//
+// Class: PFBlockQuickUnionComparator.cc
+//
+// Info: Checks the blocks of PFBlockProducer against the sequential
+//       QuickUnion algorithm that PFBlockAlgo::findBlocks used before the
+//       link tests ran concurrently. The reference runs on the elements of
+//       the blocks, with the same linkers, and each of its blocks must be
+//       found in the collection with the same elements and the same links.
+//       Throws on the first difference.
+//
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/ParticleFlowReco/interface/PFBlock.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockFwd.h"
+#include "RecoParticleFlow/PFProducer/interface/BlockElementLinkerBase.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  // the union-find of PFBlockAlgo::findBlocks before it ran concurrently
+  class QuickUnion{
+  std::vector<unsigned> id_;
+  std::vector<unsigned> size_;
+  int count_;
+
+  public:
+    QuickUnion(const unsigned NBranches) {
+      count_ = NBranches;
+      id_.resize(NBranches);
+      size_.resize(NBranches);
+      for( unsigned i = 0; i < NBranches; ++i ) {
+	id_[i] = i;
+	size_[i] = 1;
+      }
+    }
+    
+    int count() const { return count_; }
+    
+    unsigned find(unsigned p) {
+      while( p != id_[p] ) {
+	id_[p] = id_[id_[p]];
+	p = id_[p];
+      }
+      return p;
+    }
+    
+    bool connected(unsigned p, unsigned q) { return find(p) == find(q); }
+    
+    void unite(unsigned p, unsigned q) {
+      unsigned rootP = find(p);
+      unsigned rootQ = find(q);
+      id_[p] = q;
+      
+      if(size_[rootP] < size_[rootQ] ) { 
+	id_[rootP] = rootQ; size_[rootQ] += size_[rootP]; 
+      } else { 
+	id_[rootQ] = rootP; size_[rootP] += size_[rootQ]; 
+      }
+      --count_;
+    }
+  };
+
+  struct PairHash {
+    size_t operator()(const std::pair<unsigned int,unsigned int>& arg) const {
+      return arg.first ^ (arg.second << 1);
+    }
+  };
+  typedef std::unordered_map<std::pair<unsigned int,unsigned int>,double,PairHash> LinkMap;
+
+  const std::unordered_map<std::string,reco::PFBlockElement::Type> elementTypes = {
+    {"TRACK",reco::PFBlockElement::TRACK},
+    {"PS1",reco::PFBlockElement::PS1},
+    {"PS2",reco::PFBlockElement::PS2},
+    {"ECAL",reco::PFBlockElement::ECAL},
+    {"HCAL",reco::PFBlockElement::HCAL},
+    {"GSF",reco::PFBlockElement::GSF},
+    {"BREM",reco::PFBlockElement::BREM},
+    {"HFEM",reco::PFBlockElement::HFEM},
+    {"HFHAD",reco::PFBlockElement::HFHAD},
+    {"SC",reco::PFBlockElement::SC},
+    {"HO",reco::PFBlockElement::HO},
+    {"HGCAL",reco::PFBlockElement::HGCAL}
+  };
+}
+
+class PFBlockQuickUnionComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit PFBlockQuickUnionComparator(const edm::ParameterSet&);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  typedef std::unique_ptr<reco::PFBlockElement> ElementPtr;
+
+  /// the blocks of the elements, as the former findBlocks built them,
+  /// and the indices of the elements of each block
+  void findBlocks(std::vector<ElementPtr>& elements, reco::PFBlockCollection& blocks,
+		  std::vector<std::vector<unsigned> >& members) const;
+
+  /// the former PFBlockAlgo::packLinks
+  void packLinks(reco::PFBlock& block,
+		 const LinkMap& links) const;
+
+  const BlockElementLinkerBase* linkTest(const reco::PFBlockElement& e1,
+					 const reco::PFBlockElement& e2) const {
+    return linkTests_[rowsize*std::max(e1.type(),e2.type())+std::min(e1.type(),e2.type())].get();
+  }
+
+  static constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
+
+  const edm::EDGetTokenT<reco::PFBlockCollection> blocks_;
+  std::vector<std::unique_ptr<BlockElementLinkerBase> > linkTests_;
+};
+
+PFBlockQuickUnionComparator::PFBlockQuickUnionComparator(const edm::ParameterSet& conf) :
+  blocks_(consumes<reco::PFBlockCollection>(conf.getParameter<edm::InputTag>("blocks"))),
+  linkTests_(rowsize*rowsize) {
+  // the KD-tree linkers have already filled the multilinks of the elements
+  for( const auto& linkConf : conf.getParameter<std::vector<edm::ParameterSet> >("linkDefinitions") ) {
+    const std::string& linkTypeStr = linkConf.getParameter<std::string>("linkType");
+    const size_t split = linkTypeStr.find(':');
+    const auto type1 = elementTypes.at(linkTypeStr.substr(0,split));
+    const auto type2 = elementTypes.at(linkTypeStr.substr(split+1));
+    linkTests_[rowsize*std::max(type1,type2)+std::min(type1,type2)].reset(
+      BlockElementLinkerFactory::get()->create(linkConf.getParameter<std::string>("linkerName"),linkConf));
+  }
+}
+
+void PFBlockQuickUnionComparator::findBlocks(std::vector<ElementPtr>& elements, 
+					     reco::PFBlockCollection& blocks,
+					     std::vector<std::vector<unsigned> >& members) const {
+  QuickUnion qu(elements.size());
+  const auto elem_size = elements.size();
+  for( unsigned i = 0; i < elem_size; ++i ) {
+    for( unsigned j = 0; j < elem_size; ++j ) {
+      if( qu.connected(i,j) || j == i ) continue;
+      const auto test = linkTest(*elements[i],*elements[j]);
+      if( !test ) continue;
+      if( test->linkPrefilter(elements[i].get(),elements[j].get()) ) {
+        const double dist = test->testLink(elements[i].get(),elements[j].get());
+        // compute linking info if it is possible
+        if( dist > -0.5 ) {
+          qu.unite(i,j);
+        }
+      }
+    }
+  }
+
+  std::unordered_multimap<unsigned,unsigned> blocksmap(elements.size());
+  std::vector<unsigned> keys;
+  keys.reserve(elements.size());
+  for( unsigned i = 0; i < elements.size(); ++i ) {
+    unsigned key = i; 
+    while( key != qu.find(key) ) key = qu.find(key); // make sure we always find the root node...
+    auto pos  = std::lower_bound(keys.begin(),keys.end(),key);
+    if( pos == keys.end() || *pos != key ) {
+      keys.insert(pos,key);      
+    }
+    blocksmap.emplace(key,i);
+  }
+
+  for( auto key : keys ) {
+    blocks.push_back( reco::PFBlock() );
+    members.emplace_back();
+    auto range = blocksmap.equal_range(key);
+    auto& the_block = blocks.back();
+    reco::PFBlockElement* p1(elements[range.first->second].get());
+    the_block.addElement(p1);
+    members.back().push_back(range.first->second);
+    LinkMap links;
+    auto itr = range.first;
+    ++itr;
+    for( ; itr != range.second; ++itr ) {
+      reco::PFBlockElement* p2(elements[itr->second].get());
+      the_block.addElement(p2);
+      members.back().push_back(itr->second);
+      const auto test = linkTest(*p1,*p2);
+      if( test ) {
+        links.emplace( std::make_pair(p1->index(), p2->index()), test->testLink(p1,p2) );
+      }
+    }
+    packLinks( the_block, links );    
+  }
+}
+
+void PFBlockQuickUnionComparator::packLinks(reco::PFBlock& block,
+					    const LinkMap& links) const {
+  const edm::OwnVector< reco::PFBlockElement >& els = block.elements();
+  
+  block.bookLinkData();
+  unsigned elsize = els.size();
+  for( unsigned i1=0; i1<elsize; ++i1 ) {
+    for( unsigned i2=0; i2<i1; ++i2 ) {
+      double dist = -1;
+      const auto link_itr = links.find(std::make_pair(i2,i1));
+      if( link_itr != links.end() ) {
+	dist = link_itr->second;
+      } else {
+        const auto test = linkTest(els[i1],els[i2]);
+        if( test && test->linkPrefilter(&(els[i1]),&(els[i2])) ) dist = test->testLink(&(els[i1]),&(els[i2]));
+      }
+      block.setLink( i1, i2, dist, block.linkData(), reco::PFBlock::LINKTEST_RECHIT );
+    }
+  }
+}
+
+void PFBlockQuickUnionComparator::analyze(edm::StreamID, 
+					  const edm::Event& e, 
+					  const edm::EventSetup&) const {
+  edm::Handle<reco::PFBlockCollection> actual;
+  e.getByToken(blocks_, actual);
+
+  // the elements of all the blocks, those of a block in the order in which
+  // they were imported, as findBlocks puts them in decreasing order
+  std::vector<ElementPtr> elements;
+  std::vector<std::pair<unsigned,unsigned> > origin; // block and index in it
+  for( unsigned b = 0; b < actual->size(); ++b ) {
+    const auto& els = (*actual)[b].elements();
+    for( unsigned k = els.size(); k-- > 0; ) {
+      elements.emplace_back(els[k].clone());
+      origin.emplace_back(b,k);
+    }
+  }
+
+  reco::PFBlockCollection expected;
+  std::vector<std::vector<unsigned> > expectedMembers;
+  findBlocks(elements, expected, expectedMembers);
+
+  if( expected.size() != actual->size() ) {
+    throw cms::Exception("PFBlockMismatch")
+      << "event " << e.id() << ": " << actual->size() 
+      << " blocks instead of " << expected.size() << std::endl;
+  }
+  for( unsigned b = 0; b < expected.size(); ++b ) {
+    const auto& exp = expected[b];
+    const auto& members = expectedMembers[b];
+    // the block that holds the elements, and their positions in it
+    const unsigned a = origin[members.front()].first;
+    const auto& act = (*actual)[a];
+    std::vector<unsigned> position(members.size());
+    for( unsigned k = 0; k < members.size(); ++k ) {
+      if( origin[members[k]].first != a || act.elements().size() != members.size() ) {
+        throw cms::Exception("PFBlockMismatch")
+          << "event " << e.id() << ": the " << members.size() << " elements of reference block " << b
+          << " are not those of block " << a << std::endl;
+      }
+      position[k] = origin[members[k]].second;
+    }
+    for( unsigned k1 = 0; k1 < members.size(); ++k1 ) {
+      for( unsigned k2 = 0; k2 < k1; ++k2 ) {
+        const double expDist = exp.dist(k1,k2,exp.linkData());
+        const double actDist = act.dist(position[k1],position[k2],act.linkData());
+        if( expDist != actDist ) {
+          throw cms::Exception("PFBlockMismatch")
+            << "event " << e.id() << ", block " << a << ": link between elements " 
+            << position[k1] << " and " << position[k2] << " of distance " << actDist 
+            << " instead of " << expDist << std::endl;
+        }
+      }
+    }
+  }
+}
+
+DEFINE_FWK_MODULE(PFBlockQuickUnionComparator);
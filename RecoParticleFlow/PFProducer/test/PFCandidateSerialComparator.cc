@@ -0,0 +1,64 @@
+//
+// Class: PFCandidateSerialComparator.cc
+//
+// Info: Checks that two collections of PFCandidates are identical, element
+//       by element and in the same order, e.g. the candidates of PFProducer
+//       with the blocks processed concurrently and one after the other.
+//       Throws on the first difference.
+//
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+
+class PFCandidateSerialComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit PFCandidateSerialComparator(const edm::ParameterSet&);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  const edm::EDGetTokenT<reco::PFCandidateCollection> expected_;
+  const edm::EDGetTokenT<reco::PFCandidateCollection> actual_;
+};
+
+PFCandidateSerialComparator::PFCandidateSerialComparator(const edm::ParameterSet& conf) :
+  expected_(consumes<reco::PFCandidateCollection>(conf.getParameter<edm::InputTag>("expected"))),
+  actual_(consumes<reco::PFCandidateCollection>(conf.getParameter<edm::InputTag>("actual"))) {
+}
+
+void PFCandidateSerialComparator::analyze(edm::StreamID, 
+					  const edm::Event& e, 
+					  const edm::EventSetup&) const {
+  edm::Handle<reco::PFCandidateCollection> expected, actual;
+  e.getByToken(expected_, expected);
+  e.getByToken(actual_, actual);
+
+  if( expected->size() != actual->size() ) {
+    throw cms::Exception("PFCandidateMismatch")
+      << "event " << e.id() << ": " << actual->size() 
+      << " candidates instead of " << expected->size() << std::endl;
+  }
+  for( unsigned i = 0; i < expected->size(); ++i ) {
+    const reco::PFCandidate& exp = (*expected)[i];
+    const reco::PFCandidate& act = (*actual)[i];
+    // both producers read the same blocks: the block references are equal
+    if( exp.particleId() != act.particleId() || exp.charge() != act.charge() ||
+	exp.p4() != act.p4() || exp.vertex() != act.vertex() ||
+	exp.rawEcalEnergy() != act.rawEcalEnergy() || 
+	exp.rawHcalEnergy() != act.rawHcalEnergy() ||
+	exp.elementsInBlocks() != act.elementsInBlocks() ) {
+      throw cms::Exception("PFCandidateMismatch")
+	<< "event " << e.id() << ", candidate " << i << ":\n" 
+	<< act << "\ninstead of\n" << exp << std::endl;
+    }
+  }
+}
+
+DEFINE_FWK_MODULE(PFCandidateSerialComparator);
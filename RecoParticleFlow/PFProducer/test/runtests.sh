@@ -0,0 +1,6 @@
+#!/bin/sh
+
+function die { echo $1: status $2 ;  exit $2; }
+
+cmsRun ${LOCAL_TEST_DIR}/testConcurrentPFBlocks_cfg.py || die 'Failure comparing the concurrent and serial processing of the PF blocks' $?
+cmsRun ${LOCAL_TEST_DIR}/testPFBlockQuickUnion_cfg.py || die 'Failure comparing the PF blocks with the sequential QuickUnion reference' $?
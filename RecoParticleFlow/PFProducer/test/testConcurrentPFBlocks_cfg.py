@@ -0,0 +1,42 @@
+# Runs the particle flow twice on a few QCD events, with the blocks
+# processed concurrently and one after the other, and checks that the
+# candidates are identical
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.StandardSequences.Eras import eras
+
+process = cms.Process('TESTPF',eras.Run2_2016)
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc', '')
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+        '/store/relval/CMSSW_9_0_0_pre2/RelValQCD_Pt_3000_3500_13/GEN-SIM-DIGI-RAW-HLTDEBUG/90X_mcRun2_asymptotic_v0-v1/10000/00242170-3BC2-E611-AC9F-0CC47A7C3628.root'
+    )
+)
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(5) )
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.particleFlowTmpSerial = process.particleFlowTmp.clone(
+    concurrentBlocks = False
+)
+process.pfCandidateSerialComparator = cms.EDAnalyzer("PFCandidateSerialComparator",
+    expected = cms.InputTag("particleFlowTmpSerial"),
+    actual = cms.InputTag("particleFlowTmp")
+)
+
+process.reconstruction_step = cms.Path(process.RawToDigi*process.reconstruction*process.particleFlowTmpSerial)
+process.comparison_step = cms.EndPath(process.pfCandidateSerialComparator)
+process.schedule = cms.Schedule(process.reconstruction_step,process.comparison_step)
@@ -0,0 +1,39 @@
+# Runs the particle flow block producer on a few QCD events and checks that
+# its blocks have the same elements and links as with the sequential
+# QuickUnion algorithm it used before
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.StandardSequences.Eras import eras
+
+process = cms.Process('TESTPF',eras.Run2_2016)
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc', '')
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+        '/store/relval/CMSSW_9_0_0_pre2/RelValQCD_Pt_3000_3500_13/GEN-SIM-DIGI-RAW-HLTDEBUG/90X_mcRun2_asymptotic_v0-v1/10000/00242170-3BC2-E611-AC9F-0CC47A7C3628.root'
+    )
+)
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(5) )
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.pfBlockQuickUnionComparator = cms.EDAnalyzer("PFBlockQuickUnionComparator",
+    blocks = cms.InputTag("particleFlowBlock"),
+    linkDefinitions = process.particleFlowBlock.linkDefinitions
+)
+
+process.reconstruction_step = cms.Path(process.RawToDigi*process.reconstruction)
+process.comparison_step = cms.EndPath(process.pfBlockQuickUnionComparator)
+process.schedule = cms.Schedule(process.reconstruction_step,process.comparison_step)
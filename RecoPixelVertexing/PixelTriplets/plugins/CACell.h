@@ -117,9 +117,11 @@ public:
   }
   
 
-  void checkAlignmentAndAct(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
+  // calls act(koc) for each cell koc of innerCells that is aligned with this one
+  template<typename Act>
+  void checkAlignmentAndAct(CAColl const & allCells, CAntuple const & innerCells, const float ptmin, const float region_origin_x,
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut, std::vector<CACell::CAntuplet> * foundTriplets) {
+			    const float phiCut, const float hardPtCut, Act && act) const {
     int ncells = innerCells.size();
     int constexpr VSIZE = 16;
     int ok[VSIZE];
@@ -127,7 +129,6 @@ public:
     float z1[VSIZE];
     auto ro = getOuterR();
     auto zo = getOuterZ();
-    unsigned int cellId = this - &allCells.front();
     auto loop = [&](int i, int vs) {
       for (int j=0;j<vs; ++j) {
 	auto koc = innerCells[i+j];
@@ -142,10 +143,7 @@ public:
 	auto & oc =  allCells[koc]; 
 	if (ok[j]&&haveSimilarCurvature(oc,ptmin, region_origin_x, region_origin_y,
 					region_origin_radius, phiCut, hardPtCut)) {
-	  if (foundTriplets) foundTriplets->emplace_back(CACell::CAntuplet{koc,cellId});
-	  else {
-	    oc.tagAsOuterNeighbor(cellId);
-	  }
+	  act(koc);
 	}
       }
     };
@@ -158,16 +156,18 @@ public:
   void checkAlignmentAndTag(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
 			    const float phiCut, const float hardPtCut) {
+    unsigned int cellId = this - &allCells.front();
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, nullptr);
+			 phiCut, hardPtCut, [&](unsigned int koc) { allCells[koc].tagAsOuterNeighbor(cellId); });
     
   }
   void checkAlignmentAndPushTriplet(CAColl& allCells, CAntuple & innerCells, std::vector<CACell::CAntuplet>& foundTriplets,
 				    const float ptmin, const float region_origin_x, const float region_origin_y,
 				    const float region_origin_radius, const float thetaCut, const float phiCut,
 				    const float hardPtCut) {
+    unsigned int cellId = this - &allCells.front();
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, &foundTriplets);
+			 phiCut, hardPtCut, [&](unsigned int koc) { foundTriplets.emplace_back(CACell::CAntuplet{koc,cellId}); });
   }
   
   
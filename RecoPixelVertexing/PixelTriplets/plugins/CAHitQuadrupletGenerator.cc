@@ -43,7 +43,8 @@ fitFastCircleChi2Cut(cfg.getParameter<bool>("fitFastCircleChi2Cut")),
 useBendingCorrection(cfg.getParameter<bool>("useBendingCorrection")),
 caThetaCut(cfg.getParameter<double>("CAThetaCut")),
 caPhiCut(cfg.getParameter<double>("CAPhiCut")),
-caHardPtCut(cfg.getParameter<double>("CAHardPtCut"))
+caHardPtCut(cfg.getParameter<double>("CAHardPtCut")),
+caParallel(cfg.getUntrackedParameter<bool>("CAParallel", false))
 {
   edm::ParameterSet comparitorPSet = cfg.getParameter<edm::ParameterSet>("SeedComparitorPSet");
   std::string comparitorName = comparitorPSet.getParameter<std::string>("ComponentName");
@@ -61,6 +62,7 @@ void CAHitQuadrupletGenerator::fillDescriptions(edm::ParameterSetDescription& de
   desc.add<double>("CAThetaCut", 0.00125);
   desc.add<double>("CAPhiCut", 10);
   desc.add<double>("CAHardPtCut", 0);
+  desc.addUntracked<bool>("CAParallel", false)->setComment("Connect the cells, evolve the automaton and find the ntuplets with TBB tasks. Gives the same quadruplets.");
   desc.addOptional<bool>("CAOnlyOneLastHitPerLayerFilter")->setComment("Deprecated and has no effect. To be fully removed later when the parameter is no longer used in HLT configurations.");
   edm::ParameterSetDescription descMaxChi2;
   descMaxChi2.add<double>("pt1", 0.2);
@@ -207,12 +209,24 @@ void CAHitQuadrupletGenerator::hitNtuplets(const IntermediateHitDoublets& region
 
 	CellularAutomaton ca(g);
 
-	ca.createAndConnectCells(hitDoublets, region, caThetaCut,
-			caPhiCut, caHardPtCut);
+	if (caParallel)
+	{
+		ca.createAndConnectCellsParallel(hitDoublets, region, caThetaCut,
+				caPhiCut, caHardPtCut);
+
+		ca.evolveParallel(numberOfHitsInNtuplet);
+
+		ca.findNtupletsParallel(foundQuadruplets, numberOfHitsInNtuplet);
+	}
+	else
+	{
+		ca.createAndConnectCells(hitDoublets, region, caThetaCut,
+				caPhiCut, caHardPtCut);
 
-	ca.evolve(numberOfHitsInNtuplet);
+		ca.evolve(numberOfHitsInNtuplet);
 
-	ca.findNtuplets(foundQuadruplets, numberOfHitsInNtuplet);
+		ca.findNtuplets(foundQuadruplets, numberOfHitsInNtuplet);
+	}
 
 	auto & allCells = ca.getAllCells();
 	
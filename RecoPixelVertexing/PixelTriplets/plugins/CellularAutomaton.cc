@@ -1,6 +1,17 @@
 #include "CellularAutomaton.h"
 
 #include<queue>
+#include<algorithm>
+#include<iterator>
+
+#include "tbb/parallel_for.h"
+
+namespace {
+  // cells connected or evolved by one task of the parallel mode
+  constexpr unsigned int cellsPerTask = 256;
+  // root cells followed by one task of findNtupletsParallel
+  constexpr unsigned int rootCellsPerTask = 32;
+}
 
 
 void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
@@ -263,3 +274,213 @@ void CellularAutomaton::findTriplets(const std::vector<const HitDoublets*>& hitD
 	}
 
 }
+
+
+// the layer pairs in the order in which createAndConnectCells visits them:
+// a layer pair comes after all the layer pairs ending on its inner layer
+std::vector<int> CellularAutomaton::layerPairsInVisitOrder() const
+{
+	std::vector<int> visitOrder;
+	std::vector<bool> alreadyVisitedLayerPairs(theLayerGraph.theLayerPairs.size(), false);
+	for (int rootVertex : theLayerGraph.theRootLayers)
+	{
+		std::queue<int> LayerPairsToVisit;
+		for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs)
+		{
+			LayerPairsToVisit.push(LayerPair);
+		}
+
+		while (!LayerPairsToVisit.empty())
+		{
+			auto currentLayerPair = LayerPairsToVisit.front();
+			auto & currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
+			auto & currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
+			auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
+			bool allInnerLayerPairsAlreadyVisited	{ true };
+
+			for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs)
+			{
+				allInnerLayerPairsAlreadyVisited &=
+						alreadyVisitedLayerPairs[innerLayerPair];
+			}
+
+			if (alreadyVisitedLayerPairs[currentLayerPair] == false
+					&& allInnerLayerPairsAlreadyVisited)
+			{
+				visitOrder.push_back(currentLayerPair);
+				for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs)
+				{
+					LayerPairsToVisit.push(outerLayerPair);
+				}
+				alreadyVisitedLayerPairs[currentLayerPair] = true;
+			}
+			LayerPairsToVisit.pop();
+		}
+	}
+	return visitOrder;
+}
+
+void CellularAutomaton::createAndConnectCellsParallel(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
+		const float thetaCut, const float phiCut, const float hardPtCut)
+{
+	int tsize=0;
+	for ( auto hd :  hitDoublets) tsize+=hd->size();
+	allCells.reserve(tsize);
+	unsigned int cellId = 0;
+	float ptmin = region.ptMin();
+	float region_origin_x = region.origin().x();
+	float region_origin_y = region.origin().y();
+	float region_origin_radius = region.originRBound();
+
+	// create all the cells first, with the ids given by createAndConnectCells,
+	// so that isOuterHitOfCell is complete and read-only while connecting them
+	struct ConnectTask { int layerPair; unsigned int begin, end; };
+	std::vector<ConnectTask> tasks;
+	for (auto currentLayerPair : layerPairsInVisitOrder())
+	{
+		auto & currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
+		auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
+		const HitDoublets* doubletLayerPairId = hitDoublets[currentLayerPair];
+		auto numberOfDoublets = doubletLayerPairId->size();
+		currentLayerPairRef.theFoundCells[0] = cellId;
+		currentLayerPairRef.theFoundCells[1] = cellId+numberOfDoublets;
+		for (unsigned int i = 0; i < numberOfDoublets; ++i)
+		{
+			allCells.emplace_back(doubletLayerPairId, i,
+					      doubletLayerPairId->innerHitId(i),
+					      doubletLayerPairId->outerHitId(i));
+			currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
+			cellId++;
+		}
+		for (auto begin = currentLayerPairRef.theFoundCells[0]; begin < cellId; begin += cellsPerTask)
+		{
+			tasks.push_back(ConnectTask{currentLayerPair, begin, std::min(begin + cellsPerTask, cellId)});
+		}
+	}
+
+	// each task finds the compatible inner neighbors of its cells, as (inner neighbor, cell) in increasing cell order
+	std::vector<std::vector<std::pair<unsigned int, unsigned int> > > links(tasks.size());
+	tbb::parallel_for(0UL, tasks.size(), 1UL, [&](unsigned long t) {
+		auto const & task = tasks[t];
+		auto const & layerPair = theLayerGraph.theLayerPairs[task.layerPair];
+		auto const & innerLayer = theLayerGraph.theLayers[layerPair.theLayers[0]];
+		const HitDoublets* doublets = hitDoublets[task.layerPair];
+		auto & taskLinks = links[t];
+		for (auto i = task.begin; i < task.end; ++i)
+		{
+			auto const & neigCells = innerLayer.isOuterHitOfCell[doublets->innerHitId(i - layerPair.theFoundCells[0])];
+			allCells[i].checkAlignmentAndAct(allCells, neigCells, ptmin, region_origin_x,
+							 region_origin_y, region_origin_radius, thetaCut,
+							 phiCut, hardPtCut,
+							 [&](unsigned int koc) { taskLinks.emplace_back(koc, i); });
+		}
+	});
+
+	// the outer neighbors of each cell, in the order in which checkAlignmentAndTag tags them
+	theOuterNeighborsOffset.assign(allCells.size() + 1, 0);
+	for (auto const & taskLinks : links)
+		for (auto const & link : taskLinks) ++theOuterNeighborsOffset[link.first + 1];
+	for (unsigned int i = 0; i < allCells.size(); ++i)
+		theOuterNeighborsOffset[i + 1] += theOuterNeighborsOffset[i];
+	theOuterNeighbors.resize(theOuterNeighborsOffset.back());
+	std::vector<unsigned int> next(theOuterNeighborsOffset.begin(), theOuterNeighborsOffset.end() - 1);
+	for (auto const & taskLinks : links)
+		for (auto const & link : taskLinks) theOuterNeighbors[next[link.first]++] = link.second;
+}
+
+void CellularAutomaton::evolveParallel(const unsigned int minHitsPerNtuplet)
+{
+  allStatus.resize(allCells.size());
+
+  // as CACell::evolve: each cell only writes its own status
+  auto evolveCell = [&](unsigned int i) {
+    auto & status = allStatus[i];
+    status.hasSameStateNeighbors = 0;
+    for (auto j = theOuterNeighborsOffset[i]; j < theOuterNeighborsOffset[i + 1]; ++j)
+      {
+	if (allStatus[theOuterNeighbors[j]].getCAState() == status.getCAState())
+	  {
+	    status.hasSameStateNeighbors = 1;
+	    break;
+	  }
+      }
+  };
+  unsigned long numberOfTasks = (allCells.size() + cellsPerTask - 1) / cellsPerTask;
+
+  unsigned int numberOfIterations = minHitsPerNtuplet - 2;
+  // keeping the last iteration for later
+  for (unsigned int iteration = 0; iteration < numberOfIterations - 1;
+       ++iteration)
+    {
+      tbb::parallel_for(0UL, numberOfTasks, 1UL, [&](unsigned long t) {
+	  auto end = std::min<unsigned int>((t + 1) * cellsPerTask, allCells.size());
+	  for (unsigned int i = t * cellsPerTask; i < end; ++i) evolveCell(i);
+	});
+      tbb::parallel_for(0UL, numberOfTasks, 1UL, [&](unsigned long t) {
+	  auto end = std::min<unsigned int>((t + 1) * cellsPerTask, allCells.size());
+	  for (unsigned int i = t * cellsPerTask; i < end; ++i) allStatus[i].updateState();
+	});
+    }
+
+  //last iteration, serially as in evolve: it updates the state of each root cell right away
+  for(int rootLayerId : theLayerGraph.theRootLayers)
+    {
+      for(int rootLayerPair: theLayerGraph.theLayers[rootLayerId].theOuterLayerPairs)
+	{
+	  auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
+	  for (auto i =foundCells[0]; i<foundCells[1]; ++i)
+	    {
+	      auto & cell =  allStatus[i];
+	      evolveCell(i);
+	      cell.updateState();
+	      if (cell.isRootCell(minHitsPerNtuplet - 2))
+		{
+		  theRootCells.push_back(i);
+		}
+	    }
+	}
+    }
+}
+
+void CellularAutomaton::findNtupletsFrom(unsigned int cell,
+		std::vector<CACell::CAntuplet>& foundNtuplets,
+		CACell::CAntuplet& tmpNtuplet, const unsigned int minHitsPerNtuplet) const
+{
+	// as CACell::findNtuplets, with the flat neighbor lists
+	if (tmpNtuplet.size() == minHitsPerNtuplet - 1)
+	{
+		foundNtuplets.push_back(tmpNtuplet);
+	}
+	else
+	{
+		for (auto j = theOuterNeighborsOffset[cell]; j < theOuterNeighborsOffset[cell + 1]; ++j)
+		{
+			tmpNtuplet.push_back(theOuterNeighbors[j]);
+			findNtupletsFrom(theOuterNeighbors[j], foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+			tmpNtuplet.pop_back();
+		}
+	}
+}
+
+void CellularAutomaton::findNtupletsParallel(
+		std::vector<CACell::CAntuplet>& foundNtuplets,
+		const unsigned int minHitsPerNtuplet)
+{
+	// each task follows a range of root cells into its own output, concatenated in the order of the root cells
+	unsigned long numberOfTasks = (theRootCells.size() + rootCellsPerTask - 1) / rootCellsPerTask;
+	std::vector<std::vector<CACell::CAntuplet> > found(numberOfTasks);
+	tbb::parallel_for(0UL, numberOfTasks, 1UL, [&](unsigned long t) {
+		CACell::CAntuple tmpNtuplet;
+		tmpNtuplet.reserve(minHitsPerNtuplet);
+		auto end = std::min<unsigned int>((t + 1) * rootCellsPerTask, theRootCells.size());
+		for (unsigned int r = t * rootCellsPerTask; r < end; ++r)
+		{
+			tmpNtuplet.clear();
+			tmpNtuplet.push_back(theRootCells[r]);
+			findNtupletsFrom(theRootCells[r], found[t], tmpNtuplet, minHitsPerNtuplet);
+		}
+	});
+
+	for (auto & ntuplets : found)
+		std::move(ntuplets.begin(), ntuplets.end(), std::back_inserter(foundNtuplets));
+}
@@ -23,8 +23,18 @@ public:
   void findNtuplets(std::vector<CACell::CAntuplet>&, const unsigned int);
   void findTriplets(const std::vector<const HitDoublets*>& hitDoublets,std::vector<CACell::CAntuplet>& foundTriplets, const TrackingRegion& region,
 		    const float thetaCut, const float phiCut, const float hardPtCut);
+
+  // data-parallel versions of createAndConnectCells, evolve and findNtuplets, giving the same ntuplets in the same order.
+  // The outer neighbors of the cells are kept in flat arrays, indexed by cell id, instead of in the cells.
+  void createAndConnectCellsParallel(const std::vector<const HitDoublets *>&,
+				     const TrackingRegion&, const float, const float, const float);
+  void evolveParallel(const unsigned int);
+  void findNtupletsParallel(std::vector<CACell::CAntuplet>&, const unsigned int);
   
 private:
+  std::vector<int> layerPairsInVisitOrder() const;
+  void findNtupletsFrom(unsigned int, std::vector<CACell::CAntuplet>&, CACell::CAntuplet&, const unsigned int) const;
+
   CAGraph & theLayerGraph;
 
   std::vector<CACell> allCells;
@@ -32,6 +42,10 @@ private:
 
   std::vector<unsigned int> theRootCells;
   std::vector<std::vector<CACell*> > theNtuplets;
+
+  // parallel mode: the outer neighbors of cell i are theOuterNeighbors[theOuterNeighborsOffset[i] .. theOuterNeighborsOffset[i+1]-1]
+  std::vector<unsigned int> theOuterNeighborsOffset;
+  std::vector<unsigned int> theOuterNeighbors;
   
 };
 
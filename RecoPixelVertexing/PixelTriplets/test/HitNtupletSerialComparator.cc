@@ -0,0 +1,71 @@
+//
+// Class: HitNtupletSerialComparator.cc
+//
+// Info: Checks that two hit ntuplet producers give identical outputs,
+//       region by region and ntuplet by ntuplet in the same order, e.g.
+//       with the cellular automaton run with and without CAParallel.
+//       Throws on the first difference.
+//
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "RecoTracker/TkHitPairs/interface/RegionsSeedingHitSets.h"
+
+class HitNtupletSerialComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit HitNtupletSerialComparator(const edm::ParameterSet&);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  const edm::EDGetTokenT<RegionsSeedingHitSets> expectedToken_;
+  const edm::EDGetTokenT<RegionsSeedingHitSets> actualToken_;
+};
+
+HitNtupletSerialComparator::HitNtupletSerialComparator(const edm::ParameterSet& conf) :
+  expectedToken_(consumes<RegionsSeedingHitSets>(conf.getParameter<edm::InputTag>("expected"))),
+  actualToken_(consumes<RegionsSeedingHitSets>(conf.getParameter<edm::InputTag>("actual"))) {
+}
+
+void HitNtupletSerialComparator::analyze(edm::StreamID, const edm::Event& e, const edm::EventSetup&) const {
+  edm::Handle<RegionsSeedingHitSets> expected, actual;
+  e.getByToken(expectedToken_, expected);
+  e.getByToken(actualToken_, actual);
+
+  if (expected->regionSize() != actual->regionSize() || expected->size() != actual->size()) {
+    throw cms::Exception("HitNtupletMismatch")
+      << "event " << e.id() << ": " << actual->size() << " ntuplets in " << actual->regionSize()
+      << " regions instead of " << expected->size() << " in " << expected->regionSize();
+  }
+  // both producers read the same doublets, so the regions and the hits are the same objects
+  unsigned int region = 0;
+  for (auto expIt = expected->begin(), actIt = actual->begin(); expIt != expected->end(); ++expIt, ++actIt, ++region) {
+    auto exp = *expIt;
+    auto act = *actIt;
+    auto expSize = exp.end() - exp.begin();
+    auto actSize = act.end() - act.begin();
+    if (&exp.region() != &act.region() || expSize != actSize) {
+      throw cms::Exception("HitNtupletMismatch")
+        << "event " << e.id() << ": region " << region << " has " << actSize << " ntuplets instead of " << expSize;
+    }
+    auto actHits = act.begin();
+    unsigned int ntuplet = 0;
+    for (auto const& expHits : exp) {
+      bool same = expHits.size() == actHits->size();
+      for (unsigned int i = 0; same && i < expHits.size(); ++i) same = expHits[i] == (*actHits)[i];
+      if (!same) {
+        throw cms::Exception("HitNtupletMismatch")
+          << "event " << e.id() << ": region " << region << " ntuplet " << ntuplet << " differs";
+      }
+      ++actHits;
+      ++ntuplet;
+    }
+  }
+}
+
+DEFINE_FWK_MODULE(HitNtupletSerialComparator);
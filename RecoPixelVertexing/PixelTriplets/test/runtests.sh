@@ -0,0 +1,5 @@
+#!/bin/sh
+
+function die { echo $1: status $2 ;  exit $2; }
+
+cmsRun ${LOCAL_TEST_DIR}/testCAParallel_cfg.py || die 'Failure comparing the quadruplets of the parallel and serial cellular automaton' $?
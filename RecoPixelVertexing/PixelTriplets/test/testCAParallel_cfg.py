@@ -0,0 +1,52 @@
+# Runs the quadruplet cellular automaton of the initial and low pt quad
+# steps twice on a few phase 1 events, with and without CAParallel, and
+# checks that the quadruplets are identical and in the same order
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.StandardSequences.Eras import eras
+
+process = cms.Process('TESTCA',eras.Run2_2017)
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2017_realistic', '')
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+        '/store/relval/CMSSW_9_4_0_pre1/RelValSingleMuPt100/GEN-SIM-DIGI-RAW/93X_mc2017_realistic_v3-v1/00000/409345CD-F79C-E711-8383-0CC47A4D76C8.root'
+    )
+)
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(10) )
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+
+process.initialStepHitQuadrupletsParallel = process.initialStepHitQuadruplets.clone(
+    CAParallel = cms.untracked.bool(True)
+)
+process.lowPtQuadStepHitQuadrupletsParallel = process.lowPtQuadStepHitQuadruplets.clone(
+    CAParallel = cms.untracked.bool(True)
+)
+process.initialStepHitNtupletComparator = cms.EDAnalyzer("HitNtupletSerialComparator",
+    expected = cms.InputTag("initialStepHitQuadruplets"),
+    actual = cms.InputTag("initialStepHitQuadrupletsParallel")
+)
+process.lowPtQuadStepHitNtupletComparator = cms.EDAnalyzer("HitNtupletSerialComparator",
+    expected = cms.InputTag("lowPtQuadStepHitQuadruplets"),
+    actual = cms.InputTag("lowPtQuadStepHitQuadrupletsParallel")
+)
+
+process.reconstruction_step = cms.Path(process.RawToDigi*process.reconstruction*
+                                       process.initialStepHitQuadrupletsParallel*
+                                       process.lowPtQuadStepHitQuadrupletsParallel)
+process.comparison_step = cms.EndPath(process.initialStepHitNtupletComparator*
+                                      process.lowPtQuadStepHitNtupletComparator)
+process.schedule = cms.Schedule(process.reconstruction_step,process.comparison_step)
@@ -71,6 +71,12 @@ namespace cms
     RedundantSeedCleaner*  theSeedCleaner;
 
     unsigned int maxSeedsBeforeCleaning_;
+
+    // build the seeds in parallel TBB tasks; same result as the serial loop
+    bool parallelSeeds_;
+
+    // allocate the states, measurements and cloned hits from the thread-local pools (PoolAllocator.h)
+    bool usePoolAllocator_;
     
     edm::EDGetTokenT<edm::View<TrajectorySeed> >  theSeedLabel;
     edm::EDGetTokenT<MeasurementTrackerEvent>     theMTELabel;
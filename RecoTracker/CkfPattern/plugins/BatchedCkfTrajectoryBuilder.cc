@@ -0,0 +1,166 @@
+#include "BatchedCkfTrajectoryBuilder.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <algorithm>
+
+#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "TrackingTools/KalmanUpdators/interface/KFBatchUpdator.h"
+
+#include "RecoTracker/CkfPattern/src/RecHitIsInvalid.h"
+#include "RecoTracker/CkfPattern/interface/IntermediateTrajectoryCleaner.h"
+#include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
+
+namespace {
+
+  // reused across seeds to keep the allocated memory
+  thread_local KFBatchUpdator batch_;
+
+  // measurements of one candidate, and the index in batch_ of the updated state of each valid hit
+  struct CandidateMeasurements {
+    std::vector<TrajectoryMeasurement> meas;
+    std::vector<TrajectoryMeasurement>::iterator last;
+    std::vector<unsigned int> updated;
+  };
+
+  thread_local std::vector<CandidateMeasurements> work_;
+
+}
+
+BatchedCkfTrajectoryBuilder::BatchedCkfTrajectoryBuilder(const edm::ParameterSet& conf, edm::ConsumesCollector& iC):
+  CkfTrajectoryBuilder(conf, iC)
+{}
+
+TempTrajectory BatchedCkfTrajectoryBuilder::buildTrajectories (const TrajectorySeed&seed,
+							       TrajectoryContainer &result,
+							       unsigned int& nCandPerSeed,
+							       const TrajectoryFilter*) const {
+  if (theMeasurementTracker == nullptr) {
+      throw cms::Exception("LogicError") << "Asking to create trajectories to an un-initialized BatchedCkfTrajectoryBuilder.\nYou have to call clone(const MeasurementTrackerEvent *data) and then call trajectories on it instead.\n";
+  }
+
+  TempTrajectory && startingTraj = createStartingTrajectory( seed );
+
+  if (dynamic_cast<const KFUpdator*>(theUpdator) == nullptr) {
+    nCandPerSeed = limitedCandidates(seed, startingTraj, result);
+    return startingTraj;
+  }
+
+  TempTrajectoryContainer candidates;
+  candidates.push_back( startingTraj);
+  boost::shared_ptr<const TrajectorySeed>  sharedSeed(new TrajectorySeed(seed));
+  nCandPerSeed = batchedCandidates(sharedSeed, candidates, result);
+
+  return startingTraj;
+}
+
+unsigned int BatchedCkfTrajectoryBuilder::
+batchedCandidates(const boost::shared_ptr<const TrajectorySeed> & sharedSeed, TempTrajectoryContainer &candidates,
+		  TrajectoryContainer& result) const
+{
+  unsigned int nIter=1;
+  unsigned int nCands=0; // ignore startingTraj
+  unsigned int prevNewCandSize=0;
+  TempTrajectoryContainer newCand;
+  newCand.reserve(2*theMaxCand);
+
+  auto trajCandLess = [&](TempTrajectory const & a, TempTrajectory const & b) {
+    return  (a.chiSquared() + a.lostHits()*theLostHitPenalty)  <
+    (b.chiSquared() + b.lostHits()*theLostHitPenalty);
+  };
+
+  while ( !candidates.empty()) {
+
+    // first pass: measurements of all the candidates, and queue the updates
+    batch_.clear();
+    if (work_.size() < candidates.size()) work_.resize(candidates.size());
+    auto nCandidates = candidates.size();
+    bool stop = false;
+    for (unsigned int ic = 0; ic != candidates.size(); ++ic) {
+      auto & traj = candidates[ic];
+      auto & cm = work_[ic];
+      cm.meas.clear();
+      cm.updated.clear();
+      findCompatibleMeasurements(*sharedSeed, traj, cm.meas);
+
+      // --- method for debugging
+      if(!analyzeMeasurementsDebugger(traj,cm.meas,
+				      theMeasurementTracker,
+				      forwardPropagator(*sharedSeed),theEstimator,
+				      theTTRHBuilder)) {
+	nCandidates = ic;
+	stop = true;
+	break;
+      }
+      // ---
+
+      if ( cm.meas.empty()) continue;
+      if ( theAlwaysUseInvalidHits) cm.last = cm.meas.end();
+      else {
+	if (cm.meas.front().recHit()->isValid()) {
+	  cm.last = find_if( cm.meas.begin(), cm.meas.end(), RecHitIsInvalid());
+	}
+	else cm.last = cm.meas.end();
+      }
+      for(auto itm = cm.meas.begin(); itm != cm.last; itm++) {
+	if (itm->recHit()->isValid())
+	  cm.updated.push_back(batch_.add(itm->predictedState(), *itm->recHit()));
+      }
+    }
+
+    batch_.update();
+
+    // second pass: build and trim the new candidates as CkfTrajectoryBuilder::limitedCandidates does
+    newCand.clear();
+    for (unsigned int ic = 0; ic != nCandidates; ++ic) {
+      auto & traj = candidates[ic];
+      auto & cm = work_[ic];
+
+      if ( cm.meas.empty()) {
+	addToResult(sharedSeed, traj, result);
+      }
+      else {
+	auto updated = cm.updated.begin();
+	for(auto itm = cm.meas.begin(); itm != cm.last; itm++) {
+	  TempTrajectory newTraj = traj;
+	  auto && predictedState = itm->predictedState();
+	  auto && hit = itm->recHit();
+	  if ( hit->isValid()) {
+	    newTraj.emplace( std::move(predictedState), std::move(batch_.state(*updated++)),
+			     std::move(hit), itm->estimate(), itm->layer());
+	  }
+	  else {
+	    newTraj.emplace( std::move(predictedState), std::move(hit), 0, itm->layer());
+	  }
+
+	  if ( toBeContinued(newTraj)) {
+	    newCand.push_back(std::move(newTraj));  std::push_heap(newCand.begin(),newCand.end(),trajCandLess);
+	  }
+	  else {
+	    addToResult(sharedSeed, newTraj, result);
+	  }
+	}
+      }
+
+      nCands += newCand.size() - prevNewCandSize;
+      prevNewCandSize = newCand.size();
+
+      while ((int)newCand.size() > theMaxCand) {
+	std::pop_heap(newCand.begin(),newCand.end(),trajCandLess);
+	newCand.pop_back();
+      }
+    }
+    if (stop) return nCands;
+
+    std::sort_heap(newCand.begin(),newCand.end(),trajCandLess);
+    if (theIntermediateCleaning) IntermediateTrajectoryCleaner::clean(newCand);
+
+    candidates.swap(newCand);
+
+    LogDebug("CkfPattern") <<result.size()<<" candidates after "<<nIter++<<" batched CKF iteration: \n"
+			   <<PrintoutHelper::dumpCandidates(result)
+			   <<"\n "<<candidates.size()<<" running candidates are: \n"
+			   <<PrintoutHelper::dumpCandidates(candidates);
+  }
+  return nCands;
+}
@@ -0,0 +1,39 @@
+#ifndef BatchedCkfTrajectoryBuilder_H
+#define BatchedCkfTrajectoryBuilder_H
+
+#include "RecoTracker/CkfPattern/interface/CkfTrajectoryBuilder.h"
+
+#include "FWCore/Utilities/interface/Visibility.h"
+
+/** Same combinatorial search as CkfTrajectoryBuilder, with the Kalman
+ *  updates of each iteration done together.
+ *
+ *  At each iteration the compatible measurements of all the running
+ *  candidates are found first; the predicted states of all the valid
+ *  hits that would be used are then updated at once by a KFBatchUpdator,
+ *  and the new candidates are built and trimmed in the same order as in
+ *  CkfTrajectoryBuilder, so that the two builders return the same
+ *  trajectories up to the rounding of the update.
+ *  If the configured updator is not a KFUpdator the candidates are
+ *  built by CkfTrajectoryBuilder.
+ */
+
+class dso_internal BatchedCkfTrajectoryBuilder final : public CkfTrajectoryBuilder {
+
+public:
+
+  BatchedCkfTrajectoryBuilder(const edm::ParameterSet& conf, edm::ConsumesCollector& iC);
+
+  ~BatchedCkfTrajectoryBuilder() override {}
+
+  TempTrajectory buildTrajectories (const TrajectorySeed&,
+				    TrajectoryContainer &ret,
+				    unsigned int& nCandPerSeed,
+				    const TrajectoryFilter*) const override;
+
+private:
+
+  unsigned int batchedCandidates(const boost::shared_ptr<const TrajectorySeed> & sharedSeed, TempTrajectoryContainer &candidates, TrajectoryContainer& result) const;
+};
+
+#endif
@@ -18,6 +18,8 @@ DEFINE_FWK_MODULE(CkfTrajectoryMaker);
 #include "RecoTracker/CkfPattern/interface/BaseCkfTrajectoryBuilderFactory.h"
 #include "RecoTracker/CkfPattern/interface/CkfTrajectoryBuilder.h"
 #include "GroupedCkfTrajectoryBuilder.h"
+#include "BatchedCkfTrajectoryBuilder.h"
 
 DEFINE_EDM_PLUGIN(BaseCkfTrajectoryBuilderFactory, CkfTrajectoryBuilder, "CkfTrajectoryBuilder");
 DEFINE_EDM_PLUGIN(BaseCkfTrajectoryBuilderFactory, GroupedCkfTrajectoryBuilder, "GroupedCkfTrajectoryBuilder");
+DEFINE_EDM_PLUGIN(BaseCkfTrajectoryBuilderFactory, BatchedCkfTrajectoryBuilder, "BatchedCkfTrajectoryBuilder");
@@ -0,0 +1,7 @@
+import FWCore.ParameterSet.Config as cms
+
+# same search as CkfTrajectoryBuilder, with the Kalman updates of each iteration done together
+from RecoTracker.CkfPattern.CkfTrajectoryBuilder_cfi import CkfTrajectoryBuilder as _CkfTrajectoryBuilder
+BatchedCkfTrajectoryBuilder = _CkfTrajectoryBuilder.clone(
+    ComponentType = 'BatchedCkfTrajectoryBuilder'
+)
@@ -16,6 +16,12 @@ ckfTrackCandidates = cms.EDProducer("CkfTrackCandidateMaker",
 #    SeedLabel = cms.string(''),
     maxNSeeds = cms.uint32(500000),
     maxSeedsBeforeCleaning = cms.uint32(5000),
+# Build the seeds of an event in parallel (same result as the serial loop).
+# Costs extra CPU, as the seeds the RedundantSeedCleaner kills are built too,
+# and extra memory, as the trajectories of all the seeds are kept until stored.
+#    parallelSeeds = cms.untracked.bool(False),
+# Allocate the states, measurements and cloned hits from thread-local pools
+#    usePoolAllocator = cms.untracked.bool(False),
 # SeedProducer:SeedLabel descoped to src
     src = cms.InputTag('globalMixedSeeds'),                                  
     SimpleMagneticField = cms.string(''),                                    
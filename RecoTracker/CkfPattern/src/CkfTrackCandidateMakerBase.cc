@@ -16,6 +16,7 @@
 #include "TrackingTools/TrajectoryCleaning/interface/TrajectoryCleanerBySharedHits.h"
 #include "TrackingTools/Records/interface/TrackingComponentsRecord.h"
 #include "TrackingTools/TrajectoryState/interface/TrajectoryStateTransform.h"
+#include "TrackingTools/TrajectoryState/interface/PoolAllocator.h"
 
 #include "RecoTracker/CkfPattern/interface/CkfTrackCandidateMakerBase.h"
 #include "RecoTracker/CkfPattern/interface/TransientInitialStateEstimator.h"
@@ -41,9 +42,7 @@
 // #define VI_TBB
 
 #include <thread>
-#ifdef VI_TBB
 #include "tbb/parallel_for.h"
-#endif
 
 #include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
 
@@ -54,6 +53,9 @@ namespace {
   BaseCkfTrajectoryBuilder *createBaseCkfTrajectoryBuilder(const edm::ParameterSet& pset, edm::ConsumesCollector& iC) {
     return BaseCkfTrajectoryBuilderFactory::get()->create(pset.getParameter<std::string>("ComponentType"), pset, iC);
   }
+
+  // consecutive seeds built by one task with parallelSeeds
+  constexpr size_t seedsPerChunk = 8;
 }
 
 namespace cms{
@@ -74,6 +76,8 @@ namespace cms{
     theNavigationSchool(nullptr),
     theSeedCleaner(nullptr),
     maxSeedsBeforeCleaning_(0),
+    parallelSeeds_(conf.getUntrackedParameter<bool>("parallelSeeds", false)),
+    usePoolAllocator_(conf.getUntrackedParameter<bool>("usePoolAllocator", false)),
     theMTELabel(iC.consumes<MeasurementTrackerEvent>(conf.getParameter<edm::InputTag>("MeasurementTrackerEvent"))),
     skipClusters_(false),
     phase2skipClusters_(false)
@@ -152,6 +156,11 @@ namespace cms{
     // getting objects from the EventSetup
     setEventSetup( es );
 
+    // the states, measurements and hits of this event come from the pools of this thread if
+    // usePoolAllocator; the memory of what did not end up in the event is given back at the end
+    poolAllocator::Scope pools(usePoolAllocator_);
+    auto poolAllocations = poolAllocator::threadStats().allocations;
+
     // set the correct navigation
     // NavigationSetter setter( *theNavigationSchool);
 
@@ -267,38 +276,27 @@ namespace cms{
 #endif
 
       std::atomic<unsigned int> ntseed(0);
-      auto theLoop = [&](size_t ii) {
-        auto j = indeces[ii];
-
-        ntseed++;
-
-        // to be moved inside a par section (how with tbb??)
-        std::vector<Trajectory> theTmpTrajectories;
 
-
-	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
-
-        { Lock lock(theMutex);
-	// Check if seed hits already used by another track
+      // Check if seed hits already used by another track
+      auto seedIsGood = [&](unsigned int j) {
+        Lock lock(theMutex);
 	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
           LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
           (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
-          return;  // from the lambda!
-        }}
+          return false;
+        }
+        return true;
+      };
 
+      // Build the trajectories of seed j: does not depend on the other seeds.
+      // Returns NOT_STOPPED if the valid trajectories left in theTmpTrajectories are to be stored.
+      auto buildSeed = [&](unsigned int j, std::vector<Trajectory> & theTmpTrajectories, unsigned int & nCandPerSeed) {
 
 	// Build trajectory from seed outwards
         theTmpTrajectories.clear();
-        unsigned int nCandPerSeed = 0;
+        nCandPerSeed = 0;
         auto const & startTraj = theTrajectoryBuilder->buildTrajectories( (*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr );
-        {
-          Lock lock(theMutex);
-          (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
-          if(theTmpTrajectories.empty()) {
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NO_TRAJECTORY);
-            return; // from the lambda!
-          }
-        }
+        if(theTmpTrajectories.empty()) return SeedStopReason::NO_TRAJECTORY;
 
 	LogDebug("CkfPattern") << "======== In-out trajectory building found " << theTmpTrajectories.size()
 			            << " trajectories from seed " << j << " ========\n"
@@ -324,11 +322,7 @@ namespace cms{
   	  LogDebug("CkfPattern") << "======== Out-in trajectory building found " << theTmpTrajectories.size()
   			              << " valid/invalid trajectories from seed " << j << " ========\n"
 				 <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
-          if(theTmpTrajectories.empty()) {
-            Lock lock(theMutex);
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_REGION_REBUILD);
-            return;
-          }
+          if(theTmpTrajectories.empty()) return SeedStopReason::SEED_REGION_REBUILD;
         }
 
 
@@ -338,8 +332,18 @@ namespace cms{
         LogDebug("CkfPattern") << "======== Trajectory cleaning gave the following " << theTmpTrajectories.size() << " valid trajectories from seed "
                                << j << " ========\n"
 			       <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
+        return SeedStopReason::NOT_STOPPED;
+      };
+
+      // Store what buildSeed gave for seed j
+      auto storeSeed = [&](unsigned int j, std::vector<Trajectory> & theTmpTrajectories, unsigned int nCandPerSeed, SeedStopReason stopReason) {
+        Lock lock(theMutex);
+        (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
+        if (stopReason != SeedStopReason::NOT_STOPPED) {
+          (*outputSeedStopInfos)[j].setStopReason(stopReason);
+          return;
+        }
 
-        { Lock lock(theMutex);
 	for(vector<Trajectory>::iterator it=theTmpTrajectories.begin();
 	    it!=theTmpTrajectories.end(); it++){
 	  if( it->isValid() ) {
@@ -352,13 +356,12 @@ namespace cms{
             if (theSeedCleaner && rawResult.back().foundHits()>3) theSeedCleaner->add( &rawResult.back() );
             //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
 	  }
-	}}
+	}
 
         theTmpTrajectories.clear();
 
 	LogDebug("CkfPattern") << "rawResult trajectories found so far = " << rawResult.size();
 
-        { Lock lock(theMutex);
 	if ( maxSeedsBeforeCleaning_ >0 && rawResult.size() > maxSeedsBeforeCleaning_+lastCleanResult) {
           theTrajectoryCleaner->clean(rawResult);
           rawResult.erase(std::remove_if(rawResult.begin()+lastCleanResult,rawResult.end(),
@@ -366,12 +369,54 @@ namespace cms{
 			  rawResult.end());
           lastCleanResult=rawResult.size();
         }
-        }
+      };
 
+      auto theLoop = [&](size_t ii) {
+        auto j = indeces[ii];
+
+        ntseed++;
+
+        // to be moved inside a par section (how with tbb??)
+        std::vector<Trajectory> theTmpTrajectories;
+
+
+	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
+
+        if (!seedIsGood(j)) return;
+
+        unsigned int nCandPerSeed = 0;
+        auto stopReason = buildSeed(j, theTmpTrajectories, nCandPerSeed);
+        storeSeed(j, theTmpTrajectories, nCandPerSeed, stopReason);
       };
       // end of loop over seeds
 
 
+      if (parallelSeeds_) {
+        // Build all the seeds in parallel, in chunks of consecutive seeds, as if the seed cleaner
+        // killed none of them, then clean and store them in order as theLoop does.
+        // The result is the same as the serial one, at the price of building the seeds the cleaner kills.
+        struct SeedResult {
+          unsigned int nCandPerSeed = 0;
+          SeedStopReason stopReason = SeedStopReason::UNINITIALIZED;
+          std::vector<Trajectory> trajectories;
+        };
+        std::vector<SeedResult> seedResults(collseed_size);
+        size_t nChunks = (collseed_size + seedsPerChunk - 1) / seedsPerChunk;
+        tbb::parallel_for(0UL, nChunks, 1UL, [&](size_t chunk) {
+          auto end = std::min(collseed_size, (chunk + 1) * seedsPerChunk);
+          for (auto ii = chunk * seedsPerChunk; ii < end; ++ii) {
+            auto & seedResult = seedResults[ii];
+            seedResult.stopReason = buildSeed(indeces[ii], seedResult.trajectories, seedResult.nCandPerSeed);
+          }
+        });
+        for (size_t ii = 0; ii < collseed_size; ++ii) {
+          auto j = indeces[ii];
+          ntseed++;
+          auto & seedResult = seedResults[ii];
+          if (seedIsGood(j)) storeSeed(j, seedResult.trajectories, seedResult.nCandPerSeed, seedResult.stopReason);
+          std::vector<Trajectory>().swap(seedResult.trajectories);
+        }
+      } else {
 #ifdef VI_TBB
      tbb::parallel_for(0UL,collseed_size,1UL,theLoop);
 #else
@@ -382,6 +427,7 @@ namespace cms{
        theLoop(j);
       }
 #endif
+      }
       assert(ntseed==collseed_size);
       if (theSeedCleaner) theSeedCleaner->done();
 
@@ -540,6 +586,10 @@ namespace cms{
     if (theTrackCandidateOutput){e.put(std::move(output));}
     if (theTrajectoryOutput){e.put(std::move(outputT));}
     e.put(std::move(outputSeedStopInfos));
+
+    LogDebug("CkfPattern") << poolAllocator::threadStats().allocations - poolAllocations
+			   << " pool allocations in this thread, "
+			   << poolAllocator::threadStats().slabs - poolAllocator::threadStats().releasedSlabs << " slabs before trimming";
   }
 
 }
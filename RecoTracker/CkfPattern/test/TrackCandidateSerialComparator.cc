@@ -0,0 +1,94 @@
+//
+// Class: TrackCandidateSerialComparator.cc
+//
+// Info: Checks that two CkfTrackCandidateMaker outputs are identical,
+//       candidate by candidate and in the same order, together with the
+//       SeedStopInfos, e.g. with the seeds built in parallel and one after
+//       the other. Throws on the first difference.
+//
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/TrackCandidate/interface/TrackCandidateCollection.h"
+#include "DataFormats/TrackReco/interface/SeedStopInfo.h"
+
+#include <vector>
+
+class TrackCandidateSerialComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit TrackCandidateSerialComparator(const edm::ParameterSet&);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  const edm::EDGetTokenT<TrackCandidateCollection> expectedCandidates_;
+  const edm::EDGetTokenT<TrackCandidateCollection> actualCandidates_;
+  const edm::EDGetTokenT<std::vector<SeedStopInfo> > expectedStopInfos_;
+  const edm::EDGetTokenT<std::vector<SeedStopInfo> > actualStopInfos_;
+};
+
+TrackCandidateSerialComparator::TrackCandidateSerialComparator(const edm::ParameterSet& conf) :
+  expectedCandidates_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("expected"))),
+  actualCandidates_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("actual"))),
+  expectedStopInfos_(consumes<std::vector<SeedStopInfo> >(conf.getParameter<edm::InputTag>("expected"))),
+  actualStopInfos_(consumes<std::vector<SeedStopInfo> >(conf.getParameter<edm::InputTag>("actual"))) {
+}
+
+void TrackCandidateSerialComparator::analyze(edm::StreamID, const edm::Event& e, const edm::EventSetup&) const {
+  edm::Handle<TrackCandidateCollection> expected, actual;
+  e.getByToken(expectedCandidates_, expected);
+  e.getByToken(actualCandidates_, actual);
+
+  if (expected->size() != actual->size()) {
+    throw cms::Exception("TrackCandidateMismatch")
+      << "event " << e.id() << ": " << actual->size() << " candidates instead of " << expected->size();
+  }
+  for (unsigned int i = 0; i < expected->size(); ++i) {
+    auto const& exp = (*expected)[i];
+    auto const& act = (*actual)[i];
+    // both producers read the same seeds: the seed references are equal
+    bool same = exp.seedRef() == act.seedRef() && exp.nLoops() == act.nLoops() && exp.stopReason() == act.stopReason();
+    auto const& expState = exp.trajectoryStateOnDet();
+    auto const& actState = act.trajectoryStateOnDet();
+    same = same && expState.detId() == actState.detId() && expState.surfaceSide() == actState.surfaceSide() &&
+      expState.parameters().vector() == actState.parameters().vector();
+    for (int k = 0; k < 15; ++k) same = same && expState.error(k) == actState.error(k);
+    auto expHits = exp.recHits();
+    auto actHits = act.recHits();
+    same = same && (expHits.second - expHits.first) == (actHits.second - actHits.first);
+    for (auto eh = expHits.first, ah = actHits.first; same && eh != expHits.second; ++eh, ++ah) {
+      same = eh->geographicalId() == ah->geographicalId() && eh->getType() == ah->getType() &&
+        (!eh->isValid() || (eh->sharesInput(&*ah, TrackingRecHit::all) &&
+                            eh->localPosition() == ah->localPosition()));
+    }
+    if (!same) {
+      throw cms::Exception("TrackCandidateMismatch")
+        << "event " << e.id() << ": candidate " << i << " differs";
+    }
+  }
+
+  edm::Handle<std::vector<SeedStopInfo> > expectedStops, actualStops;
+  e.getByToken(expectedStopInfos_, expectedStops);
+  e.getByToken(actualStopInfos_, actualStops);
+  if (expectedStops->size() != actualStops->size()) {
+    throw cms::Exception("TrackCandidateMismatch")
+      << "event " << e.id() << ": " << actualStops->size() << " seed stop infos instead of " << expectedStops->size();
+  }
+  for (unsigned int i = 0; i < expectedStops->size(); ++i) {
+    auto const& exp = (*expectedStops)[i];
+    auto const& act = (*actualStops)[i];
+    if (exp.stopReason() != act.stopReason() || exp.candidatesPerSeed() != act.candidatesPerSeed()) {
+      throw cms::Exception("TrackCandidateMismatch")
+        << "event " << e.id() << ": seed " << i << " stopped with reason " << int(act.stopReasonUC())
+        << " and " << act.candidatesPerSeed() << " candidates instead of reason " << int(exp.stopReasonUC())
+        << " and " << exp.candidatesPerSeed();
+    }
+  }
+}
+
+DEFINE_FWK_MODULE(TrackCandidateSerialComparator);
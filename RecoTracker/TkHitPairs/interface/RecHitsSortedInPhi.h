@@ -6,12 +6,15 @@
 
 #include <vector>
 #include<array>
+#include<algorithm>
 
 #include<cassert>
 
 /** A RecHit container sorted in phi.
  *  Provides fast access for hits in a given phi window
  *  using binary search.
+ *  Large layers also get a (phi, v) binned index, that gives
+ *  the hits of a phi window in a given v range.
  */
 
 class RecHitsSortedInPhi {
@@ -85,6 +88,17 @@ public:
     return Range(theHits.begin(), theHits.end());
   }
 
+  // The indices, in increasing order, of the hits in [b,e) (as returned by doubleRange)
+  //  whose v bin overlaps [vLo,vHi]: a superset of the hits with v in [vLo,vHi].
+  //  Requires hasIndex().
+  void candidates(int b, int e, float vLo, float vHi, std::vector<int>& result) const;
+
+  bool hasIndex() const { return !cellStart.empty();}
+
+  // Builds the (phi, v) index from theHits and the u, v, dv columns.
+  //  Called by the constructor for layers with at least minHitsForIndex hits.
+  void buildIndex();
+
 public:
   float       phi(int i) const { return theHits[i].phi();}
   float       gv(int i) const { return isBarrel ? z[i] : gp(i).perp();}  // global v
@@ -112,11 +126,30 @@ public:
   std::vector<float> dv;
   std::vector<float> lphi;
 
+  // (phi, v) binned index, built if there are at least minHitsForIndex hits.
+  //  The hits of cell phiBin*nVBins+vBin are cellHits[cellStart[cell]..cellStart[cell+1]),
+  //  in increasing order; phiBins[i] is the phi bin of hit i, and does not decrease with i.
+  static constexpr int nPhiBins = 64;
+  static constexpr int nVBins = 16;
+  static constexpr unsigned int minHitsForIndex = 64;
+  std::vector<unsigned char> phiBins;
+  std::vector<int> cellStart;
+  std::vector<int> cellHits;
+  float uMin=0, uMax=0, vMin=0, vMax=0, dvMax=0;
+
+  int vBin(float vv) const {
+    float b = (vv-vMin)*vBinScale;
+    return b>0.f ? (b<float(nVBins) ? int(b) : nVBins-1) : 0;
+  }
+
   static void copyResult( const Range& range, std::vector<Hit>& result) {
     result.reserve(result.size()+(range.second-range.first));
     for (HitIter i = range.first; i != range.second; i++) result.push_back( i->hit());
   }
 
+private:
+  float vBinScale=0;
+
 };
 
 
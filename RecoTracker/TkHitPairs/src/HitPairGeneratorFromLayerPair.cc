@@ -62,6 +62,19 @@ namespace {
 	ok[i-b] = ! crossRange.empty() ;
       }
     }
+
+    // same on the hits of a list of indices
+    void operator()(int const * idx, int n, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
+      constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+      for (int k=0; k!=n; ++k) {
+	int i = idx[k];
+	Range allowed = checkRZ->range(innerHitsMap.u[i]);
+	float vErr = nSigmaRZ * innerHitsMap.dv[i];
+	Range hitRZ(innerHitsMap.v[i]-vErr, innerHitsMap.v[i]+vErr);
+	Range crossRange = allowed.intersection(hitRZ);
+	ok[k] = ! crossRange.empty() ;
+      }
+    }
     Algo const * checkRZ;
     
   };
@@ -69,6 +82,9 @@ namespace {
 
   template<typename ... Args> using Kernels = std::tuple<Kernel<Args>...>;
 
+  // inner hits found through the (phi, v) index
+  thread_local std::vector<int> candidates_;
+
 }
 
 
@@ -145,8 +161,43 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
     LogDebug("HitPairGeneratorFromLayerPair")<<
       "preparing for combination of: "<< innerRange[1]-innerRange[0]+innerRange[3]-innerRange[2]
 				      <<" inner and: "<< outerHitsMap.theHits.size()<<" outter";
+
+    // The allowed z of HitZCheck is linear in r, so its extremes over the inner layer
+    // are at the smallest and largest r: the hits outside the z window these give,
+    // widened by the largest hit error, fail the check and are not even looked at.
+    bool useIndex = innerHitsMap.hasIndex() && checkRZ->algo()==HitRZCompatibility::zAlgo;
+    float vLo=0, vHi=0;
+    if (useIndex) {
+      constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+      auto const * checkZ = reinterpret_cast<HitZCheck const *>(checkRZ);
+      Range atMin = checkZ->range(innerHitsMap.uMin);
+      Range atMax = checkZ->range(innerHitsMap.uMax);
+      float margin = 1.01f*nSigmaRZ*innerHitsMap.dvMax + 0.001f;
+      vLo = std::min(atMin.min(),atMax.min()) - margin;
+      vHi = std::max(atMin.max(),atMax.max()) + margin;
+    }
+
     for(int j=0; j<3; j+=2) {
       auto b = innerRange[j]; auto e=innerRange[j+1];
+      if (useIndex && e-b > int(RecHitsSortedInPhi::minHitsForIndex)) {
+	auto & cand = candidates_;
+	innerHitsMap.candidates(b, e, vLo, vHi, cand);
+	int n = cand.size();
+	bool ok[n];
+	std::get<0>(kernels).set(checkRZ);
+	std::get<0>(kernels)(cand.data(), n, innerHitsMap, ok);
+	for (int k=0; k!=n; ++k) {
+	  if (!ok[k]) continue;
+	  if (theMaxElement!=0 && result.size() >= theMaxElement){
+	    result.clear();
+	    edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
+	    delete checkRZ;
+	    return;
+	  }
+	  result.add(cand[k],io);
+	}
+	continue;
+      }
       bool ok[e-b];
       switch (checkRZ->algo()) {
 	case (HitRZCompatibility::zAlgo) :
@@ -44,7 +44,54 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
     dv[i] = isBarrel ? dz : dr;
     lphi[i] = loc.barePhi();
   }
-  
+
+  if (theHits.size() >= minHitsForIndex) buildIndex();
+}
+
+void RecHitsSortedInPhi::buildIndex() {
+  auto n = theHits.size();
+  uMin = *std::min_element(u.begin(),u.end()); uMax = *std::max_element(u.begin(),u.end());
+  vMin = *std::min_element(v.begin(),v.end()); vMax = *std::max_element(v.begin(),v.end());
+  dvMax = *std::max_element(dv.begin(),dv.end());
+  vBinScale = vMax>vMin ? float(nVBins)/(vMax-vMin) : 0.f;
+
+  // counting sort of the hits in the cells, keeping the phi order in each cell
+  phiBins.resize(n);
+  std::vector<int> cell(n);
+  cellStart.assign(nPhiBins*nVBins+1,0);
+  constexpr float phiScale = float(nPhiBins)/Geom::ftwoPi();
+  for (unsigned int i=0; i!=n; ++i) {
+    int pb = (theHits[i].phi()+Geom::fpi())*phiScale;
+    pb = std::max(0,std::min(nPhiBins-1,pb));
+    // keep the phi bins ordered as the hits, even for a rounding at a bin edge
+    if (i>0) pb = std::max(pb,int(phiBins[i-1]));
+    phiBins[i] = pb;
+    cell[i] = pb*nVBins+vBin(v[i]);
+    ++cellStart[cell[i]+1];
+  }
+  for (int c=0; c!=nPhiBins*nVBins; ++c) cellStart[c+1] += cellStart[c];
+  cellHits.resize(n);
+  std::vector<int> pos(cellStart.begin(),cellStart.end()-1);
+  for (unsigned int i=0; i!=n; ++i) cellHits[pos[cell[i]]++] = i;
+}
+
+void RecHitsSortedInPhi::candidates(int b, int e, float vLo, float vHi, std::vector<int>& result) const {
+  result.clear();
+  if (b>=e || vLo>vHi) return;
+  int vb = vBin(vLo), ve = vBin(vHi);
+  int pFirst = phiBins[b], pLast = phiBins[e-1];
+  for (int p=pFirst; p<=pLast; ++p) {
+    bool edge = (p==pFirst) | (p==pLast);
+    for (int c=p*nVBins+vb; c<=p*nVBins+ve; ++c) {
+      for (int k=cellStart[c]; k!=cellStart[c+1]; ++k) {
+	int i = cellHits[k];
+	if (edge && (i<b || i>=e)) continue;
+	result.push_back(i);
+      }
+    }
+  }
+  // the cells of a phi bin interleave
+  std::sort(result.begin(),result.end());
 }
 
 
@@ -0,0 +1,122 @@
+// Checks RecHitsSortedInPhi::candidates against a brute-force scan of the
+// phi ranges given by doubleRange, on random barrel and forward layers.
+// The candidates must be in increasing order, inside the phi ranges,
+// include every hit with v in the window, and be exactly the hits of the
+// ranges whose v bin overlaps the window.
+
+#include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // the index only needs isBarrel() from the layer
+  class DummyLayer final : public DetLayer {
+  public:
+    explicit DummyLayer(bool barrel) : DetLayer(false, barrel) {}
+    const BoundSurface& surface() const override { throw std::logic_error("DummyLayer::surface"); }
+    const std::vector<const GeometricSearchDet*>& components() const override { return noComponents; }
+    const std::vector<const GeomDet*>& basicComponents() const override { return noDets; }
+    std::pair<bool, TrajectoryStateOnSurface>
+    compatible(const TrajectoryStateOnSurface& ts, const Propagator&, const MeasurementEstimator&) const override {
+      return std::make_pair(false, ts);
+    }
+    SubDetector subDetector() const override { return GeomDetEnumerators::PixelBarrel; }
+    Location location() const override { return isBarrel() ? GeomDetEnumerators::barrel : GeomDetEnumerators::endcap; }
+  private:
+    std::vector<const GeometricSearchDet*> noComponents;
+    std::vector<const GeomDet*> noDets;
+  };
+
+  // fills the columns used by the index with n random hits, sorted in phi,
+  // some of them sharing their phi and v
+  void fill(RecHitsSortedInPhi& layer, std::mt19937& rng, int n) {
+    std::uniform_real_distribution<float> phi(-Geom::fpi(), Geom::fpi());
+    std::uniform_real_distribution<float> v(-25.f, 25.f), u(4.f, 7.f), dv(0.001f, 0.05f);
+    std::vector<float> phis(n);
+    for (auto& p : phis) p = phi(rng);
+    for (int i = 0; i < n/10; ++i) phis[i+1] = phis[i];
+    std::sort(phis.begin(), phis.end());
+    layer.theHits.clear();
+    for (auto p : phis) layer.theHits.emplace_back(p);
+    layer.u.resize(n); layer.v.resize(n); layer.dv.resize(n);
+    for (int i = 0; i < n; ++i) {
+      layer.u[i] = u(rng);
+      layer.v[i] = (i > 0 && i % 17 == 0) ? layer.v[i-1] : v(rng);
+      layer.dv[i] = dv(rng);
+    }
+    layer.buildIndex();
+  }
+
+  bool check(RecHitsSortedInPhi const& layer, int b, int e, float vLo, float vHi) {
+    std::vector<int> cand;
+    layer.candidates(b, e, vLo, vHi, cand);
+    if (!std::is_sorted(cand.begin(), cand.end()) || std::adjacent_find(cand.begin(), cand.end()) != cand.end()) {
+      std::cout << "  candidates not strictly increasing\n";
+      return false;
+    }
+    std::vector<int> expected;
+    for (int i = b; i < e; ++i) {
+      bool inside = layer.v[i] >= vLo && layer.v[i] <= vHi;
+      bool binned = vLo <= vHi && layer.vBin(layer.v[i]) >= layer.vBin(vLo) && layer.vBin(layer.v[i]) <= layer.vBin(vHi);
+      if (inside && !binned) {
+        std::cout << "  hit " << i << " with v " << layer.v[i] << " is outside its bins\n";
+        return false;
+      }
+      if (binned) expected.push_back(i);
+    }
+    if (cand != expected) {
+      std::cout << "  " << cand.size() << " candidates, " << expected.size() << " expected in [" << b << "," << e
+                << ") for v in [" << vLo << "," << vHi << "]\n";
+      return false;
+    }
+    return true;
+  }
+
+}
+
+int main() {
+  std::mt19937 rng(4242);
+  std::uniform_real_distribution<float> phi(-Geom::fpi(), Geom::fpi()), dphi(0.f, 1.5f);
+  std::uniform_real_distribution<float> v(-30.f, 30.f), dv(0.f, 20.f);
+  std::uniform_int_distribution<int> nhits(RecHitsSortedInPhi::minHitsForIndex, 3000);
+
+  unsigned int failures = 0, tests = 0;
+  for (bool barrel : {true, false}) {
+    DummyLayer detLayer(barrel);
+    for (int l = 0; l < 50; ++l) {
+      RecHitsSortedInPhi layer(std::vector<RecHitsSortedInPhi::Hit>(), GlobalPoint(0, 0, 0), &detLayer);
+      fill(layer, rng, nhits(rng));
+      if (!layer.hasIndex()) {
+        std::cout << "no index built\n";
+        return 1;
+      }
+      for (int w = 0; w < 200; ++w) {
+        // phi windows crossing pi included, as in the doublet search
+        float phiMin = phi(rng);
+        float phiMax = phiMin + dphi(rng);
+        auto range = layer.doubleRange(phiMin, phiMax);
+        float vLo = v(rng);
+        float vHi = vLo + (w % 10 == 0 ? -1.f : dv(rng));
+        for (int k = 0; k < 4; k += 2) {
+          ++tests;
+          if (!check(layer, range[k], range[k+1], vLo, vHi)) {
+            std::cout << (barrel ? "barrel" : "forward") << " layer " << l << ", window " << w << " failed\n";
+            ++failures;
+          }
+        }
+      }
+    }
+  }
+
+  if (failures) {
+    std::cout << failures << " failures out of " << tests << " tests" << std::endl;
+    return 1;
+  }
+  std::cout << "candidates agree with the brute-force scan in " << tests << " tests" << std::endl;
+  return 0;
+}
@@ -9,6 +9,7 @@
 
 #include "Geometry/CommonDetUnit/interface/GeomDet.h"
 #include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "TrackingTools/TrajectoryState/interface/PoolAllocator.h"
 
 
 #include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
@@ -58,7 +59,7 @@ TrackingRecHit::ConstRecHitPointer TkClonerImpl::makeShared(SiPixelRecHit const
  // std::cout << "cloning " << typeid(hit).name() << std::endl;
   const SiPixelCluster& clust = *hit.cluster();  
   auto && params = pixelCPE->getParameters( clust, *hit.detUnit(), tsos);
-  return std::make_shared<SiPixelRecHit>(std::get<0>(params), std::get<1>(params), std::get<2>(params), *hit.det(), hit.cluster());
+  return std::allocate_shared<SiPixelRecHit>(pool_allocator<SiPixelRecHit>(), std::get<0>(params), std::get<1>(params), std::get<2>(params), *hit.det(), hit.cluster());
 }
 
 TrackingRecHit::ConstRecHitPointer TkClonerImpl::makeShared(SiStripRecHit2D const & hit, TrajectoryStateOnSurface const& tsos) const {
@@ -67,7 +68,7 @@ TrackingRecHit::ConstRecHitPointer TkClonerImpl::makeShared(SiStripRecHit2D cons
     const SiStripCluster&  clust = hit.stripCluster();  
     StripClusterParameterEstimator::LocalValues lv = 
       stripCPE->localParameters( clust, *hit.detUnit(), tsos);
-    return std::make_shared<SiStripRecHit2D>(lv.first, lv.second, *hit.det(), hit.omniCluster());
+    return std::allocate_shared<SiStripRecHit2D>(pool_allocator<SiStripRecHit2D>(), lv.first, lv.second, *hit.det(), hit.omniCluster());
 }
 
 TrackingRecHit::ConstRecHitPointer TkClonerImpl::makeShared(SiStripRecHit1D const & hit, TrajectoryStateOnSurface const& tsos) const {
@@ -77,7 +78,7 @@ TrackingRecHit::ConstRecHitPointer TkClonerImpl::makeShared(SiStripRecHit1D cons
   StripClusterParameterEstimator::LocalValues lv = 
     stripCPE->localParameters( clust, *hit.detUnit(), tsos);
   LocalError le(lv.second.xx(),0.,std::numeric_limits<float>::max()); //Correct??
-  return  std::make_shared<SiStripRecHit1D>(lv.first, le, *hit.det(), hit.omniCluster());
+  return  std::allocate_shared<SiStripRecHit1D>(pool_allocator<SiStripRecHit1D>(), lv.first, le, *hit.det(), hit.omniCluster());
 }
 
 TrackingRecHit::ConstRecHitPointer TkClonerImpl::makeShared(Phase2TrackerRecHit1D const & hit, TrajectoryStateOnSurface const& tsos) const {
@@ -0,0 +1,78 @@
+#ifndef RKBatchPropagator_H
+#define RKBatchPropagator_H
+
+/** \class RKBatchPropagator
+ *  Runge-Kutta propagation in the path length, with the adaptive Cash-Karp
+ *  steps of RKPropagatorInS, of several states in lock-step.
+ *
+ *  Each stage of the steps of all the states asks the field at all their
+ *  points in one MagneticField::inTeslaBatch call, so that the volume based
+ *  field interpolates together the points of the same volume. The field at
+ *  the start of a step is computed once, for the path length estimate and
+ *  for the first stage, also when the step is retried with a smaller size.
+ *  The states are propagated in the global frame.
+ *
+ *  The single state interface of Propagator uses the same code with one state.
+ *  The n-state interface of Propagator, which the Gaussian-sum propagation
+ *  (MultiStatePropagation in GsfTools) uses for all the components of a state,
+ *  propagates the states together.
+ */
+
+#include "TrackingTools/GeomPropagators/interface/Propagator.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "FWCore/Utilities/interface/Visibility.h"
+
+#include <utility>
+
+class MagneticField;
+
+class RKBatchPropagator final : public Propagator {
+public:
+
+  explicit RKBatchPropagator( const MagneticField* field, PropagationDirection dir = alongMomentum,
+			      double tolerance = 5.e-5) :
+    Propagator(dir), theField( field), theTolerance( tolerance) {}
+
+  ~RKBatchPropagator() override {}
+
+  using Propagator::propagate;
+  using Propagator::propagateWithPath;
+
+  /// Propagates the n states fts to the plane or cylinder sur
+  void propagateWithPath( const FreeTrajectoryState* fts, unsigned int n, const Surface& sur,
+			  std::pair<TrajectoryStateOnSurface,double>* result) const override;
+
+  /// Propagates the n states fts to the plane; result must have room for n states
+  void propagateWithPath( const FreeTrajectoryState* fts, unsigned int n, const Plane& plane,
+			  std::pair<TrajectoryStateOnSurface,double>* result) const;
+
+  /// Propagates the n states fts to the cylinder; result must have room for n states
+  void propagateWithPath( const FreeTrajectoryState* fts, unsigned int n, const Cylinder& cyl,
+			  std::pair<TrajectoryStateOnSurface,double>* result) const;
+
+private:
+  std::pair< TrajectoryStateOnSurface, double>
+  propagateWithPath (const FreeTrajectoryState&, const Plane&) const override;
+
+  std::pair< TrajectoryStateOnSurface, double>
+  propagateWithPath (const FreeTrajectoryState&, const Cylinder&) const override;
+
+public:
+  Propagator * clone() const override;
+
+  const MagneticField* magneticField() const override {return theField;}
+
+private:
+
+  typedef std::pair<TrajectoryStateOnSurface,double>     TsosWP;
+
+  template <typename Target>
+  void propagateInLockStep( const FreeTrajectoryState* fts, unsigned int n, const Target& target,
+			    TsosWP* result) const dso_internal;
+
+  const MagneticField* theField;
+  double               theTolerance;
+
+};
+
+#endif
@@ -15,9 +15,21 @@ PathToPlane2Order::operator()( const Plane& plane,
   // access to the field in field frame local coordinates
     RKLocalFieldProvider::Vector B = theField.inTesla( pos.x(), pos.y(), pos.z());
 
+    return pathLength( plane, *theFieldFrame, pos, momentum, B, charge, propDir);
+}
+
+std::pair<bool,double> 
+PathToPlane2Order::pathLength( const Plane& plane, 
+			       const Frame& fieldFrame,
+			       const Vector3D& pos,
+			       const Vector3D& momentum,
+			       const Vector3D& B,
+			       double charge,
+			       const PropagationDirection propDir)
+{
     // Frame::GlobalVector localZ = Frame::GlobalVector( B.unit()); // local Z along field
     // transform field axis to global frame
-    Frame::GlobalVector localZ = theFieldFrame->toGlobal( Frame::LocalVector( B.unit())); // local Z along field
+    Frame::GlobalVector localZ = fieldFrame.toGlobal( Frame::LocalVector( B.unit())); // local Z along field
 
     Frame::GlobalVector localY = localZ.cross( Frame::GlobalVector( 1,0,0));
     if (localY.mag() < 0.1) {
@@ -29,7 +41,7 @@ PathToPlane2Order::operator()( const Plane& plane,
     Frame::GlobalVector localX = localY.cross(localZ);
 
 
-    Frame::PositionType fpos( theFieldFrame->toGlobal( Frame::LocalPoint(pos)));
+    Frame::PositionType fpos( fieldFrame.toGlobal( Frame::LocalPoint(pos)));
     Frame::RotationType frot( localX, localY, localZ);
     // frame in which the field is along Z
     Frame frame( fpos, frot);
@@ -40,7 +52,7 @@ PathToPlane2Order::operator()( const Plane& plane,
     Frame::LocalPoint localPos = frame.toLocal( fpos); // same as LocalPoint(0,0,0)
 
     //transform momentum from field frame to new frame via global frame
-    Frame::GlobalVector gmom( theFieldFrame->toGlobal( Frame::LocalVector(momentum)));
+    Frame::GlobalVector gmom( fieldFrame.toGlobal( Frame::LocalVector(momentum)));
     Frame::LocalVector localMom = frame.toLocal( gmom); 
 
     // transform the plane to the same frame
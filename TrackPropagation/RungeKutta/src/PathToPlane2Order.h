@@ -45,6 +45,15 @@ public:
 			   theFieldFrame->toLocal(momentum).basicVector(), charge, propDir);
     }
 
+    /// as above, with the field B at the position, in the fieldFrame, already known
+    static std::pair<bool,double> pathLength( const Plane& plane, 
+					      const Frame& fieldFrame,
+					      const Vector3D& position,
+					      const Vector3D& momentum,
+					      const Vector3D& B,
+					      double charge,
+					      const PropagationDirection propDir = alongMomentum);
+
 private:
 
     const RKLocalFieldProvider& theField;
@@ -0,0 +1,421 @@
+#include "TrackPropagation/RungeKutta/interface/RKBatchPropagator.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "DataFormats/GeometrySurface/interface/Cylinder.h"
+#include "DataFormats/GeometryVector/interface/Basic3DVector.h"
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "RKSmallVector.h"
+#include "CartesianStateAdaptor.h"
+#include "RKAdaptiveSolver.h"
+#include "PathToPlane2Order.h"
+#include "AnalyticalErrorPropagation.h"
+#include "GlobalParametersWithPath.h"
+#include "TrackingTools/GeomPropagators/interface/StraightLinePlaneCrossing.h"
+#include "TrackingTools/GeomPropagators/interface/StraightLineCylinderCrossing.h"
+#include "TrackingTools/GeomPropagators/interface/StraightLineBarrelCylinderCrossing.h"
+#include "TrackingTools/GeomPropagators/interface/PropagationDirectionFromPath.h"
+#include "TrackingTools/GeomPropagators/interface/PropagationExceptions.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Likely.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+  typedef RKSmallVector<double,6>             RKVector;
+  typedef CartesianStateAdaptor::Vector3D     Vector3D;
+
+  // number of states propagated in lock-step
+  constexpr unsigned int W = 16;
+
+  // derivative of the state, as CartesianLorentzForce
+  inline RKVector lorentzForce( const RKVector& state, const GlobalVector& b, float charge) {
+    constexpr float k = 2.99792458e-3; // conversion to [cm]
+    CartesianStateAdaptor start(state);
+    auto dpos = start.momentum().unit();
+    auto dmom = (k*charge) * dpos.cross( b.basicVector());
+    return CartesianStateAdaptor::rkstate( dpos, dmom);
+  }
+
+  // distance between two states, as RKCartesianDistance
+  inline double distance( const RKVector& rka, const RKVector& rkb) {
+    CartesianStateAdaptor a(rka), b(rkb);
+    return (a.position()-b.position()).mag() +
+      (a.momentum() - b.momentum()).mag() / b.momentum().mag();
+  }
+
+  inline GlobalPoint rkPoint( const RKVector& state) {
+    return GlobalPoint( CartesianStateAdaptor::position( state));
+  }
+
+  PropagationDirection invertDirection( PropagationDirection dir) {
+    if (dir == anyDirection) return dir;
+    return ( dir == alongMomentum ? oppositeToMomentum : alongMomentum);
+  }
+
+  GlobalTrajectoryParameters gtp( const CartesianStateAdaptor& state, TrackCharge charge, const MagneticField* field) {
+    return GlobalTrajectoryParameters( GlobalPoint( state.position()), GlobalVector( state.momentum()), charge, field);
+  }
+
+  // the plane as target of the propagation, as in RKPropagatorInS::propagateParametersOnPlane
+  class PlaneTarget {
+  public:
+    explicit PlaneTarget( const Plane& plane) :
+      thePlane( plane), theGlobalFrame( GloballyPositioned<float>::PositionType(0,0,0),
+					GloballyPositioned<float>::RotationType()) {}
+
+    const Surface& surface() const {return thePlane;}
+
+    double distance( const Vector3D& pos) const {return thePlane.localZ( GlobalPoint(pos));}
+
+    std::pair<bool,double> pathLength( const Vector3D& pos, const Vector3D& mom, const GlobalVector& b,
+				       TrackCharge charge, PropagationDirection dir, double) const {
+      return PathToPlane2Order::pathLength( thePlane, theGlobalFrame, pos, mom, b.basicVector(), charge, dir);
+    }
+
+    GlobalParametersWithPath straightLine( const FreeTrajectoryState& ts, PropagationDirection dir,
+					   const MagneticField* field) const {
+      GlobalPoint gpos( ts.position());
+      GlobalVector gmom( ts.momentum());
+      if unlikely(std::abs( thePlane.localZ(gpos)) < 1e-5) {
+	LogDebug("RKBatchPropagator")<< "Propagation is not performed: state is already on final surface.";
+	return GlobalParametersWithPath( GlobalTrajectoryParameters( gpos, gmom, ts.charge(), field), 0.0);
+      }
+      StraightLinePlaneCrossing::PositionType pos(gpos);
+      StraightLinePlaneCrossing::DirectionType mom(gmom);
+      StraightLinePlaneCrossing planeCrossing(pos, mom, dir);
+      std::pair<bool,double> propResult = planeCrossing.pathLength(thePlane);
+      if likely( propResult.first && field != nullptr) {
+	double s = propResult.second;
+	GlobalPoint x (planeCrossing.position(s));
+	return GlobalParametersWithPath( GlobalTrajectoryParameters( x, gmom, ts.charge(), field), s);
+      }
+      LogDebug("RKBatchPropagator")<< "Straight line propgation to plane failed !!";
+      return GlobalParametersWithPath();
+    }
+
+  private:
+    const Plane& thePlane;
+    const GloballyPositioned<float> theGlobalFrame;
+  };
+
+  // the cylinder as target of the propagation, as in RKPropagatorInS::propagateParametersOnCylinder
+  class CylinderTarget {
+  public:
+    explicit CylinderTarget( const Cylinder& cyl) : theCylinder( cyl) {}
+
+    const Surface& surface() const {return theCylinder;}
+
+    double distance( const Vector3D& pos) const {
+      return theCylinder.radius() - theCylinder.toLocal( GlobalPoint(pos)).perp();
+    }
+
+    std::pair<bool,double> pathLength( const Vector3D& pos, const Vector3D& mom, const GlobalVector&,
+				       TrackCharge, PropagationDirection dir, double eps) const {
+      StraightLineCylinderCrossing pathLength( theCylinder.toLocal( GlobalPoint(pos)),
+					       theCylinder.toLocal( GlobalVector(mom)), dir, eps);
+      return pathLength.pathLength( theCylinder);
+    }
+
+    GlobalParametersWithPath straightLine( const FreeTrajectoryState& ts, PropagationDirection dir,
+					   const MagneticField* field) const {
+      GlobalPoint gpos( ts.position());
+      GlobalVector gmom( ts.momentum());
+      StraightLineBarrelCylinderCrossing cylCrossing(gpos, gmom, dir);
+      std::pair<bool,double> propResult = cylCrossing.pathLength(theCylinder);
+      if likely( propResult.first && field != nullptr) {
+	double s = propResult.second;
+	GlobalPoint x (cylCrossing.position(s));
+	return GlobalParametersWithPath( GlobalTrajectoryParameters( x, gmom, ts.charge(), field), s);
+      }
+      edm::LogError("RKBatchPropagator") << "Straight line propagation to cylinder failed !!";
+      return GlobalParametersWithPath();
+    }
+
+  private:
+    const Cylinder& theCylinder;
+  };
+
+  // a state in the lock-step propagation
+  struct Track {
+    RKVector start;        // state at the start of the iteration
+    RKVector current;      // state at the start of the Runge-Kutta step
+    RKVector dcurrent;     // derivative at current
+    RKVector trial;        // result of the last Runge-Kutta step
+    double startDist;      // distance to the surface at start
+    double path;           // path length of the iteration
+    double stot;
+    double remaining;      // path length still to be done in the iteration
+    double stepSize;
+    PropagationDirection direction;
+    int iterations;
+    bool active;
+    bool hasDerivative;
+    GlobalParametersWithPath result;
+  };
+
+}
+
+
+std::pair<TrajectoryStateOnSurface,double>
+RKBatchPropagator::propagateWithPath( const FreeTrajectoryState& fts, const Plane& plane) const
+{
+  TsosWP result;
+  propagateWithPath( &fts, 1, plane, &result);
+  return result;
+}
+
+std::pair<TrajectoryStateOnSurface,double>
+RKBatchPropagator::propagateWithPath( const FreeTrajectoryState& fts, const Cylinder& cyl) const
+{
+  TsosWP result;
+  propagateWithPath( &fts, 1, cyl, &result);
+  return result;
+}
+
+void RKBatchPropagator::propagateWithPath( const FreeTrajectoryState* fts, unsigned int n, const Surface& sur,
+					   TsosWP* result) const
+{
+  // try plane first, most probable case (disk "is a" plane too)
+  const Plane* bp = dynamic_cast<const Plane*>(&sur);
+  if (bp != nullptr) return propagateWithPath( fts, n, *bp, result);
+
+  const Cylinder* bc = dynamic_cast<const Cylinder*>(&sur);
+  if (bc != nullptr) return propagateWithPath( fts, n, *bc, result);
+
+  throw PropagationException("The surface is neither Cylinder nor Plane");
+}
+
+void RKBatchPropagator::propagateWithPath( const FreeTrajectoryState* fts, unsigned int n, const Plane& plane,
+					   TsosWP* result) const
+{
+  propagateInLockStep( fts, n, PlaneTarget( plane), result);
+}
+
+void RKBatchPropagator::propagateWithPath( const FreeTrajectoryState* fts, unsigned int n, const Cylinder& cyl,
+					   TsosWP* result) const
+{
+  const GlobalPoint& sp = cyl.position();
+  if unlikely(sp.x()!=0. || sp.y()!=0.) {
+      throw PropagationException("Cannot propagate to an arbitrary cylinder");
+    }
+  propagateInLockStep( fts, n, CylinderTarget( cyl), result);
+}
+
+template <typename Target>
+void RKBatchPropagator::propagateInLockStep( const FreeTrajectoryState* fts, unsigned int n, const Target& target,
+					     TsosWP* result) const
+{
+  using namespace RKDetails;
+  // Cash-Karp coefficients, as in RKOneCashKarpStep
+  constexpr double b21=0.2;
+  constexpr double b31=3./40., b32=9./40.;
+  constexpr double b41=0.3,    b42=-0.9,  b43=1.2;
+  constexpr double b51=-11./54., b52=5./2., b53=-70./27., b54=35./27.;
+  constexpr double b61=1631./55296., b62=175./512., b63=575./13824., b64=44275./110592., b65=253./4096.;
+  constexpr double c1=37./378., c3=250./621., c4=125./594., c6=512./1771.;
+  constexpr double d1=2825./27648., d3=18575./48384., d4=13525./55296., d5=277./14336., d6=0.25;
+  // step size control, as in RKAdaptiveSolver
+  constexpr float Safety = 0.9;
+  const float eps = theTolerance;
+
+  Track tracks[W];
+  unsigned int active[W];
+  unsigned int solving[W];
+  unsigned int moved[W];
+  GlobalPoint points[W];
+  GlobalVector fields[W];
+  RKVector args[W];
+  RKVector k1[W], k2[W], k3[W], k4[W], k5[W], k6[W];
+
+  for (unsigned int first=0; first<n; first+=W) {
+    const unsigned int m = std::min(W, n-first);
+    const FreeTrajectoryState* ts = fts + first;
+
+    for (unsigned int i=0; i!=m; ++i) {
+      auto & t = tracks[i];
+      GlobalPoint gpos( ts[i].position());
+      GlobalVector gmom( ts[i].momentum());
+      t.result = GlobalParametersWithPath();
+      t.startDist = target.distance( gpos.basicVector());
+      t.stot = 0;
+      t.direction = propagationDirection();
+      t.iterations = 0;
+      t.active = true;
+      // Straight line approximation? |rho|<1.e-10 equivalent to ~ 1um
+      // difference in transversal position at 10m.
+      if unlikely(std::abs( ts[i].transverseCurvature()) < 1.e-10) {
+	t.result = target.straightLine( ts[i], propagationDirection(), theField);
+	t.active = false;
+      }
+      else t.start = CartesianStateAdaptor::rkstate( gpos.basicVector(), gmom.basicVector());
+    }
+
+    // field at the evaluation points of the states args[solving[0..ns)], and their derivatives
+    auto evaluate = [&](unsigned int ns, RKVector* k) {
+      for (unsigned int s=0; s!=ns; ++s) points[s] = rkPoint( args[s]);
+      theField->inTeslaBatch( points, fields, ns);
+      for (unsigned int s=0; s!=ns; ++s)
+	k[s] = tracks[solving[s]].stepSize * lorentzForce( args[s], fields[s], ts[solving[s]].charge());
+    };
+
+    while (true) {
+      // the field at the start of the iteration gives the path length and the first stage
+      unsigned int na = 0;
+      for (unsigned int i=0; i!=m; ++i)
+	if (tracks[i].active) {
+	  points[na] = rkPoint( tracks[i].start);
+	  active[na++] = i;
+	}
+      if (na == 0) break;
+      theField->inTeslaBatch( points, fields, na);
+
+      unsigned int ns = 0;
+      for (unsigned int a=0; a!=na; ++a) {
+	auto i = active[a];
+	auto & t = tracks[i];
+	if unlikely(t.iterations++ == 100) {
+	  edm::LogError("FailedPropagation") << " too many iterations trying to reach surface ";
+	  t.active = false;
+	  continue;
+	}
+	CartesianStateAdaptor startState( t.start);
+	std::pair<bool,double> path = target.pathLength( startState.position(), startState.momentum(), fields[a],
+							 ts[i].charge(), t.direction, eps);
+	if unlikely(!path.first) {
+	  LogDebug("RKBatchPropagator") << "RKBatchPropagator: Path length calculation failed!"
+					<< "...distance to surface " << target.distance( startState.position());
+	  t.active = false;
+	  continue;
+	}
+	t.path = path.second;
+	if unlikely(std::abs(t.path) < eps) {
+	  LogDebug("RKBatchPropagator") << "On-surface accuracy not reached, but pathLength calculation says we are there!";
+	  t.result = GlobalParametersWithPath( gtp( startState, ts[i].charge(), theField), t.stot);
+	  t.active = false;
+	  continue;
+	}
+	t.current = t.start;
+	t.dcurrent = lorentzForce( t.start, fields[a], ts[i].charge());
+	t.hasDerivative = true;
+	t.remaining = t.path;
+	t.stepSize = t.path;   // attempt to solve in one step
+	solving[ns++] = i;
+      }
+
+      // adaptive Cash-Karp steps of the solving states in lock-step
+      unsigned int nsolving = ns;
+      while (nsolving != 0) {
+	// derivative at the start of the steps that moved on
+	unsigned int nd = 0;
+	for (unsigned int s=0; s!=nsolving; ++s)
+	  if (!tracks[solving[s]].hasDerivative) {
+	    points[nd] = rkPoint( tracks[solving[s]].current);
+	    moved[nd++] = solving[s];
+	  }
+	if (nd != 0) {
+	  theField->inTeslaBatch( points, fields, nd);
+	  for (unsigned int d=0; d!=nd; ++d) {
+	    auto & t = tracks[moved[d]];
+	    t.dcurrent = lorentzForce( t.current, fields[d], ts[moved[d]].charge());
+	    t.hasDerivative = true;
+	  }
+	}
+
+	for (unsigned int s=0; s!=nsolving; ++s) {
+	  auto const & t = tracks[solving[s]];
+	  k1[s] = t.stepSize * t.dcurrent;
+	  args[s] = t.current + b21*k1[s];
+	}
+	evaluate( nsolving, k2);
+	for (unsigned int s=0; s!=nsolving; ++s)
+	  args[s] = tracks[solving[s]].current + b31*k1[s] + b32*k2[s];
+	evaluate( nsolving, k3);
+	for (unsigned int s=0; s!=nsolving; ++s)
+	  args[s] = tracks[solving[s]].current + b41*k1[s] + b42*k2[s] + b43*k3[s];
+	evaluate( nsolving, k4);
+	for (unsigned int s=0; s!=nsolving; ++s)
+	  args[s] = tracks[solving[s]].current + b51*k1[s] + b52*k2[s] + b53*k3[s] + b54*k4[s];
+	evaluate( nsolving, k5);
+	for (unsigned int s=0; s!=nsolving; ++s)
+	  args[s] = tracks[solving[s]].current + b61*k1[s] + b62*k2[s] + b63*k3[s] + b64*k4[s] + b65*k5[s];
+	evaluate( nsolving, k6);
+
+	unsigned int nleft = 0;
+	for (unsigned int s=0; s!=nsolving; ++s) {
+	  auto & t = tracks[solving[s]];
+	  auto const & v = t.current;
+	  RKVector r5 = v + c1*k1[s] + c3*k3[s] + c4*k4[s] +            c6*k6[s];
+	  RKVector r4 = v + d1*k1[s] + d3*k3[s] + d4*k4[s] + d5*k5[s] + d6*k6[s];
+	  t.trial = r5;
+	  float acc = distance( r4, r5);
+
+	  bool done = false;
+	  if (acc <eps || std::abs(t.stepSize) < std::abs(t.remaining)*0.1f) {
+	    if (std::abs(t.remaining - t.stepSize) < 0.5f*eps) {
+	      done = true; // we are there
+	    } else {
+	      t.remaining -= t.stepSize;
+	      // increase step size
+	      const float cut = std::pow(4.f/Safety,5.f);
+	      float factor =  (eps < cut*acc) ? Safety * fastPow(eps/acc,0.2) : 4.f;
+	      double absRemainingStep = std::abs(t.remaining);
+	      double absSize =  std::min( std::abs(t.stepSize*factor), absRemainingStep);
+	      if (absSize < 0.05f* absRemainingStep ) absSize =  0.05f* absRemainingStep;
+	      t.stepSize = std::copysign(absSize,t.stepSize);
+	      t.current = r5;
+	      t.hasDerivative = false;
+	    }
+	  } else {
+	    // decrease step size
+	    constexpr float cut =  Safety*Safety*Safety*Safety*100*100;
+	    float factor = ( cut*eps > acc) ? Safety * fastPow(eps/acc,0.25) : 0.1f;
+	    t.stepSize *= factor;
+	    if (std::abs(t.stepSize) < 0.05f*std::abs(t.remaining)) t.stepSize = 0.05f*t.remaining;
+	  }
+	  if (!done && std::abs(t.remaining) > eps*0.5f) solving[nleft++] = solving[s];
+	}
+	nsolving = nleft;
+      }
+
+      // where the iteration ended
+      for (unsigned int a=0; a!=na; ++a) {
+	auto i = active[a];
+	auto & t = tracks[i];
+	if (!t.active) continue;
+	t.stot += t.path;
+	CartesianStateAdaptor cur( t.trial);
+	double remaining = target.distance( cur.position());
+	if (std::abs(remaining) < eps) {
+	  LogDebug("RKBatchPropagator") << "On-surface accuracy reached! " << remaining;
+	  t.result = GlobalParametersWithPath( gtp( cur, ts[i].charge(), theField), t.stot);
+	  t.active = false;
+	  continue;
+	}
+	t.start = t.trial;
+	if (remaining * t.startDist <= 0) {
+	  LogDebug("RKBatchPropagator") << "Accuracy not reached yet, trying in opposite direction " << remaining;
+	  t.direction = invertDirection( t.direction);
+	}
+	t.startDist = remaining;
+      }
+    }
+
+    for (unsigned int i=0; i!=m; ++i) {
+      auto const & gp = tracks[i].result;
+      if unlikely(!gp) {
+	result[first+i] = TsosWP(TrajectoryStateOnSurface(),0.);
+	continue;
+      }
+      SurfaceSideDefinition::SurfaceSide side = PropagationDirectionFromPath()(gp.s(),propagationDirection())==alongMomentum
+	? SurfaceSideDefinition::beforeSurface : SurfaceSideDefinition::afterSurface;
+      result[first+i] = analyticalErrorPropagation( ts[i], target.surface(), side, gp.parameters(), gp.s());
+    }
+  }
+}
+
+Propagator * RKBatchPropagator::clone() const
+{
+  return new RKBatchPropagator(*this);
+}
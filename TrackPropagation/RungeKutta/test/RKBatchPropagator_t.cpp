@@ -0,0 +1,117 @@
+#include "TrackPropagation/RungeKutta/interface/RKBatchPropagator.h"
+#include "TrackPropagation/RungeKutta/interface/defaultRKPropagator.h"
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "DataFormats/GeometrySurface/interface/Cylinder.h"
+#include "TrackingTools/TrajectoryState/interface/FreeTrajectoryState.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+
+#include "FWCore/Utilities/interface/HRRealTime.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Compares RKBatchPropagator to RKPropagatorInS and times both on the same
+// states, propagated to an endcap plane and to a barrel cylinder in a
+// non uniform field; the number of states can be given as argument.
+
+class RadialField final : public MagneticField {
+public:
+
+  GlobalVector inTesla ( const GlobalPoint& gp) const override {
+    float r2 = gp.perp2()*1.e-6f;
+    float z = gp.z()*1.e-3f;
+    float bz = 3.8f/(1.f + r2 + z*z);
+    return GlobalVector(0.2f*gp.x()*z*1.e-3f, 0.2f*gp.y()*z*1.e-3f, bz);
+  }
+
+};
+
+typedef std::pair<TrajectoryStateOnSurface,double> TsosWP;
+
+double maxDifference(TsosWP const & a, TsosWP const & b) {
+  if (a.first.isValid() != b.first.isValid()) return 1.e30;
+  if (!a.first.isValid()) return 0;
+  double d = std::abs(a.second-b.second)/(std::abs(a.second)+1.e-9);
+  d = std::max(d, double((a.first.globalPosition()-b.first.globalPosition()).mag()));
+  d = std::max(d, double((a.first.globalMomentum()-b.first.globalMomentum()).mag()/b.first.globalMomentum().mag()));
+  return d;
+}
+
+template <typename Surf>
+bool compare(const char * what, std::vector<FreeTrajectoryState> const & states, Surf const & surface,
+	     Propagator const & rk, RKBatchPropagator const & batch) {
+  unsigned int n = states.size();
+  std::vector<TsosWP> scalar(n), single(n), batched(n);
+  Propagator const & oneByOne = batch;
+  bool ok = true;
+  for (int iter=0; iter<3; ++iter) {
+    edm::HRTimeType s= edm::hrRealTime();
+    for (unsigned int i=0; i<n; ++i) scalar[i] = rk.propagateWithPath(states[i], surface);
+    edm::HRTimeType e = edm::hrRealTime();
+    for (unsigned int i=0; i<n; ++i) single[i] = oneByOne.propagateWithPath(states[i], surface);
+    edm::HRTimeType se = edm::hrRealTime();
+    batch.propagateWithPath(states.data(), n, surface, batched.data());
+    edm::HRTimeType be = edm::hrRealTime();
+
+    double d = 0;
+    unsigned int valid = 0;
+    for (unsigned int i=0; i<n; ++i) {
+      d = std::max(d, maxDifference(scalar[i], single[i]));
+      d = std::max(d, maxDifference(scalar[i], batched[i]));
+      if (scalar[i].first.isValid()) ++valid;
+    }
+
+    std::cout << what << ": " << valid << "/" << n << " valid, RKPropagatorInS " << double(e-s)/n
+	      << ", RKBatchPropagator one by one " << double(se-e)/n
+	      << ", in lock-step " << double(be-se)/n
+	      << " clock per state, max difference " << d << std::endl;
+    ok &= d < 1.e-4;
+  }
+  return ok;
+}
+
+int main(int argc, char** argv) {
+
+  unsigned int n = argc > 1 ? std::atoi(argv[1]) : 10000;
+
+  RadialField field;
+  defaultRKPropagator::Product prod(&field, alongMomentum);
+  RKBatchPropagator batch(&field, alongMomentum);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> flat(-1.,1.);
+
+  AlgebraicSymMatrix55 cov;
+  for (int i=0; i<5; ++i) cov(i,i) = 1.e-4;
+
+  std::vector<FreeTrajectoryState> forward, barrel;
+  forward.reserve(n);
+  barrel.reserve(n);
+  for (unsigned int i=0; i<n; ++i) {
+    TrackCharge charge = i%2 ? 1 : -1;
+    float pt = 2.f + 20.f*std::abs(flat(gen));
+    float phi = M_PI*flat(gen);
+    // forward tracks towards the endcap, barrel tracks towards the muon chambers
+    float fz = 0.3f*flat(gen);
+    forward.emplace_back(GlobalTrajectoryParameters(GlobalPoint(flat(gen),flat(gen),300.f),
+						    GlobalVector(pt*std::cos(phi)*fz,pt*std::sin(phi)*fz,pt),
+						    charge, &field), CurvilinearTrajectoryError(cov));
+    barrel.emplace_back(GlobalTrajectoryParameters(GlobalPoint(100.f*std::cos(phi),100.f*std::sin(phi),50.f*flat(gen)),
+						   GlobalVector(pt*std::cos(phi),pt*std::sin(phi),pt*flat(gen)),
+						   charge, &field), CurvilinearTrajectoryError(cov));
+  }
+
+  Plane::PlanePointer plane = Plane::build(Plane::PositionType(0,0,700), Plane::RotationType());
+  Cylinder::CylinderPointer cylinder = Cylinder::build(450., Cylinder::PositionType(0,0,0), Cylinder::RotationType());
+
+  bool ok = compare("plane", forward, *plane, prod.propagator, batch);
+  ok &= compare("cylinder", barrel, *cylinder, prod.propagator, batch);
+
+  return ok ? 0 : 1;
+
+}
@@ -97,6 +97,14 @@ public:
     return propagateWithPath( *tsos.freeState(), sur);
   }
 
+  /** Propagates the n states fts to the surface, result having room for
+   *  n states. By default they are propagated one after the other; a
+   *  concrete propagator can take them together.
+   */
+  virtual void
+  propagateWithPath (const FreeTrajectoryState* fts, unsigned int n, const Surface& sur,
+		     std::pair< TrajectoryStateOnSurface, double>* result) const;
+
 
   /// implemented by Stepping Helix
   //! Propagate to PCA to point given a starting point
@@ -43,6 +43,13 @@ Propagator::propagateWithPath (const TrajectoryStateOnSurface& state,
   throw PropagationException("The surface is neither Cylinder nor Plane");
 }
 
+void
+Propagator::propagateWithPath (const FreeTrajectoryState* fts, unsigned int n,
+			       const Surface& sur,
+			       std::pair< TrajectoryStateOnSurface, double>* result) const
+{
+  for (unsigned int i=0; i!=n; ++i) result[i] = propagateWithPath( fts[i], sur);
+}
 
 std::pair<FreeTrajectoryState, double> 
 Propagator::propagateWithPath(const FreeTrajectoryState&, 
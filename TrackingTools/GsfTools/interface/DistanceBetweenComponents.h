@@ -2,6 +2,7 @@
 #define DistanceBetweenComponents_H
 
 #include "TrackingTools/GsfTools/interface/SingleGaussianState.h"
+#include "TrackingTools/GsfTools/interface/MultiGaussianStateSoA.h"
 
 /** Base class (abstract) of calculation of distance between
  *  two Gaussian components.
@@ -16,6 +17,16 @@ public:
   virtual double operator() (const SingleState&, 
 			     const SingleState&) const = 0;
 
+  /** Distances between the component at position i of the mixture and
+   *  each of its remaining components, in result (by position).
+   *  The default implementation calls operator().
+   */
+  virtual void distances(const MultiGaussianStateSoA<N>& mixture, unsigned int i,
+			 double* result) const {
+    auto const & ci = mixture.component(i);
+    for (unsigned int j=0; j!=mixture.size(); ++j) result[j] = (*this)(ci, mixture.component(j));
+  }
+
   virtual DistanceBetweenComponents<N>* clone() const = 0;
 
   virtual ~DistanceBetweenComponents() {}
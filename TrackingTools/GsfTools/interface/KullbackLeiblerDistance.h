@@ -15,6 +15,12 @@ public:
  double operator() (const SingleGaussianState<N>&, 
 			     const SingleGaussianState<N>&) const override;
 
+  /** Distances of the component at position i to all the remaining
+   *  components of the mixture, computed for all of them at once.
+   */
+  void distances(const MultiGaussianStateSoA<N>& mixture, unsigned int i,
+		 double* result) const override;
+
   KullbackLeiblerDistance<N>* clone() const override
   {  
     return new KullbackLeiblerDistance<N>(*this);
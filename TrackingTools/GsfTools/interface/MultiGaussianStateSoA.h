@@ -0,0 +1,98 @@
+#ifndef MultiGaussianStateSoA_H
+#define MultiGaussianStateSoA_H
+
+#include "TrackingTools/GsfTools/interface/SingleGaussianState.h"
+
+#include <memory>
+#include <vector>
+
+/** Components of a Gaussian mixture stored as a structure of arrays:
+ *  a given element of the mean, of the covariance or of the weight
+ *  matrix is contiguous for all the components, so that quantities
+ *  involving many components can be computed in loops over the
+ *  components which can be vectorized. The symmetric matrices are
+ *  stored as their lower triangles, in the order of MatRepSym.
+ *  Components can be removed, the last one taking the place of the
+ *  removed one, so that the remaining ones stay contiguous; index()
+ *  and position() convert between positions and indices in fill().
+ */
+
+template <unsigned int N>
+class MultiGaussianStateSoA {
+public:
+  using SingleState = SingleGaussianState<N>;
+  using SingleStatePtr = std::shared_ptr<SingleState>;
+
+  /// number of elements of a symmetric matrix
+  static constexpr unsigned int NSym = N*(N+1)/2;
+
+  /// packs the components, computing their weight matrices if not yet done
+  void fill(const std::vector<SingleStatePtr>& components) {
+    theSize = components.size();
+    theStride = theSize;
+    theStates.resize(theSize);
+    theIndices.resize(theSize);
+    thePositions.resize(theSize);
+    theMeans.resize(N*theStride);
+    theCovariances.resize(NSym*theStride);
+    theWeightMatrices.resize(NSym*theStride);
+    for (unsigned int i=0; i!=theSize; ++i) {
+      auto const & c = *components[i];
+      theStates[i] = &c;
+      theIndices[i] = i;
+      thePositions[i] = i;
+      for (unsigned int k=0; k!=N; ++k) theMeans[k*theStride+i] = c.mean()[k];
+      auto const * v = c.covariance().Array();
+      auto const * g = c.weightMatrix().Array();
+      for (unsigned int p=0; p!=NSym; ++p) {
+	theCovariances[p*theStride+i] = v[p];
+	theWeightMatrices[p*theStride+i] = g[p];
+      }
+    }
+  }
+
+  /// removes the component at position pos, moving the last one there
+  void remove(unsigned int pos) {
+    const unsigned int last = theSize-1;
+    if (pos!=last) {
+      theStates[pos] = theStates[last];
+      theIndices[pos] = theIndices[last];
+      thePositions[theIndices[pos]] = pos;
+      for (unsigned int k=0; k!=N; ++k) theMeans[k*theStride+pos] = theMeans[k*theStride+last];
+      for (unsigned int p=0; p!=NSym; ++p) {
+	theCovariances[p*theStride+pos] = theCovariances[p*theStride+last];
+	theWeightMatrices[p*theStride+pos] = theWeightMatrices[p*theStride+last];
+      }
+    }
+    theSize = last;
+  }
+
+  /// number of components left
+  unsigned int size() const {return theSize;}
+
+  const SingleState& component(unsigned int pos) const {return *theStates[pos];}
+
+  /// index in fill() of the component at position pos
+  unsigned int index(unsigned int pos) const {return theIndices[pos];}
+  /// position of the component of index i in fill(), if not removed
+  unsigned int position(unsigned int i) const {return thePositions[i];}
+
+  /// element k of the means of all the components
+  const double* mean(unsigned int k) const {return theMeans.data() + k*theStride;}
+  /// element p of the packed covariances of all the components
+  const double* covariance(unsigned int p) const {return theCovariances.data() + p*theStride;}
+  /// element p of the packed weight matrices of all the components
+  const double* weightMatrix(unsigned int p) const {return theWeightMatrices.data() + p*theStride;}
+
+private:
+  unsigned int theSize = 0;
+  unsigned int theStride = 0;
+  std::vector<const SingleState*> theStates;
+  std::vector<unsigned int> theIndices;
+  std::vector<unsigned int> thePositions;
+  std::vector<double> theMeans;
+  std::vector<double> theCovariances;
+  std::vector<double> theWeightMatrices;
+};
+
+#endif // MultiGaussianStateSoA_H
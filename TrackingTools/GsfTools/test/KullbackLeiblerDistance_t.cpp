@@ -15,6 +15,8 @@
 #include "FWCore/Utilities/interface/HRRealTime.h"
 #include<iostream>
 #include<vector>
+#include<memory>
+#include<cmath>
 
 bool isAligned(const void* data, long alignment)
 {
@@ -141,7 +143,59 @@ int main(int argc, char * argv[]) {
  
   std:: cout << res << std::endl;
 
+  // the same distances computed all at once
+  std::vector<std::shared_ptr<GS>> pgs;
+  for (auto const & g : vgs) pgs.push_back(std::make_shared<GS>(g));
+  MultiGaussianStateSoA<5> packed;
+  packed.fill(pgs);
+  std::vector<double> dists(vgs.size());
+  double resb=0;
+  st();
+  s= edm::hrRealTime();
+  for (int i=0; i<100;	++i) { 
+    d.distances(packed,0,dists.data());
+    for (auto x : dists) resb+=x;
+  }
+  e = edm::hrRealTime();
+  en();
+
+  std::cout << e-s << std::endl;
+
+  std:: cout << resb << std::endl;
+
+  unsigned int mismatches=0;
+  for (unsigned int i=0; i<vgs.size(); ++i) { 
+    auto one = d(vgs.front(),vgs[i]);
+    if (std::abs(one-dists[i])>1.e-8*(1.+std::abs(one))) { 
+      std::cout << "mismatch " << i << " " << one << " " << dists[i] << std::endl;
+      ++mismatches;
+    }
+  }
 
+  // and after removing components, as in CloseComponentsMerger
+  std::vector<std::shared_ptr<GS>> few;
+  for (int i=0; i<12; ++i) {
+    Vector mu(0.1*i, 1.-0.2*i, 0.3*i, 1.+0.05*i*i, -0.1*i);
+    few.push_back(std::make_shared<GS>(mu, i%2 ? cov1 : buildCovariance(0.5+0.1*i)));
+  }
+  packed.fill(few);
+  for (auto i : {0, 11, 5, 6, 1}) packed.remove(packed.position(i));
+  for (unsigned int p=0; p<packed.size(); ++p) { 
+    d.distances(packed,p,dists.data());
+    auto const & gi = *few[packed.index(p)];
+    for (unsigned int q=0; q<packed.size(); ++q) { 
+      auto one = d(gi,*few[packed.index(q)]);
+      if (std::abs(one-dists[q])>1.e-8*(1.+std::abs(one))) { 
+        std::cout << "mismatch " << packed.index(p) << " " << packed.index(q) << " " << one << " " << dists[q] << std::endl;
+        ++mismatches;
+      }
+    }
+  }
+
+  if (mismatches) { 
+    std::cout << mismatches << " mismatches" << std::endl;
+    return 1;
+  }
   return 0;
 
 }
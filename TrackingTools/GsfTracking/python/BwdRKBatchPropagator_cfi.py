@@ -0,0 +1,10 @@
+import FWCore.ParameterSet.Config as cms
+
+from TrackingTools.GsfTracking.FwdRKBatchPropagator_cfi import *
+#
+# "backward" Runge-Kutta alternative to bwdAnalyticalPropagator
+#
+bwdRKBatchPropagator = fwdRKBatchPropagator.clone(
+    ComponentName = 'bwdRKBatchPropagator',
+    PropagationDirection = 'oppositeToMomentum'
+)
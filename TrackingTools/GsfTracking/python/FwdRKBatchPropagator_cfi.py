@@ -0,0 +1,8 @@
+import FWCore.ParameterSet.Config as cms
+
+# Runge-Kutta alternative to fwdAnalyticalPropagator as GeometricalPropagator
+# of the GSF fitter: propagates all the components of a state in lock-step
+fwdRKBatchPropagator = cms.ESProducer("RKBatchPropagatorESProducer",
+    ComponentName = cms.string('fwdRKBatchPropagator'),
+    PropagationDirection = cms.string('alongMomentum')
+)
@@ -0,0 +1,89 @@
+#ifndef _TRACKER_KFBATCHUPDATOR_H_
+#define _TRACKER_KFBATCHUPDATOR_H_
+
+/** \class KFBatchUpdator
+ * Same Kalman filter update as KFUpdator, applied to many
+ * (predicted state, hit) pairs at once. <BR>
+ *
+ * The pairs are first collected with add(); update() then computes all
+ * the filtered states. The states and the hit measurements are stored,
+ * grouped by hit dimension, in blocks of W pairs holding one array of W
+ * values per matrix element, so that the gain, the filtered state and its
+ * covariance are computed by loops over the W pairs of a block which the
+ * compiler vectorizes.
+ * Only the common tracker case of a hit measuring the local position
+ * (local parameters 3 and 4) is batched; any other hit is updated by
+ * KFUpdator at once in add(). <BR>
+ *
+ * Results agree with KFUpdator up to rounding, as the matrix products
+ * are not evaluated in the same order.
+ *
+ * The predicted states passed to add() must stay alive until update()
+ * has been called.
+ */
+
+#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+
+#include <vector>
+
+class TrackingRecHit;
+
+class KFBatchUpdator {
+
+public:
+
+  /// number of pairs computed together
+  static constexpr unsigned int W = 8;
+
+  KFBatchUpdator() {}
+
+  /// queue the update of @a tsos with @a hit, returns the index of the result
+  unsigned int add(const TrajectoryStateOnSurface& tsos, const TrackingRecHit& hit);
+
+  /// compute all the queued updates
+  void update();
+
+  /// the filtered state of pair @a i, valid after update()
+  TrajectoryStateOnSurface & state(unsigned int i) { return theStates[i]; }
+
+  unsigned int size() const { return theStates.size(); }
+
+  /// forget all the pairs, keeping the allocated memory
+  void clear();
+
+private:
+
+  template <unsigned int D>
+  struct Columns {
+    static constexpr unsigned int NV = D*(D+1)/2;
+
+    // state vector, packed covariance, residual, hit error and
+    // covariance of the residual; x and C are replaced by the filtered
+    // ones by compute()
+    struct Block {
+      double x[5][W], C[15][W], r[D][W], V[NV][W], R[NV][W];
+      bool ok[W];
+    };
+
+    std::vector<Block> blocks;
+    std::vector<const TrajectoryStateOnSurface*> tsos;
+    std::vector<unsigned int> index;
+
+    unsigned int size() const { return index.size(); }
+    // false if the hit does not measure the local position
+    bool push_back(const TrajectoryStateOnSurface& ts, const TrackingRecHit& hit, unsigned int i);
+    void compute();
+    void clear();
+  };
+
+  template <unsigned int D>
+  void fill(Columns<D>& columns);
+
+  KFUpdator theScalar;
+  Columns<1> theColumns1;
+  Columns<2> theColumns2;
+  std::vector<TrajectoryStateOnSurface> theStates;
+};
+
+#endif
@@ -0,0 +1,188 @@
+#include "TrackingTools/KalmanUpdators/interface/KFBatchUpdator.h"
+#include "DataFormats/TrackingRecHit/interface/TrackingRecHit.h"
+#include "DataFormats/TrackingRecHit/interface/KfComponentsHolder.h"
+#include "DataFormats/Math/interface/ProjectMatrix.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+namespace {
+
+  constexpr unsigned int W = KFBatchUpdator::W;
+
+  // index of element (i,j) in the packed columns of a symmetric matrix
+  constexpr unsigned int sym(unsigned int i, unsigned int j) {
+    return i<j ? j*(j+1)/2+i : i*(i+1)/2+j;
+  }
+
+  // inverse of the covariance R of the residuals; lanes where R is not positive definite are flagged
+  inline void invert(double const (&R)[1][W], double (&Ri)[1][W], bool (&ok)[W]) {
+    for (unsigned int l=0; l<W; ++l) {
+      ok[l] = R[0][l] > 0;
+      Ri[0][l] = 1./(ok[l] ? R[0][l] : 1.);
+    }
+  }
+
+  inline void invert(double const (&R)[3][W], double (&Ri)[3][W], bool (&ok)[W]) {
+    for (unsigned int l=0; l<W; ++l) {
+      double R00 = R[0][l];
+      double R01 = R[1][l];
+      double R11 = R[2][l];
+      double det = R00*R11 - R01*R01;
+      ok[l] = R00 > 0 && det > 0;
+      double idet = 1./(ok[l] ? det : 1.);
+      Ri[0][l] =  R11*idet;
+      Ri[1][l] = -R01*idet;
+      Ri[2][l] =  R00*idet;
+    }
+  }
+
+}
+
+template <unsigned int D>
+bool KFBatchUpdator::Columns<D>::push_back(const TrajectoryStateOnSurface& ts, const TrackingRecHit& hit, unsigned int iState) {
+  typedef typename AlgebraicROOTObject<D,D>::SymMatrix SMatDD;
+  typedef typename AlgebraicROOTObject<D>::Vector VecD;
+  using ROOT::Math::SMatrixNoInit;
+
+  auto && par = ts.localParameters().vector();
+  auto && err = ts.localError().matrix();
+
+  ProjectMatrix<double,5,D> pf;
+  VecD r, rMeas;
+  SMatDD rErr(SMatrixNoInit{}), VMeas(SMatrixNoInit{});
+
+  KfComponentsHolder holder;
+  holder.template setup<D>(&r, &rErr, &pf, &rMeas, &VMeas, par, err);
+  hit.getKfComponents(holder);
+
+  // as in KFUpdator, the residual and its covariance are taken from the hit,
+  // which may do more than project the state; the gain needs H to select
+  // the local position
+  r -= rMeas;
+  SMatDD R = rErr + VMeas;
+  for (unsigned int a=0; a<D; ++a)
+    if (pf.index[a] != 3+a) return false;
+
+  unsigned int n = size();
+  if (n%W == 0) blocks.emplace_back();
+  auto & b = blocks.back();
+  unsigned int l = n%W;
+  for (unsigned int i=0; i<5; ++i) {
+    b.x[i][l] = par[i];
+    for (unsigned int j=0; j<=i; ++j) b.C[sym(i,j)][l] = err(i,j);
+  }
+  for (unsigned int a=0; a<D; ++a) {
+    b.r[a][l] = r[a];
+    for (unsigned int c=0; c<=a; ++c) {
+      b.V[sym(a,c)][l] = rErr(a,c);
+      b.R[sym(a,c)][l] = R(a,c);
+    }
+  }
+  tsos.push_back(&ts);
+  index.push_back(iState);
+  return true;
+}
+
+template <unsigned int D>
+void KFBatchUpdator::Columns<D>::compute() {
+  for (auto & b : blocks) {
+    double Ri[NV][W];
+    invert(b.R, Ri, b.ok);
+
+    // Kalman gain K = C H^T R^-1
+    double K[5][D][W];
+    for (unsigned int i=0; i<5; ++i)
+      for (unsigned int a=0; a<D; ++a)
+	for (unsigned int l=0; l<W; ++l) {
+	  double k = 0;
+	  for (unsigned int c=0; c<D; ++c) k += b.C[sym(i,3+c)][l]*Ri[sym(c,a)][l];
+	  K[i][a][l] = k;
+	}
+
+    // filtered state vector x + K r
+    for (unsigned int i=0; i<5; ++i)
+      for (unsigned int a=0; a<D; ++a)
+	for (unsigned int l=0; l<W; ++l) b.x[i][l] += K[i][a][l]*b.r[a][l];
+
+    // filtered covariance M C M^T + K V K^T, with M = 1 - K H
+    double MC[5][5][W];
+    for (unsigned int i=0; i<5; ++i)
+      for (unsigned int j=0; j<5; ++j)
+	for (unsigned int l=0; l<W; ++l) {
+	  double mc = b.C[sym(i,j)][l];
+	  for (unsigned int a=0; a<D; ++a) mc -= K[i][a][l]*b.C[sym(3+a,j)][l];
+	  MC[i][j][l] = mc;
+	}
+    double KV[5][D][W];
+    for (unsigned int i=0; i<5; ++i)
+      for (unsigned int a=0; a<D; ++a)
+	for (unsigned int l=0; l<W; ++l) {
+	  double kv = 0;
+	  for (unsigned int c=0; c<D; ++c) kv += K[i][c][l]*b.V[sym(c,a)][l];
+	  KV[i][a][l] = kv;
+	}
+    for (unsigned int i=0; i<5; ++i)
+      for (unsigned int j=0; j<=i; ++j)
+	for (unsigned int l=0; l<W; ++l) {
+	  double e = MC[i][j][l];
+	  for (unsigned int a=0; a<D; ++a) e += (KV[i][a][l] - MC[i][3+a][l])*K[j][a][l];
+	  b.C[sym(i,j)][l] = e;
+	}
+  }
+}
+
+template <unsigned int D>
+void KFBatchUpdator::Columns<D>::clear() {
+  blocks.clear();
+  tsos.clear();
+  index.clear();
+}
+
+template <unsigned int D>
+void KFBatchUpdator::fill(Columns<D>& columns) {
+  for (unsigned int n=0; n<columns.size(); ++n) {
+    auto const & b = columns.blocks[n/W];
+    unsigned int l = n%W;
+    auto const & tsos = *columns.tsos[n];
+    if (b.ok[l]) {
+      AlgebraicVector5 fsv;
+      AlgebraicSymMatrix55 fse;
+      for (unsigned int i=0; i<5; ++i) {
+	fsv[i] = b.x[i][l];
+	for (unsigned int j=0; j<=i; ++j) fse(i,j) = b.C[sym(i,j)][l];
+      }
+      theStates[columns.index[n]] =
+	TrajectoryStateOnSurface( LocalTrajectoryParameters(fsv, tsos.localParameters().pzSign()),
+				  LocalTrajectoryError(fse), tsos.surface(), &(tsos.globalParameters().magneticField()), tsos.surfaceSide() );
+    } else {
+      edm::LogError("KFUpdator")<<" could not invert matrix of a " << D << "D measurement";
+      theStates[columns.index[n]] = TrajectoryStateOnSurface();
+    }
+  }
+}
+
+unsigned int KFBatchUpdator::add(const TrajectoryStateOnSurface& tsos, const TrackingRecHit& hit) {
+  unsigned int i = theStates.size();
+  theStates.emplace_back();
+  bool batched = false;
+  switch (hit.dimension()) {
+    case 1: batched = theColumns1.push_back(tsos, hit, i); break;
+    case 2: batched = theColumns2.push_back(tsos, hit, i); break;
+  }
+  if (!batched) theStates.back() = theScalar.update(tsos, hit);
+  return i;
+}
+
+void KFBatchUpdator::update() {
+  theColumns1.compute();
+  theColumns2.compute();
+  fill(theColumns1);
+  fill(theColumns2);
+  theColumns1.clear();
+  theColumns2.clear();
+}
+
+void KFBatchUpdator::clear() {
+  theColumns1.clear();
+  theColumns2.clear();
+  theStates.clear();
+}
@@ -0,0 +1,137 @@
+#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "TrackingTools/KalmanUpdators/interface/KFBatchUpdator.h"
+
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "DataFormats/GeometrySurface/interface/Surface.h"
+#include "DataFormats/GeometrySurface/interface/BoundPlane.h"
+#include <Geometry/CommonDetUnit/interface/GeomDet.h>
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit1D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
+#include "DataFormats/TrackingRecHit/interface/KfComponentsHolder.h"
+
+#include "FWCore/Utilities/interface/HRRealTime.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Compares KFBatchUpdator to KFUpdator and times both on the same
+// (state, hit) pairs; the number of pairs can be given as argument.
+
+class ConstMagneticField : public MagneticField {
+public:
+
+  virtual GlobalVector inTesla ( const GlobalPoint& ) const {
+    return GlobalVector(0,0,4);
+  }
+
+};
+
+class MyDet : public GeomDet {
+ public:
+  MyDet(BoundPlane * bp, DetId id) :
+    GeomDet(bp){setDetId(id);}
+
+  virtual std::vector< const GeomDet*> components() const {
+    return std::vector< const GeomDet*>();
+  }
+
+  virtual SubDetector subDetector() const {return GeomDetEnumerators::DT;}
+
+};
+
+// a hit whose Kalman filter components are not a plain projection of the state
+class ShiftedRecHit : public TrackerSingleRecHit {
+public:
+  ShiftedRecHit(const LocalPoint& pos, const LocalError& err, GeomDet const & idet, OmniClusterRef const& clus) :
+    TrackerSingleRecHit(pos,err,idet,clus) {}
+
+  virtual ShiftedRecHit * clone() const {return new ShiftedRecHit(*this);}
+
+  virtual int dimension() const {return 2;}
+  virtual void getKfComponents( KfComponentsHolder & holder ) const {
+    getKfComponents2D(holder);
+    holder.measuredParams<2>()[0] += 0.02;
+    holder.measuredErrors<2>()(1,1) += 0.003;
+  }
+};
+
+double maxDifference(TrajectoryStateOnSurface const & a, TrajectoryStateOnSurface const & b) {
+  if (a.isValid() != b.isValid()) return 1.e30;
+  if (!a.isValid()) return 0;
+  double d = 0;
+  auto && va = a.localParameters().vector();
+  auto && vb = b.localParameters().vector();
+  auto && ea = a.localError().matrix();
+  auto && eb = b.localError().matrix();
+  for (int i=0; i<5; ++i) {
+    d = std::max(d, std::abs(va[i]-vb[i])/(std::abs(va[i])+std::abs(vb[i])+1.e-9));
+    for (int j=0; j<=i; ++j) d = std::max(d, std::abs(ea(i,j)-eb(i,j))/(std::abs(ea(i,j))+std::abs(eb(i,j))+1.e-9));
+  }
+  return d;
+}
+
+int main(int argc, char** argv) {
+
+  unsigned int n = argc > 1 ? std::atoi(argv[1]) : 10000;
+
+  MagneticField * field = new ConstMagneticField;
+  GlobalPoint gp(0,0,0);
+  BoundPlane* plane = new BoundPlane( gp, Surface::RotationType());
+  GeomDet *  det =  new MyDet(plane,41);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> flat(-1.,1.);
+
+  std::vector<TrajectoryStateOnSurface> states;
+  std::vector<std::unique_ptr<TrackingRecHit>> hits;
+  states.reserve(n);
+  hits.reserve(n);
+  OmniClusterRef cref;
+  SiPixelRecHit::ClusterRef pref;
+  for (unsigned int i=0; i<n; ++i) {
+    LocalPoint lp(flat(gen),flat(gen),0);
+    LocalVector lv(flat(gen),flat(gen),1);
+    LocalTrajectoryParameters ltp(lp,lv,1);
+    LocalTrajectoryError ler(0.1+0.05*flat(gen),0.1+0.05*flat(gen),0.01,0.05,0.1);
+    states.emplace_back(ltp,ler,*plane, field);
+
+    LocalPoint m(lp.x()+0.1f*flat(gen),lp.y()+0.1f*flat(gen),0);
+    LocalError e(0.2,-0.05*flat(gen),0.1);
+    if (i%3 == 1) hits.emplace_back(new SiPixelRecHit(m,e,1.,*det,pref));
+    else if (i%3 == 2) hits.emplace_back(new ShiftedRecHit(m,e,*det,cref));
+    else hits.emplace_back(new SiStripRecHit1D(m,e,*det,cref));
+  }
+
+  KFUpdator kfu;
+  KFBatchUpdator batch;
+  std::vector<TrajectoryStateOnSurface> scalar(n);
+
+  for (int iter=0; iter<5; ++iter) {
+    edm::HRTimeType s= edm::hrRealTime();
+    for (unsigned int i=0; i<n; ++i) scalar[i] = kfu.update(states[i], *hits[i]);
+    edm::HRTimeType e = edm::hrRealTime();
+
+    batch.clear();
+    edm::HRTimeType bs= edm::hrRealTime();
+    for (unsigned int i=0; i<n; ++i) batch.add(states[i], *hits[i]);
+    batch.update();
+    edm::HRTimeType be = edm::hrRealTime();
+
+    double d = 0;
+    for (unsigned int i=0; i<n; ++i) d = std::max(d, maxDifference(scalar[i], batch.state(i)));
+
+    std::cout << n << " updates: KFUpdator " << double(e-s)/n << ", KFBatchUpdator " << double(be-bs)/n
+	      << " clock per update, max relative difference " << d << std::endl;
+    if (d > 1.e-6) return 1;
+  }
+
+  return 0;
+
+}
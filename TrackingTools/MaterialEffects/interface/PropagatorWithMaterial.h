@@ -34,10 +34,14 @@ public:
    *  account the uncertainty in the reconstructed track momentum, (by
    *  default neglected), but assuming that the track Pt will never fall
    *  below ptMin.
+   *  If useRungeKuttaBatch is true the geometrical propagator is a
+   *  RKBatchPropagator, which can also propagate several states in
+   *  lock-step (see geometricalPropagator()).
    */
   PropagatorWithMaterial (PropagationDirection dir, const float mass,
 			  const MagneticField * mf=nullptr,const float maxDPhi=1.6,
-			  bool useRungeKutta=false, float ptMin=-1.,bool useOldGeoPropLogic=true);
+			  bool useRungeKutta=false, float ptMin=-1.,bool useOldGeoPropLogic=true,
+			  bool useRungeKuttaBatch=false);
 
   ~PropagatorWithMaterial() override;
 
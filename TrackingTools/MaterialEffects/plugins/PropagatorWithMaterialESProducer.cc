@@ -37,6 +37,8 @@ PropagatorWithMaterialESProducer::produce(const TrackingComponentsRecord & iReco
   bool useOldAnalPropLogic = pset_.existsAs<bool>("useOldAnalPropLogic") ? 
     pset_.getParameter<bool>("useOldAnalPropLogic") : true;
   double ptMin     = pset_.existsAs<double>("ptMin") ? pset_.getParameter<double>("ptMin") : -1.0;
+  bool useRKBatch  = pset_.existsAs<bool>("useRungeKuttaBatch") ?
+    pset_.getParameter<bool>("useRungeKuttaBatch") : false;
 
   ESHandle<MagneticField> magfield;
   std::string mfName = "";
@@ -55,7 +57,7 @@ PropagatorWithMaterialESProducer::produce(const TrackingComponentsRecord & iReco
   
   _propagator = std::make_shared<PropagatorWithMaterial>(dir, mass, &(*magfield),
 									maxDPhi,useRK,ptMin,
-									useOldAnalPropLogic);
+									useOldAnalPropLogic,useRKBatch);
   return _propagator;
 }
 
@@ -0,0 +1,10 @@
+import FWCore.ParameterSet.Config as cms
+
+from TrackingTools.MaterialEffects.RungeKuttaTrackerPropagatorOpposite_cfi import RungeKuttaTrackerPropagatorOpposite as _RungeKuttaTrackerPropagatorOpposite
+
+# Runge-Kutta propagator for muon and forward tracking, with the lock-step RKBatchPropagator
+# and the batched field queries instead of RKPropagatorInS
+RungeKuttaBatchTrackerPropagatorOpposite = _RungeKuttaTrackerPropagatorOpposite.clone(
+    ComponentName = 'RungeKuttaBatchTrackerPropagatorOpposite',
+    useRungeKuttaBatch = cms.bool(True)
+)
@@ -0,0 +1,10 @@
+import FWCore.ParameterSet.Config as cms
+
+from TrackingTools.MaterialEffects.RungeKuttaTrackerPropagator_cfi import RungeKuttaTrackerPropagator as _RungeKuttaTrackerPropagator
+
+# Runge-Kutta propagator for muon and forward tracking, with the lock-step RKBatchPropagator
+# and the batched field queries instead of RKPropagatorInS
+RungeKuttaBatchTrackerPropagator = _RungeKuttaTrackerPropagator.clone(
+    ComponentName = 'RungeKuttaBatchTrackerPropagator',
+    useRungeKuttaBatch = cms.bool(True)
+)
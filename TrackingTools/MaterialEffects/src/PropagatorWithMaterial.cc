@@ -1,6 +1,7 @@
 #include "TrackingTools/GeomPropagators/interface/PropagationDirectionFromPath.h"
 #include "TrackingTools/MaterialEffects/interface/PropagatorWithMaterial.h"
 #include "TrackingTools/GeomPropagators/interface/AnalyticalPropagator.h"
+#include "TrackPropagation/RungeKutta/interface/RKBatchPropagator.h"
 #include "TrackingTools/MaterialEffects/interface/CombinedMaterialEffectsUpdator.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include <string>
@@ -15,10 +16,13 @@ PropagatorWithMaterial::PropagatorWithMaterial (PropagationDirection dir,
 						const MagneticField * mf,
 						const float maxDPhi,
 						bool useRungeKutta,
-                                                float ptMin,bool useOldAnalPropLogic) :
+                                                float ptMin,bool useOldAnalPropLogic,
+						bool useRungeKuttaBatch) :
   Propagator(dir),
   rkProduct(mf,dir),
-  theGeometricalPropagator(useRungeKutta ?
+  theGeometricalPropagator(useRungeKuttaBatch ?
+			   new RKBatchPropagator(mf,dir) :
+			   useRungeKutta ?
 			   rkProduct.propagator.clone() :
 			   new AnalyticalPropagator(mf,dir,maxDPhi,useOldAnalPropLogic)
 			   ),
@@ -2,6 +2,7 @@
 #define CMSUTILS_BEUEUE_H
 #include <boost/intrusive_ptr.hpp>
 #include<cassert>
+#include "TrackingTools/TrajectoryState/interface/PoolAllocator.h"
 
 /**  Backwards linked queue with "head sharing"
 
@@ -23,6 +24,8 @@
      Note that boost::intrusive_ptr is used for items, so they are deleted automatically
      while avoiding problems if one deletes a queue which shares the head with another one
 
+     The items are allocated from the thread-local pools of PoolAllocator.h when they are on
+
      Disclaimer: I'm not sure the const_iterator is really const-correct..
 
      V.I. 22/08/2012 As the bqueue is made to be shared its content ahs been forced to be constant.
@@ -48,20 +51,38 @@ namespace cmsutils {
     friend void intrusive_ptr_add_ref<T>(_bqueue_item<T> *it);
     friend void intrusive_ptr_release<T>(_bqueue_item<T> *it);
     void addRef() { ++refCount; }
-    void delRef() { if ((--refCount) == 0) delete this; }
+    void delRef() {
+      if ((--refCount) == 0) {
+	pool_allocator<_bqueue_item> alloc(pooled);
+	this->~_bqueue_item();
+	alloc.deallocate(this,1);
+      }
+    }
+    // from the pools if they are on for the calling thread
+    template<typename... Args>
+    static _bqueue_item * make(Args && ...args) {
+      pool_allocator<_bqueue_item> alloc;
+      auto p = alloc.allocate(1);
+      try { new (p) _bqueue_item(std::forward<Args>(args)...); }
+      catch (...) { alloc.deallocate(p,1); throw; }
+      p->pooled = alloc.pooled();
+      return p;
+    }
   private:
-    _bqueue_item() : back(0), value(), refCount(0) { }
-    _bqueue_item(boost::intrusive_ptr< _bqueue_item<T> > tail, const T &val) : back(tail), value(val), refCount(0) { }
+    _bqueue_item() : back(0), value(), refCount(0), pooled(0) { }
+    _bqueue_item(boost::intrusive_ptr< _bqueue_item<T> > tail, const T &val) : back(tail), value(val), refCount(0), pooled(0) { }
     // move
     _bqueue_item(boost::intrusive_ptr< _bqueue_item<T> > tail, T &&val) : 
-      back(tail), value(std::move(val)), refCount(0) { }
+      back(tail), value(std::move(val)), refCount(0), pooled(0) { }
     // emplace
     template<typename... Args>
     _bqueue_item(boost::intrusive_ptr< _bqueue_item<T> > tail, Args && ...args) : 
-      back(tail), value(std::forward<Args>(args)...), refCount(0) { }
+      back(tail), value(std::forward<Args>(args)...), refCount(0), pooled(0) { }
     boost::intrusive_ptr< _bqueue_item<T> > back;
     T const value;
-    unsigned int refCount;
+    // whether the item is in the pools, kept in the word of the count
+    unsigned int refCount : 31;
+    unsigned int pooled : 1;
   };
   
   template<class T> inline void intrusive_ptr_add_ref(_bqueue_item<T> *it) { it->addRef(); }
@@ -131,20 +152,20 @@ namespace cmsutils {
     
     // copy
     void push_back(const T& val) {
-      m_tail = itemptr(new item(this->m_tail, val)); 
+      m_tail = itemptr(item::make(this->m_tail, val)); 
       if ((++m_size) == 1) { m_head = m_tail; };
     }
     
     //move 
     void push_back(T&& val) {
-      m_tail = itemptr(new item(this->m_tail, std::forward<T>(val))); 
+      m_tail = itemptr(item::make(this->m_tail, std::forward<T>(val))); 
       if ((++m_size) == 1) { m_head = m_tail; };
     }
     
     // emplace
     template<typename... Args>
     void emplace_back(Args && ...args){
-      m_tail = itemptr(new item(this->m_tail, std::forward<Args>(args)...)); 
+      m_tail = itemptr(item::make(this->m_tail, std::forward<Args>(args)...)); 
       if ((++m_size) == 1) { m_head = m_tail; };
     }
     
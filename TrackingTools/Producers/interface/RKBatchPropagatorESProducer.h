@@ -0,0 +1,25 @@
+#ifndef TrackingTools_ESProducers_RKBatchPropagatorESProducer_h
+#define TrackingTools_ESProducers_RKBatchPropagatorESProducer_h
+
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "TrackPropagation/RungeKutta/interface/RKBatchPropagator.h"
+#include "TrackingTools/Records/interface/TrackingComponentsRecord.h"
+#include <memory>
+
+/** Geometrical Runge-Kutta propagator without material, that propagates
+ *  several states in lock-step; the Gaussian-sum propagation uses it for
+ *  all the components of a state when it is its geometrical propagator.
+ */
+class  RKBatchPropagatorESProducer: public edm::ESProducer{
+ public:
+  RKBatchPropagatorESProducer(const edm::ParameterSet & p);
+  ~RKBatchPropagatorESProducer() override; 
+  std::shared_ptr<Propagator> produce(const TrackingComponentsRecord &);
+ private:
+  std::shared_ptr<Propagator> _propagator;
+  edm::ParameterSet pset_;
+};
+
+
+#endif
@@ -0,0 +1,36 @@
+#include "TrackingTools/Producers/interface/RKBatchPropagatorESProducer.h"
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
+
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/ModuleFactory.h"
+#include "FWCore/Framework/interface/ESProducer.h"
+
+#include <string>
+#include <memory>
+
+using namespace edm;
+
+RKBatchPropagatorESProducer::RKBatchPropagatorESProducer(const edm::ParameterSet & p) 
+{
+  std::string myname = p.getParameter<std::string>("ComponentName");
+  pset_ = p;
+  setWhatProduced(this,myname);
+}
+
+RKBatchPropagatorESProducer::~RKBatchPropagatorESProducer() {}
+
+std::shared_ptr<Propagator> 
+RKBatchPropagatorESProducer::produce(const TrackingComponentsRecord & iRecord){ 
+  ESHandle<MagneticField> magfield;
+  iRecord.getRecord<IdealMagneticFieldRecord>().get(magfield );
+  std::string pdir = pset_.getParameter<std::string>("PropagationDirection");
+
+  PropagationDirection dir = alongMomentum;
+
+  if (pdir == "oppositeToMomentum") dir = oppositeToMomentum;
+  else if (pdir == "anyDirection") dir = anyDirection;
+  _propagator = std::make_shared<RKBatchPropagator>(&(*magfield),dir);
+  return _propagator;
+}
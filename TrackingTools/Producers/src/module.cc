@@ -1,5 +1,6 @@
 #include "TrackingTools/Producers/interface/AnalyticalPropagatorESProducer.h"
 #include "TrackingTools/Producers/interface/StraightLinePropagatorESProducer.h"
+#include "TrackingTools/Producers/interface/RKBatchPropagatorESProducer.h"
 #include "TrackingTools/Producers/interface/SmartPropagatorESProducer.h"
 #include "TrackingTools/Producers/interface/BeamHaloPropagatorESProducer.h"
 #include "TrackingTools/Producers/interface/TrajectoryCleanerESProducer.h"
@@ -13,6 +14,7 @@
 #include "FWCore/Utilities/interface/typelookup.h"
 
 DEFINE_FWK_EVENTSETUP_MODULE(StraightLinePropagatorESProducer);
+DEFINE_FWK_EVENTSETUP_MODULE(RKBatchPropagatorESProducer);
 DEFINE_FWK_EVENTSETUP_MODULE(AnalyticalPropagatorESProducer);
 DEFINE_FWK_EVENTSETUP_MODULE(SmartPropagatorESProducer);
 DEFINE_FWK_EVENTSETUP_MODULE(BeamHaloPropagatorESProducer);
@@ -2,6 +2,7 @@
 #define BasicTrajectoryState_H
 
 #include "TrackingTools/TrajectoryState/interface/ProxyBase11.h"
+#include "TrackingTools/TrajectoryState/interface/PoolAllocator.h"
 
 #include "TrackingTools/TrajectoryParametrization/interface/LocalTrajectoryParameters.h"
 #include "TrackingTools/TrajectoryParametrization/interface/LocalTrajectoryError.h"
@@ -87,6 +88,9 @@ public:
   template<typename T, typename... Args>
   static std::shared_ptr<BTSOS> churn(Args && ...args){ return std::allocate_shared<T>(churn_allocator<T>(),std::forward<Args>(args)...);}
 
+  template<typename T, typename... Args>
+  static std::shared_ptr<BTSOS> pooled(Args && ...args){ return std::allocate_shared<T>(pool_allocator<T>(),std::forward<Args>(args)...);}
+
 
 
   /** Constructor from FTS and surface. For surfaces with material
@@ -0,0 +1,107 @@
+#ifndef Tracker_PoolAllocator_H
+#define Tracker_PoolAllocator_H
+#include "TrackingTools/TrajectoryState/interface/ChurnAllocator.h"
+
+#include <cstddef>
+
+/** Thread-local pools of fixed size blocks for the small objects that the
+ *  track building creates and destroys by the million (the states of the
+ *  TrajectoryStateOnSurface, the measurement chains of TempTrajectory and
+ *  the cloned rechits).
+ *
+ *  Each thread carves the blocks of each size class (multiples of 16 bytes
+ *  up to maxBlockSize) out of 64 kB slabs of its own.  A block freed by
+ *  its own thread goes back to its free list, a block freed by another
+ *  thread to a lock-free list that the owner takes over when its free list
+ *  is empty: objects can be freely passed between threads.  Larger sizes
+ *  go to operator new.
+ *
+ *  trim() returns to the system the slabs of the calling thread that have
+ *  no block in use.
+ *
+ *  The pools are off by default: pool_allocator, and so the bqueue items,
+ *  fall back to churn_allocator.  A producer turns them on for the calling
+ *  thread with a Scope for the duration of its event, and the Scope trims
+ *  at its end, when what was built is either in the event or gone.
+ *
+ *  The state belongs to the thread, not to the producer: the TBB tasks the
+ *  producer spawns use the pools when they run on its thread, not on the
+ *  other ones, and so does any task the thread steals while the producer
+ *  waits, whatever module it belongs to.  This is safe because each
+ *  allocation remembers where it came from (in the allocator, or in the
+ *  bqueue item), so a block is always freed to the pool or to the heap it
+ *  was taken from, by any thread, in or out of a Scope, and trim() only
+ *  releases the slabs with no block in use.  Stolen tasks just leave their
+ *  blocks in the slabs of the thread until they are freed.
+ */
+namespace poolAllocator {
+
+  constexpr std::size_t maxBlockSize = 512;
+
+  // counters of the calling thread
+  struct Stats {
+    unsigned long long allocations = 0;   // blocks handed out
+    unsigned long long slabs = 0;         // slabs allocated
+    unsigned long long releasedSlabs = 0; // slabs returned by trim()
+  };
+
+  void * allocate(std::size_t size);
+  void deallocate(void * p, std::size_t size) noexcept;
+
+  Stats const & threadStats();
+  void trim();
+
+  // whether the pools are on for the calling thread
+  bool enabled();
+
+  // if enable, turns the pools on for the calling thread until its end, and then trims them
+  class Scope {
+  public:
+    explicit Scope(bool enable);
+    ~Scope();
+    Scope(Scope const&) = delete;
+    Scope & operator=(Scope const&) = delete;
+  private:
+    bool enable_;
+    bool previous_;
+  };
+
+}
+
+template <typename T>
+class pool_allocator
+{
+public:
+  using value_type = T;
+
+  T * allocate(std::size_t n) {
+    static_assert(alignof(T) <= 16, "pool_allocator blocks are 16 byte aligned");
+    return pooled_ ? static_cast<T*>(poolAllocator::allocate(n*sizeof(T))) : churn_allocator<T>().allocate(n);
+  }
+
+  void deallocate(T * p, std::size_t n) noexcept {
+    if (pooled_) poolAllocator::deallocate(p, n*sizeof(T));
+    else churn_allocator<T>().deallocate(p, n);
+  }
+
+  // uses the pools if they are on for the calling thread at construction
+  pool_allocator() : pooled_(poolAllocator::enabled()) {}
+  // for the blocks that were taken with pooled() as given
+  explicit pool_allocator(bool pooled) : pooled_(pooled) {}
+  pool_allocator(pool_allocator const&)=default;
+
+  template <class U>
+  pool_allocator(const pool_allocator<U> & other) noexcept : pooled_(other.pooled()) { }
+
+  bool pooled() const { return pooled_; }
+
+  template <class U>
+  bool operator==(const pool_allocator<U> & other) const { return pooled_ == other.pooled(); }
+  template <class U>
+  bool operator!=(const pool_allocator<U> & other) const { return pooled_ != other.pooled(); }
+
+private:
+  bool pooled_;
+};
+
+#endif
@@ -52,7 +52,7 @@ public:
   }
 
   template<typename... Args>
-  explicit TrajectoryStateOnSurface(Args && ...args) : Base(BTSOS::churn<BasicSingleTrajectoryState>(std::forward<Args>(args)...)){}
+  explicit TrajectoryStateOnSurface(Args && ...args) : Base(BTSOS::pooled<BasicSingleTrajectoryState>(std::forward<Args>(args)...)){}
 
   void swap(TrajectoryStateOnSurface & rh)  noexcept {
     Base::swap(rh);
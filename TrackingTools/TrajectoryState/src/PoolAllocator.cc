@@ -0,0 +1,182 @@
+#include "TrackingTools/TrajectoryState/interface/PoolAllocator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+  constexpr std::size_t slabSize = 64*1024;
+  constexpr std::size_t granularity = 16;
+  constexpr unsigned int nClasses = poolAllocator::maxBlockSize/granularity;
+
+  struct FreeBlock { FreeBlock * next; };
+
+  struct SizeClass;
+
+  // at the start of each slab: slabs are aligned to their size, so that the slab of a block is found by masking its address
+  struct alignas(64) Slab {
+    SizeClass * owner;
+    Slab * next;
+    std::atomic<unsigned int> live;  // blocks in use
+    bool release;
+  };
+
+  struct ThreadPools;
+
+  struct SizeClass {
+    ThreadPools * pools = nullptr;
+    std::size_t blockSize = 0;
+    FreeBlock * local = nullptr;
+    std::atomic<FreeBlock *> remote{nullptr};  // freed by other threads
+    Slab * slabs = nullptr;
+    Slab * current = nullptr;  // the slab the new blocks are carved from
+    char * bump = nullptr;
+    char * bumpEnd = nullptr;
+  };
+
+  struct ThreadPools {
+    ThreadPools() {
+      for (unsigned int i=0; i<nClasses; ++i) {
+	classes[i].pools = this;
+	classes[i].blockSize = (i+1)*granularity;
+      }
+    }
+    SizeClass classes[nClasses];
+    poolAllocator::Stats stats;
+  };
+
+  // never deleted, as the blocks of a thread may be freed after it has exited
+  ThreadPools & threadPools() {
+    static thread_local ThreadPools * pools = new ThreadPools;
+    return *pools;
+  }
+
+  thread_local bool poolsEnabled = false;
+
+  // a slab aligned to its size, to be released with std::free
+  void * alignedSlab() {
+#if __cplusplus >= 201703L
+    return std::aligned_alloc(slabSize, slabSize);
+#else
+    void * m = nullptr;
+    return posix_memalign(&m, slabSize, slabSize) == 0 ? m : nullptr;
+#endif
+  }
+
+  inline Slab * slabOf(void const * p) {
+    return reinterpret_cast<Slab *>(reinterpret_cast<std::uintptr_t>(p) & ~(slabSize-1));
+  }
+
+  void newSlab(SizeClass & sc, poolAllocator::Stats & stats) {
+    void * m = alignedSlab();
+    if (m == nullptr) throw std::bad_alloc();
+    auto slab = new (m) Slab;
+    slab->owner = &sc;
+    slab->next = sc.slabs;
+    slab->live.store(0, std::memory_order_relaxed);
+    slab->release = false;
+    sc.slabs = slab;
+    sc.current = slab;
+    sc.bump = static_cast<char *>(m) + sizeof(Slab);
+    sc.bumpEnd = static_cast<char *>(m) + slabSize;
+    ++stats.slabs;
+  }
+
+}
+
+void * poolAllocator::allocate(std::size_t size) {
+  if (size > maxBlockSize) return ::operator new(size);
+  auto & pools = threadPools();
+  auto & sc = pools.classes[size == 0 ? 0 : (size-1)/granularity];
+  ++pools.stats.allocations;
+
+  FreeBlock * b = sc.local;
+  if (b == nullptr) b = sc.remote.exchange(nullptr, std::memory_order_acquire);
+  if (b != nullptr) {
+    sc.local = b->next;
+  } else {
+    if (std::size_t(sc.bumpEnd - sc.bump) < sc.blockSize) newSlab(sc, pools.stats);
+    b = reinterpret_cast<FreeBlock *>(sc.bump);
+    sc.bump += sc.blockSize;
+  }
+  slabOf(b)->live.fetch_add(1, std::memory_order_relaxed);
+  return b;
+}
+
+void poolAllocator::deallocate(void * p, std::size_t size) noexcept {
+  if (p == nullptr) return;
+  if (size > maxBlockSize) { ::operator delete(p); return; }
+  auto slab = slabOf(p);
+  auto & sc = *slab->owner;
+  auto b = static_cast<FreeBlock *>(p);
+  if (sc.pools == &threadPools()) {
+    b->next = sc.local;
+    sc.local = b;
+  } else {
+    b->next = sc.remote.load(std::memory_order_relaxed);
+    while (!sc.remote.compare_exchange_weak(b->next, b, std::memory_order_release, std::memory_order_relaxed));
+  }
+  // after the push: trim() takes a slab without live blocks to have all its blocks in the lists
+  slab->live.fetch_sub(1, std::memory_order_release);
+}
+
+bool poolAllocator::enabled() {
+  return poolsEnabled;
+}
+
+poolAllocator::Scope::Scope(bool enable) : enable_(enable), previous_(poolsEnabled) {
+  if (enable_) poolsEnabled = true;
+}
+
+poolAllocator::Scope::~Scope() {
+  if (!enable_) return;
+  poolsEnabled = previous_;
+  trim();
+}
+
+poolAllocator::Stats const & poolAllocator::threadStats() {
+  return threadPools().stats;
+}
+
+void poolAllocator::trim() {
+  auto & pools = threadPools();
+  for (auto & sc : pools.classes) {
+    // only this thread allocates from these slabs: a slab without live blocks stays so
+    bool any = false;
+    for (auto s = sc.slabs; s != nullptr; s = s->next) {
+      if (s != sc.current && s->live.load(std::memory_order_acquire) == 0) {
+	s->release = true;
+	any = true;
+      }
+    }
+    if (!any) continue;
+
+    // drop the free blocks of the slabs to release, including the ones freed by other threads
+    FreeBlock * kept = nullptr;
+    auto keep = [&](FreeBlock * b) {
+      while (b != nullptr) {
+	auto next = b->next;
+	if (!slabOf(b)->release) { b->next = kept; kept = b; }
+	b = next;
+      }
+    };
+    keep(sc.local);
+    keep(sc.remote.exchange(nullptr, std::memory_order_acquire));
+    sc.local = kept;
+
+    Slab ** link = &sc.slabs;
+    while (*link != nullptr) {
+      auto s = *link;
+      if (s->release) {
+	*link = s->next;
+	s->~Slab();
+	std::free(s);
+	++pools.stats.releasedSlabs;
+      } else {
+	link = &s->next;
+      }
+    }
+  }
+}
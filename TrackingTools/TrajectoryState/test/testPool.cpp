@@ -0,0 +1,80 @@
+#include "TrackingTools/TrajectoryState/interface/PoolAllocator.h"
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct A { virtual ~A(){} double a[4]; };
+struct B : public A { explicit B(int i) : b(i) {} int b; };
+struct Big : public A { double c[100]; };
+
+int main() {
+
+  using PA = std::shared_ptr<A>;
+
+  // the pools are off by default, and churn_allocator reuses the last block freed
+  {
+    auto before = poolAllocator::threadStats().allocations;
+    PA b = std::allocate_shared<B>(pool_allocator<B>(),1);
+    assert(poolAllocator::threadStats().allocations == before);
+    A * first = b.get();
+    b.reset();
+    b = std::allocate_shared<B>(pool_allocator<B>(),1);
+    assert(b.get() == first);
+  }
+
+  // an object built outside a Scope can be destroyed inside it, and the other way round
+  PA outside = std::allocate_shared<B>(pool_allocator<B>(),1);
+  PA inside;
+  {
+    poolAllocator::Scope pools(true);
+    assert(poolAllocator::enabled());
+    inside = std::allocate_shared<B>(pool_allocator<B>(),2);
+    outside.reset();
+  }
+  assert(!poolAllocator::enabled());
+  inside.reset();
+
+  // blocks are reused within a thread
+  {
+    poolAllocator::Scope pools(true);
+    PA b = std::allocate_shared<B>(pool_allocator<B>(),3);
+    A * first = b.get();
+    b.reset();
+    b = std::allocate_shared<B>(pool_allocator<B>(),4);
+    assert(b.get() == first);
+    assert(static_cast<B&>(*b).b == 4);
+    PA big = std::allocate_shared<Big>(pool_allocator<Big>());  // above maxBlockSize
+  }
+
+  // objects built in one thread and destroyed in another, then trimmed by the owner
+  std::vector<PA> built;
+  std::thread producer([&]() {
+      poolAllocator::Scope pools(true);
+      for (int i=0; i<100000; ++i) built.push_back(std::allocate_shared<B>(pool_allocator<B>(),i));
+      auto const & stats = poolAllocator::threadStats();
+      std::cout << "producer: " << stats.allocations << " allocations, " << stats.slabs << " slabs" << std::endl;
+
+      std::thread consumer([&]() {
+	  for (int i=0; i<100000; ++i) assert(static_cast<B&>(*built[i]).b == i);
+	  built.clear();
+	});
+      consumer.join();
+
+      poolAllocator::trim();
+      std::cout << "producer after trim: " << stats.slabs - stats.releasedSlabs << " slabs in use" << std::endl;
+      assert(stats.slabs - stats.releasedSlabs <= 1);
+
+      // the blocks freed by the consumer and the released slabs can be used again
+      for (int i=0; i<100000; ++i) built.push_back(std::allocate_shared<B>(pool_allocator<B>(),i));
+      for (int i=0; i<100000; ++i) assert(static_cast<B&>(*built[i]).b == i);
+      built.clear();
+    });
+  producer.join();
+
+  std::cout << "end " << std::endl;
+
+  return 0;
+}